@@ -8,6 +8,8 @@
 
 #include "IXsensMVNControl.h"
 
+#include <Wearable/RealTime/RealTime.h>
+
 #include <array>
 #include <map>
 #include <mutex>
@@ -140,6 +142,7 @@ namespace xsensmvn {
         const DriverDataStreamConfig dataStreamConfiguration;
         const bool saveMVNRecording;
         const bool saveCurrentCalibration;
+        const wearable::realtime::ThreadSettings processorThreadSettings;
     };
 
     enum class DriverStatus
@@ -66,6 +66,7 @@ private:
 
     // Data processor thread
     std::thread m_processor;
+    wearable::realtime::JitterStatistics m_processorJitter;
 
     // Condition variables and mutexs
     std::condition_variable m_processorVariable;
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include "XSensMVNDriverImpl.h"
+#include "Wearable/Tracing/Tracing.h"
 
 #include <chrono>
 #include <experimental/filesystem>
@@ -60,6 +61,22 @@ XSensMVNDriverImpl::~XSensMVNDriverImpl()
 void XSensMVNDriverImpl::processDataSamples()
 {
     xsInfo << "Starting processing thread";
+
+    std::string error;
+    if (!wearable::realtime::applyThreadSettings(m_driverConfiguration.processorThreadSettings,
+                                                 error)) {
+        xsWarning << "Failed to apply the processor thread settings: " << error;
+    }
+    xsInfo << "Processor thread settings: "
+           << wearable::realtime::toString(m_driverConfiguration.processorThreadSettings);
+
+    // The samples are processed as they arrive, hence the period is the sampling one
+    if (m_driverConfiguration.samplingRate > 0) {
+        m_processorJitter.setPeriod(1.0 / m_driverConfiguration.samplingRate);
+    }
+    m_processorJitter.setReportPeriod(
+        m_driverConfiguration.processorThreadSettings.jitterReportPeriod);
+
     while (true) {
 
         XSensDataSample lastSample;
@@ -75,6 +92,7 @@ void XSensMVNDriverImpl::processDataSamples()
             // Check if the thread has been notified by fini()
             if (m_stopProcessor) {
                 // Time to stop
+                xsInfo << "Processor timing: " << m_processorJitter.summary();
                 xsInfo << "Closing sample processor thread";
                 break;
             }
@@ -91,6 +109,13 @@ void XSensMVNDriverImpl::processDataSamples()
             m_newSampleAvailable = false;
         }
 
+        WEARABLES_TRACE_SCOPE("XSensMVNDriverImpl::processDataSamples");
+        const wearable::realtime::ScopedTick jitterTick(m_processorJitter);
+
+        if (m_processorJitter.reportDue()) {
+            xsInfo << "Processor timing: " << m_processorJitter.summary();
+        }
+
         // Copy last retrieved data sample to the driver structure
         {
             std::lock_guard<std::mutex> copyLock(*m_outDataMutex);
@@ -110,6 +135,7 @@ void XSensMVNDriverImpl::processDataSamples()
                     .count(); // From yarp/os/SystemClock.cpp
 
             if (m_driverConfiguration.dataStreamConfiguration.enableLinkData) {
+                WEARABLES_TRACE_SCOPE("XSensMVNDriverImpl::processLinks");
 
                 // If the link data vector is empty is the first run, so allocate the space
                 if (m_lastProcessedDataSample->links.data.empty()) {
@@ -150,6 +176,7 @@ void XSensMVNDriverImpl::processDataSamples()
             }
 
             if (m_driverConfiguration.dataStreamConfiguration.enableSensorData) {
+                WEARABLES_TRACE_SCOPE("XSensMVNDriverImpl::processSensors");
 
                 // If the link data vector is empty is the first run, so allocate the space
                 if (m_lastProcessedDataSample->sensors.data.empty()) {
@@ -186,6 +213,7 @@ void XSensMVNDriverImpl::processDataSamples()
             }
 
             if (m_driverConfiguration.dataStreamConfiguration.enableJointData) {
+                WEARABLES_TRACE_SCOPE("XSensMVNDriverImpl::processJoints");
                 // Xsens store angles this way: dof are the rows, X, Y, Z the columns
                 // They are computed using ZXY permutation using current frame formalism
                 XmeEulerPermutation anglePermutation = XmeEulerPermutation::XEP_ZXY_YUp;
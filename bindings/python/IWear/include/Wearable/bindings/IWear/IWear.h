@@ -0,0 +1,20 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLES_BINDINGS_IWEAR_IWEAR_H
+#define WEARABLES_BINDINGS_IWEAR_IWEAR_H
+
+#include <pybind11/pybind11.h>
+
+namespace wearables {
+    namespace bindings {
+        namespace iwear {
+
+            void CreateSensorEnums(pybind11::module& module);
+            void CreateIWearDevice(pybind11::module& module);
+
+        } // namespace iwear
+    } // namespace bindings
+} // namespace wearables
+
+#endif // WEARABLES_BINDINGS_IWEAR_IWEAR_H
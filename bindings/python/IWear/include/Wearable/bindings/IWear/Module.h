@@ -0,0 +1,19 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLES_BINDINGS_IWEAR_MODULE_H
+#define WEARABLES_BINDINGS_IWEAR_MODULE_H
+
+#include <pybind11/pybind11.h>
+
+namespace wearables {
+    namespace bindings {
+        namespace iwear {
+
+            void CreateModule(pybind11::module& module);
+
+        } // namespace iwear
+    } // namespace bindings
+} // namespace wearables
+
+#endif // WEARABLES_BINDINGS_IWEAR_MODULE_H
@@ -0,0 +1,497 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <Wearable/IWear/IWear.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/os/Property.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Wearable/bindings/IWear/IWear.h>
+
+namespace wearables {
+    namespace bindings {
+        namespace iwear {
+
+            using namespace ::wearable;
+
+            // Number of values of a sensor in the rows filled by IWearDevice::read.
+            // The order of the values is the same of the WearableData *AsArrays() methods.
+            size_t sensorSizeFromType(const sensor::SensorType type)
+            {
+                switch (type) {
+                    case sensor::SensorType::Accelerometer:
+                    case sensor::SensorType::Force3DSensor:
+                    case sensor::SensorType::FreeBodyAccelerationSensor:
+                    case sensor::SensorType::Gyroscope:
+                    case sensor::SensorType::Magnetometer:
+                    case sensor::SensorType::PositionSensor:
+                    case sensor::SensorType::Torque3DSensor:
+                    case sensor::SensorType::VirtualJointKinSensor:
+                        return 3;
+                    case sensor::SensorType::EmgSensor:
+                        return 2;
+                    case sensor::SensorType::ForceTorque6DSensor:
+                        return 6;
+                    case sensor::SensorType::OrientationSensor:
+                        return 4;
+                    case sensor::SensorType::PoseSensor:
+                        return 7;
+                    case sensor::SensorType::TemperatureSensor:
+                        return 1;
+                    case sensor::SensorType::VirtualLinkKinSensor:
+                        return 19;
+                    case sensor::SensorType::VirtualSphericalJointKinSensor:
+                        return 9;
+                    default:
+                        // The size of the skin sensors depends on the number of taxels
+                        return 0;
+                }
+            }
+
+            bool readSensor(const sensor::ISensor& iSensor,
+                            double* out,
+                            const size_t width,
+                            std::vector<double>& buffer)
+            {
+                Vector3 v1;
+                Vector3 v2;
+                Quaternion quat;
+
+                switch (iSensor.getSensorType()) {
+                    case sensor::SensorType::Accelerometer:
+                        if (!static_cast<const sensor::IAccelerometer&>(iSensor)
+                                 .getLinearAcceleration(v1)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out);
+                        return true;
+                    case sensor::SensorType::EmgSensor: {
+                        const auto& emg = static_cast<const sensor::IEmgSensor&>(iSensor);
+                        return emg.getEmgSignal(out[0]) && emg.getNormalizationValue(out[1]);
+                    }
+                    case sensor::SensorType::Force3DSensor:
+                        if (!static_cast<const sensor::IForce3DSensor&>(iSensor).getForce3D(v1)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out);
+                        return true;
+                    case sensor::SensorType::ForceTorque6DSensor:
+                        if (!static_cast<const sensor::IForceTorque6DSensor&>(iSensor)
+                                 .getForceTorque6D(v1, v2)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out);
+                        std::copy(v2.begin(), v2.end(), out + 3);
+                        return true;
+                    case sensor::SensorType::FreeBodyAccelerationSensor:
+                        if (!static_cast<const sensor::IFreeBodyAccelerationSensor&>(iSensor)
+                                 .getFreeBodyAcceleration(v1)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out);
+                        return true;
+                    case sensor::SensorType::Gyroscope:
+                        if (!static_cast<const sensor::IGyroscope&>(iSensor).getAngularRate(v1)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out);
+                        return true;
+                    case sensor::SensorType::Magnetometer:
+                        if (!static_cast<const sensor::IMagnetometer&>(iSensor).getMagneticField(
+                                v1)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out);
+                        return true;
+                    case sensor::SensorType::OrientationSensor:
+                        if (!static_cast<const sensor::IOrientationSensor&>(iSensor)
+                                 .getOrientationAsQuaternion(quat)) {
+                            return false;
+                        }
+                        std::copy(quat.begin(), quat.end(), out);
+                        return true;
+                    case sensor::SensorType::PoseSensor:
+                        if (!static_cast<const sensor::IPoseSensor&>(iSensor).getPose(quat, v1)) {
+                            return false;
+                        }
+                        std::copy(quat.begin(), quat.end(), out);
+                        std::copy(v1.begin(), v1.end(), out + 4);
+                        return true;
+                    case sensor::SensorType::PositionSensor:
+                        if (!static_cast<const sensor::IPositionSensor&>(iSensor).getPosition(v1)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out);
+                        return true;
+                    case sensor::SensorType::SkinSensor:
+                        if (!static_cast<const sensor::ISkinSensor&>(iSensor).getPressure(buffer)) {
+                            return false;
+                        }
+                        std::copy(
+                            buffer.begin(), buffer.begin() + std::min(buffer.size(), width), out);
+                        std::fill(out + std::min(buffer.size(), width),
+                                  out + width,
+                                  std::numeric_limits<double>::quiet_NaN());
+                        return true;
+                    case sensor::SensorType::TemperatureSensor:
+                        return static_cast<const sensor::ITemperatureSensor&>(iSensor)
+                            .getTemperature(out[0]);
+                    case sensor::SensorType::Torque3DSensor:
+                        if (!static_cast<const sensor::ITorque3DSensor&>(iSensor).getTorque3D(v1)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out);
+                        return true;
+                    case sensor::SensorType::VirtualLinkKinSensor: {
+                        const auto& link = static_cast<const sensor::IVirtualLinkKinSensor&>(iSensor);
+                        if (!link.getLinkPose(v1, quat)) {
+                            return false;
+                        }
+                        std::copy(quat.begin(), quat.end(), out);
+                        std::copy(v1.begin(), v1.end(), out + 4);
+                        if (!link.getLinkVelocity(v1, v2)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out + 7);
+                        std::copy(v2.begin(), v2.end(), out + 10);
+                        if (!link.getLinkAcceleration(v1, v2)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out + 13);
+                        std::copy(v2.begin(), v2.end(), out + 16);
+                        return true;
+                    }
+                    case sensor::SensorType::VirtualJointKinSensor: {
+                        const auto& joint =
+                            static_cast<const sensor::IVirtualJointKinSensor&>(iSensor);
+                        return joint.getJointPosition(out[0]) && joint.getJointVelocity(out[1])
+                               && joint.getJointAcceleration(out[2]);
+                    }
+                    case sensor::SensorType::VirtualSphericalJointKinSensor: {
+                        const auto& joint =
+                            static_cast<const sensor::IVirtualSphericalJointKinSensor&>(iSensor);
+                        if (!joint.getJointAnglesAsRPY(v1)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out);
+                        if (!joint.getJointVelocities(v1)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out + 3);
+                        if (!joint.getJointAccelerations(v1)) {
+                            return false;
+                        }
+                        std::copy(v1.begin(), v1.end(), out + 6);
+                        return true;
+                    }
+                    default:
+                        return false;
+                }
+            }
+
+            // Render a Python object as a value of the YARP configuration format
+            void writeConfigValue(const pybind11::handle& object, std::ostringstream& stream)
+            {
+                namespace py = ::pybind11;
+
+                if (py::isinstance<py::bool_>(object)) {
+                    stream << (object.cast<bool>() ? "true" : "false");
+                }
+                else if (py::isinstance<py::int_>(object)) {
+                    stream << object.cast<long long>();
+                }
+                else if (py::isinstance<py::float_>(object)) {
+                    stream.precision(std::numeric_limits<double>::max_digits10);
+                    stream << object.cast<double>();
+                }
+                else if (py::isinstance<py::str>(object)) {
+                    stream << '"';
+                    for (const char c : object.cast<std::string>()) {
+                        if (c == '"' || c == '\\') {
+                            stream << '\\';
+                        }
+                        stream << c;
+                    }
+                    stream << '"';
+                }
+                else if (py::isinstance<py::list>(object) || py::isinstance<py::tuple>(object)) {
+                    stream << '(';
+                    bool first = true;
+                    for (const auto& item : object) {
+                        if (!first) {
+                            stream << ' ';
+                        }
+                        writeConfigValue(item, stream);
+                        first = false;
+                    }
+                    stream << ')';
+                }
+                else {
+                    throw py::type_error("Unsupported configuration value "
+                                         + py::str(object).cast<std::string>());
+                }
+            }
+
+            // IWear device opened through a PolyDriver. The sensors of each type are resolved
+            // once and cached, so that reading a sensor type is a single pass over the cached
+            // sensors writing directly in the memory of the NumPy arrays.
+            class IWearDevice
+            {
+            private:
+                struct SensorsLayout
+                {
+                    VectorOfSensorPtr<const sensor::ISensor> sensors;
+                    size_t size = 0;
+                };
+
+                yarp::dev::PolyDriver m_driver;
+                IWear* m_iWear = nullptr;
+                std::map<sensor::SensorType, SensorsLayout> m_layouts;
+                std::vector<double> m_buffer;
+
+                IWear& iWear() const
+                {
+                    if (!m_iWear) {
+                        throw std::runtime_error("The IWear device is not open");
+                    }
+                    return *m_iWear;
+                }
+
+                const SensorsLayout& getLayout(const sensor::SensorType type)
+                {
+                    auto it = m_layouts.find(type);
+                    if (it != m_layouts.end() && !it->second.sensors.empty()) {
+                        return it->second;
+                    }
+
+                    SensorsLayout layout;
+                    layout.sensors = iWear().getSensors(type);
+                    layout.size = sensorSizeFromType(type);
+
+                    if (type == sensor::SensorType::SkinSensor) {
+                        for (const auto& s : layout.sensors) {
+                            const auto& skin = static_cast<const sensor::ISkinSensor&>(*s);
+                            if (skin.getPressure(m_buffer)) {
+                                layout.size = std::max(layout.size, m_buffer.size());
+                            }
+                        }
+                    }
+
+                    return m_layouts[type] = std::move(layout);
+                }
+
+            public:
+                ~IWearDevice() { close(); }
+
+                bool open(yarp::os::Property& options)
+                {
+                    close();
+
+                    if (!m_driver.open(options)) {
+                        return false;
+                    }
+
+                    if (!m_driver.view(m_iWear) || !m_iWear) {
+                        m_driver.close();
+                        m_iWear = nullptr;
+                        return false;
+                    }
+
+                    return true;
+                }
+
+                bool openFromDict(const pybind11::dict& options)
+                {
+                    std::ostringstream config;
+                    for (const auto& item : options) {
+                        config << '(' << pybind11::str(item.first).cast<std::string>() << ' ';
+                        writeConfigValue(item.second, config);
+                        config << ") ";
+                    }
+
+                    yarp::os::Property property;
+                    property.fromString(config.str());
+                    return open(property);
+                }
+
+                bool openFromString(const std::string& config)
+                {
+                    yarp::os::Property property;
+                    property.fromString(config);
+                    return open(property);
+                }
+
+                bool close()
+                {
+                    m_layouts.clear();
+                    m_iWear = nullptr;
+                    return !m_driver.isValid() || m_driver.close();
+                }
+
+                bool isValid() const { return m_driver.isValid() && m_iWear; }
+
+                // Drop the cached sensors, e.g. after the device exposed new sensors
+                void refresh() { m_layouts.clear(); }
+
+                std::string getWearableName() const { return iWear().getWearableName(); }
+
+                sensor::SensorStatus getStatus() const { return iWear().getStatus(); }
+
+                pybind11::tuple getTimeStamp() const
+                {
+                    const TimeStamp timestamp = iWear().getTimeStamp();
+                    return pybind11::make_tuple(timestamp.time, timestamp.sequenceNumber);
+                }
+
+                std::vector<std::string> getSensorNames(const sensor::SensorType type)
+                {
+                    std::vector<std::string> names;
+                    for (const auto& s : getLayout(type).sensors) {
+                        names.push_back(s->getSensorName());
+                    }
+                    return names;
+                }
+
+                std::vector<std::string> getAllSensorNames() const
+                {
+                    return iWear().getAllSensorNames();
+                }
+
+                size_t getNumberOfSensors(const sensor::SensorType type)
+                {
+                    return getLayout(type).sensors.size();
+                }
+
+                size_t getSensorSize(const sensor::SensorType type) { return getLayout(type).size; }
+
+                pybind11::tuple allocate(const sensor::SensorType type)
+                {
+                    namespace py = ::pybind11;
+
+                    const SensorsLayout& layout = getLayout(type);
+                    py::array_t<double> values({static_cast<py::ssize_t>(layout.sensors.size()),
+                                                static_cast<py::ssize_t>(layout.size)});
+                    py::array_t<int32_t> status(static_cast<py::ssize_t>(layout.sensors.size()));
+                    return py::make_tuple(values, status);
+                }
+
+                // Fill the preallocated (n, size) values and (n,) status arrays. The GIL is
+                // released while the sensors are read. Sensors failing to read keep their
+                // previous values and have the Error status.
+                bool read(const sensor::SensorType type,
+                          pybind11::array_t<double, pybind11::array::c_style> values,
+                          pybind11::array_t<int32_t, pybind11::array::c_style> status)
+                {
+                    namespace py = ::pybind11;
+
+                    const SensorsLayout& layout = getLayout(type);
+                    const size_t nSensors = layout.sensors.size();
+
+                    if (values.ndim() != 2 || static_cast<size_t>(values.shape(0)) != nSensors
+                        || static_cast<size_t>(values.shape(1)) != layout.size) {
+                        throw py::value_error("The values array must have shape ("
+                                              + std::to_string(nSensors) + ", "
+                                              + std::to_string(layout.size) + ")");
+                    }
+                    if (status.ndim() != 1 || static_cast<size_t>(status.shape(0)) != nSensors) {
+                        throw py::value_error("The status array must have shape ("
+                                              + std::to_string(nSensors) + ",)");
+                    }
+
+                    double* valuesData = values.mutable_data();
+                    int32_t* statusData = status.mutable_data();
+                    std::vector<double> buffer;
+
+                    bool ok = true;
+                    {
+                        py::gil_scoped_release release;
+
+                        for (size_t i = 0; i < nSensors; ++i) {
+                            const sensor::ISensor& s = *layout.sensors[i];
+                            if (readSensor(s, valuesData + i * layout.size, layout.size, buffer)) {
+                                statusData[i] = static_cast<int32_t>(s.getSensorStatus());
+                            }
+                            else {
+                                statusData[i] = static_cast<int32_t>(sensor::SensorStatus::Error);
+                                ok = false;
+                            }
+                        }
+                    }
+
+                    return ok;
+                }
+            };
+
+            void CreateSensorEnums(pybind11::module& module)
+            {
+                namespace py = ::pybind11;
+
+                py::enum_<sensor::SensorStatus>(module, "SensorStatus")
+                    .value("Error", sensor::SensorStatus::Error)
+                    .value("Ok", sensor::SensorStatus::Ok)
+                    .value("Calibrating", sensor::SensorStatus::Calibrating)
+                    .value("Overflow", sensor::SensorStatus::Overflow)
+                    .value("Timeout", sensor::SensorStatus::Timeout)
+                    .value("Unknown", sensor::SensorStatus::Unknown)
+                    .value("WaitingForFirstRead", sensor::SensorStatus::WaitingForFirstRead);
+
+                py::enum_<sensor::SensorType> sensorType(module, "SensorType");
+                for (const auto type : AllSensorTypes) {
+                    sensorType.value(sensor::sensorTypeToString(type).c_str(), type);
+                }
+
+                module.def("sensorTypeFromString", &sensor::sensorTypeFromString, py::arg("type"));
+            }
+
+            void CreateIWearDevice(pybind11::module& module)
+            {
+                namespace py = ::pybind11;
+
+                py::class_<IWearDevice>(module, "IWearDevice")
+                    .def(py::init())
+                    .def("open",
+                         &IWearDevice::openFromDict,
+                         py::arg("options"),
+                         "Open the device from a dict of options, e.g. "
+                         "{'device': 'iwear_remapper', 'wearableDataPorts': ['/port:o']}.")
+                    .def("open",
+                         &IWearDevice::openFromString,
+                         py::arg("config"),
+                         "Open the device from a configuration string in the YARP format.")
+                    .def("close", &IWearDevice::close)
+                    .def("isValid", &IWearDevice::isValid)
+                    .def("refresh", &IWearDevice::refresh)
+                    .def("getWearableName", &IWearDevice::getWearableName)
+                    .def("getStatus", &IWearDevice::getStatus)
+                    .def("getTimeStamp", &IWearDevice::getTimeStamp)
+                    .def("getSensorNames", &IWearDevice::getSensorNames, py::arg("type"))
+                    .def("getAllSensorNames", &IWearDevice::getAllSensorNames)
+                    .def("getNumberOfSensors", &IWearDevice::getNumberOfSensors, py::arg("type"))
+                    .def("getSensorSize", &IWearDevice::getSensorSize, py::arg("type"))
+                    .def("allocate",
+                         &IWearDevice::allocate,
+                         py::arg("type"),
+                         "Return a (values, status) tuple of arrays to be filled by read().")
+                    .def("read",
+                         &IWearDevice::read,
+                         py::arg("type"),
+                         py::arg("values").noconvert(),
+                         py::arg("status").noconvert(),
+                         "Fill the preallocated values and status arrays with the data of all "
+                         "the sensors of the given type.");
+            }
+        } // namespace iwear
+    } // namespace bindings
+} // namespace wearables
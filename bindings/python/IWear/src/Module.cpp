@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <pybind11/pybind11.h>
+
+#include <Wearable/bindings/IWear/IWear.h>
+
+namespace wearables {
+    namespace bindings {
+        namespace iwear {
+
+            void CreateModule(pybind11::module& module)
+            {
+                module.doc() = "IWear module.";
+
+                CreateSensorEnums(module);
+                CreateIWearDevice(module);
+            }
+        } // namespace iwear
+    } // namespace bindings
+} // namespace wearables
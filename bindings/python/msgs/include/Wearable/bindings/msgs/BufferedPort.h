@@ -24,7 +24,12 @@ namespace wearables {
                     .def("open",
                          py::overload_cast<const std::string&>(&::yarp::os::BufferedPort<T>::open),
                          py::arg("name"))
-                    .def("close", &::yarp::os::BufferedPort<T>::close)
+                    .def("close",
+                         &::yarp::os::BufferedPort<T>::close,
+                         py::call_guard<py::gil_scoped_release>())
+                    .def("interrupt",
+                         &::yarp::os::BufferedPort<T>::interrupt,
+                         py::call_guard<py::gil_scoped_release>())
                     .def("isClosed", &::yarp::os::BufferedPort<T>::isClosed)
                     .def("prepare",
                          &::yarp::os::BufferedPort<T>::prepare,
@@ -32,10 +37,12 @@ namespace wearables {
                     .def("write",
                          &::yarp::os::BufferedPort<T>::write,
                          py::arg("forceStrict") = false)
+                    // The GIL is released while waiting, so that other Python threads can run
                     .def("read",
                          &::yarp::os::BufferedPort<T>::read,
                          py::arg("shouldWait") = true,
-                         py::return_value_policy::reference_internal);
+                         py::return_value_policy::reference_internal,
+                         py::call_guard<py::gil_scoped_release>());
             }
         } // namespace msgs
     } // namespace bindings
@@ -0,0 +1,438 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLES_BINDINGS_MSGS_STREAM_READER_H
+#define WEARABLES_BINDINGS_MSGS_STREAM_READER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <pybind11/pybind11.h>
+
+#include <yarp/os/BufferedPort.h>
+
+namespace wearables {
+    namespace bindings {
+        namespace msgs {
+
+            // Reader of a stream of messages. A C++ thread reads the port without holding the
+            // GIL and stores the messages in a bounded queue, dropping the oldest message when
+            // the queue is full. The messages are consumed from Python either with get() and
+            // the iterator protocol, with a callback called from a dispatcher thread, or with
+            // the asyncio futures returned by getAsync() and the async iterator protocol.
+            // A stream should be consumed by only one of these means at a time.
+            template <typename T>
+            class StreamReader
+            {
+            private:
+                yarp::os::BufferedPort<T> m_port;
+                std::thread m_reader;
+                std::thread m_dispatcher;
+
+                std::mutex m_mutex;
+                std::condition_variable m_condition;
+                std::deque<T> m_queue;
+                const size_t m_capacity;
+                bool m_open = false;
+                bool m_closing = false;
+                uint64_t m_received = 0;
+                uint64_t m_dropped = 0;
+
+                // The Python objects are accessed only holding the GIL
+                bool m_hasCallback = false;
+                pybind11::object m_callback;
+                std::deque<std::pair<pybind11::object, pybind11::object>> m_pendingFutures;
+
+                // Set by the destructor when it runs in the dispatcher thread, which then exits
+                // without accessing the stream anymore
+                bool* m_dispatcherDestroyed = nullptr;
+
+                void readerLoop()
+                {
+                    while (true) {
+                        T* data = m_port.read(/*shouldWait=*/true);
+
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (!data || m_closing) {
+                            break;
+                        }
+
+                        if (m_queue.size() >= m_capacity) {
+                            m_queue.pop_front();
+                            m_dropped++;
+                        }
+                        m_queue.push_back(*data);
+                        m_received++;
+                        m_condition.notify_all();
+                    }
+                }
+
+                void dispatcherLoop()
+                {
+                    namespace py = ::pybind11;
+
+                    bool destroyed = false;
+                    m_dispatcherDestroyed = &destroyed;
+
+                    while (true) {
+                        T frame;
+                        {
+                            std::unique_lock<std::mutex> lock(m_mutex);
+                            m_condition.wait(lock, [this] {
+                                return m_closing
+                                       || (!m_queue.empty()
+                                           && (m_hasCallback || !m_pendingFutures.empty()));
+                            });
+                            if (m_closing) {
+                                return;
+                            }
+                            frame = std::move(m_queue.front());
+                            m_queue.pop_front();
+                        }
+
+                        py::gil_scoped_acquire gil;
+
+                        // The Python object of the stream is kept alive while dispatching, its
+                        // last reference may be released by the receivers
+                        py::object self = py::cast(this, py::return_value_policy::reference);
+                        if (!dispatch(frame)) {
+                            // The receivers went away in the meantime, e.g. cancelled futures
+                            std::lock_guard<std::mutex> lock(m_mutex);
+                            m_queue.push_front(std::move(frame));
+                        }
+                        self = py::object();
+                        if (destroyed) {
+                            return;
+                        }
+                    }
+                }
+
+                // Called holding the GIL
+                bool dispatch(const T& frame)
+                {
+                    namespace py = ::pybind11;
+
+                    while (true) {
+                        py::object loop;
+                        py::object future;
+                        {
+                            std::lock_guard<std::mutex> lock(m_mutex);
+                            if (m_pendingFutures.empty()) {
+                                break;
+                            }
+                            loop = std::move(m_pendingFutures.front().first);
+                            future = std::move(m_pendingFutures.front().second);
+                            m_pendingFutures.pop_front();
+                        }
+
+                        // A future whose event loop has been closed cannot receive the message
+                        // anymore, and is dropped as a cancelled one
+                        try {
+                            if (!future.attr("done")().cast<bool>()) {
+                                loop.attr("call_soon_threadsafe")(
+                                    py::cpp_function(&StreamReader::setFutureResult),
+                                    future,
+                                    py::cast(frame));
+                                return true;
+                            }
+                        }
+                        catch (py::error_already_set&) {
+                            // The event loop has been already closed
+                        }
+                    }
+
+                    py::object callback;
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        callback = m_callback;
+                    }
+                    if (!callback || callback.is_none()) {
+                        return false;
+                    }
+
+                    try {
+                        callback(py::cast(frame));
+                    }
+                    catch (py::error_already_set& e) {
+                        e.restore();
+                        PyErr_Print();
+                    }
+                    return true;
+                }
+
+                // Executed in the thread of the event loop owning the future
+                static void setFutureResult(pybind11::object future, pybind11::object result)
+                {
+                    if (!future.attr("done")().cast<bool>()) {
+                        future.attr("set_result")(result);
+                    }
+                }
+
+                static void setFutureStop(pybind11::object future)
+                {
+                    if (!future.attr("done")().cast<bool>()) {
+                        future.attr("set_exception")(
+                            pybind11::handle(PyExc_StopAsyncIteration)());
+                    }
+                }
+
+                // Stop the threads and close the port, called holding the GIL
+                void stop()
+                {
+                    namespace py = ::pybind11;
+
+                    if (!m_reader.joinable()) {
+                        return;
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_closing = true;
+                    }
+                    m_condition.notify_all();
+
+                    {
+                        py::gil_scoped_release release;
+                        m_port.interrupt();
+                        m_reader.join();
+                        if (m_dispatcher.joinable()) {
+                            m_dispatcher.join();
+                        }
+                        m_port.close();
+                    }
+
+                    std::deque<std::pair<py::object, py::object>> pendingFutures;
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_open = false;
+                        m_queue.clear();
+                        std::swap(pendingFutures, m_pendingFutures);
+                    }
+
+                    // Terminate the pending async iterations
+                    for (auto& pending : pendingFutures) {
+                        try {
+                            pending.first.attr("call_soon_threadsafe")(
+                                py::cpp_function(&StreamReader::setFutureStop), pending.second);
+                        }
+                        catch (py::error_already_set&) {
+                            // The event loop has been already closed
+                        }
+                    }
+                }
+
+            public:
+                explicit StreamReader(const size_t capacity)
+                    : m_capacity(capacity > 0 ? capacity : 1)
+                {}
+
+                // Called holding the GIL. Closing the stream from the destructor does not throw,
+                // and the dispatcher thread is detached when the destructor runs in it.
+                ~StreamReader()
+                {
+                    if (m_reader.joinable()
+                        && std::this_thread::get_id() == m_dispatcher.get_id()) {
+                        *m_dispatcherDestroyed = true;
+                        m_dispatcher.detach();
+                    }
+
+                    try {
+                        stop();
+                    }
+                    catch (...) {
+                        // The Python objects cannot be released, e.g. at the interpreter exit
+                    }
+                }
+
+                StreamReader(const StreamReader& other) = delete;
+                StreamReader& operator=(const StreamReader& other) = delete;
+
+                bool open(const std::string& name)
+                {
+                    if (m_reader.joinable()) {
+                        return false;
+                    }
+
+                    // The port is left interrupted by the previous close
+                    m_port.resume();
+                    if (!m_port.open(name)) {
+                        return false;
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_open = true;
+                        m_closing = false;
+                    }
+
+                    m_reader = std::thread(&StreamReader::readerLoop, this);
+                    m_dispatcher = std::thread(&StreamReader::dispatcherLoop, this);
+                    return true;
+                }
+
+                // Called holding the GIL
+                void close()
+                {
+                    if (m_reader.joinable()
+                        && std::this_thread::get_id() == m_dispatcher.get_id()) {
+                        throw std::runtime_error("The stream cannot be closed from its callback");
+                    }
+                    stop();
+                }
+
+                bool isOpen()
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return m_open;
+                }
+
+                // Wait for the next message with the GIL released. A negative timeout waits
+                // until a message is received or the stream is closed. Return None on timeout.
+                pybind11::object get(const double timeout)
+                {
+                    namespace py = ::pybind11;
+
+                    T frame;
+                    bool received = false;
+                    {
+                        py::gil_scoped_release release;
+                        std::unique_lock<std::mutex> lock(m_mutex);
+
+                        const auto ready = [this] {
+                            return !m_queue.empty() || !m_open || m_closing;
+                        };
+                        if (timeout < 0) {
+                            m_condition.wait(lock, ready);
+                        }
+                        else {
+                            m_condition.wait_for(
+                                lock, std::chrono::duration<double>(timeout), ready);
+                        }
+
+                        if (!m_queue.empty()) {
+                            frame = std::move(m_queue.front());
+                            m_queue.pop_front();
+                            received = true;
+                        }
+                    }
+
+                    if (!received) {
+                        return py::none();
+                    }
+                    return py::cast(std::move(frame));
+                }
+
+                pybind11::object next()
+                {
+                    pybind11::object frame = get(-1);
+                    if (frame.is_none()) {
+                        throw pybind11::stop_iteration();
+                    }
+                    return frame;
+                }
+
+                // Return an asyncio future of the current event loop, resolved with the next
+                // message. If the stream is closed, the future raises StopAsyncIteration.
+                pybind11::object getAsync()
+                {
+                    namespace py = ::pybind11;
+
+                    py::object loop = py::module::import("asyncio").attr("get_event_loop")();
+                    py::object future = loop.attr("create_future")();
+
+                    T frame;
+                    bool received = false;
+                    bool closed = false;
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (!m_queue.empty()) {
+                            frame = std::move(m_queue.front());
+                            m_queue.pop_front();
+                            received = true;
+                        }
+                        else if (!m_open || m_closing) {
+                            closed = true;
+                        }
+                        else {
+                            m_pendingFutures.emplace_back(loop, future);
+                        }
+                    }
+                    m_condition.notify_all();
+
+                    if (received) {
+                        future.attr("set_result")(py::cast(std::move(frame)));
+                    }
+                    else if (closed) {
+                        setFutureStop(future);
+                    }
+                    return future;
+                }
+
+                // Set the function called from the dispatcher thread with each message.
+                // None removes the callback.
+                void setCallback(pybind11::object callback)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_callback = std::move(callback);
+                        m_hasCallback = !m_callback.is_none();
+                    }
+                    m_condition.notify_all();
+                }
+
+                size_t size()
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return m_queue.size();
+                }
+
+                size_t getCapacity() const { return m_capacity; }
+
+                uint64_t getReceived()
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return m_received;
+                }
+
+                uint64_t getDropped()
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    return m_dropped;
+                }
+            };
+
+            template <typename T>
+            void CreateStreamReader(pybind11::module& module, const std::string& name)
+            {
+                namespace py = ::pybind11;
+                py::class_<StreamReader<T>>(module, name.c_str())
+                    .def(py::init<size_t>(), py::arg("capacity") = 16)
+                    .def("open", &StreamReader<T>::open, py::arg("name"))
+                    .def("close", &StreamReader<T>::close)
+                    .def("isOpen", &StreamReader<T>::isOpen)
+                    .def("get", &StreamReader<T>::get, py::arg("timeout") = -1.0)
+                    .def("getAsync", &StreamReader<T>::getAsync)
+                    .def("setCallback", &StreamReader<T>::setCallback, py::arg("callback"))
+                    .def("size", &StreamReader<T>::size)
+                    .def("getCapacity", &StreamReader<T>::getCapacity)
+                    .def("getReceived", &StreamReader<T>::getReceived)
+                    .def("getDropped", &StreamReader<T>::getDropped)
+                    .def("__iter__", [](py::object self) { return self; })
+                    .def("__next__", &StreamReader<T>::next)
+                    .def("__aiter__", [](py::object self) { return self; })
+                    .def("__anext__", &StreamReader<T>::getAsync)
+                    .def("__enter__", [](py::object self) { return self; })
+                    .def("__exit__", [](StreamReader<T>& self, py::args) { self.close(); });
+            }
+        } // namespace msgs
+    } // namespace bindings
+} // namespace wearables
+
+#endif // WEARABLES_BINDINGS_MSGS_STREAM_READER_H
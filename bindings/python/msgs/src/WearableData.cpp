@@ -4,22 +4,226 @@
 
 #include "thrift/Accelerometer.h"
 #include "thrift/EmgData.h"
+#include "thrift/ExtendedWearableData.h"
 #include "thrift/QuaternionWXYZ.h"
 #include "thrift/SensorInfo.h"
 #include "thrift/VectorXYZ.h"
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
 #include <string>
 #include <thrift/WearableData.h>
+#include <vector>
 
 #include <Wearable/bindings/msgs/BufferedPort.h>
+#include <Wearable/bindings/msgs/StreamReader.h>
 #include <Wearable/bindings/msgs/WearableData.h>
+#include <Wearable/WireEncoding/WearableDataEncoding.h>
 
 namespace wearables {
     namespace bindings {
         namespace msgs {
 
+            // Packing of the sensor data into a row of doubles. The order of the values
+            // follows the order of the fields of the thrift structures.
+            template <typename Data>
+            struct DataPacker;
+
+            template <>
+            struct DataPacker<::wearable::msg::VectorXYZ>
+            {
+                static size_t size(const ::wearable::msg::VectorXYZ&) { return 3; }
+                static void pack(const ::wearable::msg::VectorXYZ& data, double* out)
+                {
+                    out[0] = data.x;
+                    out[1] = data.y;
+                    out[2] = data.z;
+                }
+            };
+
+            template <>
+            struct DataPacker<::wearable::msg::VectorRPY>
+            {
+                static size_t size(const ::wearable::msg::VectorRPY&) { return 3; }
+                static void pack(const ::wearable::msg::VectorRPY& data, double* out)
+                {
+                    out[0] = data.r;
+                    out[1] = data.p;
+                    out[2] = data.y;
+                }
+            };
+
+            template <>
+            struct DataPacker<::wearable::msg::QuaternionWXYZ>
+            {
+                static size_t size(const ::wearable::msg::QuaternionWXYZ&) { return 4; }
+                static void pack(const ::wearable::msg::QuaternionWXYZ& data, double* out)
+                {
+                    out[0] = data.w;
+                    out[1] = data.x;
+                    out[2] = data.y;
+                    out[3] = data.z;
+                }
+            };
+
+            template <>
+            struct DataPacker<::wearable::msg::ForceTorque6DSensorData>
+            {
+                static size_t size(const ::wearable::msg::ForceTorque6DSensorData&) { return 6; }
+                static void pack(const ::wearable::msg::ForceTorque6DSensorData& data, double* out)
+                {
+                    DataPacker<::wearable::msg::VectorXYZ>::pack(data.force, out);
+                    DataPacker<::wearable::msg::VectorXYZ>::pack(data.torque, out + 3);
+                }
+            };
+
+            template <>
+            struct DataPacker<::wearable::msg::PoseSensorData>
+            {
+                static size_t size(const ::wearable::msg::PoseSensorData&) { return 7; }
+                static void pack(const ::wearable::msg::PoseSensorData& data, double* out)
+                {
+                    DataPacker<::wearable::msg::QuaternionWXYZ>::pack(data.orientation, out);
+                    DataPacker<::wearable::msg::VectorXYZ>::pack(data.position, out + 4);
+                }
+            };
+
+            template <>
+            struct DataPacker<::wearable::msg::VirtualLinkKinSensorData>
+            {
+                static size_t size(const ::wearable::msg::VirtualLinkKinSensorData&) { return 19; }
+                static void pack(const ::wearable::msg::VirtualLinkKinSensorData& data, double* out)
+                {
+                    DataPacker<::wearable::msg::QuaternionWXYZ>::pack(data.orientation, out);
+                    DataPacker<::wearable::msg::VectorXYZ>::pack(data.position, out + 4);
+                    DataPacker<::wearable::msg::VectorXYZ>::pack(data.linearVelocity, out + 7);
+                    DataPacker<::wearable::msg::VectorXYZ>::pack(data.angularVelocity, out + 10);
+                    DataPacker<::wearable::msg::VectorXYZ>::pack(data.linearAcceleration, out + 13);
+                    DataPacker<::wearable::msg::VectorXYZ>::pack(data.angularAcceleration,
+                                                                 out + 16);
+                }
+            };
+
+            template <>
+            struct DataPacker<::wearable::msg::VirtualJointKinSensorData>
+            {
+                static size_t size(const ::wearable::msg::VirtualJointKinSensorData&) { return 3; }
+                static void pack(const ::wearable::msg::VirtualJointKinSensorData& data,
+                                 double* out)
+                {
+                    out[0] = data.position;
+                    out[1] = data.velocity;
+                    out[2] = data.acceleration;
+                }
+            };
+
+            template <>
+            struct DataPacker<::wearable::msg::VirtualSphericalJointKinSensorData>
+            {
+                static size_t size(const ::wearable::msg::VirtualSphericalJointKinSensorData&)
+                {
+                    return 9;
+                }
+                static void pack(const ::wearable::msg::VirtualSphericalJointKinSensorData& data,
+                                 double* out)
+                {
+                    DataPacker<::wearable::msg::VectorRPY>::pack(data.angle, out);
+                    DataPacker<::wearable::msg::VectorXYZ>::pack(data.velocity, out + 3);
+                    DataPacker<::wearable::msg::VectorXYZ>::pack(data.acceleration, out + 6);
+                }
+            };
+
+            template <>
+            struct DataPacker<::wearable::msg::EmgData>
+            {
+                static size_t size(const ::wearable::msg::EmgData&) { return 2; }
+                static void pack(const ::wearable::msg::EmgData& data, double* out)
+                {
+                    out[0] = data.value;
+                    out[1] = data.normalization;
+                }
+            };
+
+            template <>
+            struct DataPacker<double>
+            {
+                static size_t size(const double&) { return 1; }
+                static void pack(const double& data, double* out) { out[0] = data; }
+            };
+
+            // Skin sensors may have a different number of taxels, shorter rows are padded with NaN
+            template <>
+            struct DataPacker<std::vector<double>>
+            {
+                static size_t size(const std::vector<double>& data) { return data.size(); }
+                static void pack(const std::vector<double>& data, double* out)
+                {
+                    std::copy(data.begin(), data.end(), out);
+                }
+            };
+
+            // Convert a map of sensors to (names, status, values) in a single pass, where status
+            // is a (n,) int32 array of SensorStatus and values a C-contiguous (n, size) float64
+            // array
+            template <typename Sensor>
+            pybind11::tuple SensorsAsArrays(const std::map<std::string, Sensor>& sensors)
+            {
+                namespace py = ::pybind11;
+                using Packer = DataPacker<decltype(Sensor::data)>;
+
+                size_t width = 0;
+                for (const auto& sensor : sensors) {
+                    width = std::max(width, Packer::size(sensor.second.data));
+                }
+
+                const size_t nSensors = sensors.size();
+                py::list names(nSensors);
+                py::array_t<int32_t> status(static_cast<py::ssize_t>(nSensors));
+                py::array_t<double> values(
+                    {static_cast<py::ssize_t>(nSensors), static_cast<py::ssize_t>(width)});
+
+                int32_t* statusData = status.mutable_data();
+                double* valuesData = values.mutable_data();
+
+                size_t row = 0;
+                for (const auto& sensor : sensors) {
+                    names[row] = py::str(sensor.first);
+                    statusData[row] = static_cast<int32_t>(sensor.second.info.status);
+
+                    double* out = valuesData + row * width;
+                    const size_t size = Packer::size(sensor.second.data);
+                    Packer::pack(sensor.second.data, out);
+                    std::fill(out + size, out + width, std::numeric_limits<double>::quiet_NaN());
+                    ++row;
+                }
+
+                return py::make_tuple(names, status, values);
+            }
+
+            template <typename Sensor>
+            using SensorsField = std::map<std::string, Sensor>(::wearable::msg::WearableData::*);
+
+            template <typename Sensor>
+            void DefSensorsAsArrays(pybind11::class_<::wearable::msg::WearableData>& cls,
+                                    const std::string& name,
+                                    SensorsField<Sensor> field)
+            {
+                cls.def(
+                    (name + "AsArrays").c_str(),
+                    [field](const ::wearable::msg::WearableData& data) {
+                        return SensorsAsArrays(data.*field);
+                    },
+                    ("Return the " + name
+                     + " as a tuple (names, status, values) of a list of names, an int32 array of "
+                       "SensorStatus and a 2D float64 array with one row per sensor.")
+                        .c_str());
+            }
+
             void CreateSensorStatus(pybind11::module& module)
             {
                 namespace py = ::pybind11;
@@ -162,6 +366,54 @@ namespace wearables {
                     module, "VirtualSphericalJointKinSensor");
             }
 
+            void CreateSampleBlock(pybind11::module& module)
+            {
+                namespace py = ::pybind11;
+                using ::wearable::msg::SampleBlock;
+
+                py::class_<SampleBlock>(module, "SampleBlock")
+                    .def(py::init())
+                    .def_readwrite("info", &SampleBlock::info)
+                    .def_readwrite("type", &SampleBlock::type)
+                    .def_readwrite("firstSample", &SampleBlock::firstSample)
+                    .def_readwrite("startTime", &SampleBlock::startTime)
+                    .def_readwrite("samplePeriod", &SampleBlock::samplePeriod)
+                    .def_readwrite("channels", &SampleBlock::channels)
+                    .def_readwrite("values", &SampleBlock::values)
+                    .def("__str__", &SampleBlock::toString)
+                    .def("toString", &SampleBlock::toString);
+            }
+
+            // Frames of the extended wire format, read from <dataPortName>/extended:o
+            void CreateExtendedWearableData(pybind11::module& module)
+            {
+                namespace py = ::pybind11;
+                using ::wearable::msg::ExtendedWearableData;
+
+                py::class_<ExtendedWearableData>(module, "ExtendedWearableData")
+                    .def(py::init())
+                    .def_readwrite("data", &ExtendedWearableData::data)
+                    .def_readwrite("partial", &ExtendedWearableData::partial)
+                    .def_readwrite("sampleBlocks", &ExtendedWearableData::sampleBlocks)
+                    .def(
+                        "decode",
+                        [](ExtendedWearableData& frame) {
+                            std::string error;
+                            if (!::wearable::encoding::decodeWearableData(frame, error)) {
+                                throw py::value_error(error);
+                            }
+                        },
+                        "Expand the sensors encoded by the producer into the maps of their types "
+                        "of data.")
+                    .def("__str__", &ExtendedWearableData::toString)
+                    .def("toString", &ExtendedWearableData::toString);
+
+                CreateBufferedPort<ExtendedWearableData>(module,
+                                                         "BufferedPortExtendedWearableData");
+                CreateStreamReader<ExtendedWearableData>(module,
+                                                         "StreamReaderExtendedWearableData");
+            }
+
             void CreateWearableData(pybind11::module& module)
             {
                 namespace py = ::pybind11;
@@ -172,9 +424,10 @@ namespace wearables {
                 CreateVectors(module);
                 CreateSensorData(module);
                 CreateSensorsStructure(module);
+                CreateSampleBlock(module);
 
-                py::class_<WearableData>(module, "WearableData")
-                    .def(py::init())
+                py::class_<WearableData> wearableData(module, "WearableData");
+                wearableData.def(py::init())
                     .def_readwrite("producerName", &WearableData::producerName)
                     .def_readwrite("accelerometers", &WearableData::accelerometers)
                     .def_readwrite("emgSensors", &WearableData::emgSensors)
@@ -195,7 +448,41 @@ namespace wearables {
                     .def("__str__", &WearableData::toString)
                     .def("toString", &WearableData::toString);
 
+                DefSensorsAsArrays(wearableData, "accelerometers", &WearableData::accelerometers);
+                DefSensorsAsArrays(wearableData, "emgSensors", &WearableData::emgSensors);
+                DefSensorsAsArrays(wearableData, "force3DSensors", &WearableData::force3DSensors);
+                DefSensorsAsArrays(wearableData,
+                                   "forceTorque6DSensors",
+                                   &WearableData::forceTorque6DSensors);
+                DefSensorsAsArrays(wearableData,
+                                   "freeBodyAccelerationSensors",
+                                   &WearableData::freeBodyAccelerationSensors);
+                DefSensorsAsArrays(wearableData, "gyroscopes", &WearableData::gyroscopes);
+                DefSensorsAsArrays(wearableData, "magnetometers", &WearableData::magnetometers);
+                DefSensorsAsArrays(wearableData,
+                                   "orientationSensors",
+                                   &WearableData::orientationSensors);
+                DefSensorsAsArrays(wearableData, "poseSensors", &WearableData::poseSensors);
+                DefSensorsAsArrays(wearableData, "positionSensors", &WearableData::positionSensors);
+                DefSensorsAsArrays(wearableData, "skinSensors", &WearableData::skinSensors);
+                DefSensorsAsArrays(wearableData,
+                                   "temperatureSensors",
+                                   &WearableData::temperatureSensors);
+                DefSensorsAsArrays(wearableData, "torque3DSensors", &WearableData::torque3DSensors);
+                DefSensorsAsArrays(wearableData,
+                                   "virtualLinkKinSensors",
+                                   &WearableData::virtualLinkKinSensors);
+                DefSensorsAsArrays(wearableData,
+                                   "virtualJointKinSensors",
+                                   &WearableData::virtualJointKinSensors);
+                DefSensorsAsArrays(wearableData,
+                                   "virtualSphericalJointKinSensors",
+                                   &WearableData::virtualSphericalJointKinSensors);
+
                 CreateBufferedPort<WearableData>(module, "BufferedPortWearableData");
+                CreateStreamReader<WearableData>(module, "StreamReaderWearableData");
+
+                CreateExtendedWearableData(module);
             }
         } // namespace msgs
     } // namespace bindings
@@ -0,0 +1,124 @@
+# SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+# SPDX-License-Identifier: BSD-3-Clause
+
+import gc
+import threading
+import time
+import unittest
+
+import wearables
+
+try:
+    import yarp
+except ImportError:
+    yarp = None
+
+ReaderPortName = "/testStreamReader/data:i"
+WriterPortName = "/testStreamReader/data:o"
+Timeout = 5.0
+
+
+@unittest.skipIf(yarp is None, "the YARP Python bindings are required")
+class TestStreamReader(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        # The ports are registered in the process, without a name server
+        yarp.Network.init()
+        yarp.Network.setLocalMode(True)
+
+    @classmethod
+    def tearDownClass(cls):
+        yarp.Network.fini()
+
+    def setUp(self):
+        self.writer = wearables.BufferedPortWearableData()
+        self.assertTrue(self.writer.open(WriterPortName))
+        self.reader = wearables.StreamReaderWearableData(4)
+        self.assertTrue(self.reader.open(ReaderPortName))
+        self.assertTrue(yarp.Network.connect(WriterPortName, ReaderPortName))
+
+    def tearDown(self):
+        self.reader.close()
+        self.writer.close()
+
+    def write(self, name):
+        frame = self.writer.prepare()
+        frame.producerName = name
+        self.writer.write(True)
+
+    def test_read(self):
+        self.write("first")
+        frame = self.reader.get(Timeout)
+        self.assertIsNotNone(frame)
+        self.assertEqual(frame.producerName, "first")
+        self.assertEqual(self.reader.getReceived(), 1)
+
+        # Without messages the timeout expires
+        self.assertIsNone(self.reader.get(0.1))
+
+    def test_close(self):
+        self.write("first")
+        self.assertIsNotNone(self.reader.get(Timeout))
+
+        self.reader.close()
+        self.assertFalse(self.reader.isOpen())
+        self.assertIsNone(self.reader.get(Timeout))
+        with self.assertRaises(StopIteration):
+            next(self.reader)
+
+        # Closing again does nothing, and the stream can be opened again
+        self.reader.close()
+        self.assertTrue(self.reader.open(ReaderPortName))
+        self.assertTrue(self.reader.isOpen())
+
+    def test_interrupt(self):
+        # A reader waiting without timeout is woken up by the close
+        result = []
+        waiter = threading.Thread(target=lambda: result.append(self.reader.get()))
+        waiter.start()
+        time.sleep(0.2)
+        self.reader.close()
+        waiter.join(Timeout)
+        self.assertFalse(waiter.is_alive())
+        self.assertEqual(result, [None])
+
+    def test_close_from_callback(self):
+        errors = []
+        called = threading.Event()
+
+        def callback(frame):
+            try:
+                self.reader.close()
+            except RuntimeError as error:
+                errors.append(error)
+            called.set()
+
+        self.reader.setCallback(callback)
+        self.write("first")
+        self.assertTrue(called.wait(Timeout))
+        self.assertEqual(len(errors), 1)
+        self.reader.setCallback(None)
+
+    def test_release_from_callback(self):
+        # The last reference of the stream is released by its callback, destroying the stream in
+        # its dispatcher thread
+        references = [self.reader]
+        called = threading.Event()
+
+        def callback(frame):
+            references.clear()
+            called.set()
+
+        self.reader.setCallback(callback)
+        self.reader = wearables.StreamReaderWearableData(4)
+        self.write("first")
+        self.assertTrue(called.wait(Timeout))
+        time.sleep(0.2)
+        gc.collect()
+
+        # The port of the destroyed stream is closed and its name can be used again
+        self.assertTrue(self.reader.open(ReaderPortName))
+
+
+if __name__ == "__main__":
+    unittest.main()
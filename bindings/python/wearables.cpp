@@ -4,6 +4,7 @@
 
 #include <pybind11/pybind11.h>
 
+#include <Wearable/bindings/IWear/Module.h>
 #include <Wearable/bindings/msgs/Module.h>
 
 // Create the Python module
@@ -15,4 +16,7 @@ PYBIND11_MODULE(bindings, m)
 
     py::module msgModule = m.def_submodule("msg");
     wearables::bindings::msgs::CreateModule(msgModule);
+
+    py::module iwearModule = m.def_submodule("iwear");
+    wearables::bindings::iwear::CreateModule(iwearModule);
 }
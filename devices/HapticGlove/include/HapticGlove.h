@@ -38,6 +38,7 @@ public:
     bool close() override;
 
     // PeriodicThread
+    bool threadInit() override;
     void run() override;
     void threadRelease() override;
 
@@ -4,6 +4,8 @@
 
 #include <HapticGlove.h>
 #include <SenseGloveHelper.hpp>
+#include <Wearable/RealTime/RealTime.h>
+#include <Wearable/Tracing/Tracing.h>
 
 #include <yarp/os/Bottle.h>
 #include <yarp/os/LogStream.h>
@@ -67,6 +69,10 @@ public:
 
     double period = 0.01; //default 100Hz
 
+    // Real-time settings and timing of the loop
+    wearable::realtime::ThreadSettings threadSettings;
+    wearable::realtime::JitterStatistics jitter;
+
     SenseGloveIMUData gloveData;
 
     WearableName wearableName;
@@ -188,11 +194,14 @@ bool HapticGlove::SenseGloveImpl::run()
     std::lock_guard<std::mutex> lock(this->mutex);
 
     // sensors
-    this->pGlove->getPalmLinkPose(this->gloveData.humanPalmLinkPose);
+    {
+        WEARABLES_TRACE_SCOPE("HapticGlove::readSensors");
+        this->pGlove->getPalmLinkPose(this->gloveData.humanPalmLinkPose);
 
-    this->pGlove->getHandJointsAngles(this->gloveData.humanJointValues);
+        this->pGlove->getHandJointsAngles(this->gloveData.humanJointValues);
 
-    this->pGlove->getGloveFingertipLinksPose(this->gloveData.fingertipPoses);
+        this->pGlove->getGloveFingertipLinksPose(this->gloveData.fingertipPoses);
+    }
 
     // link poses
     this->gloveData.humanLinkPoses[0] = this->gloveData.humanPalmLinkPose;
@@ -209,6 +218,7 @@ bool HapticGlove::SenseGloveImpl::run()
     this->gloveData.palmThumperFeedback = static_cast<senseGlove::ThumperCmd>(
         round(this->gloveData.fingersHapticFeedback[2 * this->nFingers]));
 
+    WEARABLES_TRACE_SCOPE("HapticGlove::writeActuators");
     this->pGlove->setFingersForceReference(this->gloveData.fingersForceFeedback);
     this->pGlove->setBuzzMotorsReference(this->gloveData.fingersVibroTactileFeedback);
     this->pGlove->setPalmFeedbackThumper(this->gloveData.palmThumperFeedback);
@@ -263,6 +273,13 @@ bool HapticGlove::open(yarp::os::Searchable& config)
     }
     setPeriod(m_pImpl->period);
 
+    std::string error;
+    if (!wearable::realtime::parseThreadSettings(config, m_pImpl->threadSettings, error)) {
+        yError() << LogPrefix << error;
+        return false;
+    }
+    m_pImpl->jitter.setReportPeriod(m_pImpl->threadSettings.jitterReportPeriod);
+
     if (!(config.check("wearableName") && config.find("wearableName").isString())) {
         yInfo() << LogPrefix << "Using default wearable name SenseGlove";
         m_pImpl->wearableName = DeviceName;
@@ -561,8 +578,28 @@ private:
 };
 
 // ===========================================
+bool HapticGlove::threadInit()
+{
+    std::string error;
+    if (!wearable::realtime::applyThreadSettings(m_pImpl->threadSettings, error)) {
+        yWarning() << LogPrefix << "Failed to apply the thread settings:" << error;
+    }
+    yInfo() << LogPrefix << "Loop thread settings:"
+            << wearable::realtime::toString(m_pImpl->threadSettings);
+
+    m_pImpl->jitter.setPeriod(getPeriod());
+    return true;
+}
+
 void HapticGlove::run()
 {
+    WEARABLES_TRACE_SCOPE("HapticGlove::run");
+    const wearable::realtime::ScopedTick jitterTick(m_pImpl->jitter);
+
+    if (m_pImpl->jitter.reportDue()) {
+        yInfo() << LogPrefix << "Loop timing:" << m_pImpl->jitter.summary();
+    }
+
     // Get timestamp
     m_pImpl->timeStamp.time = yarp::os::Time::now();
 
@@ -581,7 +618,10 @@ bool HapticGlove::close()
     return true;
 }
 
-void HapticGlove::threadRelease() {}
+void HapticGlove::threadRelease()
+{
+    yInfo() << LogPrefix << "Loop timing:" << m_pImpl->jitter.summary();
+}
 
 // =========================
 // IPreciselyTimed interface
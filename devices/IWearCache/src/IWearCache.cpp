@@ -0,0 +1,785 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "IWearCache.h"
+#include "Wearable/IWear/Sensors/impl/SensorsImpl.h"
+#include "Wearable/IWear/impl/AttachedSource.h"
+#include "Wearable/Metrics/Metrics.h"
+#include "Wearable/RealTime/RealTime.h"
+#include "Wearable/Tracing/Tracing.h"
+
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+const std::string DeviceName = "IWearCache";
+const std::string LogPrefix = DeviceName + " :";
+constexpr double DefaultPeriod = 0.01;
+
+using namespace wearable;
+using namespace wearable::sensor;
+using namespace wearable::devices;
+
+class IWearCache::Impl
+{
+public:
+    struct
+    {
+        WearableName wearableName;
+        double period = DefaultPeriod;
+        // Acquire only when the timestamp of the attached device changes
+        bool onNewSequence = false;
+    } options;
+
+    wearable::impl::AttachedSource source;
+
+    // Cached copy of a sensor of the attached device, with the function reading the source
+    // sensor into the copy
+    struct CachedSensor
+    {
+        SensorPtr<ISensor> cache;
+        std::function<void()> update;
+    };
+    std::vector<CachedSensor> cachedSensors;
+    bool sensorsCreated = false;
+
+    size_t acquisitions = 0;
+    size_t skippedReads = 0;
+
+    mutable std::mutex mutex;
+    WearStatus status = WearStatus::WaitingForFirstRead;
+    TimeStamp timestamp;
+    yarp::os::Stamp stamp;
+
+    std::map<SensorType, VectorOfSensorPtr<const ISensor>> sensorsByType;
+    std::map<SensorName, SensorPtr<const ISensor>> sensorsByName;
+
+    // Runtime metrics, enabled by the metricsPortName option
+    std::unique_ptr<metrics::Metrics> metrics;
+    metrics::MetricsServer metricsServer;
+
+    realtime::ThreadSettings threadSettings;
+    realtime::JitterStatistics jitter;
+
+    template <typename SensorInterface>
+    SensorPtr<const SensorInterface> getSensor(const SensorName& name) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto it = sensorsByName.find(name);
+        if (it == sensorsByName.end()) {
+            yWarning() << LogPrefix << "Sensor" << name << "not found.";
+            return nullptr;
+        }
+        return std::dynamic_pointer_cast<const SensorInterface>(it->second);
+    }
+
+    bool createSensor(const SensorPtr<const ISensor>& sourceSensor);
+    void createSensors();
+    void acquire();
+};
+
+template <typename SensorImpl>
+static std::shared_ptr<SensorImpl> makeSensor(const SensorName& name)
+{
+    return std::make_shared<SensorImpl>(name, SensorStatus::WaitingForFirstRead);
+}
+
+// Return the function reading the source sensor into the cached one. The status of the source
+// sensor is propagated, and a failed read keeps the previous values of the copy.
+template <typename SensorImpl, typename Read>
+static std::function<void()> makeUpdate(const SensorPtr<const ISensor>& source,
+                                        const std::shared_ptr<SensorImpl>& cache,
+                                        Read read)
+{
+    return [source, cache, read]() {
+        SensorStatus status = source->getSensorStatus();
+        if (!read(*cache) && status == SensorStatus::Ok) {
+            status = SensorStatus::Error;
+        }
+        cache->setStatus(status);
+    };
+}
+
+bool IWearCache::Impl::createSensor(const SensorPtr<const ISensor>& sourceSensor)
+{
+    const SensorName name = sourceSensor->getSensorName();
+    CachedSensor entry;
+
+    switch (sourceSensor->getSensorType()) {
+        case SensorType::Accelerometer: {
+            auto source = std::dynamic_pointer_cast<const IAccelerometer>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::Accelerometer>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Vector3 value;
+                if (!source->getLinearAcceleration(value)) {
+                    return false;
+                }
+                cached.setBuffer(value);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::EmgSensor: {
+            auto source = std::dynamic_pointer_cast<const IEmgSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::EmgSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                double value = 0;
+                double normalization = 0;
+                if (!(source->getEmgSignal(value)
+                      && source->getNormalizationValue(normalization))) {
+                    return false;
+                }
+                cached.setBuffer(value, normalization);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::Force3DSensor: {
+            auto source = std::dynamic_pointer_cast<const IForce3DSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::Force3DSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Vector3 value;
+                if (!source->getForce3D(value)) {
+                    return false;
+                }
+                cached.setBuffer(value);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::ForceTorque6DSensor: {
+            auto source = std::dynamic_pointer_cast<const IForceTorque6DSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::ForceTorque6DSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Vector3 force;
+                Vector3 torque;
+                if (!source->getForceTorque6D(force, torque)) {
+                    return false;
+                }
+                cached.setBuffer(force, torque);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::FreeBodyAccelerationSensor: {
+            auto source =
+                std::dynamic_pointer_cast<const IFreeBodyAccelerationSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::FreeBodyAccelerationSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Vector3 value;
+                if (!source->getFreeBodyAcceleration(value)) {
+                    return false;
+                }
+                cached.setBuffer(value);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::Gyroscope: {
+            auto source = std::dynamic_pointer_cast<const IGyroscope>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::Gyroscope>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Vector3 value;
+                if (!source->getAngularRate(value)) {
+                    return false;
+                }
+                cached.setBuffer(value);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::Magnetometer: {
+            auto source = std::dynamic_pointer_cast<const IMagnetometer>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::Magnetometer>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Vector3 value;
+                if (!source->getMagneticField(value)) {
+                    return false;
+                }
+                cached.setBuffer(value);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::OrientationSensor: {
+            auto source = std::dynamic_pointer_cast<const IOrientationSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::OrientationSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Quaternion value;
+                if (!source->getOrientationAsQuaternion(value)) {
+                    return false;
+                }
+                cached.setBuffer(value);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::PoseSensor: {
+            auto source = std::dynamic_pointer_cast<const IPoseSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::PoseSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Quaternion orientation;
+                Vector3 position;
+                if (!source->getPose(orientation, position)) {
+                    return false;
+                }
+                cached.setBuffer(orientation, position);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::PositionSensor: {
+            auto source = std::dynamic_pointer_cast<const IPositionSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::PositionSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Vector3 value;
+                if (!source->getPosition(value)) {
+                    return false;
+                }
+                cached.setBuffer(value);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::SkinSensor: {
+            auto source = std::dynamic_pointer_cast<const ISkinSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::SkinSensor>(name);
+            // The buffer is reused among the acquisitions, avoiding an allocation per period
+            auto pressure = std::make_shared<std::vector<double>>();
+            entry.update = makeUpdate(sourceSensor, cache, [source, pressure](auto& cached) {
+                if (!source->getPressure(*pressure)) {
+                    return false;
+                }
+                cached.setBuffer(*pressure);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::TemperatureSensor: {
+            auto source = std::dynamic_pointer_cast<const ITemperatureSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::TemperatureSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                double value = 0;
+                if (!source->getTemperature(value)) {
+                    return false;
+                }
+                cached.setBuffer(value);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::Torque3DSensor: {
+            auto source = std::dynamic_pointer_cast<const ITorque3DSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::Torque3DSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Vector3 value;
+                if (!source->getTorque3D(value)) {
+                    return false;
+                }
+                cached.setBuffer(value);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::VirtualLinkKinSensor: {
+            auto source = std::dynamic_pointer_cast<const IVirtualLinkKinSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::VirtualLinkKinSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Vector3 linearAcc, angularAcc, linearVel, angularVel, position;
+                Quaternion orientation;
+                if (!(source->getLinkAcceleration(linearAcc, angularAcc)
+                      && source->getLinkVelocity(linearVel, angularVel)
+                      && source->getLinkPose(position, orientation))) {
+                    return false;
+                }
+                cached.setBuffer(
+                    linearAcc, angularAcc, linearVel, angularVel, position, orientation);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::VirtualJointKinSensor: {
+            auto source = std::dynamic_pointer_cast<const IVirtualJointKinSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::VirtualJointKinSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                double position = 0;
+                double velocity = 0;
+                double acceleration = 0;
+                if (!(source->getJointPosition(position) && source->getJointVelocity(velocity)
+                      && source->getJointAcceleration(acceleration))) {
+                    return false;
+                }
+                cached.setBuffer(position, velocity, acceleration);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        case SensorType::VirtualSphericalJointKinSensor: {
+            auto source =
+                std::dynamic_pointer_cast<const IVirtualSphericalJointKinSensor>(sourceSensor);
+            auto cache = makeSensor<sensor::impl::VirtualSphericalJointKinSensor>(name);
+            entry.update = makeUpdate(sourceSensor, cache, [source](auto& cached) {
+                Vector3 angles, velocities, accelerations;
+                if (!(source->getJointAnglesAsRPY(angles) && source->getJointVelocities(velocities)
+                      && source->getJointAccelerations(accelerations))) {
+                    return false;
+                }
+                cached.setBuffer(angles, velocities, accelerations);
+                return true;
+            });
+            entry.cache = cache;
+            break;
+        }
+        default:
+            yWarning() << LogPrefix << "Sensor" << name << "has an unsupported type";
+            return false;
+    }
+
+    sensorsByType[sourceSensor->getSensorType()].push_back(entry.cache);
+    sensorsByName.emplace(name, entry.cache);
+    cachedSensors.push_back(std::move(entry));
+    return true;
+}
+
+void IWearCache::Impl::createSensors()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (const auto& sourceSensor : source->getAllSensors()) {
+        if (sourceSensor) {
+            createSensor(sourceSensor);
+        }
+    }
+
+    yInfo() << LogPrefix << "*** Cached sensors     :" << sensorsByName.size();
+    for (const auto& entry : sensorsByType) {
+        yInfo() << LogPrefix << "***                     " << sensorTypeToString(entry.first)
+                << entry.second.size();
+    }
+
+    sensorsCreated = true;
+}
+
+void IWearCache::Impl::acquire()
+{
+    WEARABLES_TRACE_SCOPE("IWearCache::acquire");
+
+    for (auto& entry : cachedSensors) {
+        entry.update();
+    }
+}
+
+// ==========
+// IWearCache
+// ==========
+
+IWearCache::IWearCache()
+    : PeriodicThread(DefaultPeriod)
+    , pImpl{std::make_unique<Impl>()}
+{}
+
+// Without this destructor here, the linker complains for
+// undefined reference to vtable
+IWearCache::~IWearCache() = default;
+
+bool IWearCache::open(yarp::os::Searchable& config)
+{
+    // ===============
+    // READ PARAMETERS
+    // ===============
+
+    auto& options = pImpl->options;
+    options.period = config.check("period", yarp::os::Value(DefaultPeriod)).asFloat64();
+
+    if (options.period <= 0) {
+        yError() << LogPrefix << "Parameter 'period' must be positive";
+        return false;
+    }
+
+    const std::string trigger = config.check("trigger", yarp::os::Value("period")).asString();
+    if (trigger == "period") {
+        options.onNewSequence = false;
+    }
+    else if (trigger == "sequence") {
+        options.onNewSequence = true;
+    }
+    else {
+        yError() << LogPrefix << "Parameter 'trigger' must be period or sequence";
+        return false;
+    }
+
+    // Without this parameter, the name is the one of the attached device
+    if (config.check("wearableName")) {
+        options.wearableName = config.find("wearableName").asString();
+    }
+
+    std::string error;
+    if (!realtime::parseThreadSettings(config, pImpl->threadSettings, error)) {
+        yError() << LogPrefix << error;
+        return false;
+    }
+    pImpl->jitter.setReportPeriod(pImpl->threadSettings.jitterReportPeriod);
+
+    // Metrics optional configuration
+    if (config.check("metricsPortName")) {
+        const std::string metricsPortName = config.find("metricsPortName").asString();
+        pImpl->metrics.reset(new metrics::Metrics(DeviceName + " " + metricsPortName));
+        pImpl->metrics->setPeriod(options.period);
+
+        if (!pImpl->metricsServer.open(metricsPortName, pImpl->metrics.get())) {
+            yError() << LogPrefix << "Failed to open the metrics port" << metricsPortName;
+            return false;
+        }
+    }
+
+    yInfo() << LogPrefix << "*** ====================";
+    yInfo() << LogPrefix << "*** Period             :" << options.period;
+    yInfo() << LogPrefix << "*** Trigger            :" << trigger;
+    yInfo() << LogPrefix << "*** ====================";
+
+    setPeriod(options.period);
+    return true;
+}
+
+bool IWearCache::close()
+{
+    detach();
+    pImpl->metricsServer.close();
+    return true;
+}
+
+// ========================
+// PeriodicThread interface
+// ========================
+
+bool IWearCache::threadInit()
+{
+    std::string error;
+    if (!realtime::applyThreadSettings(pImpl->threadSettings, error)) {
+        yWarning() << LogPrefix << "Failed to apply the thread settings:" << error;
+    }
+    yInfo() << LogPrefix << "Loop thread settings:" << realtime::toString(pImpl->threadSettings);
+
+    pImpl->jitter.setPeriod(getPeriod());
+    return true;
+}
+
+void IWearCache::run()
+{
+    WEARABLES_TRACE_SCOPE("IWearCache::run");
+    const realtime::ScopedTick jitterTick(pImpl->jitter);
+    const double tickStartTime = yarp::os::Time::now();
+
+    if (pImpl->jitter.reportDue()) {
+        yInfo() << LogPrefix << "Loop timing:" << pImpl->jitter.summary();
+    }
+
+    const WearStatus sourceStatus = pImpl->source->getStatus();
+
+    // Until the attached device provides data, its status is exposed as it is
+    if (!pImpl->source.isProvidingData(sourceStatus, LogPrefix)) {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->status = sourceStatus;
+        return;
+    }
+
+    // The sensors are known once the attached device provided the first data
+    if (!pImpl->sensorsCreated) {
+        pImpl->createSensors();
+    }
+
+    TimeStamp sourceTimestamp;
+    double dt = 0;
+    const bool newSample = pImpl->source.nextSample(sourceTimestamp, dt);
+    if (pImpl->options.onNewSequence && !newSample) {
+        pImpl->skippedReads++;
+        return;
+    }
+
+    pImpl->acquire();
+
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->acquisitions++;
+    pImpl->status = sourceStatus;
+    pImpl->timestamp.time = sourceTimestamp.time;
+    pImpl->timestamp.sequenceNumber++;
+    pImpl->stamp = pImpl->source.getStamp(pImpl->timestamp);
+
+    if (pImpl->metrics) {
+        pImpl->metrics->addFramesIn();
+        pImpl->metrics->addTick(yarp::os::Time::now() - tickStartTime);
+    }
+}
+
+void IWearCache::threadRelease()
+{
+    yInfo() << LogPrefix << "Loop timing:" << pImpl->jitter.summary();
+    yInfo() << LogPrefix << "Acquisitions:" << pImpl->acquisitions
+            << "skipped without new data:" << pImpl->skippedReads;
+}
+
+// ==================
+// IWrapper interface
+// ==================
+
+bool IWearCache::attach(yarp::dev::PolyDriver* poly)
+{
+    if (!pImpl->source.attach(poly, LogPrefix)) {
+        return false;
+    }
+
+    if (pImpl->options.wearableName.empty()) {
+        pImpl->options.wearableName = pImpl->source.getWearableName();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->cachedSensors.clear();
+        pImpl->sensorsByType.clear();
+        pImpl->sensorsByName.clear();
+        pImpl->sensorsCreated = false;
+        pImpl->acquisitions = 0;
+        pImpl->skippedReads = 0;
+        pImpl->status = WearStatus::WaitingForFirstRead;
+    }
+
+    if (!start()) {
+        yError() << LogPrefix << "Failed to start the loop.";
+        pImpl->source.detach();
+        return false;
+    }
+
+    yDebug() << LogPrefix << "attach() successful";
+    return true;
+}
+
+bool IWearCache::detach()
+{
+    while (isRunning()) {
+        stop();
+    }
+
+    // The cached sensors stay available with the last values
+    pImpl->source.detach();
+
+    return true;
+}
+
+// ==========================
+// IMultipleWrapper interface
+// ==========================
+
+bool IWearCache::attachAll(const yarp::dev::PolyDriverList& driverList)
+{
+    if (driverList.size() > 1) {
+        yError() << LogPrefix << "This device accepts only one attached PolyDriver.";
+        return false;
+    }
+
+    const yarp::dev::PolyDriverDescriptor* driver = driverList[0];
+
+    if (!driver) {
+        yError() << LogPrefix << "Passed PolyDriverDescriptor is nullptr.";
+        return false;
+    }
+
+    return attach(driver->poly);
+}
+
+bool IWearCache::detachAll()
+{
+    return detach();
+}
+
+// ===============
+// IPreciselyTimed
+// ===============
+
+yarp::os::Stamp IWearCache::getLastInputStamp()
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->stamp;
+}
+
+// =====
+// IWEAR
+// =====
+
+WearableName IWearCache::getWearableName() const
+{
+    return pImpl->options.wearableName + wearable::Separator;
+}
+
+WearStatus IWearCache::getStatus() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    // The status of the attached device is exposed only after the first acquisition
+    if (pImpl->acquisitions == 0 && pImpl->status == WearStatus::Ok) {
+        return WearStatus::WaitingForFirstRead;
+    }
+    return pImpl->status;
+}
+
+TimeStamp IWearCache::getTimeStamp() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->timestamp;
+}
+
+SensorPtr<const ISensor> IWearCache::getSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ISensor>(name);
+}
+
+VectorOfSensorPtr<const ISensor> IWearCache::getSensors(const SensorType type) const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    const auto it = pImpl->sensorsByType.find(type);
+    if (it == pImpl->sensorsByType.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+SensorPtr<const IAccelerometer> IWearCache::getAccelerometer(const SensorName name) const
+{
+    return pImpl->getSensor<IAccelerometer>(name);
+}
+
+SensorPtr<const IEmgSensor> IWearCache::getEmgSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IEmgSensor>(name);
+}
+
+SensorPtr<const IForce3DSensor> IWearCache::getForce3DSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IForce3DSensor>(name);
+}
+
+SensorPtr<const IForceTorque6DSensor>
+IWearCache::getForceTorque6DSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IForceTorque6DSensor>(name);
+}
+
+SensorPtr<const IFreeBodyAccelerationSensor>
+IWearCache::getFreeBodyAccelerationSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IFreeBodyAccelerationSensor>(name);
+}
+
+SensorPtr<const IGyroscope> IWearCache::getGyroscope(const SensorName name) const
+{
+    return pImpl->getSensor<IGyroscope>(name);
+}
+
+SensorPtr<const IMagnetometer> IWearCache::getMagnetometer(const SensorName name) const
+{
+    return pImpl->getSensor<IMagnetometer>(name);
+}
+
+SensorPtr<const IOrientationSensor> IWearCache::getOrientationSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IOrientationSensor>(name);
+}
+
+SensorPtr<const IPoseSensor> IWearCache::getPoseSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IPoseSensor>(name);
+}
+
+SensorPtr<const IPositionSensor> IWearCache::getPositionSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IPositionSensor>(name);
+}
+
+SensorPtr<const ISkinSensor> IWearCache::getSkinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ISkinSensor>(name);
+}
+
+SensorPtr<const ITemperatureSensor> IWearCache::getTemperatureSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ITemperatureSensor>(name);
+}
+
+SensorPtr<const ITorque3DSensor> IWearCache::getTorque3DSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ITorque3DSensor>(name);
+}
+
+SensorPtr<const IVirtualLinkKinSensor>
+IWearCache::getVirtualLinkKinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IVirtualLinkKinSensor>(name);
+}
+
+SensorPtr<const IVirtualJointKinSensor>
+IWearCache::getVirtualJointKinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IVirtualJointKinSensor>(name);
+}
+
+SensorPtr<const IVirtualSphericalJointKinSensor>
+IWearCache::getVirtualSphericalJointKinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IVirtualSphericalJointKinSensor>(name);
+}
+
+// =========
+// ACTUATORS
+// =========
+
+ElementPtr<const actuator::IActuator>
+IWearCache::getActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getActuator(name) : nullptr;
+}
+
+VectorOfElementPtr<const actuator::IActuator>
+IWearCache::getActuators(const actuator::ActuatorType type) const
+{
+    if (!pImpl->source) {
+        return {};
+    }
+    return pImpl->source->getActuators(type);
+}
+
+ElementPtr<const actuator::IHaptic>
+IWearCache::getHapticActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getHapticActuator(name) : nullptr;
+}
+
+ElementPtr<const actuator::IMotor>
+IWearCache::getMotorActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getMotorActuator(name) : nullptr;
+}
+
+ElementPtr<const actuator::IHeater>
+IWearCache::getHeaterActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getHeaterActuator(name) : nullptr;
+}
@@ -0,0 +1,851 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "IWearJointKinEstimator.h"
+#include "Wearable/Estimation/Differentiator.h"
+#include "Wearable/IWear/Sensors/impl/SensorsImpl.h"
+#include "Wearable/IWear/Utils.h"
+#include "Wearable/IWear/impl/AttachedSource.h"
+#include "Wearable/Metrics/Metrics.h"
+#include "Wearable/RealTime/RealTime.h"
+#include "Wearable/Tracing/Tracing.h"
+
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#define WEARABLES_RESTRICT __restrict
+#else
+#define WEARABLES_RESTRICT __restrict__
+#endif
+
+const std::string DeviceName = "IWearJointKinEstimator";
+const std::string LogPrefix = DeviceName + " :";
+constexpr double DefaultPeriod = 0.01;
+// After longer intervals between two samples (e.g. after a pause of the attached device) the
+// estimation of the velocities restarts
+constexpr double MaxTimeStep = 0.5;
+
+using namespace wearable;
+using namespace wearable::sensor;
+using namespace wearable::devices;
+using Differentiator = wearable::estimation::Differentiator;
+
+class IWearJointKinEstimator::Impl
+{
+public:
+    struct JointConfig
+    {
+        std::string name;
+        std::string parentLink;
+        std::string childLink;
+    };
+
+    struct
+    {
+        WearableName wearableName;
+        double period = DefaultPeriod;
+        std::vector<JointConfig> joints;
+        Differentiator::Settings differentiator;
+    } options;
+
+    wearable::impl::AttachedSource source;
+
+    // The orientation of a link is read from its orientation, pose or virtual link kinematics
+    // sensor, the first available
+    struct Link
+    {
+        SensorPtr<const IOrientationSensor> orientation;
+        SensorPtr<const IPoseSensor> pose;
+        SensorPtr<const IVirtualLinkKinSensor> kinematics;
+    };
+    std::vector<Link> links;
+
+    struct Joint
+    {
+        size_t parent;
+        size_t child;
+        std::shared_ptr<sensor::impl::VirtualSphericalJointKinSensor> kinematics;
+    };
+    std::vector<Joint> joints;
+    bool jointsCreated = false;
+
+    // Orientations of the links, and of the parent and child links of the joints, as structures
+    // of arrays w x y z
+    std::vector<double> linkOrientations;
+    std::vector<double> parentOrientations;
+    std::vector<double> childOrientations;
+    std::vector<SensorStatus> linkStatuses;
+
+    // The relative orientations of all the joints are differentiated together. The channel of
+    // the component c of the joint j is c * joints.size() + j.
+    Differentiator differentiator;
+    std::vector<double> relativeOrientations;
+
+    size_t updates = 0;
+
+    mutable std::mutex mutex;
+    WearStatus status = WearStatus::WaitingForFirstRead;
+    TimeStamp timestamp;
+    yarp::os::Stamp stamp;
+
+    VectorOfSensorPtr<const ISensor> estimatedSensors;
+    std::map<SensorName, SensorPtr<const IVirtualSphericalJointKinSensor>> estimatedByName;
+
+    // Runtime metrics, enabled by the metricsPortName option
+    std::unique_ptr<metrics::Metrics> metrics;
+    metrics::MetricsServer metricsServer;
+
+    realtime::ThreadSettings threadSettings;
+    realtime::JitterStatistics jitter;
+
+    SensorPtr<const IVirtualSphericalJointKinSensor>
+    getEstimatedSensor(const SensorName& name) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto it = estimatedByName.find(name);
+        return it == estimatedByName.end() ? nullptr : it->second;
+    }
+
+    bool createJoints();
+    SensorStatus readLink(const Link& link, Quaternion& orientation) const;
+    void update(const double time, const bool restart);
+};
+
+// Map the sensors <wearable>::<prefix><link> by link, and return the <wearable> part of their
+// names
+template <typename SensorInterface>
+static std::map<std::string, SensorPtr<const SensorInterface>>
+mapByLink(const VectorOfSensorPtr<const SensorInterface>& sensors, std::string& wearable)
+{
+    std::map<std::string, SensorPtr<const SensorInterface>> map;
+    for (const auto& sensor : sensors) {
+        if (!sensor) {
+            continue;
+        }
+        const SensorName& name = sensor->getSensorName();
+        const size_t prefixPosition = name.rfind(SensorInterface::getPrefix());
+        if (prefixPosition != std::string::npos) {
+            wearable = name.substr(0, prefixPosition);
+            map.emplace(name.substr(prefixPosition + SensorInterface::getPrefix().size()), sensor);
+        }
+    }
+    return map;
+}
+
+// The kernel takes the arrays as restrict arguments, so that the compiler knows that they do not
+// overlap and vectorizes the loop. The relative orientation of each joint is
+// conj(parent) ⊗ child, with the sign closer to the previous one, since q and -q are the same
+// orientation and the relative orientations are differentiated.
+static void relativeOrientation(const size_t n,
+                                const double* WEARABLES_RESTRICT parent,
+                                const double* WEARABLES_RESTRICT child,
+                                const double* WEARABLES_RESTRICT previous,
+                                double* WEARABLES_RESTRICT relative)
+{
+    const double* pw = parent;
+    const double* px = parent + n;
+    const double* py = parent + 2 * n;
+    const double* pz = parent + 3 * n;
+    const double* cw = child;
+    const double* cx = child + n;
+    const double* cy = child + 2 * n;
+    const double* cz = child + 3 * n;
+
+    for (size_t j = 0; j < n; ++j) {
+        const double w = pw[j] * cw[j] + px[j] * cx[j] + py[j] * cy[j] + pz[j] * cz[j];
+        const double x = pw[j] * cx[j] - cw[j] * px[j] - (py[j] * cz[j] - pz[j] * cy[j]);
+        const double y = pw[j] * cy[j] - cw[j] * py[j] - (pz[j] * cx[j] - px[j] * cz[j]);
+        const double z = pw[j] * cz[j] - cw[j] * pz[j] - (px[j] * cy[j] - py[j] * cx[j]);
+
+        const double dot = w * previous[j] + x * previous[n + j] + y * previous[2 * n + j]
+                           + z * previous[3 * n + j];
+        const double sign = dot < 0 ? -1.0 : 1.0;
+
+        relative[j] = sign * w;
+        relative[n + j] = sign * x;
+        relative[2 * n + j] = sign * y;
+        relative[3 * n + j] = sign * z;
+    }
+}
+
+// Vector part of 2 * derivative ⊗ conjugate(orientation), that is the angular velocity (or
+// acceleration, from the second derivative) of the child link relative to the parent link, in
+// the parent frame. The quaternions are w x y z.
+static Vector3 angularRate(const Quaternion& orientation, const double (&derivative)[4])
+{
+    const double w = orientation[0];
+    const double x = orientation[1];
+    const double y = orientation[2];
+    const double z = orientation[3];
+    const double dw = derivative[0];
+    const double dx = derivative[1];
+    const double dy = derivative[2];
+    const double dz = derivative[3];
+
+    return {2 * (w * dx - dw * x - (dy * z - dz * y)),
+            2 * (w * dy - dw * y - (dz * x - dx * z)),
+            2 * (w * dz - dw * z - (dx * y - dy * x))};
+}
+
+// The joints whose links have no orientation are skipped, their kinematics is
+// <wearable>::vSJoint::<joint>
+bool IWearJointKinEstimator::Impl::createJoints()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::string wearable = source->getWearableName();
+    const auto orientationSensors = mapByLink(source->getOrientationSensors(), wearable);
+    const auto poseSensors = mapByLink(source->getPoseSensors(), wearable);
+    const auto linkKinSensors = mapByLink(source->getVirtualLinkKinSensors(), wearable);
+    std::string sourceJointsWearable;
+    const auto sourceJoints =
+        mapByLink(source->getVirtualSphericalJointKinSensors(), sourceJointsWearable);
+
+    std::map<std::string, size_t> linkIndices;
+    const auto findLink = [&](const std::string& name, size_t& index) -> bool {
+        const auto known = linkIndices.find(name);
+        if (known != linkIndices.end()) {
+            index = known->second;
+            return true;
+        }
+
+        Link link;
+        const auto orientation = orientationSensors.find(name);
+        const auto pose = poseSensors.find(name);
+        const auto kinematics = linkKinSensors.find(name);
+        if (orientation != orientationSensors.end()) {
+            link.orientation = orientation->second;
+        }
+        else if (pose != poseSensors.end()) {
+            link.pose = pose->second;
+        }
+        else if (kinematics != linkKinSensors.end()) {
+            link.kinematics = kinematics->second;
+        }
+        else {
+            return false;
+        }
+
+        index = links.size();
+        linkIndices.emplace(name, index);
+        links.push_back(std::move(link));
+        return true;
+    };
+
+    for (const auto& config : options.joints) {
+        if (sourceJoints.find(config.name) != sourceJoints.end()) {
+            yInfo() << LogPrefix << "The attached device already provides the joint"
+                    << config.name;
+            continue;
+        }
+
+        Joint joint;
+        if (!findLink(config.parentLink, joint.parent)
+            || !findLink(config.childLink, joint.child)) {
+            yWarning() << LogPrefix << "Skipping the joint" << config.name << ", the links"
+                       << config.parentLink << "and" << config.childLink
+                       << "must have an orientation, pose or virtual link kinematics sensor";
+            continue;
+        }
+
+        const SensorName jointName =
+            wearable + IVirtualSphericalJointKinSensor::getPrefix() + config.name;
+        joint.kinematics = std::make_shared<sensor::impl::VirtualSphericalJointKinSensor>(
+            jointName, SensorStatus::WaitingForFirstRead);
+
+        estimatedSensors.push_back(joint.kinematics);
+        estimatedByName.emplace(jointName, joint.kinematics);
+        joints.push_back(std::move(joint));
+    }
+
+    linkOrientations.assign(4 * links.size(), 0.0);
+    linkStatuses.assign(links.size(), SensorStatus::Ok);
+    parentOrientations.assign(4 * joints.size(), 0.0);
+    childOrientations.assign(4 * joints.size(), 0.0);
+    relativeOrientations.assign(4 * joints.size(), 0.0);
+
+    std::string error;
+    if (!differentiator.configure(options.differentiator, relativeOrientations.size(), error)) {
+        yError() << LogPrefix << error;
+        return false;
+    }
+
+    yInfo() << LogPrefix << "*** Estimated joints   :" << joints.size();
+    yInfo() << LogPrefix << "*** Links              :" << links.size();
+
+    jointsCreated = true;
+    return true;
+}
+
+SensorStatus IWearJointKinEstimator::Impl::readLink(const Link& link,
+                                                    Quaternion& orientation) const
+{
+    const ISensor* sensor = link.orientation
+                                ? static_cast<const ISensor*>(link.orientation.get())
+                                : link.pose ? static_cast<const ISensor*>(link.pose.get())
+                                            : static_cast<const ISensor*>(link.kinematics.get());
+    if (sensor->getSensorStatus() != SensorStatus::Ok) {
+        return sensor->getSensorStatus();
+    }
+
+    Vector3 position;
+    const bool read = link.orientation ? link.orientation->getOrientationAsQuaternion(orientation)
+                      : link.pose      ? link.pose->getPose(orientation, position)
+                                       : link.kinematics->getLinkPose(position, orientation);
+    return read ? SensorStatus::Ok : SensorStatus::Error;
+}
+
+void IWearJointKinEstimator::Impl::update(const double time, const bool restart)
+{
+    WEARABLES_TRACE_SCOPE("IWearJointKinEstimator::update");
+
+    const size_t nLinks = links.size();
+    const size_t nJoints = joints.size();
+    if (nJoints == 0) {
+        return;
+    }
+
+    // Each link is read once, also when it belongs to several joints. The orientation of a link
+    // that is not Ok holds its last value.
+    for (size_t l = 0; l < nLinks; ++l) {
+        Quaternion orientation;
+        linkStatuses[l] = readLink(links[l], orientation);
+        if (linkStatuses[l] == SensorStatus::Ok) {
+            const Quaternion normalized = utils::normalizeQuaternion(orientation);
+            for (size_t c = 0; c < 4; ++c) {
+                linkOrientations[c * nLinks + l] = normalized[c];
+            }
+        }
+    }
+
+    for (size_t j = 0; j < nJoints; ++j) {
+        for (size_t c = 0; c < 4; ++c) {
+            parentOrientations[c * nJoints + j] = linkOrientations[c * nLinks + joints[j].parent];
+            childOrientations[c * nJoints + j] = linkOrientations[c * nLinks + joints[j].child];
+        }
+    }
+
+    {
+        WEARABLES_TRACE_SCOPE("IWearJointKinEstimator::relativeOrientation");
+        relativeOrientation(nJoints,
+                            parentOrientations.data(),
+                            childOrientations.data(),
+                            differentiator.getSample(0),
+                            relativeOrientations.data());
+    }
+
+    if (restart) {
+        differentiator.reset();
+    }
+
+    bool ready = false;
+    {
+        WEARABLES_TRACE_SCOPE("IWearJointKinEstimator::differentiator");
+        ready = differentiator.update(time, relativeOrientations.data());
+    }
+
+    const double* first = differentiator.getFirstDerivative();
+    const double* second = differentiator.getSecondDerivative();
+
+    for (size_t j = 0; j < nJoints; ++j) {
+        Quaternion orientation;
+        double orientationFirst[4];
+        double orientationSecond[4];
+        for (size_t c = 0; c < 4; ++c) {
+            orientation[c] = relativeOrientations[c * nJoints + j];
+            orientationFirst[c] = first[c * nJoints + j];
+            orientationSecond[c] = second[c * nJoints + j];
+        }
+
+        SensorStatus status = linkStatuses[joints[j].parent];
+        if (status == SensorStatus::Ok) {
+            status = linkStatuses[joints[j].child];
+        }
+
+        joints[j].kinematics->setBuffer(utils::quaternionToRPY(orientation),
+                                        angularRate(orientation, orientationFirst),
+                                        angularRate(orientation, orientationSecond));
+        joints[j].kinematics->setStatus(ready ? status : SensorStatus::WaitingForFirstRead);
+    }
+}
+
+// ======================
+// IWearJointKinEstimator
+// ======================
+
+IWearJointKinEstimator::IWearJointKinEstimator()
+    : PeriodicThread(DefaultPeriod)
+    , pImpl{std::make_unique<Impl>()}
+{}
+
+// Without this destructor here, the linker complains for
+// undefined reference to vtable
+IWearJointKinEstimator::~IWearJointKinEstimator() = default;
+
+bool IWearJointKinEstimator::open(yarp::os::Searchable& config)
+{
+    // ===============
+    // READ PARAMETERS
+    // ===============
+
+    auto& options = pImpl->options;
+    options.period = config.check("period", yarp::os::Value(DefaultPeriod)).asFloat64();
+
+    if (options.period <= 0) {
+        yError() << LogPrefix << "Parameter 'period' must be positive";
+        return false;
+    }
+
+    auto& settings = options.differentiator;
+    const std::string method =
+        config.check("method", yarp::os::Value("savitzkyGolay")).asString();
+    if (method == "savitzkyGolay") {
+        settings.method = Differentiator::Method::SavitzkyGolay;
+    }
+    else if (method == "filteredDifference") {
+        settings.method = Differentiator::Method::FilteredDifference;
+    }
+    else {
+        yError() << LogPrefix << "Parameter 'method' must be savitzkyGolay or filteredDifference";
+        return false;
+    }
+
+    const int window =
+        config.check("window", yarp::os::Value(static_cast<int>(settings.window))).asInt32();
+    const int polynomialOrder =
+        config
+            .check("polynomialOrder", yarp::os::Value(static_cast<int>(settings.polynomialOrder)))
+            .asInt32();
+    if (window <= 0 || polynomialOrder <= 0) {
+        yError() << LogPrefix << "Parameters 'window' and 'polynomialOrder' must be positive";
+        return false;
+    }
+    settings.window = static_cast<size_t>(window);
+    settings.polynomialOrder = static_cast<size_t>(polynomialOrder);
+    settings.cutoffFrequency =
+        config.check("cutoffFrequency", yarp::os::Value(settings.cutoffFrequency)).asFloat64();
+
+    // The settings are checked here, the number of channels is known only after the attach
+    std::string error;
+    Differentiator check;
+    if (!check.configure(settings, 0, error)) {
+        yError() << LogPrefix << error;
+        return false;
+    }
+
+    // The joints are configured as a list of (joint parentLink childLink), the links being the
+    // names of their sensors after the prefix
+    const yarp::os::Bottle* jointsList =
+        config.check("joints") ? config.find("joints").asList() : nullptr;
+    if (!jointsList || jointsList->size() == 0) {
+        yError() << LogPrefix << "Parameter 'joints' must be a non empty list";
+        return false;
+    }
+    for (size_t i = 0; i < jointsList->size(); ++i) {
+        const yarp::os::Bottle* entry = jointsList->get(i).asList();
+        if (!entry || entry->size() != 3 || !entry->get(0).isString()
+            || !entry->get(1).isString() || !entry->get(2).isString()) {
+            yError() << LogPrefix
+                     << "The elements of 'joints' must be (joint parentLink childLink)";
+            return false;
+        }
+        options.joints.push_back(
+            {entry->get(0).asString(), entry->get(1).asString(), entry->get(2).asString()});
+    }
+
+    // Without this parameter, the name is the one of the attached device
+    if (config.check("wearableName")) {
+        options.wearableName = config.find("wearableName").asString();
+    }
+
+    if (!realtime::parseThreadSettings(config, pImpl->threadSettings, error)) {
+        yError() << LogPrefix << error;
+        return false;
+    }
+    pImpl->jitter.setReportPeriod(pImpl->threadSettings.jitterReportPeriod);
+
+    // Metrics optional configuration
+    if (config.check("metricsPortName")) {
+        const std::string metricsPortName = config.find("metricsPortName").asString();
+        pImpl->metrics.reset(new metrics::Metrics(DeviceName + " " + metricsPortName));
+        pImpl->metrics->setPeriod(options.period);
+
+        if (!pImpl->metricsServer.open(metricsPortName, pImpl->metrics.get())) {
+            yError() << LogPrefix << "Failed to open the metrics port" << metricsPortName;
+            return false;
+        }
+    }
+
+    yInfo() << LogPrefix << "*** ====================";
+    yInfo() << LogPrefix << "*** Period             :" << options.period;
+    yInfo() << LogPrefix << "*** Joints             :" << options.joints.size();
+    yInfo() << LogPrefix << "*** Method             :" << method;
+    if (settings.method == Differentiator::Method::SavitzkyGolay) {
+        yInfo() << LogPrefix << "*** Window             :" << settings.window;
+        yInfo() << LogPrefix << "*** Polynomial order   :" << settings.polynomialOrder;
+    }
+    else {
+        yInfo() << LogPrefix << "*** Cutoff frequency   :" << settings.cutoffFrequency;
+    }
+    yInfo() << LogPrefix << "*** ====================";
+
+    setPeriod(options.period);
+    return true;
+}
+
+bool IWearJointKinEstimator::close()
+{
+    detach();
+    pImpl->metricsServer.close();
+    return true;
+}
+
+// ========================
+// PeriodicThread interface
+// ========================
+
+bool IWearJointKinEstimator::threadInit()
+{
+    std::string error;
+    if (!realtime::applyThreadSettings(pImpl->threadSettings, error)) {
+        yWarning() << LogPrefix << "Failed to apply the thread settings:" << error;
+    }
+    yInfo() << LogPrefix << "Loop thread settings:" << realtime::toString(pImpl->threadSettings);
+
+    pImpl->jitter.setPeriod(getPeriod());
+    return true;
+}
+
+void IWearJointKinEstimator::run()
+{
+    WEARABLES_TRACE_SCOPE("IWearJointKinEstimator::run");
+    const realtime::ScopedTick jitterTick(pImpl->jitter);
+    const double tickStartTime = yarp::os::Time::now();
+
+    if (pImpl->jitter.reportDue()) {
+        yInfo() << LogPrefix << "Loop timing:" << pImpl->jitter.summary();
+    }
+
+    const WearStatus sourceStatus = pImpl->source->getStatus();
+
+    // Until the attached device provides data, its status is exposed as it is
+    if (!pImpl->source.isProvidingData(sourceStatus, LogPrefix)) {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->status = sourceStatus;
+        return;
+    }
+
+    // The sensors are known once the attached device provided the first data
+    if (!pImpl->jointsCreated) {
+        if (!pImpl->createJoints()) {
+            std::lock_guard<std::mutex> lock(pImpl->mutex);
+            pImpl->status = WearStatus::Error;
+            return;
+        }
+        if (pImpl->joints.empty()) {
+            yWarning() << LogPrefix << "None of the configured joints can be estimated";
+        }
+    }
+
+    // The estimates are updated at the rate of the attached device
+    TimeStamp sourceTimestamp;
+    double dt = 0;
+    if (!pImpl->source.nextSample(sourceTimestamp, dt)) {
+        return;
+    }
+
+    pImpl->update(sourceTimestamp.time,
+                  pImpl->source.getSamples() > 1 && (dt <= 0 || dt > MaxTimeStep));
+
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->updates++;
+    pImpl->status = sourceStatus;
+    pImpl->timestamp.time = sourceTimestamp.time;
+    pImpl->timestamp.sequenceNumber++;
+    pImpl->stamp = pImpl->source.getStamp(pImpl->timestamp);
+
+    if (pImpl->metrics) {
+        pImpl->metrics->addFramesIn();
+        pImpl->metrics->addTick(yarp::os::Time::now() - tickStartTime);
+    }
+}
+
+void IWearJointKinEstimator::threadRelease()
+{
+    yInfo() << LogPrefix << "Loop timing:" << pImpl->jitter.summary();
+}
+
+// ==================
+// IWrapper interface
+// ==================
+
+bool IWearJointKinEstimator::attach(yarp::dev::PolyDriver* poly)
+{
+    if (!pImpl->source.attach(poly, LogPrefix)) {
+        return false;
+    }
+
+    if (pImpl->options.wearableName.empty()) {
+        pImpl->options.wearableName = pImpl->source.getWearableName();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->links.clear();
+        pImpl->joints.clear();
+        pImpl->estimatedSensors.clear();
+        pImpl->estimatedByName.clear();
+        pImpl->jointsCreated = false;
+        pImpl->updates = 0;
+        pImpl->status = WearStatus::WaitingForFirstRead;
+    }
+
+    if (!start()) {
+        yError() << LogPrefix << "Failed to start the loop.";
+        pImpl->source.detach();
+        return false;
+    }
+
+    yDebug() << LogPrefix << "attach() successful";
+    return true;
+}
+
+bool IWearJointKinEstimator::detach()
+{
+    while (isRunning()) {
+        stop();
+    }
+
+    pImpl->source.detach();
+
+    return true;
+}
+
+// ==========================
+// IMultipleWrapper interface
+// ==========================
+
+bool IWearJointKinEstimator::attachAll(const yarp::dev::PolyDriverList& driverList)
+{
+    if (driverList.size() > 1) {
+        yError() << LogPrefix << "This device accepts only one attached PolyDriver.";
+        return false;
+    }
+
+    const yarp::dev::PolyDriverDescriptor* driver = driverList[0];
+
+    if (!driver) {
+        yError() << LogPrefix << "Passed PolyDriverDescriptor is nullptr.";
+        return false;
+    }
+
+    return attach(driver->poly);
+}
+
+bool IWearJointKinEstimator::detachAll()
+{
+    return detach();
+}
+
+// ===============
+// IPreciselyTimed
+// ===============
+
+yarp::os::Stamp IWearJointKinEstimator::getLastInputStamp()
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->stamp;
+}
+
+// =====
+// IWEAR
+// =====
+
+WearableName IWearJointKinEstimator::getWearableName() const
+{
+    return pImpl->options.wearableName + wearable::Separator;
+}
+
+WearStatus IWearJointKinEstimator::getStatus() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    // The status of the attached device is exposed only after the first update of the estimates
+    if (pImpl->updates == 0 && pImpl->status == WearStatus::Ok) {
+        return WearStatus::WaitingForFirstRead;
+    }
+    return pImpl->status;
+}
+
+TimeStamp IWearJointKinEstimator::getTimeStamp() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->timestamp;
+}
+
+// The estimated joint kinematics are added to the sensors of the attached device, that are
+// forwarded
+
+SensorPtr<const ISensor> IWearJointKinEstimator::getSensor(const SensorName name) const
+{
+    const auto estimated = pImpl->getEstimatedSensor(name);
+    if (estimated) {
+        return estimated;
+    }
+    return pImpl->source ? pImpl->source->getSensor(name) : nullptr;
+}
+
+VectorOfSensorPtr<const ISensor> IWearJointKinEstimator::getSensors(const SensorType type) const
+{
+    VectorOfSensorPtr<const ISensor> sensors;
+    if (pImpl->source) {
+        sensors = pImpl->source->getSensors(type);
+    }
+
+    if (type == SensorType::VirtualSphericalJointKinSensor) {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        sensors.insert(
+            sensors.end(), pImpl->estimatedSensors.begin(), pImpl->estimatedSensors.end());
+    }
+    return sensors;
+}
+
+SensorPtr<const IAccelerometer>
+IWearJointKinEstimator::getAccelerometer(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getAccelerometer(name) : nullptr;
+}
+
+SensorPtr<const IEmgSensor> IWearJointKinEstimator::getEmgSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getEmgSensor(name) : nullptr;
+}
+
+SensorPtr<const IForce3DSensor>
+IWearJointKinEstimator::getForce3DSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getForce3DSensor(name) : nullptr;
+}
+
+SensorPtr<const IForceTorque6DSensor>
+IWearJointKinEstimator::getForceTorque6DSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getForceTorque6DSensor(name) : nullptr;
+}
+
+SensorPtr<const IFreeBodyAccelerationSensor>
+IWearJointKinEstimator::getFreeBodyAccelerationSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getFreeBodyAccelerationSensor(name) : nullptr;
+}
+
+SensorPtr<const IGyroscope> IWearJointKinEstimator::getGyroscope(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getGyroscope(name) : nullptr;
+}
+
+SensorPtr<const IMagnetometer>
+IWearJointKinEstimator::getMagnetometer(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getMagnetometer(name) : nullptr;
+}
+
+SensorPtr<const IOrientationSensor>
+IWearJointKinEstimator::getOrientationSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getOrientationSensor(name) : nullptr;
+}
+
+SensorPtr<const IPoseSensor> IWearJointKinEstimator::getPoseSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getPoseSensor(name) : nullptr;
+}
+
+SensorPtr<const IPositionSensor>
+IWearJointKinEstimator::getPositionSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getPositionSensor(name) : nullptr;
+}
+
+SensorPtr<const ISkinSensor> IWearJointKinEstimator::getSkinSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getSkinSensor(name) : nullptr;
+}
+
+SensorPtr<const ITemperatureSensor>
+IWearJointKinEstimator::getTemperatureSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getTemperatureSensor(name) : nullptr;
+}
+
+SensorPtr<const ITorque3DSensor>
+IWearJointKinEstimator::getTorque3DSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getTorque3DSensor(name) : nullptr;
+}
+
+SensorPtr<const IVirtualLinkKinSensor>
+IWearJointKinEstimator::getVirtualLinkKinSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getVirtualLinkKinSensor(name) : nullptr;
+}
+
+SensorPtr<const IVirtualJointKinSensor>
+IWearJointKinEstimator::getVirtualJointKinSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getVirtualJointKinSensor(name) : nullptr;
+}
+
+SensorPtr<const IVirtualSphericalJointKinSensor>
+IWearJointKinEstimator::getVirtualSphericalJointKinSensor(const SensorName name) const
+{
+    const auto estimated = pImpl->getEstimatedSensor(name);
+    if (estimated) {
+        return estimated;
+    }
+    return pImpl->source ? pImpl->source->getVirtualSphericalJointKinSensor(name) : nullptr;
+}
+
+// =========
+// ACTUATORS
+// =========
+
+ElementPtr<const actuator::IActuator>
+IWearJointKinEstimator::getActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getActuator(name) : nullptr;
+}
+
+VectorOfElementPtr<const actuator::IActuator>
+IWearJointKinEstimator::getActuators(const actuator::ActuatorType type) const
+{
+    if (!pImpl->source) {
+        return {};
+    }
+    return pImpl->source->getActuators(type);
+}
+
+ElementPtr<const actuator::IHaptic>
+IWearJointKinEstimator::getHapticActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getHapticActuator(name) : nullptr;
+}
+
+ElementPtr<const actuator::IMotor>
+IWearJointKinEstimator::getMotorActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getMotorActuator(name) : nullptr;
+}
+
+ElementPtr<const actuator::IHeater>
+IWearJointKinEstimator::getHeaterActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getHeaterActuator(name) : nullptr;
+}
@@ -0,0 +1,745 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "IWearLinkKinEstimator.h"
+#include "Wearable/Estimation/Differentiator.h"
+#include "Wearable/IWear/Sensors/impl/SensorsImpl.h"
+#include "Wearable/IWear/impl/AttachedSource.h"
+#include "Wearable/Metrics/Metrics.h"
+#include "Wearable/RealTime/RealTime.h"
+#include "Wearable/Tracing/Tracing.h"
+
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+const std::string DeviceName = "IWearLinkKinEstimator";
+const std::string LogPrefix = DeviceName + " :";
+constexpr double DefaultPeriod = 0.01;
+// After longer intervals between two samples (e.g. after a pause of the attached device) the
+// estimation restarts
+constexpr double MaxTimeStep = 0.5;
+
+// Components of a link in the channels of the differentiator: position and quaternion
+constexpr size_t PositionChannels = 3;
+constexpr size_t LinkChannels = 7;
+
+using namespace wearable;
+using namespace wearable::sensor;
+using namespace wearable::devices;
+using Differentiator = wearable::estimation::Differentiator;
+
+class IWearLinkKinEstimator::Impl
+{
+public:
+    struct
+    {
+        WearableName wearableName;
+        double period = DefaultPeriod;
+        Differentiator::Settings differentiator;
+    } options;
+
+    wearable::impl::AttachedSource source;
+
+    // The input of a link, a pose sensor or an orientation sensor, and its estimated kinematics
+    struct Link
+    {
+        SensorPtr<const IPoseSensor> pose;
+        SensorPtr<const IOrientationSensor> orientation;
+        std::shared_ptr<sensor::impl::VirtualLinkKinSensor> kinematics;
+    };
+    std::vector<Link> links;
+    std::vector<SensorStatus> linkStatuses;
+    bool linksCreated = false;
+
+    // All the links are differentiated together. The channel of the component c of the link l is
+    // c * links.size() + l, so that each component of all the links is contiguous.
+    Differentiator differentiator;
+    std::vector<double> input;
+
+    size_t updates = 0;
+
+    mutable std::mutex mutex;
+    WearStatus status = WearStatus::WaitingForFirstRead;
+    TimeStamp timestamp;
+    yarp::os::Stamp stamp;
+
+    VectorOfSensorPtr<const ISensor> estimatedSensors;
+    std::map<SensorName, SensorPtr<const IVirtualLinkKinSensor>> estimatedByName;
+
+    // Runtime metrics, enabled by the metricsPortName option
+    std::unique_ptr<metrics::Metrics> metrics;
+    metrics::MetricsServer metricsServer;
+
+    realtime::ThreadSettings threadSettings;
+    realtime::JitterStatistics jitter;
+
+    SensorPtr<const IVirtualLinkKinSensor> getEstimatedSensor(const SensorName& name) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto it = estimatedByName.find(name);
+        return it == estimatedByName.end() ? nullptr : it->second;
+    }
+
+    bool createLinks();
+    bool readLink(const size_t l, Quaternion& orientation, Vector3& position) const;
+    void update(const double time, const bool restart);
+};
+
+template <typename SensorInterface>
+static std::map<SensorName, SensorPtr<const SensorInterface>>
+mapByName(const VectorOfSensorPtr<const SensorInterface>& sensors)
+{
+    std::map<SensorName, SensorPtr<const SensorInterface>> map;
+    for (const auto& sensor : sensors) {
+        if (sensor) {
+            map.emplace(sensor->getSensorName(), sensor);
+        }
+    }
+    return map;
+}
+
+// Vector part of 2 * derivative ⊗ conjugate(orientation), that is the angular velocity (or
+// acceleration, from the second derivative) in the world frame. The quaternions are w x y z.
+static Vector3 angularRate(const Quaternion& orientation, const double (&derivative)[4])
+{
+    const double w = orientation[0];
+    const double x = orientation[1];
+    const double y = orientation[2];
+    const double z = orientation[3];
+    const double dw = derivative[0];
+    const double dx = derivative[1];
+    const double dy = derivative[2];
+    const double dz = derivative[3];
+
+    return {2 * (w * dx - dw * x - (dy * z - dz * y)),
+            2 * (w * dy - dw * y - (dz * x - dx * z)),
+            2 * (w * dz - dw * z - (dx * y - dy * x))};
+}
+
+// The links are the ones of the pose sensors <wearable>::pose::<link>, and of the orientation
+// sensors <wearable>::orient::<link> without a pose sensor. Their kinematics is
+// <wearable>::vLink::<link>.
+bool IWearLinkKinEstimator::Impl::createLinks()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto linkKinSensors = mapByName(source->getVirtualLinkKinSensors());
+    std::map<std::string, Link> linksByName;
+
+    const auto addLink = [&](const SensorName& name, const std::string& prefix) -> Link* {
+        const size_t prefixPosition = name.rfind(prefix);
+        if (prefixPosition == std::string::npos) {
+            yWarning() << LogPrefix << "Skipping the sensor" << name
+                       << ", the name does not contain" << prefix;
+            return nullptr;
+        }
+
+        const std::string link = name.substr(prefixPosition + prefix.size());
+        const SensorName kinematicsName =
+            name.substr(0, prefixPosition) + IVirtualLinkKinSensor::getPrefix() + link;
+        if (linksByName.find(kinematicsName) != linksByName.end()) {
+            return nullptr;
+        }
+        if (linkKinSensors.find(kinematicsName) != linkKinSensors.end()) {
+            yInfo() << LogPrefix << "The attached device already provides" << kinematicsName;
+            return nullptr;
+        }
+
+        Link& entry = linksByName[kinematicsName];
+        entry.kinematics = std::make_shared<sensor::impl::VirtualLinkKinSensor>(
+            kinematicsName, SensorStatus::WaitingForFirstRead);
+        return &entry;
+    };
+
+    for (const auto& pose : source->getPoseSensors()) {
+        if (pose) {
+            Link* link = addLink(pose->getSensorName(), IPoseSensor::getPrefix());
+            if (link) {
+                link->pose = pose;
+            }
+        }
+    }
+
+    for (const auto& orientation : source->getOrientationSensors()) {
+        if (orientation) {
+            Link* link = addLink(orientation->getSensorName(), IOrientationSensor::getPrefix());
+            if (link) {
+                link->orientation = orientation;
+            }
+        }
+    }
+
+    size_t nPoses = 0;
+    for (auto& entry : linksByName) {
+        nPoses += entry.second.pose ? 1 : 0;
+        estimatedSensors.push_back(entry.second.kinematics);
+        estimatedByName.emplace(entry.first, entry.second.kinematics);
+        links.push_back(std::move(entry.second));
+    }
+
+    linkStatuses.resize(links.size(), SensorStatus::Ok);
+    input.assign(LinkChannels * links.size(), 0.0);
+
+    std::string error;
+    if (!differentiator.configure(options.differentiator, input.size(), error)) {
+        yError() << LogPrefix << error;
+        return false;
+    }
+
+    yInfo() << LogPrefix << "*** Estimated links    :" << links.size();
+    yInfo() << LogPrefix << "***   from poses        :" << nPoses;
+    yInfo() << LogPrefix << "***   from orientations :" << links.size() - nPoses;
+
+    linksCreated = true;
+    return true;
+}
+
+bool IWearLinkKinEstimator::Impl::readLink(const size_t l,
+                                           Quaternion& orientation,
+                                           Vector3& position) const
+{
+    const Link& link = links[l];
+    if (link.pose) {
+        return link.pose->getPose(orientation, position);
+    }
+    position = {0, 0, 0};
+    return link.orientation->getOrientationAsQuaternion(orientation);
+}
+
+void IWearLinkKinEstimator::Impl::update(const double time, const bool restart)
+{
+    WEARABLES_TRACE_SCOPE("IWearLinkKinEstimator::update");
+
+    const size_t nLinks = links.size();
+
+    // The input of a link that is not Ok holds its last value
+    for (size_t l = 0; l < nLinks; ++l) {
+        const ISensor* sensor = links[l].pose ? static_cast<const ISensor*>(links[l].pose.get())
+                                              : links[l].orientation.get();
+        SensorStatus& status = linkStatuses[l];
+        status = sensor->getSensorStatus();
+
+        Quaternion orientation;
+        Vector3 position;
+        if (status == SensorStatus::Ok && !readLink(l, orientation, position)) {
+            status = SensorStatus::Error;
+        }
+        if (status != SensorStatus::Ok) {
+            continue;
+        }
+
+        // q and -q are the same orientation, the sign closer to the last sample keeps the
+        // quaternion continuous
+        double dot = 0;
+        for (size_t c = 0; c < 4; ++c) {
+            dot += orientation[c] * input[(PositionChannels + c) * nLinks + l];
+        }
+        const double sign = dot < 0 ? -1.0 : 1.0;
+
+        for (size_t c = 0; c < PositionChannels; ++c) {
+            input[c * nLinks + l] = position[c];
+        }
+        for (size_t c = 0; c < 4; ++c) {
+            input[(PositionChannels + c) * nLinks + l] = sign * orientation[c];
+        }
+    }
+
+    if (restart) {
+        differentiator.reset();
+    }
+
+    bool ready = false;
+    {
+        WEARABLES_TRACE_SCOPE("IWearLinkKinEstimator::differentiator");
+        ready = differentiator.update(time, input.data());
+    }
+
+    const double* first = differentiator.getFirstDerivative();
+    const double* second = differentiator.getSecondDerivative();
+
+    for (size_t l = 0; l < nLinks; ++l) {
+        Vector3 position;
+        Quaternion orientation;
+        Vector3 linearVelocity;
+        Vector3 linearAcceleration;
+        double orientationFirst[4];
+        double orientationSecond[4];
+
+        for (size_t c = 0; c < PositionChannels; ++c) {
+            position[c] = input[c * nLinks + l];
+            linearVelocity[c] = first[c * nLinks + l];
+            linearAcceleration[c] = second[c * nLinks + l];
+        }
+        for (size_t c = 0; c < 4; ++c) {
+            orientation[c] = input[(PositionChannels + c) * nLinks + l];
+            orientationFirst[c] = first[(PositionChannels + c) * nLinks + l];
+            orientationSecond[c] = second[(PositionChannels + c) * nLinks + l];
+        }
+
+        links[l].kinematics->setBuffer(linearAcceleration,
+                                       angularRate(orientation, orientationSecond),
+                                       linearVelocity,
+                                       angularRate(orientation, orientationFirst),
+                                       position,
+                                       orientation);
+        links[l].kinematics->setStatus(ready ? linkStatuses[l] : SensorStatus::WaitingForFirstRead);
+    }
+}
+
+// =====================
+// IWearLinkKinEstimator
+// =====================
+
+IWearLinkKinEstimator::IWearLinkKinEstimator()
+    : PeriodicThread(DefaultPeriod)
+    , pImpl{std::make_unique<Impl>()}
+{}
+
+// Without this destructor here, the linker complains for
+// undefined reference to vtable
+IWearLinkKinEstimator::~IWearLinkKinEstimator() = default;
+
+bool IWearLinkKinEstimator::open(yarp::os::Searchable& config)
+{
+    // ===============
+    // READ PARAMETERS
+    // ===============
+
+    auto& options = pImpl->options;
+    options.period = config.check("period", yarp::os::Value(DefaultPeriod)).asFloat64();
+
+    if (options.period <= 0) {
+        yError() << LogPrefix << "Parameter 'period' must be positive";
+        return false;
+    }
+
+    auto& settings = options.differentiator;
+    const std::string method =
+        config.check("method", yarp::os::Value("savitzkyGolay")).asString();
+    if (method == "savitzkyGolay") {
+        settings.method = Differentiator::Method::SavitzkyGolay;
+    }
+    else if (method == "filteredDifference") {
+        settings.method = Differentiator::Method::FilteredDifference;
+    }
+    else {
+        yError() << LogPrefix << "Parameter 'method' must be savitzkyGolay or filteredDifference";
+        return false;
+    }
+
+    const int window =
+        config.check("window", yarp::os::Value(static_cast<int>(settings.window))).asInt32();
+    const int polynomialOrder =
+        config
+            .check("polynomialOrder", yarp::os::Value(static_cast<int>(settings.polynomialOrder)))
+            .asInt32();
+    if (window <= 0 || polynomialOrder <= 0) {
+        yError() << LogPrefix << "Parameters 'window' and 'polynomialOrder' must be positive";
+        return false;
+    }
+    settings.window = static_cast<size_t>(window);
+    settings.polynomialOrder = static_cast<size_t>(polynomialOrder);
+    settings.cutoffFrequency =
+        config.check("cutoffFrequency", yarp::os::Value(settings.cutoffFrequency)).asFloat64();
+
+    // The settings are checked here, the number of channels is known only after the attach
+    std::string error;
+    Differentiator check;
+    if (!check.configure(settings, 0, error)) {
+        yError() << LogPrefix << error;
+        return false;
+    }
+
+    // Without this parameter, the name is the one of the attached device
+    if (config.check("wearableName")) {
+        options.wearableName = config.find("wearableName").asString();
+    }
+
+    if (!realtime::parseThreadSettings(config, pImpl->threadSettings, error)) {
+        yError() << LogPrefix << error;
+        return false;
+    }
+    pImpl->jitter.setReportPeriod(pImpl->threadSettings.jitterReportPeriod);
+
+    // Metrics optional configuration
+    if (config.check("metricsPortName")) {
+        const std::string metricsPortName = config.find("metricsPortName").asString();
+        pImpl->metrics.reset(new metrics::Metrics(DeviceName + " " + metricsPortName));
+        pImpl->metrics->setPeriod(options.period);
+
+        if (!pImpl->metricsServer.open(metricsPortName, pImpl->metrics.get())) {
+            yError() << LogPrefix << "Failed to open the metrics port" << metricsPortName;
+            return false;
+        }
+    }
+
+    yInfo() << LogPrefix << "*** ====================";
+    yInfo() << LogPrefix << "*** Period             :" << options.period;
+    yInfo() << LogPrefix << "*** Method             :" << method;
+    if (settings.method == Differentiator::Method::SavitzkyGolay) {
+        yInfo() << LogPrefix << "*** Window             :" << settings.window;
+        yInfo() << LogPrefix << "*** Polynomial order   :" << settings.polynomialOrder;
+    }
+    else {
+        yInfo() << LogPrefix << "*** Cutoff frequency   :" << settings.cutoffFrequency;
+    }
+    yInfo() << LogPrefix << "*** ====================";
+
+    setPeriod(options.period);
+    return true;
+}
+
+bool IWearLinkKinEstimator::close()
+{
+    detach();
+    pImpl->metricsServer.close();
+    return true;
+}
+
+// ========================
+// PeriodicThread interface
+// ========================
+
+bool IWearLinkKinEstimator::threadInit()
+{
+    std::string error;
+    if (!realtime::applyThreadSettings(pImpl->threadSettings, error)) {
+        yWarning() << LogPrefix << "Failed to apply the thread settings:" << error;
+    }
+    yInfo() << LogPrefix << "Loop thread settings:" << realtime::toString(pImpl->threadSettings);
+
+    pImpl->jitter.setPeriod(getPeriod());
+    return true;
+}
+
+void IWearLinkKinEstimator::run()
+{
+    WEARABLES_TRACE_SCOPE("IWearLinkKinEstimator::run");
+    const realtime::ScopedTick jitterTick(pImpl->jitter);
+    const double tickStartTime = yarp::os::Time::now();
+
+    if (pImpl->jitter.reportDue()) {
+        yInfo() << LogPrefix << "Loop timing:" << pImpl->jitter.summary();
+    }
+
+    const WearStatus sourceStatus = pImpl->source->getStatus();
+
+    // Until the attached device provides data, its status is exposed as it is
+    if (!pImpl->source.isProvidingData(sourceStatus, LogPrefix)) {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->status = sourceStatus;
+        return;
+    }
+
+    // The sensors are known once the attached device provided the first data
+    if (!pImpl->linksCreated) {
+        if (!pImpl->createLinks()) {
+            std::lock_guard<std::mutex> lock(pImpl->mutex);
+            pImpl->status = WearStatus::Error;
+            return;
+        }
+        if (pImpl->links.empty()) {
+            yWarning() << LogPrefix << "The attached device has no pose or orientation sensor";
+        }
+    }
+
+    // The estimates are updated at the rate of the attached device
+    TimeStamp sourceTimestamp;
+    double dt = 0;
+    if (!pImpl->source.nextSample(sourceTimestamp, dt)) {
+        return;
+    }
+
+    pImpl->update(sourceTimestamp.time,
+                  pImpl->source.getSamples() > 1 && (dt <= 0 || dt > MaxTimeStep));
+
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->updates++;
+    pImpl->status = sourceStatus;
+    pImpl->timestamp.time = sourceTimestamp.time;
+    pImpl->timestamp.sequenceNumber++;
+    pImpl->stamp = pImpl->source.getStamp(pImpl->timestamp);
+
+    if (pImpl->metrics) {
+        pImpl->metrics->addFramesIn();
+        pImpl->metrics->addTick(yarp::os::Time::now() - tickStartTime);
+    }
+}
+
+void IWearLinkKinEstimator::threadRelease()
+{
+    yInfo() << LogPrefix << "Loop timing:" << pImpl->jitter.summary();
+}
+
+// ==================
+// IWrapper interface
+// ==================
+
+bool IWearLinkKinEstimator::attach(yarp::dev::PolyDriver* poly)
+{
+    if (!pImpl->source.attach(poly, LogPrefix)) {
+        return false;
+    }
+
+    if (pImpl->options.wearableName.empty()) {
+        pImpl->options.wearableName = pImpl->source.getWearableName();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->links.clear();
+        pImpl->linkStatuses.clear();
+        pImpl->input.clear();
+        pImpl->estimatedSensors.clear();
+        pImpl->estimatedByName.clear();
+        pImpl->linksCreated = false;
+        pImpl->updates = 0;
+        pImpl->status = WearStatus::WaitingForFirstRead;
+    }
+
+    if (!start()) {
+        yError() << LogPrefix << "Failed to start the loop.";
+        pImpl->source.detach();
+        return false;
+    }
+
+    yDebug() << LogPrefix << "attach() successful";
+    return true;
+}
+
+bool IWearLinkKinEstimator::detach()
+{
+    while (isRunning()) {
+        stop();
+    }
+
+    pImpl->source.detach();
+
+    return true;
+}
+
+// ==========================
+// IMultipleWrapper interface
+// ==========================
+
+bool IWearLinkKinEstimator::attachAll(const yarp::dev::PolyDriverList& driverList)
+{
+    if (driverList.size() > 1) {
+        yError() << LogPrefix << "This device accepts only one attached PolyDriver.";
+        return false;
+    }
+
+    const yarp::dev::PolyDriverDescriptor* driver = driverList[0];
+
+    if (!driver) {
+        yError() << LogPrefix << "Passed PolyDriverDescriptor is nullptr.";
+        return false;
+    }
+
+    return attach(driver->poly);
+}
+
+bool IWearLinkKinEstimator::detachAll()
+{
+    return detach();
+}
+
+// ===============
+// IPreciselyTimed
+// ===============
+
+yarp::os::Stamp IWearLinkKinEstimator::getLastInputStamp()
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->stamp;
+}
+
+// =====
+// IWEAR
+// =====
+
+WearableName IWearLinkKinEstimator::getWearableName() const
+{
+    return pImpl->options.wearableName + wearable::Separator;
+}
+
+WearStatus IWearLinkKinEstimator::getStatus() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    // The status of the attached device is exposed only after the first update of the estimates
+    if (pImpl->updates == 0 && pImpl->status == WearStatus::Ok) {
+        return WearStatus::WaitingForFirstRead;
+    }
+    return pImpl->status;
+}
+
+TimeStamp IWearLinkKinEstimator::getTimeStamp() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->timestamp;
+}
+
+// The estimated link kinematics are added to the sensors of the attached device, that are forwarded
+
+SensorPtr<const ISensor> IWearLinkKinEstimator::getSensor(const SensorName name) const
+{
+    const auto estimated = pImpl->getEstimatedSensor(name);
+    if (estimated) {
+        return estimated;
+    }
+    return pImpl->source ? pImpl->source->getSensor(name) : nullptr;
+}
+
+VectorOfSensorPtr<const ISensor> IWearLinkKinEstimator::getSensors(const SensorType type) const
+{
+    VectorOfSensorPtr<const ISensor> sensors;
+    if (pImpl->source) {
+        sensors = pImpl->source->getSensors(type);
+    }
+
+    if (type == SensorType::VirtualLinkKinSensor) {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        sensors.insert(
+            sensors.end(), pImpl->estimatedSensors.begin(), pImpl->estimatedSensors.end());
+    }
+    return sensors;
+}
+
+SensorPtr<const IAccelerometer>
+IWearLinkKinEstimator::getAccelerometer(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getAccelerometer(name) : nullptr;
+}
+
+SensorPtr<const IEmgSensor> IWearLinkKinEstimator::getEmgSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getEmgSensor(name) : nullptr;
+}
+
+SensorPtr<const IForce3DSensor>
+IWearLinkKinEstimator::getForce3DSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getForce3DSensor(name) : nullptr;
+}
+
+SensorPtr<const IForceTorque6DSensor>
+IWearLinkKinEstimator::getForceTorque6DSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getForceTorque6DSensor(name) : nullptr;
+}
+
+SensorPtr<const IFreeBodyAccelerationSensor>
+IWearLinkKinEstimator::getFreeBodyAccelerationSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getFreeBodyAccelerationSensor(name) : nullptr;
+}
+
+SensorPtr<const IGyroscope> IWearLinkKinEstimator::getGyroscope(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getGyroscope(name) : nullptr;
+}
+
+SensorPtr<const IMagnetometer>
+IWearLinkKinEstimator::getMagnetometer(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getMagnetometer(name) : nullptr;
+}
+
+SensorPtr<const IOrientationSensor>
+IWearLinkKinEstimator::getOrientationSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getOrientationSensor(name) : nullptr;
+}
+
+SensorPtr<const IPoseSensor> IWearLinkKinEstimator::getPoseSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getPoseSensor(name) : nullptr;
+}
+
+SensorPtr<const IPositionSensor>
+IWearLinkKinEstimator::getPositionSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getPositionSensor(name) : nullptr;
+}
+
+SensorPtr<const ISkinSensor> IWearLinkKinEstimator::getSkinSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getSkinSensor(name) : nullptr;
+}
+
+SensorPtr<const ITemperatureSensor>
+IWearLinkKinEstimator::getTemperatureSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getTemperatureSensor(name) : nullptr;
+}
+
+SensorPtr<const ITorque3DSensor>
+IWearLinkKinEstimator::getTorque3DSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getTorque3DSensor(name) : nullptr;
+}
+
+SensorPtr<const IVirtualLinkKinSensor>
+IWearLinkKinEstimator::getVirtualLinkKinSensor(const SensorName name) const
+{
+    const auto estimated = pImpl->getEstimatedSensor(name);
+    if (estimated) {
+        return estimated;
+    }
+    return pImpl->source ? pImpl->source->getVirtualLinkKinSensor(name) : nullptr;
+}
+
+SensorPtr<const IVirtualJointKinSensor>
+IWearLinkKinEstimator::getVirtualJointKinSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getVirtualJointKinSensor(name) : nullptr;
+}
+
+SensorPtr<const IVirtualSphericalJointKinSensor>
+IWearLinkKinEstimator::getVirtualSphericalJointKinSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getVirtualSphericalJointKinSensor(name) : nullptr;
+}
+
+// =========
+// ACTUATORS
+// =========
+
+ElementPtr<const actuator::IActuator>
+IWearLinkKinEstimator::getActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getActuator(name) : nullptr;
+}
+
+VectorOfElementPtr<const actuator::IActuator>
+IWearLinkKinEstimator::getActuators(const actuator::ActuatorType type) const
+{
+    if (!pImpl->source) {
+        return {};
+    }
+    return pImpl->source->getActuators(type);
+}
+
+ElementPtr<const actuator::IHaptic>
+IWearLinkKinEstimator::getHapticActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getHapticActuator(name) : nullptr;
+}
+
+ElementPtr<const actuator::IMotor>
+IWearLinkKinEstimator::getMotorActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getMotorActuator(name) : nullptr;
+}
+
+ElementPtr<const actuator::IHeater>
+IWearLinkKinEstimator::getHeaterActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getHeaterActuator(name) : nullptr;
+}
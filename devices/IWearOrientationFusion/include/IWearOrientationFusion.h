@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_IWEARORIENTATIONFUSION_H
+#define WEARABLE_IWEARORIENTATIONFUSION_H
+
+#include "Wearable/IWear/IWear.h"
+
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IMultipleWrapper.h>
+#include <yarp/dev/IPreciselyTimed.h>
+#include <yarp/dev/IWrapper.h>
+#include <yarp/os/PeriodicThread.h>
+
+#include <memory>
+
+namespace wearable {
+    namespace devices {
+        class IWearOrientationFusion;
+    } // namespace devices
+} // namespace wearable
+
+// Device estimating the orientation of the IMUs of a wearable. It attaches to an IWear, groups
+// the accelerometers, gyroscopes and (optionally) magnetometers with the same name after their
+// prefix, fuses each group with a Madgwick filter, all the groups together, and exposes the
+// results as orientation sensors together with the sensors of the attached device.
+class wearable::devices::IWearOrientationFusion
+    : public yarp::dev::DeviceDriver
+    , public yarp::os::PeriodicThread
+    , public yarp::dev::IPreciselyTimed
+    , public yarp::dev::IWrapper
+    , public yarp::dev::IMultipleWrapper
+    , public wearable::IWear
+{
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+
+public:
+    IWearOrientationFusion();
+    ~IWearOrientationFusion() override;
+
+    IWearOrientationFusion(const IWearOrientationFusion& other) = delete;
+    IWearOrientationFusion(IWearOrientationFusion&& other) = delete;
+    IWearOrientationFusion& operator=(const IWearOrientationFusion& other) = delete;
+    IWearOrientationFusion& operator=(IWearOrientationFusion&& other) = delete;
+
+    // DeviceDriver
+    bool open(yarp::os::Searchable& config) override;
+    bool close() override;
+
+    // PeriodicThread
+    bool threadInit() override;
+    void run() override;
+    void threadRelease() override;
+
+    // IPreciselyTimed
+    yarp::os::Stamp getLastInputStamp() override;
+
+    // IWrapper interface
+    bool attach(yarp::dev::PolyDriver* poly) override;
+    bool detach() override;
+
+    // IMultipleWrapper interface
+    bool attachAll(const yarp::dev::PolyDriverList& driverList) override;
+    bool detachAll() override;
+
+    // =====
+    // IWEAR
+    // =====
+
+    // -------
+    // GENERIC
+    // -------
+
+    WearableName getWearableName() const override;
+    WearStatus getStatus() const override;
+    TimeStamp getTimeStamp() const override;
+
+    SensorPtr<const sensor::ISensor> getSensor(const sensor::SensorName name) const override;
+
+    VectorOfSensorPtr<const sensor::ISensor>
+    getSensors(const sensor::SensorType type) const override;
+
+    // --------------
+    // SINGLE SENSORS
+    // --------------
+
+    SensorPtr<const sensor::IAccelerometer>
+    getAccelerometer(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IEmgSensor> getEmgSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IForce3DSensor>
+    getForce3DSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IForceTorque6DSensor>
+    getForceTorque6DSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IFreeBodyAccelerationSensor>
+    getFreeBodyAccelerationSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IGyroscope> getGyroscope(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IMagnetometer>
+    getMagnetometer(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IOrientationSensor>
+    getOrientationSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IPoseSensor>
+    getPoseSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IPositionSensor>
+    getPositionSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::ISkinSensor>
+    getSkinSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::ITemperatureSensor>
+    getTemperatureSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::ITorque3DSensor>
+    getTorque3DSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IVirtualLinkKinSensor>
+    getVirtualLinkKinSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IVirtualJointKinSensor>
+    getVirtualJointKinSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IVirtualSphericalJointKinSensor>
+    getVirtualSphericalJointKinSensor(const sensor::SensorName name) const override;
+
+    // ---------
+    // ACTUATORS
+    // ---------
+
+    // The actuators are the ones of the attached device
+
+    ElementPtr<const actuator::IActuator>
+    getActuator(const actuator::ActuatorName name) const override;
+
+    VectorOfElementPtr<const actuator::IActuator>
+    getActuators(const actuator::ActuatorType type) const override;
+
+    ElementPtr<const actuator::IHaptic>
+    getHapticActuator(const actuator::ActuatorName name) const override;
+
+    ElementPtr<const actuator::IMotor>
+    getMotorActuator(const actuator::ActuatorName name) const override;
+
+    ElementPtr<const actuator::IHeater>
+    getHeaterActuator(const actuator::ActuatorName name) const override;
+};
+
+#endif // WEARABLE_IWEARORIENTATIONFUSION_H
@@ -0,0 +1,651 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "IWearOrientationFusion.h"
+#include "Wearable/Fusion/OrientationFusion.h"
+#include "Wearable/IWear/Sensors/impl/SensorsImpl.h"
+#include "Wearable/IWear/impl/AttachedSource.h"
+#include "Wearable/Metrics/Metrics.h"
+#include "Wearable/RealTime/RealTime.h"
+#include "Wearable/Tracing/Tracing.h"
+
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+const std::string DeviceName = "IWearOrientationFusion";
+const std::string LogPrefix = DeviceName + " :";
+constexpr double DefaultPeriod = 0.01;
+constexpr double DefaultGain = 0.1;
+// Longer intervals between two samples (e.g. after a pause of the attached device) are
+// integrated as one period
+constexpr double MaxTimeStep = 0.5;
+
+using namespace wearable;
+using namespace wearable::sensor;
+using namespace wearable::devices;
+
+class IWearOrientationFusion::Impl
+{
+public:
+    struct
+    {
+        WearableName wearableName;
+        double period = DefaultPeriod;
+        double gain = DefaultGain;
+        bool useMagnetometer = true;
+    } options;
+
+    wearable::impl::AttachedSource source;
+
+    // The inputs of an IMU, and the filter estimating its orientation
+    struct Imu
+    {
+        SensorPtr<const IAccelerometer> accelerometer;
+        SensorPtr<const IGyroscope> gyroscope;
+        SensorPtr<const IMagnetometer> magnetometer;
+        std::shared_ptr<sensor::impl::OrientationSensor> orientation;
+        fusion::OrientationFilterBank* filters;
+        size_t index;
+    };
+    std::vector<Imu> imus;
+    std::vector<SensorStatus> imuStatuses;
+    bool imusCreated = false;
+
+    // The IMUs with and without magnetometer are fused by two banks of filters
+    fusion::OrientationFilterBank filtersWithMagnetometer{true};
+    fusion::OrientationFilterBank filtersWithoutMagnetometer{false};
+
+    size_t updates = 0;
+
+    mutable std::mutex mutex;
+    WearStatus status = WearStatus::WaitingForFirstRead;
+    TimeStamp timestamp;
+    yarp::os::Stamp stamp;
+
+    VectorOfSensorPtr<const ISensor> fusedSensors;
+    std::map<SensorName, SensorPtr<const IOrientationSensor>> fusedByName;
+
+    // Runtime metrics, enabled by the metricsPortName option
+    std::unique_ptr<metrics::Metrics> metrics;
+    metrics::MetricsServer metricsServer;
+
+    realtime::ThreadSettings threadSettings;
+    realtime::JitterStatistics jitter;
+
+    SensorPtr<const IOrientationSensor> getFusedSensor(const SensorName& name) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto it = fusedByName.find(name);
+        return it == fusedByName.end() ? nullptr : it->second;
+    }
+
+    void createImus();
+    void update(const double dt);
+};
+
+template <typename SensorInterface>
+static std::map<SensorName, SensorPtr<const SensorInterface>>
+mapByName(const VectorOfSensorPtr<const SensorInterface>& sensors)
+{
+    std::map<SensorName, SensorPtr<const SensorInterface>> map;
+    for (const auto& sensor : sensors) {
+        if (sensor) {
+            map.emplace(sensor->getSensorName(), sensor);
+        }
+    }
+    return map;
+}
+
+// The IMUs are found from the gyroscopes. The accelerometer, the magnetometer and the estimated
+// orientation of the gyroscope <wearable>::gyro::<imu> are <wearable>::acc::<imu>,
+// <wearable>::mag::<imu> and <wearable>::orient::<imu>.
+void IWearOrientationFusion::Impl::createImus()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto accelerometers = mapByName(source->getAccelerometers());
+    const auto magnetometers = mapByName(source->getMagnetometers());
+    const auto orientationSensors = mapByName(source->getOrientationSensors());
+
+    size_t nWithMagnetometer = 0;
+    size_t nWithoutMagnetometer = 0;
+
+    for (const auto& gyroscope : source->getGyroscopes()) {
+        if (!gyroscope) {
+            continue;
+        }
+
+        const SensorName& gyroscopeName = gyroscope->getSensorName();
+        const size_t prefixPosition = gyroscopeName.rfind(IGyroscope::getPrefix());
+        if (prefixPosition == std::string::npos) {
+            yWarning() << LogPrefix << "Skipping the gyroscope" << gyroscopeName
+                       << ", the name does not contain" << IGyroscope::getPrefix();
+            continue;
+        }
+
+        const std::string wearable = gyroscopeName.substr(0, prefixPosition);
+        const std::string imu =
+            gyroscopeName.substr(prefixPosition + IGyroscope::getPrefix().size());
+
+        const auto accelerometer =
+            accelerometers.find(wearable + IAccelerometer::getPrefix() + imu);
+        if (accelerometer == accelerometers.end()) {
+            yWarning() << LogPrefix << "Skipping the gyroscope" << gyroscopeName
+                       << ", no accelerometer with the same name";
+            continue;
+        }
+
+        const SensorName orientationName = wearable + IOrientationSensor::getPrefix() + imu;
+        if (orientationSensors.find(orientationName) != orientationSensors.end()) {
+            yInfo() << LogPrefix << "The attached device already provides" << orientationName;
+            continue;
+        }
+
+        Imu entry;
+        entry.accelerometer = accelerometer->second;
+        entry.gyroscope = gyroscope;
+        entry.orientation = std::make_shared<sensor::impl::OrientationSensor>(
+            orientationName, SensorStatus::WaitingForFirstRead);
+
+        const auto magnetometer = magnetometers.find(wearable + IMagnetometer::getPrefix() + imu);
+        if (options.useMagnetometer && magnetometer != magnetometers.end()) {
+            entry.magnetometer = magnetometer->second;
+            entry.filters = &filtersWithMagnetometer;
+            entry.index = nWithMagnetometer++;
+        }
+        else {
+            entry.filters = &filtersWithoutMagnetometer;
+            entry.index = nWithoutMagnetometer++;
+        }
+
+        fusedSensors.push_back(entry.orientation);
+        fusedByName.emplace(orientationName, entry.orientation);
+        imus.push_back(std::move(entry));
+    }
+
+    imuStatuses.resize(imus.size(), SensorStatus::Ok);
+    filtersWithMagnetometer.resize(nWithMagnetometer);
+    filtersWithoutMagnetometer.resize(nWithoutMagnetometer);
+    filtersWithMagnetometer.setGain(options.gain);
+    filtersWithoutMagnetometer.setGain(options.gain);
+
+    yInfo() << LogPrefix << "*** Fused IMUs         :" << imus.size();
+    yInfo() << LogPrefix << "***   with magnetometer :" << nWithMagnetometer;
+    yInfo() << LogPrefix << "***   without           :" << nWithoutMagnetometer;
+
+    imusCreated = true;
+}
+
+void IWearOrientationFusion::Impl::update(const double dt)
+{
+    WEARABLES_TRACE_SCOPE("IWearOrientationFusion::update");
+
+    // The inputs of an IMU that is not Ok are zeroed, holding its orientation
+    for (size_t i = 0; i < imus.size(); ++i) {
+        const Imu& imu = imus[i];
+        Vector3 acc{0, 0, 0};
+        Vector3 gyro{0, 0, 0};
+        Vector3 mag{0, 0, 0};
+
+        SensorStatus& status = imuStatuses[i];
+        status = SensorStatus::Ok;
+        for (const ISensor* input : {static_cast<const ISensor*>(imu.accelerometer.get()),
+                                     static_cast<const ISensor*>(imu.gyroscope.get()),
+                                     static_cast<const ISensor*>(imu.magnetometer.get())}) {
+            if (input && input->getSensorStatus() != SensorStatus::Ok) {
+                status = input->getSensorStatus();
+            }
+        }
+
+        if (status == SensorStatus::Ok
+            && !(imu.accelerometer->getLinearAcceleration(acc)
+                 && imu.gyroscope->getAngularRate(gyro)
+                 && (!imu.magnetometer || imu.magnetometer->getMagneticField(mag)))) {
+            status = SensorStatus::Error;
+        }
+
+        if (status != SensorStatus::Ok) {
+            acc = {0, 0, 0};
+            gyro = {0, 0, 0};
+            mag = {0, 0, 0};
+        }
+
+        imu.filters->setInput(imu.index, acc.data(), gyro.data(), mag.data());
+    }
+
+    {
+        WEARABLES_TRACE_SCOPE("IWearOrientationFusion::filters");
+        filtersWithMagnetometer.update(dt);
+        filtersWithoutMagnetometer.update(dt);
+    }
+
+    for (size_t i = 0; i < imus.size(); ++i) {
+        const Imu& imu = imus[i];
+        Quaternion orientation;
+        imu.filters->getOrientation(imu.index, orientation.data());
+        imu.orientation->setBuffer(orientation);
+        imu.orientation->setStatus(imuStatuses[i]);
+    }
+}
+
+// ======================
+// IWearOrientationFusion
+// ======================
+
+IWearOrientationFusion::IWearOrientationFusion()
+    : PeriodicThread(DefaultPeriod)
+    , pImpl{std::make_unique<Impl>()}
+{}
+
+// Without this destructor here, the linker complains for
+// undefined reference to vtable
+IWearOrientationFusion::~IWearOrientationFusion() = default;
+
+bool IWearOrientationFusion::open(yarp::os::Searchable& config)
+{
+    // ===============
+    // READ PARAMETERS
+    // ===============
+
+    auto& options = pImpl->options;
+    options.period = config.check("period", yarp::os::Value(DefaultPeriod)).asFloat64();
+    options.gain = config.check("gain", yarp::os::Value(DefaultGain)).asFloat64();
+    options.useMagnetometer = config.check("useMagnetometer", yarp::os::Value(true)).asBool();
+
+    if (options.period <= 0) {
+        yError() << LogPrefix << "Parameter 'period' must be positive";
+        return false;
+    }
+
+    if (options.gain < 0) {
+        yError() << LogPrefix << "Parameter 'gain' must not be negative";
+        return false;
+    }
+
+    // Without this parameter, the name is the one of the attached device
+    if (config.check("wearableName")) {
+        options.wearableName = config.find("wearableName").asString();
+    }
+
+    std::string error;
+    if (!realtime::parseThreadSettings(config, pImpl->threadSettings, error)) {
+        yError() << LogPrefix << error;
+        return false;
+    }
+    pImpl->jitter.setReportPeriod(pImpl->threadSettings.jitterReportPeriod);
+
+    // Metrics optional configuration
+    if (config.check("metricsPortName")) {
+        const std::string metricsPortName = config.find("metricsPortName").asString();
+        pImpl->metrics.reset(new metrics::Metrics(DeviceName + " " + metricsPortName));
+        pImpl->metrics->setPeriod(options.period);
+
+        if (!pImpl->metricsServer.open(metricsPortName, pImpl->metrics.get())) {
+            yError() << LogPrefix << "Failed to open the metrics port" << metricsPortName;
+            return false;
+        }
+    }
+
+    yInfo() << LogPrefix << "*** ====================";
+    yInfo() << LogPrefix << "*** Period             :" << options.period;
+    yInfo() << LogPrefix << "*** Gain               :" << options.gain;
+    yInfo() << LogPrefix << "*** Use magnetometer   :" << options.useMagnetometer;
+    yInfo() << LogPrefix << "*** ====================";
+
+    setPeriod(options.period);
+    return true;
+}
+
+bool IWearOrientationFusion::close()
+{
+    detach();
+    pImpl->metricsServer.close();
+    return true;
+}
+
+// ========================
+// PeriodicThread interface
+// ========================
+
+bool IWearOrientationFusion::threadInit()
+{
+    std::string error;
+    if (!realtime::applyThreadSettings(pImpl->threadSettings, error)) {
+        yWarning() << LogPrefix << "Failed to apply the thread settings:" << error;
+    }
+    yInfo() << LogPrefix << "Loop thread settings:" << realtime::toString(pImpl->threadSettings);
+
+    pImpl->jitter.setPeriod(getPeriod());
+    return true;
+}
+
+void IWearOrientationFusion::run()
+{
+    WEARABLES_TRACE_SCOPE("IWearOrientationFusion::run");
+    const realtime::ScopedTick jitterTick(pImpl->jitter);
+    const double tickStartTime = yarp::os::Time::now();
+
+    if (pImpl->jitter.reportDue()) {
+        yInfo() << LogPrefix << "Loop timing:" << pImpl->jitter.summary();
+    }
+
+    const WearStatus sourceStatus = pImpl->source->getStatus();
+
+    // Until the attached device provides data, its status is exposed as it is
+    if (!pImpl->source.isProvidingData(sourceStatus, LogPrefix)) {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->status = sourceStatus;
+        return;
+    }
+
+    // The sensors are known once the attached device provided the first data
+    if (!pImpl->imusCreated) {
+        pImpl->createImus();
+        if (pImpl->imus.empty()) {
+            yWarning() << LogPrefix << "The attached device has no IMU to fuse";
+        }
+    }
+
+    // The filters are updated at the rate of the attached device
+    TimeStamp sourceTimestamp;
+    double dt = 0;
+    if (!pImpl->source.nextSample(sourceTimestamp, dt)) {
+        return;
+    }
+
+    if (pImpl->source.getSamples() == 1 || dt <= 0 || dt > MaxTimeStep) {
+        dt = pImpl->options.period;
+    }
+
+    pImpl->update(dt);
+
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->updates++;
+    pImpl->status = sourceStatus;
+    pImpl->timestamp.time = sourceTimestamp.time;
+    pImpl->timestamp.sequenceNumber++;
+    pImpl->stamp = pImpl->source.getStamp(pImpl->timestamp);
+
+    if (pImpl->metrics) {
+        pImpl->metrics->addFramesIn();
+        pImpl->metrics->addTick(yarp::os::Time::now() - tickStartTime);
+    }
+}
+
+void IWearOrientationFusion::threadRelease()
+{
+    yInfo() << LogPrefix << "Loop timing:" << pImpl->jitter.summary();
+}
+
+// ==================
+// IWrapper interface
+// ==================
+
+bool IWearOrientationFusion::attach(yarp::dev::PolyDriver* poly)
+{
+    if (!pImpl->source.attach(poly, LogPrefix)) {
+        return false;
+    }
+
+    if (pImpl->options.wearableName.empty()) {
+        pImpl->options.wearableName = pImpl->source.getWearableName();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        pImpl->imus.clear();
+        pImpl->imuStatuses.clear();
+        pImpl->filtersWithMagnetometer = fusion::OrientationFilterBank(true);
+        pImpl->filtersWithoutMagnetometer = fusion::OrientationFilterBank(false);
+        pImpl->fusedSensors.clear();
+        pImpl->fusedByName.clear();
+        pImpl->imusCreated = false;
+        pImpl->updates = 0;
+        pImpl->status = WearStatus::WaitingForFirstRead;
+    }
+
+    if (!start()) {
+        yError() << LogPrefix << "Failed to start the loop.";
+        pImpl->source.detach();
+        return false;
+    }
+
+    yDebug() << LogPrefix << "attach() successful";
+    return true;
+}
+
+bool IWearOrientationFusion::detach()
+{
+    while (isRunning()) {
+        stop();
+    }
+
+    pImpl->source.detach();
+
+    return true;
+}
+
+// ==========================
+// IMultipleWrapper interface
+// ==========================
+
+bool IWearOrientationFusion::attachAll(const yarp::dev::PolyDriverList& driverList)
+{
+    if (driverList.size() > 1) {
+        yError() << LogPrefix << "This device accepts only one attached PolyDriver.";
+        return false;
+    }
+
+    const yarp::dev::PolyDriverDescriptor* driver = driverList[0];
+
+    if (!driver) {
+        yError() << LogPrefix << "Passed PolyDriverDescriptor is nullptr.";
+        return false;
+    }
+
+    return attach(driver->poly);
+}
+
+bool IWearOrientationFusion::detachAll()
+{
+    return detach();
+}
+
+// ===============
+// IPreciselyTimed
+// ===============
+
+yarp::os::Stamp IWearOrientationFusion::getLastInputStamp()
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->stamp;
+}
+
+// =====
+// IWEAR
+// =====
+
+WearableName IWearOrientationFusion::getWearableName() const
+{
+    return pImpl->options.wearableName + wearable::Separator;
+}
+
+WearStatus IWearOrientationFusion::getStatus() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    // The status of the attached device is exposed only after the first update of the filters
+    if (pImpl->updates == 0 && pImpl->status == WearStatus::Ok) {
+        return WearStatus::WaitingForFirstRead;
+    }
+    return pImpl->status;
+}
+
+TimeStamp IWearOrientationFusion::getTimeStamp() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->timestamp;
+}
+
+// The estimated orientations are added to the sensors of the attached device, that are forwarded
+
+SensorPtr<const ISensor> IWearOrientationFusion::getSensor(const SensorName name) const
+{
+    const auto fused = pImpl->getFusedSensor(name);
+    if (fused) {
+        return fused;
+    }
+    return pImpl->source ? pImpl->source->getSensor(name) : nullptr;
+}
+
+VectorOfSensorPtr<const ISensor> IWearOrientationFusion::getSensors(const SensorType type) const
+{
+    VectorOfSensorPtr<const ISensor> sensors;
+    if (pImpl->source) {
+        sensors = pImpl->source->getSensors(type);
+    }
+
+    if (type == SensorType::OrientationSensor) {
+        std::lock_guard<std::mutex> lock(pImpl->mutex);
+        sensors.insert(sensors.end(), pImpl->fusedSensors.begin(), pImpl->fusedSensors.end());
+    }
+    return sensors;
+}
+
+SensorPtr<const IAccelerometer>
+IWearOrientationFusion::getAccelerometer(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getAccelerometer(name) : nullptr;
+}
+
+SensorPtr<const IEmgSensor> IWearOrientationFusion::getEmgSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getEmgSensor(name) : nullptr;
+}
+
+SensorPtr<const IForce3DSensor>
+IWearOrientationFusion::getForce3DSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getForce3DSensor(name) : nullptr;
+}
+
+SensorPtr<const IForceTorque6DSensor>
+IWearOrientationFusion::getForceTorque6DSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getForceTorque6DSensor(name) : nullptr;
+}
+
+SensorPtr<const IFreeBodyAccelerationSensor>
+IWearOrientationFusion::getFreeBodyAccelerationSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getFreeBodyAccelerationSensor(name) : nullptr;
+}
+
+SensorPtr<const IGyroscope> IWearOrientationFusion::getGyroscope(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getGyroscope(name) : nullptr;
+}
+
+SensorPtr<const IMagnetometer>
+IWearOrientationFusion::getMagnetometer(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getMagnetometer(name) : nullptr;
+}
+
+SensorPtr<const IOrientationSensor>
+IWearOrientationFusion::getOrientationSensor(const SensorName name) const
+{
+    const auto fused = pImpl->getFusedSensor(name);
+    if (fused) {
+        return fused;
+    }
+    return pImpl->source ? pImpl->source->getOrientationSensor(name) : nullptr;
+}
+
+SensorPtr<const IPoseSensor> IWearOrientationFusion::getPoseSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getPoseSensor(name) : nullptr;
+}
+
+SensorPtr<const IPositionSensor>
+IWearOrientationFusion::getPositionSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getPositionSensor(name) : nullptr;
+}
+
+SensorPtr<const ISkinSensor> IWearOrientationFusion::getSkinSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getSkinSensor(name) : nullptr;
+}
+
+SensorPtr<const ITemperatureSensor>
+IWearOrientationFusion::getTemperatureSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getTemperatureSensor(name) : nullptr;
+}
+
+SensorPtr<const ITorque3DSensor>
+IWearOrientationFusion::getTorque3DSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getTorque3DSensor(name) : nullptr;
+}
+
+SensorPtr<const IVirtualLinkKinSensor>
+IWearOrientationFusion::getVirtualLinkKinSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getVirtualLinkKinSensor(name) : nullptr;
+}
+
+SensorPtr<const IVirtualJointKinSensor>
+IWearOrientationFusion::getVirtualJointKinSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getVirtualJointKinSensor(name) : nullptr;
+}
+
+SensorPtr<const IVirtualSphericalJointKinSensor>
+IWearOrientationFusion::getVirtualSphericalJointKinSensor(const SensorName name) const
+{
+    return pImpl->source ? pImpl->source->getVirtualSphericalJointKinSensor(name) : nullptr;
+}
+
+// =========
+// ACTUATORS
+// =========
+
+ElementPtr<const actuator::IActuator>
+IWearOrientationFusion::getActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getActuator(name) : nullptr;
+}
+
+VectorOfElementPtr<const actuator::IActuator>
+IWearOrientationFusion::getActuators(const actuator::ActuatorType type) const
+{
+    if (!pImpl->source) {
+        return {};
+    }
+    return pImpl->source->getActuators(type);
+}
+
+ElementPtr<const actuator::IHaptic>
+IWearOrientationFusion::getHapticActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getHapticActuator(name) : nullptr;
+}
+
+ElementPtr<const actuator::IMotor>
+IWearOrientationFusion::getMotorActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getMotorActuator(name) : nullptr;
+}
+
+ElementPtr<const actuator::IHeater>
+IWearOrientationFusion::getHeaterActuator(const actuator::ActuatorName name) const
+{
+    return pImpl->source ? pImpl->source->getHeaterActuator(name) : nullptr;
+}
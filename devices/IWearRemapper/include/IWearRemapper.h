@@ -14,10 +14,12 @@
 #include <yarp/os/TypedReaderCallback.h>
 
 #include <memory>
+#include <string>
 
 namespace wearable {
     namespace msg {
         class WearableData;
+        class ExtendedWearableData;
     }
     namespace devices {
         class IWearRemapper;
@@ -28,6 +30,7 @@ class wearable::devices::IWearRemapper
     : public yarp::dev::DeviceDriver
     , public wearable::IWear
     , public yarp::os::TypedReaderCallback<msg::WearableData>
+    , public yarp::os::TypedReaderCallback<msg::ExtendedWearableData>
     , public yarp::os::PeriodicThread
     , public yarp::dev::IMultipleWrapper
     , public yarp::dev::IPreciselyTimed
@@ -36,6 +39,12 @@ private:
     class impl;
     std::unique_ptr<impl> pImpl;
 
+    // Processing of the frames received on the input ports, with their extensions if read from
+    // the ports of the extended wire format
+    void onFrame(msg::WearableData& wearData,
+                 msg::ExtendedWearableData* extendedData,
+                 const std::string& portName);
+
 public:
     IWearRemapper();
     ~IWearRemapper() override;
@@ -50,6 +59,8 @@ public:
 
     // TypedReaderCallback
     void onRead(msg::WearableData& wearData, const yarp::os::TypedReader<msg::WearableData>& typedReader) override;
+    void onRead(msg::ExtendedWearableData& extendedData,
+                const yarp::os::TypedReader<msg::ExtendedWearableData>& typedReader) override;
 
     // PreciselyTimed interface
     yarp::os::Stamp getLastInputStamp() override;
@@ -2,8 +2,14 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include "IWearRemapper.h"
+#include "Wearable/ClockSync/ClockSync.h"
 #include "Wearable/IWear/IWear.h"
 #include "Wearable/IWear/Sensors/impl/SensorsImpl.h"
+#include "Wearable/Metrics/Metrics.h"
+#include "Wearable/RealTime/RealTime.h"
+#include "Wearable/Tracing/Tracing.h"
+#include "Wearable/WireEncoding/WearableDataEncoding.h"
+#include "thrift/ExtendedWearableData.h"
 #include "thrift/WearableData.h"
 
 #include <yarp/dev/IPreciselyTimed.h>
@@ -14,12 +20,19 @@
 #include <yarp/os/TypedReaderCallback.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <utility>
 #include <unordered_map>
+#include <unordered_set>
 
 const std::string WrapperName = "IWearRemapper";
+const std::string DefaultMetricsPortName = "/" + WrapperName + "/metrics:rpc";
 const std::string logPrefix = WrapperName + " :";
+constexpr double DefaultSampleBlockHistory = 1.0;
 
 using namespace wearable;
 using namespace wearable::devices;
@@ -45,8 +58,40 @@ public:
     mutable std::mutex mutex;
 
     msg::WearableData wearableData;
+
+    // Runtime metrics, enabled by the metricsPortName option
+    std::unique_ptr<metrics::Metrics> metrics;
+    metrics::MetricsServer metricsServer;
+    std::mutex metricsMutex;
+    std::unordered_map<std::string, metrics::SensorCounter*> sensorCounters;
+
+    // Real-time settings of the threads of the input port callbacks, applied once per thread
+    realtime::ThreadSettings threadSettings;
+    std::mutex configuredThreadsMutex;
+    std::unordered_set<std::thread::id> configuredThreads;
+
+    template <typename SensorData>
+    void countSensors(const std::map<std::string, SensorData>& sensors, const double time);
+    void countSensors(const msg::WearableData& receivedWearData, const double time);
+    // With extendedDataPorts, the ports of the extended wire format of the producers
+    // (<wearableDataPort>/extended:o) are read instead of their data ports
+    bool extendedDataPorts = false;
     std::vector<std::unique_ptr<yarp::os::BufferedPort<msg::WearableData>>> inputPortsWearData;
+    std::vector<std::unique_ptr<yarp::os::BufferedPort<msg::ExtendedWearableData>>>
+        inputPortsExtendedData;
+    std::vector<std::string> inputPortsNames;
+    template <typename Message>
+    bool openInputPort(std::vector<std::unique_ptr<yarp::os::BufferedPort<Message>>>& ports,
+                       yarp::os::TypedReaderCallback<Message>& callback);
     std::vector<bool> firstInputReceived; //flag to check that at least a first message from the inputs port was received
+    // Decoders of the encoded sensors of each input port, used only by the thread of its callback
+    std::vector<std::unique_ptr<encoding::WearableDataDecoder>> decoders;
+
+    // Estimators of the clocks of the producers of the input ports, enabled by clockSync. The
+    // data is stamped with the time of its producer mapped to the local clock.
+    bool clockSync = false;
+    double clockSyncPeriod = clocksync::DefaultPeriod;
+    std::vector<std::unique_ptr<clocksync::ClockSyncClient>> clockClients;
 
     // Sensors stored for exposing wearable::IWear
     std::unordered_map<std::string, std::shared_ptr<sensor::impl::Accelerometer>> accelerometers;
@@ -70,7 +115,22 @@ public:
     std::unordered_map<std::string, std::shared_ptr<sensor::impl::VirtualSphericalJointKinSensor>>
         virtualSphericalJointKinSensors;
 
-    bool updateData(msg::WearableData& receivedWearData, bool create);
+    bool updateData(msg::WearableData& receivedWearData,
+                    msg::ExtendedWearableData* extendedData,
+                    bool create);
+
+    // Sample blocks, stored by the sensors of the types delivering them for the seconds of
+    // history. The blocks of the other sensors are ignored, with a warning for each sensor.
+    double sampleBlockHistory = DefaultSampleBlockHistory;
+    std::mutex ignoredSampleBlocksMutex;
+    std::unordered_set<std::string> ignoredSampleBlocks;
+
+    template <typename SensorImpl>
+    bool appendSampleBlock(
+        const sensor::SampleBlock& block,
+        const sensor::SensorName& name,
+        const std::unordered_map<std::string, std::shared_ptr<SensorImpl>>& storage);
+    void updateSampleBlocks(std::vector<msg::SampleBlock>& receivedBlocks);
 
     template <typename SensorInterface, typename SensorImpl>
     SensorPtr<const SensorInterface>
@@ -169,6 +229,33 @@ bool IWearRemapper::open(yarp::os::Searchable& config)
         pImpl->allowDynamicData = config.find("allowDynamicData").asBool();
     }
     yInfo() << logPrefix << "Using allowDynamicData parameter:"<<pImpl->allowDynamicData;
+
+    std::string error;
+    if (!realtime::parseThreadSettings(config, pImpl->threadSettings, error)) {
+        yError() << logPrefix << error;
+        return false;
+    }
+
+    pImpl->sampleBlockHistory =
+        config.check("sampleBlockHistory", yarp::os::Value(DefaultSampleBlockHistory))
+            .asFloat64();
+    if (!(pImpl->sampleBlockHistory > 0)) {
+        yError() << logPrefix << "Parameter 'sampleBlockHistory' must be positive";
+        return false;
+    }
+
+    // The metrics are enabled by the metrics option or by setting the name of their port. They
+    // are not needed for remapping the data, hence failures are not fatal.
+    if (config.check("metrics", yarp::os::Value(false)).asBool()
+        || config.check("metricsPortName")) {
+        const std::string metricsPortName =
+            config.check("metricsPortName", yarp::os::Value(DefaultMetricsPortName)).asString();
+        pImpl->metrics.reset(new metrics::Metrics(WrapperName + " " + metricsPortName));
+
+        if (!pImpl->metricsServer.open(metricsPortName, pImpl->metrics.get())) {
+            yWarning() << logPrefix << "Failed to open the metrics port" << metricsPortName;
+        }
+    }
     
     pImpl->inputDataPorts = config.check("wearableDataPorts");
 
@@ -222,15 +309,69 @@ bool IWearRemapper::open(yarp::os::Searchable& config)
             // ==========================
             yDebug() << logPrefix << "Configuring input data ports";
 
-            for (unsigned i = 0; i < config.find("wearableDataPorts").asList()->size(); ++i) {
-                pImpl->inputPortsWearData.emplace_back(new yarp::os::BufferedPort<msg::WearableData>());
-                pImpl->inputPortsWearData.back()->useCallback(*this);
+            pImpl->extendedDataPorts =
+                config.check("extendedDataPorts", yarp::os::Value(false)).asBool();
+            if (pImpl->extendedDataPorts) {
+                yInfo() << logPrefix << "Reading the extended wire format of the producers";
+            }
 
-                if (!pImpl->inputPortsWearData.back()->open("...")) {
+            for (unsigned i = 0; i < config.find("wearableDataPorts").asList()->size(); ++i) {
+                const bool opened =
+                    pImpl->extendedDataPorts
+                        ? pImpl->openInputPort<msg::ExtendedWearableData>(
+                            pImpl->inputPortsExtendedData, *this)
+                        : pImpl->openInputPort<msg::WearableData>(pImpl->inputPortsWearData,
+                                                                  *this);
+                if (!opened) {
                     yError() << logPrefix << "Failed to open local input port";
                     return false;
                 }
                 pImpl->firstInputReceived.push_back(false);
+                pImpl->decoders.emplace_back(new encoding::WearableDataDecoder());
+            }
+
+            // The clock ports default to the ones of IWearWrapper, next to its data ports, opened
+            // when clockSync is enabled in the wrapper as well
+            pImpl->clockSync = config.check("clockSync", yarp::os::Value(false)).asBool();
+            pImpl->clockSyncPeriod =
+                config.check("clockSyncPeriod", yarp::os::Value(clocksync::DefaultPeriod))
+                    .asFloat64();
+            std::vector<std::string> clockPortsNamesVector;
+            for (const std::string& inputDataPortName : inputDataPortsNamesVector) {
+                clockPortsNamesVector.push_back(inputDataPortName + "/clock:rpc");
+            }
+            if (config.check("clockPorts")) {
+                const yarp::os::Bottle* clockPortsList = config.find("clockPorts").asList();
+                if (!clockPortsList
+                    || clockPortsList->size() != inputDataPortsNamesVector.size()) {
+                    yError() << logPrefix
+                             << "clockPorts option must be a list with a port for each of the "
+                                "wearableDataPorts";
+                    return false;
+                }
+                for (unsigned i = 0; i < clockPortsList->size(); ++i) {
+                    clockPortsNamesVector[i] = clockPortsList->get(i).asString();
+                }
+            }
+            if (pImpl->clockSync && !(pImpl->clockSyncPeriod > 0)) {
+                yError() << logPrefix << "Parameter 'clockSyncPeriod' must be positive";
+                return false;
+            }
+
+            // ===============
+            // CLOCK EXCHANGES
+            // ===============
+            // The clients are started before connecting the input ports, whose callbacks use them
+            for (unsigned i = 0; pImpl->clockSync && i < clockPortsNamesVector.size(); ++i) {
+                yInfo() << logPrefix << "*** Clock Port" << i + 1 << "        :"
+                        << clockPortsNamesVector[i];
+                pImpl->clockClients.emplace_back(
+                    new clocksync::ClockSyncClient(pImpl->clockSyncPeriod));
+                if (!pImpl->clockClients.back()->open(clockPortsNamesVector[i])) {
+                    yError() << logPrefix << "Failed to start the clock exchanges with"
+                             << clockPortsNamesVector[i];
+                    return false;
+                }
             }
 
             // ================
@@ -239,11 +380,13 @@ bool IWearRemapper::open(yarp::os::Searchable& config)
             yDebug() << logPrefix << "Opening input ports";
 
             for (unsigned i = 0; i < config.find("wearableDataPorts").asList()->size(); ++i) {
-                if (!yarp::os::Network::connect(inputDataPortsNamesVector[i],
-                                                pImpl->inputPortsWearData[i]->getName(),
-                                                carrier)) {
-                    yError() << logPrefix << "Failed to connect " << inputDataPortsNamesVector[i]
-                            << " with " << pImpl->inputPortsWearData[i]->getName();
+                const std::string sourcePortName =
+                    pImpl->extendedDataPorts ? inputDataPortsNamesVector[i] + "/extended:o"
+                                             : inputDataPortsNamesVector[i];
+                if (!yarp::os::Network::connect(
+                        sourcePortName, pImpl->inputPortsNames[i], carrier)) {
+                    yError() << logPrefix << "Failed to connect " << sourcePortName
+                            << " with " << pImpl->inputPortsNames[i];
                     return false;
                 }
             }
@@ -279,6 +422,10 @@ bool IWearRemapper::close()
         stop();
     }
 
+    for (auto& clockClient : pImpl->clockClients) {
+        clockClient->close();
+    }
+    pImpl->metricsServer.close();
     return true;
 }
 
@@ -302,7 +449,9 @@ const std::unordered_map<msg::SensorStatus, sensor::SensorStatus> MapSensorStatu
 
 
 
-bool IWearRemapper::impl::updateData(msg::WearableData& receivedWearData, bool create)
+bool IWearRemapper::impl::updateData(msg::WearableData& receivedWearData,
+                                     msg::ExtendedWearableData* extendedData,
+                                     bool create)
 {
     for (auto& accelerometersMap : receivedWearData.accelerometers) {
         const std::string& inputSensorName = accelerometersMap.first;
@@ -703,26 +852,204 @@ bool IWearRemapper::impl::updateData(msg::WearableData& receivedWearData, bool c
         sensor->setStatus(MapSensorStatus.at(wearDataInputSensor.info.status));
     }
 
+    if (extendedData) {
+        updateSampleBlocks(extendedData->sampleBlocks);
+    }
     return true;
 }
 
+template <typename Message>
+bool IWearRemapper::impl::openInputPort(
+    std::vector<std::unique_ptr<yarp::os::BufferedPort<Message>>>& ports,
+    yarp::os::TypedReaderCallback<Message>& callback)
+{
+    ports.emplace_back(new yarp::os::BufferedPort<Message>());
+    ports.back()->useCallback(callback);
+    if (!ports.back()->open("...")) {
+        return false;
+    }
+    inputPortsNames.push_back(ports.back()->getName());
+    return true;
+}
+
+template <typename SensorImpl>
+bool IWearRemapper::impl::appendSampleBlock(
+    const sensor::SampleBlock& block,
+    const sensor::SensorName& name,
+    const std::unordered_map<std::string, std::shared_ptr<SensorImpl>>& storage)
+{
+    const auto it = storage.find(name);
+    if (it == storage.end()) {
+        return false;
+    }
+    it->second->m_samples.setHistory(sampleBlockHistory);
+    return it->second->m_samples.append(block);
+}
+
+void IWearRemapper::impl::updateSampleBlocks(std::vector<msg::SampleBlock>& receivedBlocks)
+{
+    sensor::SampleBlock block;
+    for (msg::SampleBlock& receivedBlock : receivedBlocks) {
+        block.firstSample = static_cast<size_t>(std::max<std::int64_t>(0, receivedBlock.firstSample));
+        block.startTime = receivedBlock.startTime;
+        block.samplePeriod = receivedBlock.samplePeriod;
+        block.channels = static_cast<size_t>(std::max<std::int32_t>(0, receivedBlock.channels));
+        block.values.swap(receivedBlock.values);
+
+        const sensor::SensorName& name = receivedBlock.info.name;
+        bool appended = false;
+        switch (sensor::sensorTypeFromString(receivedBlock.type)) {
+            case sensor::SensorType::Accelerometer:
+                appended = appendSampleBlock(block, name, accelerometers);
+                break;
+            case sensor::SensorType::EmgSensor:
+                appended = appendSampleBlock(block, name, emgSensors);
+                break;
+            case sensor::SensorType::Gyroscope:
+                appended = appendSampleBlock(block, name, gyroscopes);
+                break;
+            case sensor::SensorType::Magnetometer:
+                appended = appendSampleBlock(block, name, magnetometers);
+                break;
+            default:
+                break;
+        }
+
+        if (!appended) {
+            std::lock_guard<std::mutex> lock(ignoredSampleBlocksMutex);
+            if (ignoredSampleBlocks.insert(name).second) {
+                yWarning() << logPrefix << "Ignoring the sample blocks of" << name << "of type"
+                           << receivedBlock.type << ", unknown, invalid or not supported";
+            }
+        }
+    }
+}
+
+template <typename SensorData>
+void IWearRemapper::impl::countSensors(const std::map<std::string, SensorData>& sensors,
+                                       const double time)
+{
+    for (const auto& sensor : sensors) {
+        if (sensor.second.info.status != msg::SensorStatus::OK) {
+            continue;
+        }
+
+        auto it = sensorCounters.find(sensor.first);
+        if (it == sensorCounters.end()) {
+            it = sensorCounters.emplace(sensor.first, metrics->addSensor(sensor.first)).first;
+        }
+        it->second->update(time);
+    }
+}
+
+void IWearRemapper::impl::countSensors(const msg::WearableData& receivedWearData,
+                                       const double time)
+{
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    countSensors(receivedWearData.accelerometers, time);
+    countSensors(receivedWearData.emgSensors, time);
+    countSensors(receivedWearData.force3DSensors, time);
+    countSensors(receivedWearData.forceTorque6DSensors, time);
+    countSensors(receivedWearData.freeBodyAccelerationSensors, time);
+    countSensors(receivedWearData.gyroscopes, time);
+    countSensors(receivedWearData.magnetometers, time);
+    countSensors(receivedWearData.orientationSensors, time);
+    countSensors(receivedWearData.poseSensors, time);
+    countSensors(receivedWearData.positionSensors, time);
+    countSensors(receivedWearData.skinSensors, time);
+    countSensors(receivedWearData.temperatureSensors, time);
+    countSensors(receivedWearData.torque3DSensors, time);
+    countSensors(receivedWearData.virtualLinkKinSensors, time);
+    countSensors(receivedWearData.virtualJointKinSensors, time);
+    countSensors(receivedWearData.virtualSphericalJointKinSensors, time);
+}
+
 void IWearRemapper::onRead(msg::WearableData& wearData, const yarp::os::TypedReader<msg::WearableData>& typedReader)
 {
+    onFrame(wearData, nullptr, typedReader.getName());
+}
+
+void IWearRemapper::onRead(msg::ExtendedWearableData& extendedData,
+                           const yarp::os::TypedReader<msg::ExtendedWearableData>& typedReader)
+{
+    onFrame(extendedData.data, &extendedData, typedReader.getName());
+}
+
+void IWearRemapper::onFrame(msg::WearableData& wearData,
+                            msg::ExtendedWearableData* extendedData,
+                            const std::string& portName)
+{
+    WEARABLES_TRACE_SCOPE("IWearRemapper::onRead");
+    const double readStartTime = yarp::os::Time::now();
+
+    // Each input port has its own thread, configured when it receives the first data
+    bool configureThread = false;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->configuredThreadsMutex);
+        configureThread = pImpl->configuredThreads.insert(std::this_thread::get_id()).second;
+    }
+    if (configureThread) {
+        std::string error;
+        if (!realtime::applyThreadSettings(pImpl->threadSettings, error)) {
+            yWarning() << logPrefix << "Failed to apply the settings of the thread of"
+                       << portName << ":" << error;
+        }
+    }
+
     if (pImpl->terminationCall) {
         return;
     }
 
+    const auto portIt =
+        std::find(pImpl->inputPortsNames.begin(), pImpl->inputPortsNames.end(), portName);
+    if (portIt == pImpl->inputPortsNames.end()) {
+        yError() << logPrefix << "Received data on the unknown port" << portName;
+        return;
+    }
+    const size_t port = static_cast<size_t>(portIt - pImpl->inputPortsNames.begin());
+    const bool partial = extendedData && extendedData->partial;
+
+    // The timestamp of the data is the one set by its producer, in the clock of its host. It is
+    // mapped to the local clock once the estimate of the clock of the producer is available.
+    bool producerTime = false;
+    double dataTime = readStartTime;
+    if (pImpl->clockSync && port < pImpl->clockClients.size()) {
+        yarp::os::Stamp stamp;
+        if (pImpl->extendedDataPorts) {
+            pImpl->inputPortsExtendedData[port]->getEnvelope(stamp);
+        }
+        else {
+            pImpl->inputPortsWearData[port]->getEnvelope(stamp);
+        }
+        producerTime =
+            stamp.isValid() && pImpl->clockClients[port]->toLocalTime(stamp.getTime(), dataTime);
+    }
+
+    // The sensors encoded by the producer are expanded into the maps of their types, by the
+    // decoder of the port keeping the reference of the sparse skin sensors
+    if (extendedData && !extendedData->encodedSensors.empty()) {
+        WEARABLES_TRACE_SCOPE("IWearRemapper::decode");
+        std::string error;
+        if (!pImpl->decoders[port]->decode(*extendedData, error)) {
+            yError() << logPrefix << "Dropping a frame of" << portName
+                     << "with invalid encoded sensors:" << error;
+            return;
+        }
+    }
+
     bool dataUpdated = true;
     if(pImpl->firstRun || pImpl->allowDynamicData)
     {
         // locked version
         std::lock_guard<std::mutex> lock(pImpl->mutex);
-        dataUpdated = pImpl->updateData(wearData, true);
+        WEARABLES_TRACE_SCOPE("IWearRemapper::updateData");
+        dataUpdated = pImpl->updateData(wearData, extendedData, true);
     }
     else
     {
         // non-locked version
-        dataUpdated = pImpl->updateData(wearData, false);
+        WEARABLES_TRACE_SCOPE("IWearRemapper::updateData");
+        dataUpdated = pImpl->updateData(wearData, extendedData, false);
     }
 
     if(!dataUpdated)
@@ -734,17 +1061,24 @@ void IWearRemapper::onRead(msg::WearableData& wearData, const yarp::os::TypedRea
     {
         std::lock_guard<std::mutex> lock(pImpl->mutex);
         pImpl->timestamp.sequenceNumber++;
-        pImpl->timestamp.time = yarp::os::Time::now();
+        pImpl->timestamp.time = producerTime ? dataTime : yarp::os::Time::now();
 
         // This is used to handle the overall status of IWear
         if (pImpl->firstRun) {
-            // check if all ports were read
+            // check if all ports were read. With a producer in send-on-change mode, a port is
+            // read with its first keyframe, since the partial frames contain only the sensors
+            // that changed, and they are merged in the sensors already received.
             bool allRead = true;
-            for(int i = 0; i<pImpl->inputPortsWearData.size(); i++)
+            for(int i = 0; i<pImpl->inputPortsNames.size(); i++)
             {
-                if(pImpl->inputPortsWearData[i]->getName()==typedReader.getName())
+                if(pImpl->inputPortsNames[i]==portName)
                 {
-                    pImpl->firstInputReceived[i] = true;
+                    if (!partial) {
+                        pImpl->firstInputReceived[i] = true;
+                    }
+                    else if (!pImpl->firstInputReceived[i]) {
+                        allRead = false;
+                    }
                 }
                 else if(!pImpl->firstInputReceived[i])
                 {
@@ -758,6 +1092,12 @@ void IWearRemapper::onRead(msg::WearableData& wearData, const yarp::os::TypedRea
             }
         }
     }
+
+    if (pImpl->metrics) {
+        pImpl->countSensors(wearData, dataTime);
+        pImpl->metrics->addFramesIn();
+        pImpl->metrics->addTick(yarp::os::Time::now() - readStartTime);
+    }
 }
 
 yarp::os::Stamp IWearRemapper::getLastInputStamp()
@@ -0,0 +1,1053 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "IWearReplay.h"
+#include "Wearable/IWear/Sensors/impl/SensorsImpl.h"
+#include "Wearable/Logger/BinaryLog.h"
+#include "Wearable/Logger/RawCapture.h"
+#include "Wearable/WireEncoding/WearableDataEncoding.h"
+
+#include <thrift/ExtendedWearableData.h>
+#include <thrift/WearableData.h>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Portable.h>
+#include <yarp/os/Time.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+const std::string DeviceName = "IWearReplay";
+const std::string LogPrefix = DeviceName + " :";
+constexpr double DefaultPeriod = 0.01;
+
+using namespace wearable;
+using namespace wearable::sensor;
+using namespace wearable::devices;
+
+const std::unordered_map<msg::SensorStatus, SensorStatus> MapSensorStatus = {
+    {msg::SensorStatus::OK, SensorStatus::Ok},
+    {msg::SensorStatus::ERROR, SensorStatus::Error},
+    {msg::SensorStatus::DATA_OVERFLOW, SensorStatus::Overflow},
+    {msg::SensorStatus::CALIBRATING, SensorStatus::Calibrating},
+    {msg::SensorStatus::TIMEOUT, SensorStatus::Timeout},
+    {msg::SensorStatus::WAITING_FOR_FIRST_READ, SensorStatus::WaitingForFirstRead},
+    {msg::SensorStatus::UNKNOWN, SensorStatus::Unknown},
+};
+
+// Number of values of a sensor of the given type, excluding the status. The layout of the values
+// is the one of the IWearLogger channels. The skin sensors have one value per taxel.
+static size_t getSensorSize(const SensorType type)
+{
+    switch (type) {
+        case SensorType::EmgSensor:
+            return 2;
+        case SensorType::ForceTorque6DSensor:
+            return 6;
+        case SensorType::OrientationSensor:
+            return 4;
+        case SensorType::PoseSensor:
+            return 7;
+        case SensorType::SkinSensor:
+            return 0;
+        case SensorType::TemperatureSensor:
+            return 1;
+        case SensorType::VirtualLinkKinSensor:
+            return 19;
+        case SensorType::VirtualJointKinSensor:
+            return 3;
+        case SensorType::VirtualSphericalJointKinSensor:
+            return 9;
+        default:
+            return 3;
+    }
+}
+
+// Call visit(type, name, status, values, size) for every sensor of the message, with the values
+// ordered as in the IWearLogger channels
+template <typename Visitor>
+static void visitSensors(const msg::WearableData& data, Visitor&& visit)
+{
+    for (const auto& s : data.accelerometers) {
+        const auto& d = s.second.data;
+        const double values[] = {d.x, d.y, d.z};
+        visit(SensorType::Accelerometer, s.first, s.second.info.status, values, 3);
+    }
+    for (const auto& s : data.emgSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {d.value, d.normalization};
+        visit(SensorType::EmgSensor, s.first, s.second.info.status, values, 2);
+    }
+    for (const auto& s : data.force3DSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {d.x, d.y, d.z};
+        visit(SensorType::Force3DSensor, s.first, s.second.info.status, values, 3);
+    }
+    for (const auto& s : data.forceTorque6DSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {
+            d.force.x, d.force.y, d.force.z, d.torque.x, d.torque.y, d.torque.z};
+        visit(SensorType::ForceTorque6DSensor, s.first, s.second.info.status, values, 6);
+    }
+    for (const auto& s : data.freeBodyAccelerationSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {d.x, d.y, d.z};
+        visit(SensorType::FreeBodyAccelerationSensor, s.first, s.second.info.status, values, 3);
+    }
+    for (const auto& s : data.gyroscopes) {
+        const auto& d = s.second.data;
+        const double values[] = {d.x, d.y, d.z};
+        visit(SensorType::Gyroscope, s.first, s.second.info.status, values, 3);
+    }
+    for (const auto& s : data.magnetometers) {
+        const auto& d = s.second.data;
+        const double values[] = {d.x, d.y, d.z};
+        visit(SensorType::Magnetometer, s.first, s.second.info.status, values, 3);
+    }
+    for (const auto& s : data.orientationSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {d.w, d.x, d.y, d.z};
+        visit(SensorType::OrientationSensor, s.first, s.second.info.status, values, 4);
+    }
+    for (const auto& s : data.poseSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {d.position.x,
+                                 d.position.y,
+                                 d.position.z,
+                                 d.orientation.w,
+                                 d.orientation.x,
+                                 d.orientation.y,
+                                 d.orientation.z};
+        visit(SensorType::PoseSensor, s.first, s.second.info.status, values, 7);
+    }
+    for (const auto& s : data.positionSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {d.x, d.y, d.z};
+        visit(SensorType::PositionSensor, s.first, s.second.info.status, values, 3);
+    }
+    for (const auto& s : data.skinSensors) {
+        const auto& d = s.second.data;
+        visit(SensorType::SkinSensor, s.first, s.second.info.status, d.data(), d.size());
+    }
+    for (const auto& s : data.temperatureSensors) {
+        const double values[] = {s.second.data};
+        visit(SensorType::TemperatureSensor, s.first, s.second.info.status, values, 1);
+    }
+    for (const auto& s : data.torque3DSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {d.x, d.y, d.z};
+        visit(SensorType::Torque3DSensor, s.first, s.second.info.status, values, 3);
+    }
+    for (const auto& s : data.virtualLinkKinSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {d.position.x,
+                                 d.position.y,
+                                 d.position.z,
+                                 d.orientation.w,
+                                 d.orientation.x,
+                                 d.orientation.y,
+                                 d.orientation.z,
+                                 d.linearVelocity.x,
+                                 d.linearVelocity.y,
+                                 d.linearVelocity.z,
+                                 d.angularVelocity.x,
+                                 d.angularVelocity.y,
+                                 d.angularVelocity.z,
+                                 d.linearAcceleration.x,
+                                 d.linearAcceleration.y,
+                                 d.linearAcceleration.z,
+                                 d.angularAcceleration.x,
+                                 d.angularAcceleration.y,
+                                 d.angularAcceleration.z};
+        visit(SensorType::VirtualLinkKinSensor, s.first, s.second.info.status, values, 19);
+    }
+    for (const auto& s : data.virtualJointKinSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {d.position, d.velocity, d.acceleration};
+        visit(SensorType::VirtualJointKinSensor, s.first, s.second.info.status, values, 3);
+    }
+    for (const auto& s : data.virtualSphericalJointKinSensors) {
+        const auto& d = s.second.data;
+        const double values[] = {d.angle.r,
+                                 d.angle.p,
+                                 d.angle.y,
+                                 d.velocity.x,
+                                 d.velocity.y,
+                                 d.velocity.z,
+                                 d.acceleration.x,
+                                 d.acceleration.y,
+                                 d.acceleration.z};
+        visit(SensorType::VirtualSphericalJointKinSensor,
+              s.first,
+              s.second.info.status,
+              values,
+              9);
+    }
+}
+
+// Sensor stored in the recording. Its values in the samples start from offset and are
+// prefixed with the sensor status, as in the IWearLogger channels.
+struct RecordedSensor
+{
+    SensorName name;
+    SensorType type = SensorType::Invalid;
+    size_t offset = 0;
+    size_t size = 0;
+};
+
+// Sample of the recording, storing the values of all the sensors and a validity flag for each
+// sensor. The sensors not updated in the sample are not valid.
+struct RecordedSample
+{
+    double time = 0;
+    std::vector<double> values;
+    std::vector<uint8_t> valid;
+};
+
+// Source of the samples of a recording
+class RecordingSource
+{
+public:
+    virtual ~RecordingSource() = default;
+
+    // Open the recording and read the list of its sensors
+    virtual bool open(const std::string& fileName, std::vector<RecordedSensor>& sensors) = 0;
+    // Read the next sample, return false at the end of the recording
+    virtual bool next(RecordedSample& sample) = 0;
+    // Restart reading from the first sample
+    virtual void rewind() = 0;
+};
+
+// Binary log of IWearLogger, whose channels already have the layout of the samples
+class BinaryLogSource : public RecordingSource
+{
+private:
+    logger::binary::Reader m_reader;
+    logger::binary::Chunk m_chunk;
+    size_t m_nextChunk = 0;
+    size_t m_nextSample = 0;
+
+public:
+    bool open(const std::string& fileName, std::vector<RecordedSensor>& sensors) override
+    {
+        if (!m_reader.open(fileName)) {
+            yError() << LogPrefix << "Failed to open" << fileName << ":"
+                     << m_reader.getLastError();
+            return false;
+        }
+
+        const auto& channels = m_reader.getChannels();
+        for (size_t c = 0; c < channels.size(); ++c) {
+            RecordedSensor sensor;
+            sensor.name = channels[c].name;
+            sensor.type = sensorTypeFromString(channels[c].type);
+            sensor.offset = m_reader.getChannelOffset(c);
+            sensor.size = channels[c].size;
+
+            const size_t expectedSize = getSensorSize(sensor.type) + 1;
+            if (sensor.type == SensorType::Invalid
+                || (sensor.type != SensorType::SkinSensor && sensor.size != expectedSize)
+                || sensor.size == 0) {
+                yWarning() << LogPrefix << "Channel" << sensor.name << "of type"
+                           << channels[c].type << "and size" << sensor.size
+                           << "is not a sensor, it will not be replayed";
+                sensor.type = SensorType::Invalid;
+            }
+            sensors.push_back(sensor);
+        }
+
+        yInfo() << LogPrefix << "Opened binary log" << fileName << "with"
+                << m_reader.getNumberOfSamples() << "samples from" << m_reader.getStartTime()
+                << "to" << m_reader.getEndTime();
+        return true;
+    }
+
+    bool next(RecordedSample& sample) override
+    {
+        // Skip the empty chunks
+        while (m_nextSample >= m_chunk.nSamples) {
+            if (m_nextChunk >= m_reader.getIndex().size()) {
+                return false;
+            }
+            if (!m_reader.readChunk(m_nextChunk++, m_chunk)) {
+                yError() << LogPrefix << "Failed to read the binary log:"
+                         << m_reader.getLastError();
+                return false;
+            }
+            m_nextSample = 0;
+        }
+
+        const size_t n = m_chunk.nSamples;
+        const size_t s = m_nextSample++;
+
+        sample.time = m_chunk.time[s];
+        for (size_t c = 0; c < sample.valid.size(); ++c) {
+            sample.valid[c] = m_chunk.valid[c * n + s];
+        }
+        for (size_t v = 0; v < sample.values.size(); ++v) {
+            sample.values[v] = m_chunk.values[v * n + s];
+        }
+        return true;
+    }
+
+    void rewind() override
+    {
+        m_chunk = {};
+        m_nextChunk = 0;
+        m_nextSample = 0;
+    }
+};
+
+// Raw capture of WearableData streams, or of ExtendedWearableData streams of the extended wire
+// format. The sensors are collected by scanning the whole capture when it is opened, and the
+// samples contain the sensors of a single message.
+class RawCaptureSource : public RecordingSource
+{
+private:
+    logger::raw::CaptureReader m_reader;
+    logger::raw::Record m_record;
+    msg::ExtendedWearableData m_extendedMessage;
+    msg::WearableData& m_message = m_extendedMessage.data;
+    encoding::WearableDataDecoder m_decoder;
+    std::map<SensorName, size_t> m_sensorsIndex;
+    std::vector<RecordedSensor>* m_sensors = nullptr;
+
+    bool decode()
+    {
+        yarp::os::Bottle bottle;
+        bottle.fromBinary(m_record.message.data(), m_record.message.size());
+        // The layouts of the two messages differ from the first field, a string in WearableData
+        // and a list in ExtendedWearableData
+        if (yarp::os::Portable::copyPortable(bottle, m_message)) {
+            return true;
+        }
+        if (!yarp::os::Portable::copyPortable(bottle, m_extendedMessage)) {
+            return false;
+        }
+        // The sensors encoded by the producer are expanded into the maps of their types
+        std::string error;
+        return m_decoder.decode(m_extendedMessage, error);
+    }
+
+public:
+    bool open(const std::string& fileName, std::vector<RecordedSensor>& sensors) override
+    {
+        if (!m_reader.open(fileName)) {
+            yError() << LogPrefix << "Failed to open" << fileName << ":"
+                     << m_reader.getLastError();
+            return false;
+        }
+
+        size_t nRecords = 0;
+        size_t nInvalid = 0;
+        size_t nValues = 0;
+        double startTime = std::numeric_limits<double>::infinity();
+        double endTime = -std::numeric_limits<double>::infinity();
+
+        while (m_reader.next(m_record)) {
+            if (!decode()) {
+                ++nInvalid;
+                continue;
+            }
+            ++nRecords;
+            startTime = std::min(startTime, m_record.time);
+            endTime = std::max(endTime, m_record.time);
+
+            visitSensors(m_message,
+                         [&](const SensorType type,
+                             const std::string& name,
+                             const msg::SensorStatus,
+                             const double*,
+                             const size_t size) {
+                             if (m_sensorsIndex.find(name) != m_sensorsIndex.end()) {
+                                 return;
+                             }
+                             m_sensorsIndex.emplace(name, sensors.size());
+                             sensors.push_back({name, type, nValues, size + 1});
+                             nValues += size + 1;
+                         });
+        }
+
+        if (!m_reader.getLastError().empty()) {
+            yWarning() << LogPrefix << "Replaying the capture up to a corrupted record:"
+                       << m_reader.getLastError();
+        }
+
+        if (nInvalid > 0) {
+            yWarning() << LogPrefix << nInvalid
+                       << "records of the capture are not WearableData or ExtendedWearableData"
+                       << "messages, they will"
+                       << "not be replayed";
+        }
+
+        yInfo() << LogPrefix << "Opened raw capture" << fileName << "with" << nRecords
+                << "messages from" << m_reader.getStreams().size() << "streams, from"
+                << startTime << "to" << endTime;
+
+        m_sensors = &sensors;
+        m_reader.rewind();
+        m_decoder = {};
+        return true;
+    }
+
+    bool next(RecordedSample& sample) override
+    {
+        while (m_reader.next(m_record)) {
+            if (!decode()) {
+                continue;
+            }
+
+            sample.time = m_record.time;
+            std::fill(sample.valid.begin(), sample.valid.end(), 0);
+
+            visitSensors(m_message,
+                         [&](const SensorType,
+                             const std::string& name,
+                             const msg::SensorStatus status,
+                             const double* values,
+                             const size_t size) {
+                             const auto it = m_sensorsIndex.find(name);
+                             if (it == m_sensorsIndex.end()) {
+                                 return;
+                             }
+                             // The skin sensors could change their size during the capture
+                             const RecordedSensor& sensor = (*m_sensors)[it->second];
+                             if (size + 1 != sensor.size) {
+                                 return;
+                             }
+                             sample.values[sensor.offset] =
+                                 static_cast<double>(MapSensorStatus.at(status));
+                             std::copy(values, values + size, &sample.values[sensor.offset + 1]);
+                             sample.valid[it->second] = 1;
+                         });
+            return true;
+        }
+        return false;
+    }
+
+    void rewind() override
+    {
+        m_reader.rewind();
+        m_decoder = {};
+    }
+};
+
+class IWearReplay::Impl
+{
+public:
+    struct
+    {
+        WearableName wearableName;
+        std::string file;
+        double period = DefaultPeriod;
+        double speed = 1.0;
+        bool loop = false;
+        bool recordedTimestamps = true;
+    } options;
+
+    std::unique_ptr<RecordingSource> source;
+    std::vector<RecordedSensor> recordedSensors;
+    std::vector<SensorPtr<ISensor>> sensors; // nullptr for the channels that are not replayed
+
+    // Next sample to replay, and the latest values of all the sensors
+    RecordedSample pending;
+    bool hasPending = false;
+    RecordedSample current;
+    std::vector<uint8_t> updated;
+
+    // Virtual clock: the sample with the recorded time recordStart is replayed at playStart,
+    // and the following samples are replayed when the recorded time elapsed (scaled by speed)
+    bool started = false;
+    double playStart = 0;
+    double recordStart = 0;
+    // Duration of the previous loops, added to the recorded time to keep it increasing
+    double loopOffset = 0;
+    size_t loops = 0;
+    bool endReported = false;
+
+    mutable std::mutex mutex;
+    bool firstRun = true;
+    TimeStamp timestamp;
+
+    std::map<SensorType, VectorOfSensorPtr<const ISensor>> sensorsByType;
+    std::map<SensorName, SensorPtr<const ISensor>> sensorsByName;
+
+    template <typename SensorInterface>
+    SensorPtr<const SensorInterface> getSensor(const SensorName& name) const
+    {
+        const auto it = sensorsByName.find(name);
+        if (it == sensorsByName.end()) {
+            yWarning() << LogPrefix << "Sensor" << name << "not found.";
+            return nullptr;
+        }
+        return std::dynamic_pointer_cast<const SensorInterface>(it->second);
+    }
+
+    void createSensors();
+    bool nextSample();
+    void merge(const RecordedSample& sample);
+    void apply(const size_t index);
+};
+
+template <typename SensorImpl>
+static SensorPtr<ISensor> makeSensor(const SensorName& name)
+{
+    return std::make_shared<SensorImpl>(name, SensorStatus::Unknown);
+}
+
+void IWearReplay::Impl::createSensors()
+{
+    for (const auto& recorded : recordedSensors) {
+        SensorPtr<ISensor> sensor;
+        switch (recorded.type) {
+            case SensorType::Accelerometer:
+                sensor = makeSensor<sensor::impl::Accelerometer>(recorded.name);
+                break;
+            case SensorType::EmgSensor:
+                sensor = makeSensor<sensor::impl::EmgSensor>(recorded.name);
+                break;
+            case SensorType::Force3DSensor:
+                sensor = makeSensor<sensor::impl::Force3DSensor>(recorded.name);
+                break;
+            case SensorType::ForceTorque6DSensor:
+                sensor = makeSensor<sensor::impl::ForceTorque6DSensor>(recorded.name);
+                break;
+            case SensorType::FreeBodyAccelerationSensor:
+                sensor = makeSensor<sensor::impl::FreeBodyAccelerationSensor>(recorded.name);
+                break;
+            case SensorType::Gyroscope:
+                sensor = makeSensor<sensor::impl::Gyroscope>(recorded.name);
+                break;
+            case SensorType::Magnetometer:
+                sensor = makeSensor<sensor::impl::Magnetometer>(recorded.name);
+                break;
+            case SensorType::OrientationSensor:
+                sensor = makeSensor<sensor::impl::OrientationSensor>(recorded.name);
+                break;
+            case SensorType::PoseSensor:
+                sensor = makeSensor<sensor::impl::PoseSensor>(recorded.name);
+                break;
+            case SensorType::PositionSensor:
+                sensor = makeSensor<sensor::impl::PositionSensor>(recorded.name);
+                break;
+            case SensorType::SkinSensor:
+                sensor = makeSensor<sensor::impl::SkinSensor>(recorded.name);
+                break;
+            case SensorType::TemperatureSensor:
+                sensor = makeSensor<sensor::impl::TemperatureSensor>(recorded.name);
+                break;
+            case SensorType::Torque3DSensor:
+                sensor = makeSensor<sensor::impl::Torque3DSensor>(recorded.name);
+                break;
+            case SensorType::VirtualLinkKinSensor:
+                sensor = makeSensor<sensor::impl::VirtualLinkKinSensor>(recorded.name);
+                break;
+            case SensorType::VirtualJointKinSensor:
+                sensor = makeSensor<sensor::impl::VirtualJointKinSensor>(recorded.name);
+                break;
+            case SensorType::VirtualSphericalJointKinSensor:
+                sensor = makeSensor<sensor::impl::VirtualSphericalJointKinSensor>(recorded.name);
+                break;
+            default:
+                break;
+        }
+
+        sensors.push_back(sensor);
+        if (sensor) {
+            sensorsByType[recorded.type].push_back(sensor);
+            sensorsByName.emplace(recorded.name, sensor);
+        }
+    }
+
+    size_t nValues = 0;
+    for (const auto& recorded : recordedSensors) {
+        nValues = std::max(nValues, recorded.offset + recorded.size);
+    }
+
+    for (RecordedSample* sample : {&pending, &current}) {
+        sample->values.resize(nValues, 0.0);
+        sample->valid.resize(recordedSensors.size(), 0);
+    }
+    updated.resize(recordedSensors.size(), 0);
+}
+
+// Read the next sample, restarting from the first one at the end of the recording if the
+// playback loops
+bool IWearReplay::Impl::nextSample()
+{
+    if (source->next(pending)) {
+        return true;
+    }
+
+    if (!options.loop) {
+        return false;
+    }
+
+    const double loopDuration = current.time - recordStart;
+    source->rewind();
+    if (!source->next(pending)) {
+        return false;
+    }
+
+    // The first sample of the new loop is replayed one period after the last one
+    loopOffset += loopDuration + options.period * std::max(options.speed, 1.0);
+    recordStart = pending.time;
+    playStart = yarp::os::Time::now();
+    loops++;
+    return true;
+}
+
+void IWearReplay::Impl::merge(const RecordedSample& sample)
+{
+    current.time = sample.time;
+    for (size_t s = 0; s < recordedSensors.size(); ++s) {
+        if (!sample.valid[s] || !sensors[s]) {
+            continue;
+        }
+        const RecordedSensor& recorded = recordedSensors[s];
+        std::copy(sample.values.begin() + recorded.offset,
+                  sample.values.begin() + recorded.offset + recorded.size,
+                  current.values.begin() + recorded.offset);
+        updated[s] = 1;
+    }
+}
+
+// Store the latest values of the sensor in its buffer. The first value is the status.
+void IWearReplay::Impl::apply(const size_t index)
+{
+    const RecordedSensor& recorded = recordedSensors[index];
+    const double* v = &current.values[recorded.offset];
+    const SensorStatus status = static_cast<SensorStatus>(static_cast<int>(v[0]));
+    ++v;
+
+    switch (recorded.type) {
+        case SensorType::Accelerometer: {
+            auto* sensor = static_cast<sensor::impl::Accelerometer*>(sensors[index].get());
+            sensor->setBuffer({v[0], v[1], v[2]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::EmgSensor: {
+            auto* sensor = static_cast<sensor::impl::EmgSensor*>(sensors[index].get());
+            sensor->setBuffer(v[0], v[1]);
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::Force3DSensor: {
+            auto* sensor = static_cast<sensor::impl::Force3DSensor*>(sensors[index].get());
+            sensor->setBuffer({v[0], v[1], v[2]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::ForceTorque6DSensor: {
+            auto* sensor = static_cast<sensor::impl::ForceTorque6DSensor*>(sensors[index].get());
+            sensor->setBuffer({v[0], v[1], v[2]}, {v[3], v[4], v[5]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::FreeBodyAccelerationSensor: {
+            auto* sensor =
+                static_cast<sensor::impl::FreeBodyAccelerationSensor*>(sensors[index].get());
+            sensor->setBuffer({v[0], v[1], v[2]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::Gyroscope: {
+            auto* sensor = static_cast<sensor::impl::Gyroscope*>(sensors[index].get());
+            sensor->setBuffer({v[0], v[1], v[2]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::Magnetometer: {
+            auto* sensor = static_cast<sensor::impl::Magnetometer*>(sensors[index].get());
+            sensor->setBuffer({v[0], v[1], v[2]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::OrientationSensor: {
+            auto* sensor = static_cast<sensor::impl::OrientationSensor*>(sensors[index].get());
+            sensor->setBuffer({v[0], v[1], v[2], v[3]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::PoseSensor: {
+            auto* sensor = static_cast<sensor::impl::PoseSensor*>(sensors[index].get());
+            sensor->setBuffer({v[3], v[4], v[5], v[6]}, {v[0], v[1], v[2]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::PositionSensor: {
+            auto* sensor = static_cast<sensor::impl::PositionSensor*>(sensors[index].get());
+            sensor->setBuffer({v[0], v[1], v[2]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::SkinSensor: {
+            auto* sensor = static_cast<sensor::impl::SkinSensor*>(sensors[index].get());
+            sensor->setBuffer(std::vector<double>(v, v + recorded.size - 1));
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::TemperatureSensor: {
+            auto* sensor = static_cast<sensor::impl::TemperatureSensor*>(sensors[index].get());
+            sensor->setBuffer(v[0]);
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::Torque3DSensor: {
+            auto* sensor = static_cast<sensor::impl::Torque3DSensor*>(sensors[index].get());
+            sensor->setBuffer({v[0], v[1], v[2]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::VirtualLinkKinSensor: {
+            // position, orientation, linear and angular velocity, linear and angular acceleration
+            auto* sensor = static_cast<sensor::impl::VirtualLinkKinSensor*>(sensors[index].get());
+            sensor->setBuffer({v[13], v[14], v[15]},
+                              {v[16], v[17], v[18]},
+                              {v[7], v[8], v[9]},
+                              {v[10], v[11], v[12]},
+                              {v[0], v[1], v[2]},
+                              {v[3], v[4], v[5], v[6]});
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::VirtualJointKinSensor: {
+            auto* sensor = static_cast<sensor::impl::VirtualJointKinSensor*>(sensors[index].get());
+            sensor->setBuffer(v[0], v[1], v[2]);
+            sensor->setStatus(status);
+            break;
+        }
+        case SensorType::VirtualSphericalJointKinSensor: {
+            auto* sensor =
+                static_cast<sensor::impl::VirtualSphericalJointKinSensor*>(sensors[index].get());
+            sensor->setBuffer({v[0], v[1], v[2]}, {v[3], v[4], v[5]}, {v[6], v[7], v[8]});
+            sensor->setStatus(status);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// ===========
+// IWearReplay
+// ===========
+
+IWearReplay::IWearReplay()
+    : PeriodicThread(DefaultPeriod)
+    , pImpl{std::make_unique<Impl>()}
+{}
+
+// Without this destructor here, the linker complains for
+// undefined reference to vtable
+IWearReplay::~IWearReplay() = default;
+
+bool IWearReplay::open(yarp::os::Searchable& config)
+{
+    // ===============================
+    // CHECK THE CONFIGURATION OPTIONS
+    // ===============================
+
+    if (!(config.check("file") && config.find("file").isString())) {
+        yError() << LogPrefix << "Parameter 'file' missing or invalid";
+        return false;
+    }
+
+    // ===============
+    // READ PARAMETERS
+    // ===============
+
+    auto& options = pImpl->options;
+    options.file = config.find("file").asString();
+    options.period = config.check("period", yarp::os::Value(DefaultPeriod)).asFloat64();
+    options.speed = config.check("speed", yarp::os::Value(1.0)).asFloat64();
+    options.loop = config.check("loop", yarp::os::Value(false)).asBool();
+
+    if (options.period <= 0) {
+        yError() << LogPrefix << "Parameter 'period' must be positive";
+        return false;
+    }
+
+    // With speed 0 the samples are replayed as fast as possible, one per period
+    if (options.speed < 0) {
+        yError() << LogPrefix << "Parameter 'speed' must not be negative";
+        return false;
+    }
+
+    const std::string timestamps =
+        config.check("timestamps", yarp::os::Value("recorded")).asString();
+    if (timestamps == "recorded") {
+        options.recordedTimestamps = true;
+    }
+    else if (timestamps == "local") {
+        options.recordedTimestamps = false;
+    }
+    else {
+        yError() << LogPrefix << "Parameter 'timestamps' must be recorded or local";
+        return false;
+    }
+
+    // ==================
+    // OPEN THE RECORDING
+    // ==================
+
+    const auto hasExtension = [&](const std::string& extension) {
+        return options.file.size() >= extension.size()
+               && options.file.compare(
+                      options.file.size() - extension.size(), extension.size(), extension)
+                      == 0;
+    };
+
+    if (hasExtension(".iwlog")) {
+        pImpl->source = std::make_unique<BinaryLogSource>();
+    }
+    else if (hasExtension(".iwraw")) {
+        pImpl->source = std::make_unique<RawCaptureSource>();
+    }
+    else {
+        yError() << LogPrefix << "Unsupported recording" << options.file
+                 << ", the supported formats are .iwlog and .iwraw";
+        return false;
+    }
+
+    if (!pImpl->source->open(options.file, pImpl->recordedSensors)) {
+        return false;
+    }
+
+    pImpl->createSensors();
+    if (pImpl->sensorsByName.empty()) {
+        yError() << LogPrefix << "The recording does not contain any sensor";
+        return false;
+    }
+
+    pImpl->hasPending = pImpl->source->next(pImpl->pending);
+    if (!pImpl->hasPending) {
+        yError() << LogPrefix << "The recording does not contain any sample";
+        return false;
+    }
+
+    // By default the wearable name is the one of the recorded sensors
+    if (config.check("wearableName")) {
+        options.wearableName = config.find("wearableName").asString();
+    }
+    else {
+        const SensorName& name = pImpl->sensorsByName.begin()->first;
+        options.wearableName = name.substr(0, name.find(wearable::Separator));
+    }
+
+    yInfo() << LogPrefix << "*** ====================";
+    yInfo() << LogPrefix << "*** Wearable name      :" << options.wearableName;
+    yInfo() << LogPrefix << "*** File               :" << options.file;
+    yInfo() << LogPrefix << "*** Period             :" << options.period;
+    yInfo() << LogPrefix << "*** Speed              :"
+            << (options.speed > 0 ? std::to_string(options.speed) : "as fast as possible");
+    yInfo() << LogPrefix << "*** Loop               :" << options.loop;
+    yInfo() << LogPrefix << "*** Timestamps         :" << timestamps;
+    yInfo() << LogPrefix << "*** Sensors            :" << pImpl->sensorsByName.size();
+    for (const auto& entry : pImpl->sensorsByType) {
+        yInfo() << LogPrefix << "***                     " << sensorTypeToString(entry.first)
+                << entry.second.size();
+    }
+    yInfo() << LogPrefix << "*** ====================";
+
+    setPeriod(options.period);
+    if (!start()) {
+        yError() << LogPrefix << "Failed to start the periodic thread";
+        return false;
+    }
+
+    return true;
+}
+
+bool IWearReplay::close()
+{
+    if (isRunning()) {
+        stop();
+    }
+    return true;
+}
+
+void IWearReplay::run()
+{
+    const double now = yarp::os::Time::now();
+
+    if (!pImpl->started) {
+        pImpl->playStart = now;
+        pImpl->recordStart = pImpl->pending.time;
+        pImpl->started = true;
+    }
+
+    // Merge all the samples whose recorded time elapsed, so that the sensors expose the latest
+    // values even when the recording is faster than the period
+    bool hasUpdates = false;
+    while (pImpl->hasPending) {
+        const double target =
+            pImpl->options.speed > 0
+                ? pImpl->recordStart + (now - pImpl->playStart) * pImpl->options.speed
+                : std::numeric_limits<double>::infinity();
+        if (pImpl->pending.time > target) {
+            break;
+        }
+
+        pImpl->merge(pImpl->pending);
+        hasUpdates = true;
+        pImpl->hasPending = pImpl->nextSample();
+
+        if (pImpl->options.speed <= 0) {
+            break;
+        }
+    }
+
+    if (!pImpl->hasPending && !pImpl->endReported) {
+        yInfo() << LogPrefix << "End of the recording, the last sample stays available";
+        pImpl->endReported = true;
+    }
+
+    if (!hasUpdates) {
+        return;
+    }
+
+    for (size_t s = 0; s < pImpl->updated.size(); ++s) {
+        if (pImpl->updated[s]) {
+            pImpl->apply(s);
+            pImpl->updated[s] = 0;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->timestamp.time = pImpl->options.recordedTimestamps
+                                ? pImpl->current.time + pImpl->loopOffset
+                                : now;
+    pImpl->timestamp.sequenceNumber++;
+    pImpl->firstRun = false;
+}
+
+yarp::os::Stamp IWearReplay::getLastInputStamp()
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return yarp::os::Stamp(static_cast<int>(pImpl->timestamp.sequenceNumber),
+                           pImpl->timestamp.time);
+}
+
+WearableName IWearReplay::getWearableName() const
+{
+    return pImpl->options.wearableName + wearable::Separator;
+}
+
+WearStatus IWearReplay::getStatus() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->firstRun ? WearStatus::WaitingForFirstRead : WearStatus::Ok;
+}
+
+TimeStamp IWearReplay::getTimeStamp() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->timestamp;
+}
+
+SensorPtr<const ISensor> IWearReplay::getSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ISensor>(name);
+}
+
+VectorOfSensorPtr<const ISensor> IWearReplay::getSensors(const SensorType type) const
+{
+    const auto it = pImpl->sensorsByType.find(type);
+    if (it == pImpl->sensorsByType.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+SensorPtr<const IAccelerometer> IWearReplay::getAccelerometer(const SensorName name) const
+{
+    return pImpl->getSensor<IAccelerometer>(name);
+}
+
+SensorPtr<const IEmgSensor> IWearReplay::getEmgSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IEmgSensor>(name);
+}
+
+SensorPtr<const IForce3DSensor> IWearReplay::getForce3DSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IForce3DSensor>(name);
+}
+
+SensorPtr<const IForceTorque6DSensor>
+IWearReplay::getForceTorque6DSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IForceTorque6DSensor>(name);
+}
+
+SensorPtr<const IFreeBodyAccelerationSensor>
+IWearReplay::getFreeBodyAccelerationSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IFreeBodyAccelerationSensor>(name);
+}
+
+SensorPtr<const IGyroscope> IWearReplay::getGyroscope(const SensorName name) const
+{
+    return pImpl->getSensor<IGyroscope>(name);
+}
+
+SensorPtr<const IMagnetometer> IWearReplay::getMagnetometer(const SensorName name) const
+{
+    return pImpl->getSensor<IMagnetometer>(name);
+}
+
+SensorPtr<const IOrientationSensor> IWearReplay::getOrientationSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IOrientationSensor>(name);
+}
+
+SensorPtr<const IPoseSensor> IWearReplay::getPoseSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IPoseSensor>(name);
+}
+
+SensorPtr<const IPositionSensor> IWearReplay::getPositionSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IPositionSensor>(name);
+}
+
+SensorPtr<const ISkinSensor> IWearReplay::getSkinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ISkinSensor>(name);
+}
+
+SensorPtr<const ITemperatureSensor> IWearReplay::getTemperatureSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ITemperatureSensor>(name);
+}
+
+SensorPtr<const ITorque3DSensor> IWearReplay::getTorque3DSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ITorque3DSensor>(name);
+}
+
+SensorPtr<const IVirtualLinkKinSensor>
+IWearReplay::getVirtualLinkKinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IVirtualLinkKinSensor>(name);
+}
+
+SensorPtr<const IVirtualJointKinSensor>
+IWearReplay::getVirtualJointKinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IVirtualJointKinSensor>(name);
+}
+
+SensorPtr<const IVirtualSphericalJointKinSensor>
+IWearReplay::getVirtualSphericalJointKinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IVirtualSphericalJointKinSensor>(name);
+}
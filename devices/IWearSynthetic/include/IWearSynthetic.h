@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_IWEARSYNTHETIC_H
+#define WEARABLE_IWEARSYNTHETIC_H
+
+#include "Wearable/IWear/IWear.h"
+
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IPreciselyTimed.h>
+#include <yarp/os/PeriodicThread.h>
+
+#include <memory>
+
+namespace wearable {
+    namespace devices {
+        class IWearSynthetic;
+    } // namespace devices
+} // namespace wearable
+
+// Device exposing a configurable number of sensors of every type, whose data is generated at
+// a configurable rate. It is meant for testing and benchmarking the wearables pipeline
+// without hardware.
+class wearable::devices::IWearSynthetic
+    : public yarp::dev::DeviceDriver
+    , public yarp::os::PeriodicThread
+    , public yarp::dev::IPreciselyTimed
+    , public wearable::IWear
+{
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+
+public:
+    IWearSynthetic();
+    ~IWearSynthetic() override;
+
+    IWearSynthetic(const IWearSynthetic& other) = delete;
+    IWearSynthetic(IWearSynthetic&& other) = delete;
+    IWearSynthetic& operator=(const IWearSynthetic& other) = delete;
+    IWearSynthetic& operator=(IWearSynthetic&& other) = delete;
+
+    // DeviceDriver
+    bool open(yarp::os::Searchable& config) override;
+    bool close() override;
+
+    // PeriodicThread
+    void run() override;
+
+    // IPreciselyTimed
+    yarp::os::Stamp getLastInputStamp() override;
+
+    // =====
+    // IWEAR
+    // =====
+
+    // -------
+    // GENERIC
+    // -------
+
+    WearableName getWearableName() const override;
+    WearStatus getStatus() const override;
+    TimeStamp getTimeStamp() const override;
+
+    SensorPtr<const sensor::ISensor> getSensor(const sensor::SensorName name) const override;
+
+    VectorOfSensorPtr<const sensor::ISensor>
+    getSensors(const sensor::SensorType type) const override;
+
+    // --------------
+    // SINGLE SENSORS
+    // --------------
+
+    SensorPtr<const sensor::IAccelerometer>
+    getAccelerometer(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IEmgSensor> getEmgSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IForce3DSensor>
+    getForce3DSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IForceTorque6DSensor>
+    getForceTorque6DSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IFreeBodyAccelerationSensor>
+    getFreeBodyAccelerationSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IGyroscope> getGyroscope(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IMagnetometer>
+    getMagnetometer(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IOrientationSensor>
+    getOrientationSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IPoseSensor> getPoseSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IPositionSensor>
+    getPositionSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::ISkinSensor> getSkinSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::ITemperatureSensor>
+    getTemperatureSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::ITorque3DSensor>
+    getTorque3DSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IVirtualLinkKinSensor>
+    getVirtualLinkKinSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IVirtualJointKinSensor>
+    getVirtualJointKinSensor(const sensor::SensorName name) const override;
+
+    SensorPtr<const sensor::IVirtualSphericalJointKinSensor>
+    getVirtualSphericalJointKinSensor(const sensor::SensorName name) const override;
+
+    // ---------
+    // ACTUATORS
+    // ---------
+
+    inline ElementPtr<const actuator::IActuator>
+    getActuator(const actuator::ActuatorName name) const override;
+
+    inline VectorOfElementPtr<const actuator::IActuator>
+    getActuators(const actuator::ActuatorType type) const override;
+
+    inline ElementPtr<const actuator::IHaptic>
+    getHapticActuator(const actuator::ActuatorName) const override;
+
+    inline ElementPtr<const actuator::IMotor>
+    getMotorActuator(const actuator::ActuatorName) const override;
+
+    inline ElementPtr<const actuator::IHeater>
+    getHeaterActuator(const actuator::ActuatorName) const override;
+};
+
+inline wearable::ElementPtr<const wearable::actuator::IActuator>
+wearable::devices::IWearSynthetic::getActuator(const actuator::ActuatorName /*name*/) const
+{
+    return nullptr;
+}
+
+inline wearable::VectorOfElementPtr<const wearable::actuator::IActuator>
+wearable::devices::IWearSynthetic::getActuators(const actuator::ActuatorType /*type*/) const
+{
+    return {};
+}
+
+inline wearable::ElementPtr<const wearable::actuator::IHaptic>
+wearable::devices::IWearSynthetic::getHapticActuator(const actuator::ActuatorName) const
+{
+    return nullptr;
+}
+
+inline wearable::ElementPtr<const wearable::actuator::IMotor>
+wearable::devices::IWearSynthetic::getMotorActuator(const actuator::ActuatorName) const
+{
+    return nullptr;
+}
+
+inline wearable::ElementPtr<const wearable::actuator::IHeater>
+wearable::devices::IWearSynthetic::getHeaterActuator(const actuator::ActuatorName) const
+{
+    return nullptr;
+}
+
+#endif // WEARABLE_IWEARSYNTHETIC_H
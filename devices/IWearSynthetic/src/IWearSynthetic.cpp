@@ -0,0 +1,997 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "IWearSynthetic.h"
+#include "Wearable/IWear/Sensors/impl/SensorsImpl.h"
+#include "Wearable/IWear/Utils.h"
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+const std::string DeviceName = "IWearSynthetic";
+const std::string LogPrefix = DeviceName + " :";
+constexpr double DefaultPeriod = 0.01;
+
+using namespace wearable;
+using namespace wearable::sensor;
+using namespace wearable::devices;
+
+enum class SignalType
+{
+    Random,
+    Sine,
+    Pattern,
+};
+
+// Number of values generated for a sensor of the given type. The skin sensors have one value
+// per taxel and the emg sensors have the signal and the normalization value.
+static size_t getSensorSize(const SensorType type, const size_t skinTaxels)
+{
+    switch (type) {
+        case SensorType::EmgSensor:
+            return 2;
+        case SensorType::ForceTorque6DSensor:
+            return 6;
+        case SensorType::OrientationSensor:
+            return 4;
+        case SensorType::PoseSensor:
+            return 7;
+        case SensorType::SkinSensor:
+            return skinTaxels;
+        case SensorType::TemperatureSensor:
+            return 1;
+        case SensorType::VirtualLinkKinSensor:
+            return 19;
+        case SensorType::VirtualSphericalJointKinSensor:
+            return 9;
+        default:
+            return 3;
+    }
+}
+
+static std::string getSensorPrefix(const SensorType type)
+{
+    switch (type) {
+        case SensorType::Accelerometer:
+            return IAccelerometer::getPrefix();
+        case SensorType::EmgSensor:
+            return IEmgSensor::getPrefix();
+        case SensorType::Force3DSensor:
+            return IForce3DSensor::getPrefix();
+        case SensorType::ForceTorque6DSensor:
+            return IForceTorque6DSensor::getPrefix();
+        case SensorType::FreeBodyAccelerationSensor:
+            return IFreeBodyAccelerationSensor::getPrefix();
+        case SensorType::Gyroscope:
+            return IGyroscope::getPrefix();
+        case SensorType::Magnetometer:
+            return IMagnetometer::getPrefix();
+        case SensorType::OrientationSensor:
+            return IOrientationSensor::getPrefix();
+        case SensorType::PoseSensor:
+            return IPoseSensor::getPrefix();
+        case SensorType::PositionSensor:
+            return IPositionSensor::getPrefix();
+        case SensorType::SkinSensor:
+            return ISkinSensor::getPrefix();
+        case SensorType::TemperatureSensor:
+            return ITemperatureSensor::getPrefix();
+        case SensorType::Torque3DSensor:
+            return ITorque3DSensor::getPrefix();
+        case SensorType::VirtualLinkKinSensor:
+            return IVirtualLinkKinSensor::getPrefix();
+        case SensorType::VirtualJointKinSensor:
+            return IVirtualJointKinSensor::getPrefix();
+        case SensorType::VirtualSphericalJointKinSensor:
+            return IVirtualSphericalJointKinSensor::getPrefix();
+        default:
+            return "";
+    }
+}
+
+static SensorStatus sensorStatusFromString(const std::string& status)
+{
+    if (status == "Calibrating") {
+        return SensorStatus::Calibrating;
+    }
+    if (status == "Overflow") {
+        return SensorStatus::Overflow;
+    }
+    if (status == "Timeout") {
+        return SensorStatus::Timeout;
+    }
+    if (status == "Unknown") {
+        return SensorStatus::Unknown;
+    }
+    return SensorStatus::Error;
+}
+
+// Status setter shared by all the synthetic sensors
+class SyntheticSensorStatus
+{
+public:
+    virtual ~SyntheticSensorStatus() = default;
+    virtual void setStatus(const SensorStatus aStatus) = 0;
+};
+
+// Values of all the sensors, stored contiguously. The sensors read their own range.
+class SyntheticBuffer
+{
+public:
+    mutable std::mutex mutex;
+    bool firstRun = true;
+    TimeStamp timestamp;
+    std::vector<double> values;
+
+    bool read(const size_t offset, const size_t size, double* out) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (firstRun) {
+            return false;
+        }
+        std::copy(values.begin() + offset, values.begin() + offset + size, out);
+        return true;
+    }
+};
+
+class IWearSynthetic::Impl
+{
+public:
+    struct
+    {
+        WearableName wearableName;
+        double period = DefaultPeriod;
+        std::map<SensorType, size_t> nSensors;
+        size_t skinTaxels = 64;
+        SignalType signal = SignalType::Sine;
+        unsigned seed = 0;
+        double frequency = 1.0;
+        std::string patternFile;
+        double latency = 0;
+        double jitter = 0;
+        double errorProbability = 0;
+        SensorStatus errorStatus = SensorStatus::Error;
+        bool clockSensor = false;
+        double emgSampleRate = 0;
+    } options;
+
+    struct SensorSlot
+    {
+        SensorType type;
+        size_t offset;
+        size_t size;
+        SyntheticSensorStatus* status;
+    };
+
+    // The data is generated in nextValues and published by swapping it with the buffer
+    SyntheticBuffer buffer;
+    std::vector<double> nextValues;
+    std::vector<SensorStatus> nextStatus;
+    std::vector<SensorSlot> slots;
+
+    // Optional sensor carrying the generation time and the sequence number of the sample,
+    // used by the consumers to measure the latency of the pipeline
+    SensorSlot clock = {SensorType::VirtualJointKinSensor, 0, 0, nullptr};
+    std::vector<std::vector<double>> pattern;
+    size_t tick = 0;
+
+    // Signal of the emg sensors sampled at emgSampleRate, delivered in sample blocks
+    struct EmgSamples
+    {
+        size_t channel;
+        std::unique_ptr<impl::SampleBlockBuffer> buffer;
+    };
+    std::vector<EmgSamples> emgSamples;
+    size_t emgSample = 0;
+    SampleBlock emgBlock;
+
+    // Separate generators, so that the data does not depend on the injected jitter and on the
+    // sample blocks
+    std::mt19937 dataGenerator;
+    std::mt19937 jitterGenerator;
+    std::mt19937 sampleGenerator;
+
+    std::map<SensorType, VectorOfSensorPtr<const ISensor>> sensorsByType;
+    std::map<SensorName, SensorPtr<const ISensor>> sensorsByName;
+
+    template <typename SensorInterface>
+    SensorPtr<const SensorInterface> getSensor(const SensorName& name) const
+    {
+        const auto it = sensorsByName.find(name);
+        if (it == sensorsByName.end()) {
+            yWarning() << LogPrefix << "Sensor" << name << "not found.";
+            return nullptr;
+        }
+        return std::dynamic_pointer_cast<const SensorInterface>(it->second);
+    }
+
+    bool loadPattern(const std::string& fileName);
+    template <typename Sensor>
+    void addSensors(const SensorType type);
+    void createSensors();
+    double signal(const size_t channel,
+                  const double time,
+                  const size_t index,
+                  std::mt19937& generator) const;
+    void generate();
+    void appendEmgSamples(const double time);
+};
+
+// ================================
+// WEARABLE SENSORS IMPLEMENTATIONS
+// ================================
+
+template <typename SensorInterface>
+class SyntheticSensor
+    : public SensorInterface
+    , public SyntheticSensorStatus
+{
+protected:
+    const SyntheticBuffer* m_buffer;
+    const size_t m_offset;
+    const size_t m_size;
+
+    bool read(double* out) const { return m_buffer->read(m_offset, m_size, out); }
+
+public:
+    SyntheticSensor(const SensorName& name,
+                    const SyntheticBuffer* buffer,
+                    const size_t offset,
+                    const size_t size)
+        : SensorInterface(name, SensorStatus::WaitingForFirstRead)
+        , m_buffer(buffer)
+        , m_offset(offset)
+        , m_size(size)
+    {}
+
+    // The status is atomic, the readers of getSensorStatus() do not take the mutex of the buffer
+    void setStatus(const SensorStatus aStatus) override
+    {
+        this->m_status.store(aStatus, std::memory_order_release);
+    }
+};
+
+class SyntheticAccelerometer : public SyntheticSensor<IAccelerometer>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getLinearAcceleration(Vector3& linearAcceleration) const override
+    {
+        return read(linearAcceleration.data());
+    }
+};
+
+class SyntheticEmgSensor : public SyntheticSensor<IEmgSensor>
+{
+private:
+    const impl::SampleBlockBuffer* m_samples = nullptr;
+
+public:
+    using SyntheticSensor::SyntheticSensor;
+    void setSamples(const impl::SampleBlockBuffer* samples) { m_samples = samples; }
+    bool getSampleBlock(size_t& nextSample, SampleBlock& block) const override
+    {
+        return m_samples && m_samples->read(nextSample, block);
+    }
+    bool getEmgSignal(double& emgSignal) const override
+    {
+        double values[2];
+        if (!read(values)) {
+            return false;
+        }
+        emgSignal = values[0];
+        return true;
+    }
+    bool getNormalizationValue(double& normalizationValue) const override
+    {
+        double values[2];
+        if (!read(values)) {
+            return false;
+        }
+        normalizationValue = values[1];
+        return true;
+    }
+};
+
+class SyntheticForce3DSensor : public SyntheticSensor<IForce3DSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getForce3D(Vector3& force) const override { return read(force.data()); }
+};
+
+class SyntheticForceTorque6DSensor : public SyntheticSensor<IForceTorque6DSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getForceTorque6D(Vector3& force3D, Vector3& torque3D) const override
+    {
+        double values[6];
+        if (!read(values)) {
+            return false;
+        }
+        std::copy(values, values + 3, force3D.begin());
+        std::copy(values + 3, values + 6, torque3D.begin());
+        return true;
+    }
+};
+
+class SyntheticFreeBodyAccelerationSensor : public SyntheticSensor<IFreeBodyAccelerationSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getFreeBodyAcceleration(Vector3& freeBodyAcceleration) const override
+    {
+        return read(freeBodyAcceleration.data());
+    }
+};
+
+class SyntheticGyroscope : public SyntheticSensor<IGyroscope>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getAngularRate(Vector3& angularRate) const override { return read(angularRate.data()); }
+};
+
+class SyntheticMagnetometer : public SyntheticSensor<IMagnetometer>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getMagneticField(Vector3& magneticField) const override
+    {
+        return read(magneticField.data());
+    }
+};
+
+class SyntheticOrientationSensor : public SyntheticSensor<IOrientationSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getOrientationAsQuaternion(Quaternion& orientation) const override
+    {
+        return read(orientation.data());
+    }
+};
+
+class SyntheticPoseSensor : public SyntheticSensor<IPoseSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getPose(Quaternion& orientation, Vector3& position) const override
+    {
+        double values[7];
+        if (!read(values)) {
+            return false;
+        }
+        std::copy(values, values + 4, orientation.begin());
+        std::copy(values + 4, values + 7, position.begin());
+        return true;
+    }
+};
+
+class SyntheticPositionSensor : public SyntheticSensor<IPositionSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getPosition(Vector3& position) const override { return read(position.data()); }
+};
+
+class SyntheticSkinSensor : public SyntheticSensor<ISkinSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getPressure(std::vector<double>& pressure) const override
+    {
+        pressure.resize(m_size);
+        return read(pressure.data());
+    }
+};
+
+class SyntheticTemperatureSensor : public SyntheticSensor<ITemperatureSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getTemperature(double& temperature) const override { return read(&temperature); }
+};
+
+class SyntheticTorque3DSensor : public SyntheticSensor<ITorque3DSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getTorque3D(Vector3& torque) const override { return read(torque.data()); }
+};
+
+class SyntheticVirtualLinkKinSensor : public SyntheticSensor<IVirtualLinkKinSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getLinkAcceleration(Vector3& linear, Vector3& angular) const override
+    {
+        double values[19];
+        if (!read(values)) {
+            return false;
+        }
+        std::copy(values + 13, values + 16, linear.begin());
+        std::copy(values + 16, values + 19, angular.begin());
+        return true;
+    }
+    bool getLinkPose(Vector3& position, Quaternion& orientation) const override
+    {
+        double values[19];
+        if (!read(values)) {
+            return false;
+        }
+        std::copy(values, values + 4, orientation.begin());
+        std::copy(values + 4, values + 7, position.begin());
+        return true;
+    }
+    bool getLinkVelocity(Vector3& linear, Vector3& angular) const override
+    {
+        double values[19];
+        if (!read(values)) {
+            return false;
+        }
+        std::copy(values + 7, values + 10, linear.begin());
+        std::copy(values + 10, values + 13, angular.begin());
+        return true;
+    }
+};
+
+class SyntheticVirtualJointKinSensor : public SyntheticSensor<IVirtualJointKinSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getJointPosition(double& position) const override { return readOne(0, position); }
+    bool getJointVelocity(double& velocity) const override { return readOne(1, velocity); }
+    bool getJointAcceleration(double& acceleration) const override
+    {
+        return readOne(2, acceleration);
+    }
+
+private:
+    bool readOne(const size_t index, double& value) const
+    {
+        double values[3];
+        if (!read(values)) {
+            return false;
+        }
+        value = values[index];
+        return true;
+    }
+};
+
+class SyntheticVirtualSphericalJointKinSensor
+    : public SyntheticSensor<IVirtualSphericalJointKinSensor>
+{
+public:
+    using SyntheticSensor::SyntheticSensor;
+    bool getJointAnglesAsRPY(Vector3& angleAsRPY) const override
+    {
+        return readThree(0, angleAsRPY);
+    }
+    bool getJointVelocities(Vector3& velocities) const override
+    {
+        return readThree(3, velocities);
+    }
+    bool getJointAccelerations(Vector3& accelerations) const override
+    {
+        return readThree(6, accelerations);
+    }
+
+private:
+    bool readThree(const size_t offset, Vector3& value) const
+    {
+        double values[9];
+        if (!read(values)) {
+            return false;
+        }
+        std::copy(values + offset, values + offset + 3, value.begin());
+        return true;
+    }
+};
+
+// ==============
+// IMPL FUNCTIONS
+// ==============
+
+bool IWearSynthetic::Impl::loadPattern(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        yError() << LogPrefix << "Failed to open the pattern file" << fileName;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream stream(line);
+        std::vector<double> sample;
+        double value;
+        while (stream >> value) {
+            sample.push_back(value);
+        }
+        if (!sample.empty()) {
+            pattern.push_back(sample);
+        }
+    }
+
+    if (pattern.empty()) {
+        yError() << LogPrefix << "The pattern file" << fileName << "does not contain samples";
+        return false;
+    }
+    return true;
+}
+
+template <typename Sensor>
+void IWearSynthetic::Impl::addSensors(const SensorType type)
+{
+    const auto it = options.nSensors.find(type);
+    if (it == options.nSensors.end()) {
+        return;
+    }
+
+    const size_t size = getSensorSize(type, options.skinTaxels);
+    const std::string prefix =
+        options.wearableName + wearable::Separator + getSensorPrefix(type);
+
+    for (size_t i = 0; i < it->second; ++i) {
+        const size_t offset = buffer.values.size();
+        auto sensor = std::make_shared<Sensor>(prefix + std::to_string(i), &buffer, offset, size);
+        slots.push_back({type, offset, size, sensor.get()});
+        buffer.values.resize(offset + size, 0.0);
+
+        sensorsByType[type].push_back(sensor);
+        sensorsByName.emplace(sensor->getSensorName(), sensor);
+    }
+}
+
+void IWearSynthetic::Impl::createSensors()
+{
+    addSensors<SyntheticAccelerometer>(SensorType::Accelerometer);
+    addSensors<SyntheticEmgSensor>(SensorType::EmgSensor);
+    addSensors<SyntheticForce3DSensor>(SensorType::Force3DSensor);
+    addSensors<SyntheticForceTorque6DSensor>(SensorType::ForceTorque6DSensor);
+    addSensors<SyntheticFreeBodyAccelerationSensor>(SensorType::FreeBodyAccelerationSensor);
+    addSensors<SyntheticGyroscope>(SensorType::Gyroscope);
+    addSensors<SyntheticMagnetometer>(SensorType::Magnetometer);
+    addSensors<SyntheticOrientationSensor>(SensorType::OrientationSensor);
+    addSensors<SyntheticPoseSensor>(SensorType::PoseSensor);
+    addSensors<SyntheticPositionSensor>(SensorType::PositionSensor);
+    addSensors<SyntheticSkinSensor>(SensorType::SkinSensor);
+    addSensors<SyntheticTemperatureSensor>(SensorType::TemperatureSensor);
+    addSensors<SyntheticTorque3DSensor>(SensorType::Torque3DSensor);
+    addSensors<SyntheticVirtualLinkKinSensor>(SensorType::VirtualLinkKinSensor);
+    addSensors<SyntheticVirtualJointKinSensor>(SensorType::VirtualJointKinSensor);
+    addSensors<SyntheticVirtualSphericalJointKinSensor>(SensorType::VirtualSphericalJointKinSensor);
+
+    if (options.clockSensor) {
+        const size_t offset = buffer.values.size();
+        auto sensor = std::make_shared<SyntheticVirtualJointKinSensor>(
+            options.wearableName + wearable::Separator + IVirtualJointKinSensor::getPrefix()
+                + "clock",
+            &buffer,
+            offset,
+            3);
+        clock = {SensorType::VirtualJointKinSensor, offset, 3, sensor.get()};
+        buffer.values.resize(offset + 3, 0.0);
+
+        sensorsByType[SensorType::VirtualJointKinSensor].push_back(sensor);
+        sensorsByName.emplace(sensor->getSensorName(), sensor);
+    }
+
+    if (options.emgSampleRate > 0) {
+        for (const SensorSlot& slot : slots) {
+            if (slot.type == SensorType::EmgSensor) {
+                emgSamples.push_back({slot.offset, std::make_unique<impl::SampleBlockBuffer>()});
+                static_cast<SyntheticEmgSensor*>(slot.status)
+                    ->setSamples(emgSamples.back().buffer.get());
+            }
+        }
+    }
+
+    nextValues.resize(buffer.values.size(), 0.0);
+    nextStatus.resize(slots.size(), SensorStatus::Ok);
+}
+
+double IWearSynthetic::Impl::signal(const size_t channel,
+                                    const double time,
+                                    const size_t index,
+                                    std::mt19937& generator) const
+{
+    switch (options.signal) {
+        case SignalType::Random:
+            return std::uniform_real_distribution<double>(-1.0, 1.0)(generator);
+        case SignalType::Sine:
+            return std::sin(2 * M_PI * options.frequency * time + 0.1 * channel);
+        case SignalType::Pattern: {
+            const auto& sample = pattern[index % pattern.size()];
+            return sample[channel % sample.size()];
+        }
+    }
+    return 0;
+}
+
+// Generate the next sample. The signals depend only on the sample index and on the seed, so
+// that the same configuration always produces the same data.
+void IWearSynthetic::Impl::generate()
+{
+    const double time = static_cast<double>(tick) * options.period;
+    std::uniform_real_distribution<double> probability(0.0, 1.0);
+
+    for (size_t s = 0; s < slots.size(); ++s) {
+        const SensorSlot& slot = slots[s];
+        double* out = nextValues.data() + slot.offset;
+
+        for (size_t i = 0; i < slot.size; ++i) {
+            out[i] = signal(slot.offset + i, time, tick, dataGenerator);
+        }
+
+        // Keep the quaternions valid and the emg normalization positive
+        switch (slot.type) {
+            case SensorType::OrientationSensor:
+            case SensorType::PoseSensor:
+            case SensorType::VirtualLinkKinSensor: {
+                const Quaternion quaternion =
+                    utils::RPYToQuaternion({out[0] * M_PI, out[1] * M_PI / 2, out[2] * M_PI});
+                std::copy(quaternion.begin(), quaternion.end(), out);
+                break;
+            }
+            case SensorType::EmgSensor:
+                out[1] = 1.0 + std::abs(out[1]);
+                break;
+            default:
+                break;
+        }
+
+        nextStatus[s] = options.errorProbability > 0
+                                && probability(dataGenerator) < options.errorProbability
+                            ? options.errorStatus
+                            : SensorStatus::Ok;
+    }
+
+    tick++;
+}
+
+// Append the samples of the emg signals up to the time of the last generated tick, the time
+// given being the one of its data
+void IWearSynthetic::Impl::appendEmgSamples(const double time)
+{
+    const double rate = options.emgSampleRate;
+    const double tickTime = static_cast<double>(tick - 1) * options.period;
+    const size_t endSample = static_cast<size_t>(std::floor(tickTime * rate + 1e-6)) + 1;
+    if (emgSamples.empty() || endSample <= emgSample) {
+        return;
+    }
+
+    emgBlock.firstSample = emgSample;
+    emgBlock.startTime = time - tickTime + static_cast<double>(emgSample) / rate;
+    emgBlock.samplePeriod = 1.0 / rate;
+    emgBlock.channels = 1;
+    for (EmgSamples& emg : emgSamples) {
+        emgBlock.values.clear();
+        for (size_t k = emgSample; k < endSample; ++k) {
+            emgBlock.values.push_back(
+                signal(emg.channel, static_cast<double>(k) / rate, k, sampleGenerator));
+        }
+        emg.buffer->append(emgBlock);
+    }
+    emgSample = endSample;
+}
+
+// ==============
+// IWearSynthetic
+// ==============
+
+IWearSynthetic::IWearSynthetic()
+    : PeriodicThread(DefaultPeriod)
+    , pImpl{std::make_unique<Impl>()}
+{}
+
+// Without this destructor here, the linker complains for
+// undefined reference to vtable
+IWearSynthetic::~IWearSynthetic() = default;
+
+bool IWearSynthetic::open(yarp::os::Searchable& config)
+{
+    // ===============================
+    // CHECK THE CONFIGURATION OPTIONS
+    // ===============================
+
+    if (!(config.check("sensors") && config.find("sensors").isList())) {
+        yError() << LogPrefix << "Parameter 'sensors' missing or invalid";
+        return false;
+    }
+
+    // ===============
+    // READ PARAMETERS
+    // ===============
+
+    auto& options = pImpl->options;
+    options.wearableName = config.check("wearableName", yarp::os::Value(DeviceName)).asString();
+    options.period = config.check("period", yarp::os::Value(DefaultPeriod)).asFloat64();
+    const int skinTaxels = config.check("skinTaxels", yarp::os::Value(64)).asInt32();
+    options.seed = config.check("seed", yarp::os::Value(0)).asInt32();
+    options.frequency = config.check("frequency", yarp::os::Value(1.0)).asFloat64();
+    options.latency = config.check("latency", yarp::os::Value(0.0)).asFloat64();
+    options.jitter = config.check("jitter", yarp::os::Value(0.0)).asFloat64();
+    options.errorProbability = config.check("errorProbability", yarp::os::Value(0.0)).asFloat64();
+    options.clockSensor = config.check("clockSensor", yarp::os::Value(false)).asBool();
+    options.emgSampleRate = config.check("emgSampleRate", yarp::os::Value(0.0)).asFloat64();
+    options.errorStatus =
+        sensorStatusFromString(config.check("errorStatus", yarp::os::Value("Error")).asString());
+
+    if (options.period <= 0) {
+        yError() << LogPrefix << "Parameter 'period' must be positive";
+        return false;
+    }
+
+    if (options.latency < 0 || options.jitter < 0
+        || options.latency + options.jitter >= options.period) {
+        yError() << LogPrefix << "Parameters 'latency' and 'jitter' must be positive and their"
+                 << "sum must be smaller than 'period'";
+        return false;
+    }
+
+    if (skinTaxels <= 0) {
+        yError() << LogPrefix << "Parameter 'skinTaxels' must be positive";
+        return false;
+    }
+    options.skinTaxels = static_cast<size_t>(skinTaxels);
+
+    if (options.emgSampleRate < 0) {
+        yError() << LogPrefix << "Parameter 'emgSampleRate' must not be negative";
+        return false;
+    }
+
+    const std::string signal = config.check("signal", yarp::os::Value("sine")).asString();
+    if (signal == "random") {
+        options.signal = SignalType::Random;
+    }
+    else if (signal == "sine") {
+        options.signal = SignalType::Sine;
+    }
+    else if (signal == "pattern") {
+        options.signal = SignalType::Pattern;
+        if (!(config.check("patternFile") && config.find("patternFile").isString())) {
+            yError() << LogPrefix << "Parameter 'patternFile' is required by the pattern signal";
+            return false;
+        }
+        options.patternFile = config.find("patternFile").asString();
+        if (!pImpl->loadPattern(options.patternFile)) {
+            return false;
+        }
+    }
+    else {
+        yError() << LogPrefix << "Parameter 'signal' must be random, sine or pattern";
+        return false;
+    }
+
+    // The sensors are configured as a list of (SensorType number)
+    const yarp::os::Bottle* sensorsList = config.find("sensors").asList();
+    for (size_t i = 0; i < sensorsList->size(); ++i) {
+        const yarp::os::Bottle* entry = sensorsList->get(i).asList();
+        if (!entry || entry->size() != 2 || !entry->get(0).isString()
+            || !entry->get(1).isInt32()) {
+            yError() << LogPrefix << "The elements of 'sensors' must be (SensorType number)";
+            return false;
+        }
+
+        const SensorType type = sensorTypeFromString(entry->get(0).asString());
+        if (type == SensorType::Invalid) {
+            yError() << LogPrefix << "Invalid sensor type" << entry->get(0).asString();
+            return false;
+        }
+        options.nSensors[type] = static_cast<size_t>(std::max(0, entry->get(1).asInt32()));
+    }
+
+    pImpl->dataGenerator.seed(options.seed);
+    pImpl->jitterGenerator.seed(options.seed + 1);
+    pImpl->sampleGenerator.seed(options.seed + 2);
+    pImpl->createSensors();
+
+    yInfo() << LogPrefix << "*** ====================";
+    yInfo() << LogPrefix << "*** Wearable name      :" << options.wearableName;
+    yInfo() << LogPrefix << "*** Period             :" << options.period;
+    yInfo() << LogPrefix << "*** Signal             :" << signal;
+    yInfo() << LogPrefix << "*** Seed               :" << options.seed;
+    yInfo() << LogPrefix << "*** Sensors            :" << pImpl->slots.size();
+    for (const auto& entry : options.nSensors) {
+        yInfo() << LogPrefix << "***                     " << sensorTypeToString(entry.first)
+                << entry.second;
+    }
+    yInfo() << LogPrefix << "*** Clock sensor       :" << options.clockSensor;
+    yInfo() << LogPrefix << "*** Emg sample rate    :" << options.emgSampleRate;
+    yInfo() << LogPrefix << "*** Values per sample  :" << pImpl->buffer.values.size();
+    yInfo() << LogPrefix << "*** ====================";
+
+    setPeriod(options.period);
+    if (!start()) {
+        yError() << LogPrefix << "Failed to start the periodic thread";
+        return false;
+    }
+
+    return true;
+}
+
+bool IWearSynthetic::close()
+{
+    if (isRunning()) {
+        stop();
+    }
+    return true;
+}
+
+void IWearSynthetic::run()
+{
+    pImpl->generate();
+    const double generationTime = yarp::os::Time::now();
+
+    // The clock sensor stores the time as position and the sequence number as velocity
+    if (pImpl->clock.status) {
+        pImpl->nextValues[pImpl->clock.offset] = generationTime;
+        pImpl->nextValues[pImpl->clock.offset + 1] =
+            static_cast<double>(pImpl->buffer.timestamp.sequenceNumber + 1);
+    }
+
+    // Simulate the transport latency between the acquisition and the availability of the data
+    const double delay =
+        pImpl->options.latency
+        + std::uniform_real_distribution<double>(0.0, pImpl->options.jitter)(pImpl->jitterGenerator);
+    if (delay > 0) {
+        yarp::os::Time::delay(delay);
+    }
+
+    pImpl->appendEmgSamples(generationTime);
+
+    SyntheticBuffer& buffer = pImpl->buffer;
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    std::swap(buffer.values, pImpl->nextValues);
+    for (size_t s = 0; s < pImpl->slots.size(); ++s) {
+        pImpl->slots[s].status->setStatus(pImpl->nextStatus[s]);
+    }
+    buffer.timestamp.time = generationTime;
+    buffer.timestamp.sequenceNumber++;
+    if (pImpl->clock.status) {
+        pImpl->clock.status->setStatus(SensorStatus::Ok);
+    }
+    buffer.firstRun = false;
+}
+
+yarp::os::Stamp IWearSynthetic::getLastInputStamp()
+{
+    std::lock_guard<std::mutex> lock(pImpl->buffer.mutex);
+    return yarp::os::Stamp(static_cast<int>(pImpl->buffer.timestamp.sequenceNumber),
+                           pImpl->buffer.timestamp.time);
+}
+
+WearableName IWearSynthetic::getWearableName() const
+{
+    return pImpl->options.wearableName + wearable::Separator;
+}
+
+WearStatus IWearSynthetic::getStatus() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->buffer.mutex);
+    return pImpl->buffer.firstRun ? WearStatus::WaitingForFirstRead : WearStatus::Ok;
+}
+
+TimeStamp IWearSynthetic::getTimeStamp() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->buffer.mutex);
+    return pImpl->buffer.timestamp;
+}
+
+SensorPtr<const ISensor> IWearSynthetic::getSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ISensor>(name);
+}
+
+VectorOfSensorPtr<const ISensor> IWearSynthetic::getSensors(const SensorType type) const
+{
+    const auto it = pImpl->sensorsByType.find(type);
+    if (it == pImpl->sensorsByType.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+SensorPtr<const IAccelerometer> IWearSynthetic::getAccelerometer(const SensorName name) const
+{
+    return pImpl->getSensor<IAccelerometer>(name);
+}
+
+SensorPtr<const IEmgSensor> IWearSynthetic::getEmgSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IEmgSensor>(name);
+}
+
+SensorPtr<const IForce3DSensor> IWearSynthetic::getForce3DSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IForce3DSensor>(name);
+}
+
+SensorPtr<const IForceTorque6DSensor>
+IWearSynthetic::getForceTorque6DSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IForceTorque6DSensor>(name);
+}
+
+SensorPtr<const IFreeBodyAccelerationSensor>
+IWearSynthetic::getFreeBodyAccelerationSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IFreeBodyAccelerationSensor>(name);
+}
+
+SensorPtr<const IGyroscope> IWearSynthetic::getGyroscope(const SensorName name) const
+{
+    return pImpl->getSensor<IGyroscope>(name);
+}
+
+SensorPtr<const IMagnetometer> IWearSynthetic::getMagnetometer(const SensorName name) const
+{
+    return pImpl->getSensor<IMagnetometer>(name);
+}
+
+SensorPtr<const IOrientationSensor>
+IWearSynthetic::getOrientationSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IOrientationSensor>(name);
+}
+
+SensorPtr<const IPoseSensor> IWearSynthetic::getPoseSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IPoseSensor>(name);
+}
+
+SensorPtr<const IPositionSensor> IWearSynthetic::getPositionSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IPositionSensor>(name);
+}
+
+SensorPtr<const ISkinSensor> IWearSynthetic::getSkinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ISkinSensor>(name);
+}
+
+SensorPtr<const ITemperatureSensor>
+IWearSynthetic::getTemperatureSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ITemperatureSensor>(name);
+}
+
+SensorPtr<const ITorque3DSensor> IWearSynthetic::getTorque3DSensor(const SensorName name) const
+{
+    return pImpl->getSensor<ITorque3DSensor>(name);
+}
+
+SensorPtr<const IVirtualLinkKinSensor>
+IWearSynthetic::getVirtualLinkKinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IVirtualLinkKinSensor>(name);
+}
+
+SensorPtr<const IVirtualJointKinSensor>
+IWearSynthetic::getVirtualJointKinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IVirtualJointKinSensor>(name);
+}
+
+SensorPtr<const IVirtualSphericalJointKinSensor>
+IWearSynthetic::getVirtualSphericalJointKinSensor(const SensorName name) const
+{
+    return pImpl->getSensor<IVirtualSphericalJointKinSensor>(name);
+}
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include "Paexo.h"
+#include "Wearable/RealTime/RealTime.h"
 
 #include <yarp/os/Bottle.h>
 #include <yarp/os/LogStream.h>
@@ -52,6 +53,10 @@ public:
 
     wearable::TimeStamp timeStamp;
 
+    // Real-time settings and timing of the loop
+    realtime::ThreadSettings threadSettings;
+    realtime::JitterStatistics jitter;
+
     std::string portsPrefix;
     yarp::os::BufferedPort<yarp::os::Bottle> dataPort;
 
@@ -271,6 +276,13 @@ bool Paexo::open(yarp::os::Searchable& config)
         yInfo() << LogPrefix << "Using the period : " << period << "s";
     }
 
+    std::string error;
+    if (!realtime::parseThreadSettings(config, pImpl->threadSettings, error)) {
+        yError() << LogPrefix << error;
+        return false;
+    }
+    pImpl->jitter.setReportPeriod(pImpl->threadSettings.jitterReportPeriod);
+
     // Get port prefix name
     if (!(config.check("portsPrefixName") && config.find("portsPrefixName").isString())) {
         yInfo() << LogPrefix << "Using default port prefix /wearable/paexo";
@@ -727,8 +739,26 @@ void Paexo::PaexoImpl::PaexoMotorControlPort::onRead(yarp::os::Bottle& motorComm
     paexoMotorActuator.get()->setMotorPosition(cmd);
 }
 
+bool Paexo::threadInit()
+{
+    std::string error;
+    if (!realtime::applyThreadSettings(pImpl->threadSettings, error)) {
+        yWarning() << LogPrefix << "Failed to apply the thread settings:" << error;
+    }
+    yInfo() << LogPrefix << "Loop thread settings:" << realtime::toString(pImpl->threadSettings);
+
+    pImpl->jitter.setPeriod(getPeriod());
+    return true;
+}
+
 void Paexo::run()
 {
+    const realtime::ScopedTick jitterTick(pImpl->jitter);
+
+    if (pImpl->jitter.reportDue()) {
+        yInfo() << LogPrefix << "Loop timing:" << pImpl->jitter.summary();
+    }
+
     // Send commands to BLE central serial port
     {
         std::lock_guard<std::mutex> lock(pImpl->mutex);
@@ -855,7 +885,10 @@ bool Paexo::detachAll()
     return detach();
 }
 
-void Paexo::threadRelease() {}
+void Paexo::threadRelease()
+{
+    yInfo() << LogPrefix << "Loop timing:" << pImpl->jitter.summary();
+}
 
 // =========================
 // IPreciselyTimed interface
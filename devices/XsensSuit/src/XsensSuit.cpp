@@ -785,6 +785,14 @@ bool XsensSuit::open(yarp::os::Searchable& config)
                 << saveCurrentCalibration;
     }
 
+    // Real-time settings of the thread processing the samples
+    wearable::realtime::ThreadSettings processorThreadSettings;
+    std::string error;
+    if (!wearable::realtime::parseThreadSettings(config, processorThreadSettings, error)) {
+        yError() << logPrefix << error;
+        return false;
+    }
+
     xsensmvn::DriverConfiguration driverConfig{rundepsFolder,
                                                suitConfiguration,
                                                acquisitionScenario,
@@ -795,7 +803,8 @@ bool XsensSuit::open(yarp::os::Searchable& config)
                                                subjectBodyDimensions,
                                                outputStreamConfig,
                                                saveMVNRecording,
-                                               saveCurrentCalibration};
+                                               saveCurrentCalibration,
+                                               processorThreadSettings};
 
     pImpl->driver.reset(new xsensmvn::XSensMVNDriver(driverConfig));
 
@@ -0,0 +1,863 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Logger/BinaryLog.h"
+#include "Wearable/Logger/TimeSeriesCodec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace wearable::logger;
+using namespace wearable::logger::binary;
+
+const char FileMagic[8] = {'I', 'W', 'L', 'O', 'G', 'B', 'I', 'N'};
+const char TrailerMagic[8] = {'I', 'W', 'L', 'O', 'G', 'E', 'N', 'D'};
+constexpr uint32_t ChunkMagic = 0x4B435749; // "IWCK"
+constexpr uint32_t FooterMagic = 0x58495749; // "IWIX"
+constexpr size_t ChunkHeaderSize = 48;
+constexpr size_t TrailerSize = 16;
+// Smallest channel of the header: empty name and type, and the size
+constexpr size_t MinChannelSize = 3 * sizeof(uint32_t);
+constexpr size_t FooterEntrySize = 32;
+
+// ==============
+// Payload coding
+// ==============
+
+// Raw payload of a chunk with n samples, C channels and V values:
+// time (n x double), sequence number (n x int32), valid (C*n x uint8), values (V*n x double)
+static size_t rawPayloadSize(const size_t nSamples, const size_t nChannels, const size_t nValues)
+{
+    return nSamples * (sizeof(double) + sizeof(int32_t) + nChannels + nValues * sizeof(double));
+}
+
+// XOR each element with the previous one of the column and transpose the bytes of
+// the column, so that the most significant bytes (that rarely change) end up contiguous
+template <typename T>
+static void encodeColumn(const T* column, const size_t n, uint8_t* out)
+{
+    constexpr size_t width = sizeof(T);
+    uint64_t previous = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &column[i], width);
+        const uint64_t residual = bits ^ previous;
+        previous = bits;
+        for (size_t b = 0; b < width; ++b) {
+            out[b * n + i] = static_cast<uint8_t>(residual >> (8 * b));
+        }
+    }
+}
+
+template <typename T>
+static void decodeColumn(const uint8_t* in, const size_t n, T* column)
+{
+    constexpr size_t width = sizeof(T);
+    uint64_t previous = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t residual = 0;
+        for (size_t b = 0; b < width; ++b) {
+            residual |= static_cast<uint64_t>(in[b * n + i]) << (8 * b);
+        }
+        const uint64_t bits = residual ^ previous;
+        previous = bits;
+        std::memcpy(&column[i], &bits, width);
+    }
+}
+
+// Zero bytes are stored as a (0, run length) pair, all the other bytes as they are
+static void encodeZeroRuns(const std::vector<uint8_t>& in, std::vector<uint8_t>& out)
+{
+    out.clear();
+    out.reserve(in.size());
+    for (size_t i = 0; i < in.size();) {
+        if (in[i] != 0) {
+            out.push_back(in[i++]);
+            continue;
+        }
+        size_t run = 0;
+        while (i < in.size() && in[i] == 0 && run < 255) {
+            ++run;
+            ++i;
+        }
+        out.push_back(0);
+        out.push_back(static_cast<uint8_t>(run));
+    }
+}
+
+static bool decodeZeroRuns(const std::vector<uint8_t>& in, std::vector<uint8_t>& out)
+{
+    size_t pos = 0;
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (in[i] != 0) {
+            if (pos >= out.size()) {
+                return false;
+            }
+            out[pos++] = in[i];
+            continue;
+        }
+        if (++i >= in.size() || pos + in[i] > out.size()) {
+            return false;
+        }
+        std::fill_n(out.begin() + pos, in[i], 0);
+        pos += in[i];
+    }
+    return pos == out.size();
+}
+
+// Gorilla payload: the time (as the integer with the same bits) and the sequence numbers coded
+// with delta of delta, the validity flags as a bitmap, and each value column coded with XOR.
+// The columns of the chunk being written have the given stride.
+static void encodeGorillaPayload(const Chunk& chunk,
+                                 const size_t stride,
+                                 const size_t nChannels,
+                                 const size_t nValues,
+                                 std::vector<int64_t>& integers,
+                                 std::vector<uint8_t>& out)
+{
+    const size_t n = chunk.nSamples;
+    out.clear();
+    integers.resize(n);
+
+    std::memcpy(integers.data(), chunk.time.data(), n * sizeof(double));
+    codec::encodeDeltaOfDelta(integers.data(), n, out);
+
+    std::copy_n(chunk.sequenceNumber.begin(), n, integers.begin());
+    codec::encodeDeltaOfDelta(integers.data(), n, out);
+
+    codec::BitWriter writer(out);
+    for (size_t channel = 0; channel < nChannels; ++channel) {
+        for (size_t i = 0; i < n; ++i) {
+            writer.write(chunk.valid[channel * stride + i] != 0, 1);
+        }
+    }
+    writer.flush();
+
+    for (size_t column = 0; column < nValues; ++column) {
+        codec::encodeXor(&chunk.values[column * stride], n, out);
+    }
+}
+
+static bool decodeGorillaPayload(const std::vector<uint8_t>& in,
+                                 const size_t nChannels,
+                                 const size_t nValues,
+                                 std::vector<int64_t>& integers,
+                                 Chunk& data)
+{
+    const size_t n = data.nSamples;
+    const uint8_t* position = in.data();
+    const uint8_t* const end = in.data() + in.size();
+    integers.resize(n);
+
+    size_t read = codec::decodeDeltaOfDelta(position, end - position, n, integers.data());
+    if (read == 0) {
+        return false;
+    }
+    std::memcpy(data.time.data(), integers.data(), n * sizeof(double));
+    position += read;
+
+    read = codec::decodeDeltaOfDelta(position, end - position, n, integers.data());
+    if (read == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        data.sequenceNumber[i] = static_cast<int32_t>(integers[i]);
+    }
+    position += read;
+
+    codec::BitReader reader(position, end - position);
+    for (size_t i = 0; i < n * nChannels; ++i) {
+        data.valid[i] = reader.readBit() ? 1 : 0;
+    }
+    if (reader.overflow()) {
+        return false;
+    }
+    position += reader.getBytesRead();
+
+    for (size_t column = 0; column < nValues; ++column) {
+        read = codec::decodeXor(position, end - position, n, &data.values[column * n]);
+        if (read == 0) {
+            return false;
+        }
+        position += read;
+    }
+
+    return position == end;
+}
+
+template <typename T>
+static bool readValue(std::ifstream& file, T& value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Bytes of the file following the read position
+static uint64_t remainingBytes(std::ifstream& file, const uint64_t fileSize)
+{
+    const std::streamoff position = file.tellg();
+    if (position < 0 || static_cast<uint64_t>(position) > fileSize) {
+        return 0;
+    }
+    return fileSize - static_cast<uint64_t>(position);
+}
+
+static bool readString(std::ifstream& file, std::string& str, const uint64_t fileSize)
+{
+    uint32_t length = 0;
+    if (!readValue(file, length) || length > remainingBytes(file, fileSize)) {
+        return false;
+    }
+    str.resize(length);
+    return length == 0 || static_cast<bool>(file.read(&str[0], length));
+}
+
+// ======
+// Writer
+// ======
+
+Writer::~Writer()
+{
+    close();
+}
+
+bool Writer::write(const void* data, const size_t size)
+{
+    if (!m_file.write(static_cast<const char*>(data), size)) {
+        m_lastError = "Failed to write to " + m_fileName;
+        return false;
+    }
+    m_bytesWritten += size;
+    return true;
+}
+
+bool Writer::open(const std::string& fileName,
+                  const std::vector<Channel>& channels,
+                  const WriterOptions& options)
+{
+    if (m_file.is_open()) {
+        m_lastError = "The writer is already open on " + m_fileName;
+        return false;
+    }
+
+    if (options.chunkSize == 0) {
+        m_lastError = "The chunk size must be positive";
+        return false;
+    }
+
+    m_file.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        m_lastError = "Failed to open " + fileName;
+        return false;
+    }
+
+    m_fileName = fileName;
+    m_channels = channels;
+    m_options = options;
+    m_bytesWritten = 0;
+    m_index.clear();
+
+    m_nValues = 0;
+    for (const auto& channel : m_channels) {
+        m_nValues += channel.size;
+    }
+
+    // The chunk buffers are allocated once, with a stride of chunkSize samples
+    m_chunk.nSamples = 0;
+    m_chunk.time.assign(m_options.chunkSize, 0.0);
+    m_chunk.sequenceNumber.assign(m_options.chunkSize, 0);
+    m_chunk.valid.assign(m_options.chunkSize * m_channels.size(), 0);
+    m_chunk.values.assign(m_options.chunkSize * m_nValues, 0.0);
+    m_rawPayload.reserve(rawPayloadSize(m_options.chunkSize, m_channels.size(), m_nValues));
+    m_payload.reserve(m_rawPayload.capacity());
+
+    return writeHeader();
+}
+
+bool Writer::isOpen() const
+{
+    return m_file.is_open();
+}
+
+bool Writer::writeHeader()
+{
+    const uint32_t version = FormatVersion;
+    const uint32_t nChannels = static_cast<uint32_t>(m_channels.size());
+
+    bool ok = write(FileMagic, sizeof(FileMagic));
+    ok = ok && write(&version, sizeof(version));
+    ok = ok && write(&nChannels, sizeof(nChannels));
+
+    for (const auto& channel : m_channels) {
+        const uint32_t nameLength = static_cast<uint32_t>(channel.name.size());
+        const uint32_t typeLength = static_cast<uint32_t>(channel.type.size());
+        ok = ok && write(&nameLength, sizeof(nameLength));
+        ok = ok && write(channel.name.data(), nameLength);
+        ok = ok && write(&typeLength, sizeof(typeLength));
+        ok = ok && write(channel.type.data(), typeLength);
+        ok = ok && write(&channel.size, sizeof(channel.size));
+    }
+
+    return ok && static_cast<bool>(m_file.flush());
+}
+
+bool Writer::append(const double time,
+                    const int32_t sequenceNumber,
+                    const double* values,
+                    const uint8_t* valid)
+{
+    if (!m_file.is_open()) {
+        m_lastError = "The writer is not open";
+        return false;
+    }
+
+    const size_t stride = m_options.chunkSize;
+    const size_t sample = m_chunk.nSamples;
+
+    m_chunk.time[sample] = time;
+    m_chunk.sequenceNumber[sample] = sequenceNumber;
+    for (size_t channel = 0; channel < m_channels.size(); ++channel) {
+        m_chunk.valid[channel * stride + sample] = valid[channel];
+    }
+    for (size_t column = 0; column < m_nValues; ++column) {
+        m_chunk.values[column * stride + sample] = values[column];
+    }
+
+    if (++m_chunk.nSamples == stride) {
+        return flush();
+    }
+    return true;
+}
+
+bool Writer::flush()
+{
+    if (!m_file.is_open() || m_chunk.nSamples == 0) {
+        return true;
+    }
+
+    const size_t n = m_chunk.nSamples;
+    const size_t stride = m_options.chunkSize;
+    const size_t nChannels = m_channels.size();
+    const bool compress = m_options.compression == Compression::XorRle;
+    const uint64_t rawSize = rawPayloadSize(n, nChannels, m_nValues);
+
+    if (m_options.compression == Compression::Gorilla) {
+        encodeGorillaPayload(m_chunk, stride, nChannels, m_nValues, m_integers, m_payload);
+        return writeChunk(m_payload, rawSize);
+    }
+
+    m_rawPayload.resize(rawSize);
+    uint8_t* out = m_rawPayload.data();
+
+    if (compress) {
+        encodeColumn(m_chunk.time.data(), n, out);
+    }
+    else {
+        std::memcpy(out, m_chunk.time.data(), n * sizeof(double));
+    }
+    out += n * sizeof(double);
+
+    if (compress) {
+        encodeColumn(m_chunk.sequenceNumber.data(), n, out);
+    }
+    else {
+        std::memcpy(out, m_chunk.sequenceNumber.data(), n * sizeof(int32_t));
+    }
+    out += n * sizeof(int32_t);
+
+    for (size_t channel = 0; channel < nChannels; ++channel) {
+        std::memcpy(out, &m_chunk.valid[channel * stride], n);
+        out += n;
+    }
+
+    for (size_t column = 0; column < m_nValues; ++column) {
+        if (compress) {
+            encodeColumn(&m_chunk.values[column * stride], n, out);
+        }
+        else {
+            std::memcpy(out, &m_chunk.values[column * stride], n * sizeof(double));
+        }
+        out += n * sizeof(double);
+    }
+
+    if (compress) {
+        encodeZeroRuns(m_rawPayload, m_payload);
+        return writeChunk(m_payload, rawSize);
+    }
+    return writeChunk(m_rawPayload, rawSize);
+}
+
+// Write the header of the chunk and its payload, and add the chunk to the index
+bool Writer::writeChunk(const std::vector<uint8_t>& payload, const uint64_t rawSize)
+{
+    const size_t n = m_chunk.nSamples;
+
+    ChunkIndex entry;
+    entry.offset = m_bytesWritten;
+    entry.nSamples = static_cast<uint32_t>(n);
+    entry.startTime = m_chunk.time[0];
+    entry.endTime = m_chunk.time[n - 1];
+
+    const uint32_t magic = ChunkMagic;
+    const uint32_t compression = static_cast<uint32_t>(m_options.compression);
+    const uint32_t reserved = 0;
+    const uint64_t storedSize = payload.size();
+
+    bool ok = write(&magic, sizeof(magic));
+    ok = ok && write(&entry.nSamples, sizeof(entry.nSamples));
+    ok = ok && write(&compression, sizeof(compression));
+    ok = ok && write(&reserved, sizeof(reserved));
+    ok = ok && write(&entry.startTime, sizeof(entry.startTime));
+    ok = ok && write(&entry.endTime, sizeof(entry.endTime));
+    ok = ok && write(&rawSize, sizeof(rawSize));
+    ok = ok && write(&storedSize, sizeof(storedSize));
+    ok = ok && write(payload.data(), payload.size());
+
+    // Flush every chunk, so that a crash loses at most the samples of the current chunk
+    ok = ok && static_cast<bool>(m_file.flush());
+
+    m_chunk.nSamples = 0;
+    if (ok) {
+        m_index.push_back(entry);
+    }
+    return ok;
+}
+
+bool Writer::writeFooter()
+{
+    const uint64_t footerOffset = m_bytesWritten;
+    const uint32_t magic = FooterMagic;
+    const uint32_t nChunks = static_cast<uint32_t>(m_index.size());
+    const uint32_t reserved = 0;
+
+    bool ok = write(&magic, sizeof(magic));
+    ok = ok && write(&nChunks, sizeof(nChunks));
+    for (const auto& entry : m_index) {
+        ok = ok && write(&entry.offset, sizeof(entry.offset));
+        ok = ok && write(&entry.nSamples, sizeof(entry.nSamples));
+        ok = ok && write(&reserved, sizeof(reserved));
+        ok = ok && write(&entry.startTime, sizeof(entry.startTime));
+        ok = ok && write(&entry.endTime, sizeof(entry.endTime));
+    }
+    ok = ok && write(&footerOffset, sizeof(footerOffset));
+    ok = ok && write(TrailerMagic, sizeof(TrailerMagic));
+
+    return ok;
+}
+
+bool Writer::close()
+{
+    if (!m_file.is_open()) {
+        return true;
+    }
+
+    bool ok = flush();
+    ok = ok && writeFooter();
+    m_file.close();
+
+    return ok;
+}
+
+uint64_t Writer::getBytesWritten() const
+{
+    return m_bytesWritten;
+}
+
+const std::string& Writer::getLastError() const
+{
+    return m_lastError;
+}
+
+// ======
+// Reader
+// ======
+
+bool Reader::open(const std::string& fileName)
+{
+    close();
+
+    m_file.open(fileName, std::ios::in | std::ios::binary);
+    if (!m_file.is_open()) {
+        m_lastError = "Failed to open " + fileName;
+        return false;
+    }
+
+    m_file.seekg(0, std::ios::end);
+    m_fileSize = static_cast<uint64_t>(m_file.tellg());
+    m_file.seekg(0);
+
+    if (!readHeader()) {
+        close();
+        return false;
+    }
+
+    const uint64_t firstChunkOffset = static_cast<uint64_t>(m_file.tellg());
+
+    m_hasFooter = readFooter();
+    if (!m_hasFooter && !scanChunks(firstChunkOffset)) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void Reader::close()
+{
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_file.clear();
+    m_channels.clear();
+    m_channelOffsets.clear();
+    m_index.clear();
+    m_nValues = 0;
+    m_fileSize = 0;
+    m_hasFooter = false;
+}
+
+bool Reader::readHeader()
+{
+    char magic[sizeof(FileMagic)];
+    if (!m_file.read(magic, sizeof(magic)) || std::memcmp(magic, FileMagic, sizeof(magic))) {
+        m_lastError = "The file is not a wearable binary log";
+        return false;
+    }
+
+    uint32_t version = 0;
+    uint32_t nChannels = 0;
+    if (!readValue(m_file, version) || version != FormatVersion) {
+        m_lastError = "Unsupported binary log version " + std::to_string(version);
+        return false;
+    }
+
+    if (!readValue(m_file, nChannels)) {
+        m_lastError = "Truncated header";
+        return false;
+    }
+
+    // Check the number of channels before allocating them
+    if (nChannels > remainingBytes(m_file, m_fileSize) / MinChannelSize) {
+        m_lastError = "Corrupted header, " + std::to_string(nChannels)
+                      + " channels do not fit in the file";
+        return false;
+    }
+
+    m_channels.resize(nChannels);
+    m_channelOffsets.resize(nChannels);
+    for (size_t i = 0; i < nChannels; ++i) {
+        Channel& channel = m_channels[i];
+        if (!readString(m_file, channel.name, m_fileSize)
+            || !readString(m_file, channel.type, m_fileSize) || !readValue(m_file, channel.size)) {
+            m_lastError = "Truncated header";
+            return false;
+        }
+        m_channelOffsets[i] = m_nValues;
+        m_nValues += channel.size;
+    }
+
+    return true;
+}
+
+bool Reader::readFooter()
+{
+    const uint64_t fileSize = m_fileSize;
+    if (fileSize < TrailerSize) {
+        return false;
+    }
+
+    uint64_t footerOffset = 0;
+    char magic[sizeof(TrailerMagic)];
+    m_file.seekg(fileSize - TrailerSize);
+    if (!readValue(m_file, footerOffset) || !m_file.read(magic, sizeof(magic))
+        || std::memcmp(magic, TrailerMagic, sizeof(magic)) || footerOffset >= fileSize) {
+        m_file.clear();
+        return false;
+    }
+
+    uint32_t footerMagic = 0;
+    uint32_t nChunks = 0;
+    m_file.seekg(footerOffset);
+    if (!readValue(m_file, footerMagic) || footerMagic != FooterMagic
+        || !readValue(m_file, nChunks)
+        || nChunks > remainingBytes(m_file, m_fileSize) / FooterEntrySize) {
+        m_file.clear();
+        return false;
+    }
+
+    m_index.resize(nChunks);
+    for (auto& entry : m_index) {
+        uint32_t reserved = 0;
+        if (!readValue(m_file, entry.offset) || !readValue(m_file, entry.nSamples)
+            || !readValue(m_file, reserved) || !readValue(m_file, entry.startTime)
+            || !readValue(m_file, entry.endTime)) {
+            m_file.clear();
+            m_index.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Reader::scanChunks(const uint64_t firstChunkOffset)
+{
+    m_file.clear();
+    const uint64_t fileSize = m_fileSize;
+
+    m_index.clear();
+    uint64_t offset = firstChunkOffset;
+    while (offset + ChunkHeaderSize <= fileSize) {
+        m_file.seekg(offset);
+
+        ChunkIndex entry;
+        uint32_t magic = 0;
+        uint32_t compression = 0;
+        uint32_t reserved = 0;
+        uint64_t rawSize = 0;
+        uint64_t storedSize = 0;
+        if (!readValue(m_file, magic) || magic != ChunkMagic
+            || !readValue(m_file, entry.nSamples) || !readValue(m_file, compression)
+            || !readValue(m_file, reserved) || !readValue(m_file, entry.startTime)
+            || !readValue(m_file, entry.endTime) || !readValue(m_file, rawSize)
+            || !readValue(m_file, storedSize)) {
+            break;
+        }
+
+        // Stop at the first incomplete chunk
+        if (storedSize > fileSize - offset - ChunkHeaderSize) {
+            break;
+        }
+
+        entry.offset = offset;
+        m_index.push_back(entry);
+        offset += ChunkHeaderSize + storedSize;
+    }
+
+    m_file.clear();
+    return true;
+}
+
+const std::vector<Channel>& Reader::getChannels() const
+{
+    return m_channels;
+}
+
+const std::vector<ChunkIndex>& Reader::getIndex() const
+{
+    return m_index;
+}
+
+bool Reader::hasFooter() const
+{
+    return m_hasFooter;
+}
+
+size_t Reader::getNumberOfSamples() const
+{
+    size_t nSamples = 0;
+    for (const auto& entry : m_index) {
+        nSamples += entry.nSamples;
+    }
+    return nSamples;
+}
+
+double Reader::getStartTime() const
+{
+    return m_index.empty() ? 0.0 : m_index.front().startTime;
+}
+
+double Reader::getEndTime() const
+{
+    return m_index.empty() ? 0.0 : m_index.back().endTime;
+}
+
+size_t Reader::getChannelIndex(const std::string& name) const
+{
+    for (size_t i = 0; i < m_channels.size(); ++i) {
+        if (m_channels[i].name == name) {
+            return i;
+        }
+    }
+    return m_channels.size();
+}
+
+size_t Reader::getChannelOffset(const size_t channel) const
+{
+    return m_channelOffsets.at(channel);
+}
+
+bool Reader::readChunk(const size_t chunk, Chunk& data) const
+{
+    if (chunk >= m_index.size()) {
+        m_lastError = "Chunk " + std::to_string(chunk) + " does not exist";
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t nSamples = 0;
+    uint32_t compression = 0;
+    uint32_t reserved = 0;
+    double startTime = 0;
+    double endTime = 0;
+    uint64_t rawSize = 0;
+    uint64_t storedSize = 0;
+
+    m_file.clear();
+    m_file.seekg(m_index[chunk].offset);
+    if (!readValue(m_file, magic) || magic != ChunkMagic || !readValue(m_file, nSamples)
+        || !readValue(m_file, compression) || !readValue(m_file, reserved)
+        || !readValue(m_file, startTime) || !readValue(m_file, endTime)
+        || !readValue(m_file, rawSize) || !readValue(m_file, storedSize)) {
+        m_lastError = "Corrupted header of chunk " + std::to_string(chunk);
+        return false;
+    }
+
+    // The payload is allocated only once known to fit in the file, and the raw size only if it
+    // does not overflow
+    if (storedSize > remainingBytes(m_file, m_fileSize)) {
+        m_lastError = "Truncated chunk " + std::to_string(chunk);
+        return false;
+    }
+
+    const size_t n = nSamples;
+    const size_t nChannels = m_channels.size();
+    const size_t sampleSize = sizeof(double) + sizeof(int32_t) + nChannels;
+    if (m_nValues > (std::numeric_limits<size_t>::max() - sampleSize) / sizeof(double)
+        || (n > 0
+            && sampleSize + m_nValues * sizeof(double)
+                   > std::numeric_limits<size_t>::max() / n)
+        || rawSize != rawPayloadSize(n, nChannels, m_nValues)) {
+        m_lastError = "Unexpected size of chunk " + std::to_string(chunk);
+        return false;
+    }
+
+    // The samples are allocated only if the stored payload can hold them: a zero run expands 2
+    // bytes to at most 255, and the Gorilla coding takes at least a bit for each sample of each
+    // column and validity flag
+    bool fits = false;
+    switch (static_cast<Compression>(compression)) {
+        case Compression::None:
+            fits = storedSize == rawSize;
+            break;
+        case Compression::XorRle:
+            fits = rawSize / 128 <= storedSize;
+            break;
+        case Compression::Gorilla:
+            fits = n * (2 + nChannels + m_nValues) / 8 <= storedSize;
+            break;
+        default:
+            m_lastError = "Unsupported compression of chunk " + std::to_string(chunk);
+            return false;
+    }
+    if (!fits) {
+        m_lastError = "Unexpected size of chunk " + std::to_string(chunk);
+        return false;
+    }
+
+    m_payload.resize(storedSize);
+    if (storedSize > 0
+        && !m_file.read(reinterpret_cast<char*>(m_payload.data()), storedSize)) {
+        m_lastError = "Truncated chunk " + std::to_string(chunk);
+        return false;
+    }
+
+    data.nSamples = n;
+    data.time.resize(n);
+    data.sequenceNumber.resize(n);
+    data.valid.resize(n * nChannels);
+    data.values.resize(n * m_nValues);
+
+    if (static_cast<Compression>(compression) == Compression::Gorilla) {
+        if (!decodeGorillaPayload(m_payload, nChannels, m_nValues, m_integers, data)) {
+            m_lastError = "Corrupted payload of chunk " + std::to_string(chunk);
+            return false;
+        }
+        return true;
+    }
+
+    const bool compressed = static_cast<Compression>(compression) == Compression::XorRle;
+    if (compressed) {
+        m_rawPayload.resize(rawSize);
+        if (!decodeZeroRuns(m_payload, m_rawPayload)) {
+            m_lastError = "Corrupted payload of chunk " + std::to_string(chunk);
+            return false;
+        }
+    }
+
+    const uint8_t* in = compressed ? m_rawPayload.data() : m_payload.data();
+
+    if (compressed) {
+        decodeColumn(in, n, data.time.data());
+        in += n * sizeof(double);
+        decodeColumn(in, n, data.sequenceNumber.data());
+        in += n * sizeof(int32_t);
+        std::memcpy(data.valid.data(), in, n * nChannels);
+        in += n * nChannels;
+        for (size_t column = 0; column < m_nValues; ++column) {
+            decodeColumn(in, n, &data.values[column * n]);
+            in += n * sizeof(double);
+        }
+    }
+    else {
+        std::memcpy(data.time.data(), in, n * sizeof(double));
+        in += n * sizeof(double);
+        std::memcpy(data.sequenceNumber.data(), in, n * sizeof(int32_t));
+        in += n * sizeof(int32_t);
+        std::memcpy(data.valid.data(), in, n * nChannels);
+        in += n * nChannels;
+        std::memcpy(data.values.data(), in, n * m_nValues * sizeof(double));
+    }
+
+    return true;
+}
+
+bool Reader::readChannel(const size_t channel,
+                         const double startTime,
+                         const double endTime,
+                         std::vector<double>& time,
+                         std::vector<double>& values) const
+{
+    time.clear();
+    values.clear();
+
+    if (channel >= m_channels.size()) {
+        m_lastError = "Channel " + std::to_string(channel) + " does not exist";
+        return false;
+    }
+
+    const size_t size = m_channels[channel].size;
+    const size_t offset = m_channelOffsets[channel];
+
+    // Chunks are sorted by time, skip the ones ending before the requested range
+    auto it = std::lower_bound(
+        m_index.begin(), m_index.end(), startTime, [](const ChunkIndex& entry, double t) {
+            return entry.endTime < t;
+        });
+
+    Chunk data;
+    for (; it != m_index.end() && it->startTime <= endTime; ++it) {
+        if (!readChunk(static_cast<size_t>(it - m_index.begin()), data)) {
+            return false;
+        }
+
+        const size_t n = data.nSamples;
+        for (size_t sample = 0; sample < n; ++sample) {
+            const double t = data.time[sample];
+            if (t < startTime || t > endTime || !data.valid[channel * n + sample]) {
+                continue;
+            }
+            time.push_back(t);
+            for (size_t column = offset; column < offset + size; ++column) {
+                values.push_back(data.values[column * n + sample]);
+            }
+        }
+    }
+
+    return true;
+}
+
+const std::string& Reader::getLastError() const
+{
+    return m_lastError;
+}
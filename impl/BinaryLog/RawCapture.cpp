@@ -0,0 +1,273 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Logger/RawCapture.h"
+
+#include <cstring>
+
+using namespace wearable::logger::raw;
+
+const char CaptureMagic[8] = {'I', 'W', 'R', 'A', 'W', 'C', 'A', 'P'};
+
+template <typename T>
+static bool readValue(std::ifstream& file, T& value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Bytes of the file following the read position
+static uint64_t remainingBytes(std::ifstream& file, const uint64_t fileSize)
+{
+    const std::streamoff position = file.tellg();
+    if (position < 0 || static_cast<uint64_t>(position) > fileSize) {
+        return 0;
+    }
+    return fileSize - static_cast<uint64_t>(position);
+}
+
+// =============
+// CaptureWriter
+// =============
+
+CaptureWriter::~CaptureWriter()
+{
+    close();
+}
+
+bool CaptureWriter::write(const void* data, const size_t size)
+{
+    if (!m_file.write(static_cast<const char*>(data), size)) {
+        m_lastError = "Failed to write to " + m_fileName;
+        return false;
+    }
+    m_bytesWritten += size;
+    return true;
+}
+
+bool CaptureWriter::open(const std::string& fileName, const std::vector<std::string>& streams)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_file.is_open()) {
+        m_lastError = "The writer is already open on " + m_fileName;
+        return false;
+    }
+
+    m_file.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        m_lastError = "Failed to open " + fileName;
+        return false;
+    }
+
+    m_fileName = fileName;
+    m_nStreams = streams.size();
+    m_nRecords = 0;
+    m_bytesWritten = 0;
+
+    const uint32_t version = FormatVersion;
+    const uint32_t nStreams = static_cast<uint32_t>(streams.size());
+
+    bool ok = write(CaptureMagic, sizeof(CaptureMagic));
+    ok = ok && write(&version, sizeof(version));
+    ok = ok && write(&nStreams, sizeof(nStreams));
+    for (const auto& stream : streams) {
+        const uint32_t length = static_cast<uint32_t>(stream.size());
+        ok = ok && write(&length, sizeof(length));
+        ok = ok && write(stream.data(), length);
+    }
+
+    return ok && static_cast<bool>(m_file.flush());
+}
+
+bool CaptureWriter::isOpen()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_file.is_open();
+}
+
+bool CaptureWriter::append(const uint32_t stream,
+                           const int32_t sequenceNumber,
+                           const double time,
+                           const double receptionTime,
+                           const char* message,
+                           const size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_file.is_open()) {
+        m_lastError = "The writer is not open";
+        return false;
+    }
+
+    if (stream >= m_nStreams) {
+        m_lastError = "Stream " + std::to_string(stream) + " does not exist";
+        return false;
+    }
+
+    const uint32_t messageSize = static_cast<uint32_t>(size);
+
+    bool ok = write(&stream, sizeof(stream));
+    ok = ok && write(&sequenceNumber, sizeof(sequenceNumber));
+    ok = ok && write(&time, sizeof(time));
+    ok = ok && write(&receptionTime, sizeof(receptionTime));
+    ok = ok && write(&messageSize, sizeof(messageSize));
+    ok = ok && write(message, size);
+
+    if (ok) {
+        m_nRecords++;
+    }
+    return ok;
+}
+
+bool CaptureWriter::flush()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_file.is_open() || static_cast<bool>(m_file.flush());
+}
+
+bool CaptureWriter::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_file.is_open()) {
+        return true;
+    }
+
+    const bool ok = static_cast<bool>(m_file.flush());
+    m_file.close();
+    return ok;
+}
+
+uint64_t CaptureWriter::getNumberOfRecords()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nRecords;
+}
+
+uint64_t CaptureWriter::getBytesWritten()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytesWritten;
+}
+
+std::string CaptureWriter::getLastError()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastError;
+}
+
+// =============
+// CaptureReader
+// =============
+
+bool CaptureReader::open(const std::string& fileName)
+{
+    close();
+    m_lastError.clear();
+
+    m_file.open(fileName, std::ios::in | std::ios::binary);
+    if (!m_file.is_open()) {
+        m_lastError = "Failed to open " + fileName;
+        return false;
+    }
+
+    m_file.seekg(0, std::ios::end);
+    m_fileSize = static_cast<uint64_t>(m_file.tellg());
+    m_file.seekg(0);
+
+    char magic[sizeof(CaptureMagic)];
+    uint32_t version = 0;
+    uint32_t nStreams = 0;
+    if (!m_file.read(magic, sizeof(magic)) || std::memcmp(magic, CaptureMagic, sizeof(magic))) {
+        m_lastError = "The file is not a wearable raw capture";
+        close();
+        return false;
+    }
+
+    if (!readValue(m_file, version) || version != FormatVersion
+        || !readValue(m_file, nStreams)) {
+        m_lastError = "Unsupported raw capture version " + std::to_string(version);
+        close();
+        return false;
+    }
+
+    // Each stream takes at least the length of its name
+    if (nStreams > remainingBytes(m_file, m_fileSize) / sizeof(uint32_t)) {
+        m_lastError = "Corrupted header, " + std::to_string(nStreams)
+                      + " streams do not fit in the file";
+        close();
+        return false;
+    }
+
+    m_streams.resize(nStreams);
+    for (auto& stream : m_streams) {
+        uint32_t length = 0;
+        if (!readValue(m_file, length) || length > remainingBytes(m_file, m_fileSize)) {
+            m_lastError = "Truncated header";
+            close();
+            return false;
+        }
+        stream.resize(length);
+        if (length > 0 && !m_file.read(&stream[0], length)) {
+            m_lastError = "Truncated header";
+            close();
+            return false;
+        }
+    }
+
+    m_firstRecordOffset = static_cast<uint64_t>(m_file.tellg());
+    return true;
+}
+
+void CaptureReader::close()
+{
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_file.clear();
+    m_streams.clear();
+    m_firstRecordOffset = 0;
+    m_fileSize = 0;
+}
+
+const std::vector<std::string>& CaptureReader::getStreams() const
+{
+    return m_streams;
+}
+
+bool CaptureReader::next(Record& record)
+{
+    if (!m_file.is_open()) {
+        return false;
+    }
+
+    uint32_t size = 0;
+    if (!readValue(m_file, record.stream) || !readValue(m_file, record.sequenceNumber)
+        || !readValue(m_file, record.time) || !readValue(m_file, record.receptionTime)
+        || !readValue(m_file, size)) {
+        return false;
+    }
+
+    if (record.stream >= m_streams.size()) {
+        m_lastError = "Record of the unknown stream " + std::to_string(record.stream);
+        return false;
+    }
+    if (size > remainingBytes(m_file, m_fileSize)) {
+        m_lastError = "Truncated record of " + std::to_string(size) + " bytes";
+        return false;
+    }
+
+    record.message.resize(size);
+    return size == 0 || static_cast<bool>(m_file.read(record.message.data(), size));
+}
+
+void CaptureReader::rewind()
+{
+    m_file.clear();
+    m_file.seekg(m_firstRecordOffset);
+}
+
+const std::string& CaptureReader::getLastError() const
+{
+    return m_lastError;
+}
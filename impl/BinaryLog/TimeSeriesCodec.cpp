@@ -0,0 +1,306 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Logger/TimeSeriesCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace wearable::logger::codec;
+
+static uint64_t lowMask(const unsigned nBits)
+{
+    return nBits >= 64 ? ~uint64_t(0) : (uint64_t(1) << nBits) - 1;
+}
+
+// The argument must not be zero
+static unsigned countLeadingZeros(const uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, x);
+    return 63 - static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_clzll(x));
+#endif
+}
+
+// The argument must not be zero
+static unsigned countTrailingZeros(const uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+// Map the signed values to unsigned ones with small magnitude: 0, -1, 1, -2, 2, ...
+static uint64_t zigZagEncode(const int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t zigZagDecode(const uint64_t value)
+{
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// =========
+// BitWriter
+// =========
+
+void BitWriter::write(const uint64_t value, const unsigned nBits)
+{
+    unsigned remaining = nBits;
+    while (remaining > 0) {
+        const unsigned take = std::min(remaining, 64 - m_nBits);
+        const uint64_t bits = (value >> (remaining - take)) & lowMask(take);
+        m_buffer = take == 64 ? bits : (m_buffer << take) | bits;
+        m_nBits += take;
+        remaining -= take;
+
+        if (m_nBits == 64) {
+            for (int b = 7; b >= 0; --b) {
+                m_out.push_back(static_cast<uint8_t>(m_buffer >> (8 * b)));
+            }
+            m_buffer = 0;
+            m_nBits = 0;
+        }
+    }
+}
+
+void BitWriter::flush()
+{
+    while (m_nBits >= 8) {
+        m_nBits -= 8;
+        m_out.push_back(static_cast<uint8_t>(m_buffer >> m_nBits));
+    }
+    if (m_nBits > 0) {
+        m_out.push_back(static_cast<uint8_t>(m_buffer << (8 - m_nBits)));
+    }
+    m_buffer = 0;
+    m_nBits = 0;
+}
+
+// =========
+// BitReader
+// =========
+
+uint64_t BitReader::read(const unsigned nBits)
+{
+    // The buffer holds at most 63 bits, the longer reads are split
+    if (nBits > 56) {
+        const uint64_t high = read(nBits - 32);
+        return (high << 32) | read(32);
+    }
+
+    while (m_nBits < nBits) {
+        m_buffer <<= 8;
+        if (m_position < m_size) {
+            m_buffer |= m_in[m_position++];
+        }
+        else {
+            m_overflow = true;
+        }
+        m_nBits += 8;
+    }
+
+    m_nBits -= nBits;
+    return (m_buffer >> m_nBits) & lowMask(nBits);
+}
+
+// =========
+// XOR codec
+// =========
+
+void wearable::logger::codec::encodeXor(const double* values,
+                                        const size_t n,
+                                        std::vector<uint8_t>& out)
+{
+    if (n == 0) {
+        return;
+    }
+
+    BitWriter writer(out);
+
+    uint64_t previous = 0;
+    std::memcpy(&previous, &values[0], sizeof(double));
+    writer.write(previous, 64);
+
+    // The window of the meaningful bits of the last residual stored with its own window.
+    // Initially there is no window, so that the first residual stores it.
+    unsigned windowLeading = 64;
+    unsigned windowTrailing = 64;
+
+    for (size_t i = 1; i < n; ++i) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &values[i], sizeof(double));
+        const uint64_t residual = bits ^ previous;
+        previous = bits;
+
+        if (residual == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+
+        const unsigned leading = countLeadingZeros(residual);
+        const unsigned trailing = countTrailingZeros(residual);
+
+        // 10: the meaningful bits fit in the previous window. A new window is stored anyway when
+        // its 12 bits of header are less than the bits wasted by the previous one.
+        const unsigned length = 64 - leading - trailing;
+        if (leading >= windowLeading && trailing >= windowTrailing
+            && 64 - windowLeading - windowTrailing <= length + 12) {
+            writer.write(0b10, 2);
+            writer.write(residual >> windowTrailing, 64 - windowLeading - windowTrailing);
+            continue;
+        }
+
+        // 11: new window, with 6 bits of leading zeros and 6 bits of length minus one
+        writer.write(0b11, 2);
+        writer.write(leading, 6);
+        writer.write(length - 1, 6);
+        writer.write(residual >> trailing, length);
+        windowLeading = leading;
+        windowTrailing = trailing;
+    }
+
+    writer.flush();
+}
+
+size_t wearable::logger::codec::decodeXor(const uint8_t* in,
+                                          const size_t size,
+                                          const size_t n,
+                                          double* values)
+{
+    if (n == 0) {
+        return 0;
+    }
+
+    BitReader reader(in, size);
+
+    uint64_t previous = reader.read(64);
+    std::memcpy(&values[0], &previous, sizeof(double));
+
+    bool hasWindow = false;
+    unsigned windowTrailing = 0;
+    unsigned windowLength = 0;
+
+    for (size_t i = 1; i < n; ++i) {
+        if (reader.readBit()) {
+            if (reader.readBit()) {
+                const unsigned leading = static_cast<unsigned>(reader.read(6));
+                windowLength = static_cast<unsigned>(reader.read(6)) + 1;
+                if (leading + windowLength > 64) {
+                    return 0;
+                }
+                windowTrailing = 64 - leading - windowLength;
+                hasWindow = true;
+            }
+            else if (!hasWindow) {
+                return 0;
+            }
+            previous ^= reader.read(windowLength) << windowTrailing;
+        }
+        std::memcpy(&values[i], &previous, sizeof(double));
+    }
+
+    return reader.overflow() ? 0 : reader.getBytesRead();
+}
+
+// ====================
+// Delta of delta codec
+// ====================
+
+void wearable::logger::codec::encodeDeltaOfDelta(const int64_t* values,
+                                                 const size_t n,
+                                                 std::vector<uint8_t>& out)
+{
+    if (n == 0) {
+        return;
+    }
+
+    BitWriter writer(out);
+
+    // The differences wrap around, so that any sequence of integers is coded losslessly
+    uint64_t previous = static_cast<uint64_t>(values[0]);
+    uint64_t previousDelta = 0;
+    writer.write(previous, 64);
+
+    for (size_t i = 1; i < n; ++i) {
+        const uint64_t value = static_cast<uint64_t>(values[i]);
+        const uint64_t delta = value - previous;
+        const uint64_t deltaOfDelta = zigZagEncode(static_cast<int64_t>(delta - previousDelta));
+        previous = value;
+        previousDelta = delta;
+
+        if (deltaOfDelta == 0) {
+            writer.write(0, 1);
+        }
+        else if (deltaOfDelta < (uint64_t(1) << 7)) {
+            writer.write(0b10, 2);
+            writer.write(deltaOfDelta, 7);
+        }
+        else if (deltaOfDelta < (uint64_t(1) << 9)) {
+            writer.write(0b110, 3);
+            writer.write(deltaOfDelta, 9);
+        }
+        else if (deltaOfDelta < (uint64_t(1) << 12)) {
+            writer.write(0b1110, 4);
+            writer.write(deltaOfDelta, 12);
+        }
+        else {
+            writer.write(0b1111, 4);
+            writer.write(deltaOfDelta, 64);
+        }
+    }
+
+    writer.flush();
+}
+
+size_t wearable::logger::codec::decodeDeltaOfDelta(const uint8_t* in,
+                                                   const size_t size,
+                                                   const size_t n,
+                                                   int64_t* values)
+{
+    if (n == 0) {
+        return 0;
+    }
+
+    BitReader reader(in, size);
+
+    uint64_t previous = reader.read(64);
+    uint64_t previousDelta = 0;
+    values[0] = static_cast<int64_t>(previous);
+
+    for (size_t i = 1; i < n; ++i) {
+        uint64_t deltaOfDelta = 0;
+        if (reader.readBit()) {
+            if (!reader.readBit()) {
+                deltaOfDelta = reader.read(7);
+            }
+            else if (!reader.readBit()) {
+                deltaOfDelta = reader.read(9);
+            }
+            else if (!reader.readBit()) {
+                deltaOfDelta = reader.read(12);
+            }
+            else {
+                deltaOfDelta = reader.read(64);
+            }
+        }
+
+        previousDelta += static_cast<uint64_t>(zigZagDecode(deltaOfDelta));
+        previous += previousDelta;
+        values[i] = static_cast<int64_t>(previous);
+    }
+
+    return reader.overflow() ? 0 : reader.getBytesRead();
+}
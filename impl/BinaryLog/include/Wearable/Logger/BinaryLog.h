@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_LOGGER_BINARYLOG_H
+#define WEARABLE_LOGGER_BINARYLOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Streaming columnar binary log.
+//
+// The file is append-only and composed by:
+// - a header with the list of channels (name, sensor type and number of values);
+// - a sequence of self-describing chunks, each storing a bounded number of samples
+//   as columns (time, sequence number, validity of each channel, one column per value);
+// - a footer with the index of the chunks (file offset and time range), used for
+//   random access by time.
+//
+// Chunks are written as soon as they are full, so the memory used by the writer is
+// bounded by the chunk size. If the footer is missing (e.g. the logger crashed) the
+// reader rebuilds the index by scanning the chunks.
+// All the numbers are stored with the native (little-endian) byte order.
+
+namespace wearable {
+    namespace logger {
+        namespace binary {
+            enum class Compression : uint32_t
+            {
+                // Plain little-endian columns
+                None = 0,
+                // XOR with the previous value of the column, byte shuffling and
+                // run-length encoding of the zero bytes
+                XorRle = 1,
+                // Delta of delta coding of the time and of the sequence numbers, one bit per
+                // validity flag and XOR coding of the values with bit packing (see
+                // TimeSeriesCodec.h)
+                Gorilla = 2,
+            };
+
+            struct Channel
+            {
+                std::string name;
+                std::string type;
+                uint32_t size = 0;
+            };
+
+            struct ChunkIndex
+            {
+                uint64_t offset = 0;
+                uint32_t nSamples = 0;
+                double startTime = 0;
+                double endTime = 0;
+            };
+
+            // Columnar block of samples. Values are stored column-major:
+            // values[column * nSamples + sample], where the columns of each channel are
+            // contiguous and ordered as the channels in the header.
+            struct Chunk
+            {
+                size_t nSamples = 0;
+                std::vector<double> time;
+                std::vector<int32_t> sequenceNumber;
+                std::vector<uint8_t> valid; // valid[channel * nSamples + sample]
+                std::vector<double> values;
+            };
+
+            struct WriterOptions
+            {
+                size_t chunkSize = 1000;
+                Compression compression = Compression::XorRle;
+            };
+
+            class Writer;
+            class Reader;
+
+            constexpr uint32_t FormatVersion = 1;
+        } // namespace binary
+    } // namespace logger
+} // namespace wearable
+
+class wearable::logger::binary::Writer
+{
+private:
+    std::ofstream m_file;
+    std::string m_fileName;
+    std::vector<Channel> m_channels;
+    WriterOptions m_options;
+    size_t m_nValues = 0;
+    uint64_t m_bytesWritten = 0;
+
+    Chunk m_chunk;
+    std::vector<ChunkIndex> m_index;
+    std::vector<uint8_t> m_rawPayload;
+    std::vector<uint8_t> m_payload;
+    std::vector<int64_t> m_integers;
+
+    std::string m_lastError;
+
+    bool writeHeader();
+    bool writeChunk(const std::vector<uint8_t>& payload, const uint64_t rawSize);
+    bool writeFooter();
+    bool write(const void* data, const size_t size);
+
+public:
+    Writer() = default;
+    ~Writer();
+
+    Writer(const Writer& other) = delete;
+    Writer& operator=(const Writer& other) = delete;
+
+    bool open(const std::string& fileName,
+              const std::vector<Channel>& channels,
+              const WriterOptions& options = {});
+    bool isOpen() const;
+
+    // values contains the values of all the channels ordered as in the header,
+    // valid contains a flag for each channel
+    bool append(const double time,
+                const int32_t sequenceNumber,
+                const double* values,
+                const uint8_t* valid);
+
+    // Write the samples stored in the current chunk
+    bool flush();
+    // Write the pending samples and the footer
+    bool close();
+
+    uint64_t getBytesWritten() const;
+    const std::string& getLastError() const;
+};
+
+class wearable::logger::binary::Reader
+{
+private:
+    mutable std::ifstream m_file;
+    std::vector<Channel> m_channels;
+    std::vector<size_t> m_channelOffsets;
+    std::vector<ChunkIndex> m_index;
+    size_t m_nValues = 0;
+    uint64_t m_fileSize = 0;
+    bool m_hasFooter = false;
+
+    mutable std::vector<uint8_t> m_payload;
+    mutable std::vector<uint8_t> m_rawPayload;
+    mutable std::vector<int64_t> m_integers;
+    mutable std::string m_lastError;
+
+    bool readHeader();
+    bool readFooter();
+    bool scanChunks(const uint64_t firstChunkOffset);
+
+public:
+    Reader() = default;
+
+    Reader(const Reader& other) = delete;
+    Reader& operator=(const Reader& other) = delete;
+
+    bool open(const std::string& fileName);
+    void close();
+
+    const std::vector<Channel>& getChannels() const;
+    const std::vector<ChunkIndex>& getIndex() const;
+    // False if the index was rebuilt because the footer is missing
+    bool hasFooter() const;
+
+    size_t getNumberOfSamples() const;
+    double getStartTime() const;
+    double getEndTime() const;
+
+    // Return the index of the channel in the header, or the number of channels if missing
+    size_t getChannelIndex(const std::string& name) const;
+    // Position of the first value of the channel in the value columns
+    size_t getChannelOffset(const size_t channel) const;
+
+    bool readChunk(const size_t chunk, Chunk& data) const;
+
+    // Read the samples in the [startTime, endTime] time range of a channel.
+    // values is filled row-major (one row of getChannels()[channel].size values per sample),
+    // samples in which the channel was not valid are skipped.
+    bool readChannel(const size_t channel,
+                     const double startTime,
+                     const double endTime,
+                     std::vector<double>& time,
+                     std::vector<double>& values) const;
+
+    const std::string& getLastError() const;
+};
+
+#endif // WEARABLE_LOGGER_BINARYLOG_H
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_LOGGER_RAWCAPTURE_H
+#define WEARABLE_LOGGER_RAWCAPTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Append-only capture of serialized messages.
+//
+// The file is composed by a header with the names of the captured streams (e.g. the
+// names of the source ports), followed by one record per received message storing the
+// stream index, the envelope (sequence number and time), the reception time and the
+// serialized message as it was received. The content of the messages is opaque.
+// A truncated record at the end of the file (e.g. after a crash) is ignored by the reader.
+
+namespace wearable {
+    namespace logger {
+        namespace raw {
+            struct Record
+            {
+                uint32_t stream = 0;
+                int32_t sequenceNumber = 0;
+                double time = 0;
+                double receptionTime = 0;
+                std::vector<char> message;
+            };
+
+            class CaptureWriter;
+            class CaptureReader;
+
+            constexpr uint32_t FormatVersion = 1;
+        } // namespace raw
+    } // namespace logger
+} // namespace wearable
+
+class wearable::logger::raw::CaptureWriter
+{
+private:
+    std::mutex m_mutex;
+    std::ofstream m_file;
+    std::string m_fileName;
+    size_t m_nStreams = 0;
+    uint64_t m_nRecords = 0;
+    uint64_t m_bytesWritten = 0;
+    std::string m_lastError;
+
+    bool write(const void* data, const size_t size);
+
+public:
+    CaptureWriter() = default;
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter& other) = delete;
+    CaptureWriter& operator=(const CaptureWriter& other) = delete;
+
+    bool open(const std::string& fileName, const std::vector<std::string>& streams);
+    bool isOpen();
+
+    // Thread safe, it can be called concurrently by the callbacks of different streams
+    bool append(const uint32_t stream,
+                const int32_t sequenceNumber,
+                const double time,
+                const double receptionTime,
+                const char* message,
+                const size_t size);
+
+    bool flush();
+    bool close();
+
+    uint64_t getNumberOfRecords();
+    uint64_t getBytesWritten();
+    std::string getLastError();
+};
+
+class wearable::logger::raw::CaptureReader
+{
+private:
+    std::ifstream m_file;
+    std::vector<std::string> m_streams;
+    uint64_t m_firstRecordOffset = 0;
+    uint64_t m_fileSize = 0;
+    std::string m_lastError;
+
+public:
+    CaptureReader() = default;
+
+    CaptureReader(const CaptureReader& other) = delete;
+    CaptureReader& operator=(const CaptureReader& other) = delete;
+
+    bool open(const std::string& fileName);
+    void close();
+
+    const std::vector<std::string>& getStreams() const;
+
+    // Read the next record, return false at the end of the file or at a corrupted record, whose
+    // error is returned by getLastError
+    bool next(Record& record);
+    // Restart reading from the first record
+    void rewind();
+
+    const std::string& getLastError() const;
+};
+
+#endif // WEARABLE_LOGGER_RAWCAPTURE_H
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_LOGGER_TIMESERIESCODEC_H
+#define WEARABLE_LOGGER_TIMESERIESCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Lossless codecs of time series, storing each series as a byte aligned stream of bits.
+//
+// - XOR coding of doubles (as in the Gorilla time series database): each value is XORed with
+//   the previous one, a repeated value takes one bit and for the others only the meaningful
+//   bits of the residual are stored, reusing the window of leading and trailing zeros of the
+//   previous residual when it fits without wasting too many bits. Repeated values and values
+//   with few significant bits (e.g. converted from float or fixed point readings) take a few
+//   bits, full precision noise takes close to the 64 bits.
+// - Delta of delta coding of integers: regularly spaced values (e.g. sequence numbers, or
+//   timestamps reinterpreted as integers) take one bit per value, and small irregularities
+//   take 9 to 16 bits.
+//
+// The bits are stored most significant first, and every encoded series starts at a byte boundary.
+
+namespace wearable {
+    namespace logger {
+        namespace codec {
+            class BitWriter;
+            class BitReader;
+
+            // Append the encoded series to out
+            void encodeXor(const double* values, const size_t n, std::vector<uint8_t>& out);
+            void encodeDeltaOfDelta(const int64_t* values,
+                                    const size_t n,
+                                    std::vector<uint8_t>& out);
+
+            // Decode a series of n values, return the number of bytes read or 0 if the input
+            // is truncated or corrupted
+            size_t decodeXor(const uint8_t* in, const size_t size, const size_t n, double* values);
+            size_t decodeDeltaOfDelta(const uint8_t* in,
+                                      const size_t size,
+                                      const size_t n,
+                                      int64_t* values);
+        } // namespace codec
+    } // namespace logger
+} // namespace wearable
+
+class wearable::logger::codec::BitWriter
+{
+private:
+    std::vector<uint8_t>& m_out;
+    uint64_t m_buffer = 0;
+    unsigned m_nBits = 0;
+
+public:
+    explicit BitWriter(std::vector<uint8_t>& out)
+        : m_out(out)
+    {}
+
+    // Write the nBits (up to 64) least significant bits of value
+    void write(const uint64_t value, const unsigned nBits);
+    // Write the pending bits, padding the last byte with zeros
+    void flush();
+};
+
+class wearable::logger::codec::BitReader
+{
+private:
+    const uint8_t* m_in;
+    const size_t m_size;
+    size_t m_position = 0;
+    uint64_t m_buffer = 0;
+    unsigned m_nBits = 0;
+    bool m_overflow = false;
+
+public:
+    BitReader(const uint8_t* in, const size_t size)
+        : m_in(in)
+        , m_size(size)
+    {}
+
+    // Read nBits (up to 64), the missing bits after the end of the input are zeros
+    uint64_t read(const unsigned nBits);
+    bool readBit() { return read(1) != 0; }
+
+    // Bytes consumed, including the partially read one
+    size_t getBytesRead() const { return m_position; }
+    // True if the reads went past the end of the input
+    bool overflow() const { return m_overflow; }
+};
+
+#endif // WEARABLE_LOGGER_TIMESERIESCODEC_H
@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Logger/BinaryLog.h"
+#include "Wearable/TestUtils/Check.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace wearable::logger::binary;
+using wearable::test::check;
+
+static const std::string logFile = "testBinaryLogReader.iwlog";
+static const std::string corruptedFile = "testBinaryLogReaderCorrupted.iwlog";
+
+static std::vector<char> readFile(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::in | std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), {});
+}
+
+static void writeFile(const std::string& fileName, const std::vector<char>& bytes)
+{
+    std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), bytes.size());
+}
+
+template <typename T>
+static void overwrite(std::vector<char>& bytes, const size_t offset, const T value)
+{
+    std::memcpy(&bytes.at(offset), &value, sizeof(T));
+}
+
+static bool writeLog(const Compression compression)
+{
+    const std::vector<Channel> channels = {{"acc", "Accelerometer", 3}, {"emg", "EmgSensor", 2}};
+    WriterOptions options;
+    options.chunkSize = 10;
+    options.compression = compression;
+
+    Writer writer;
+    if (!writer.open(logFile, channels, options)) {
+        std::cerr << writer.getLastError() << std::endl;
+        return false;
+    }
+    for (int i = 0; i < 25; ++i) {
+        const double values[5] = {0.1 * i, 9.81, -0.5 * i, static_cast<double>(i % 3), 100.0};
+        const uint8_t valid[2] = {1, static_cast<uint8_t>(i % 2)};
+        writer.append(0.01 * i, i, values, valid);
+    }
+    return writer.close();
+}
+
+// Opening the file and reading all its chunks either succeeds or fails with an error
+static bool readAll(const std::string& fileName, std::string& error)
+{
+    Reader reader;
+    if (!reader.open(fileName)) {
+        error = reader.getLastError();
+        return false;
+    }
+    Chunk chunk;
+    for (size_t i = 0; i < reader.getIndex().size(); ++i) {
+        if (!reader.readChunk(i, chunk)) {
+            error = reader.getLastError();
+            return false;
+        }
+    }
+    return true;
+}
+
+static void checkRejected(const std::vector<char>& bytes, const std::string& name)
+{
+    writeFile(corruptedFile, bytes);
+    std::string error;
+    check(!readAll(corruptedFile, error), name + " accepted");
+    check(!error.empty(), name + " rejected without an error");
+}
+
+static void testCorruptedFile(const Compression compression)
+{
+    const std::string name = "compression " + std::to_string(static_cast<uint32_t>(compression));
+    check(writeLog(compression), name + ": failed to write the log");
+
+    std::string error;
+    Reader reader;
+    check(reader.open(logFile) && reader.hasFooter(), name + ": " + reader.getLastError());
+    check(reader.getNumberOfSamples() == 25 && reader.getIndex().size() == 3,
+          name + ": wrong number of samples or chunks");
+    const uint64_t firstChunk = reader.getIndex().at(0).offset;
+    reader.close();
+
+    const std::vector<char> valid = readFile(logFile);
+
+    // Layout: magic (8), version (4), channels (4), ...
+    std::vector<char> bytes = valid;
+    overwrite<uint32_t>(bytes, 12, 0xFFFFFFFF);
+    checkRejected(bytes, name + ": number of channels beyond the file");
+
+    bytes = valid;
+    overwrite<uint32_t>(bytes, 16, 0x7FFFFFFF);
+    checkRejected(bytes, name + ": channel name beyond the file");
+
+    // Chunk header: magic (4), samples (4), ..., raw size (8) and stored size (8) at the end of
+    // its 48 bytes. The raw size of a sample is 8 + 4 + 2 channels + 5 values * 8 = 54.
+    bytes = valid;
+    overwrite<uint32_t>(bytes, firstChunk + 4, 0xFFFFFFFF);
+    overwrite<uint64_t>(bytes, firstChunk + 32, uint64_t(0xFFFFFFFF) * 54);
+    checkRejected(bytes, name + ": samples beyond the stored size");
+
+    bytes = valid;
+    overwrite<uint64_t>(bytes, firstChunk + 40, UINT64_MAX - 10);
+    checkRejected(bytes, name + ": stored size beyond the file");
+
+    bytes = valid;
+    overwrite<uint64_t>(bytes, firstChunk + 40, bytes.size());
+    checkRejected(bytes, name + ": stored size of the whole file");
+
+    // Without the footer the index is rebuilt, stopping at the chunk beyond the file
+    bytes = valid;
+    bytes.resize(bytes.size() - 1);
+    overwrite<uint64_t>(bytes, firstChunk + 40, UINT64_MAX - 10);
+    writeFile(corruptedFile, bytes);
+    check(reader.open(corruptedFile) && !reader.hasFooter() && reader.getIndex().empty(),
+          name + ": chunk beyond the file indexed without the footer");
+    reader.close();
+
+    // Any truncation opens the chunks left, or fails with an error
+    for (size_t size = 0; size < valid.size(); ++size) {
+        bytes.assign(valid.begin(), valid.begin() + size);
+        writeFile(corruptedFile, bytes);
+        error.clear();
+        check(readAll(corruptedFile, error) || !error.empty(),
+              name + ": truncated to " + std::to_string(size) + " bytes failed without an error");
+    }
+}
+
+static void testNumberOfChunks()
+{
+    check(writeLog(Compression::XorRle), "failed to write the log");
+    std::vector<char> bytes = readFile(logFile);
+
+    // Trailer: footer offset (8) and magic (8), the footer starts with its magic and the number
+    // of chunks. A footer with too many chunks is ignored and the index rebuilt.
+    uint64_t footerOffset = 0;
+    std::memcpy(&footerOffset, &bytes.at(bytes.size() - 16), sizeof(footerOffset));
+    overwrite<uint32_t>(bytes, footerOffset + 4, 0xFFFFFFFF);
+    writeFile(corruptedFile, bytes);
+
+    Reader reader;
+    check(reader.open(corruptedFile) && !reader.hasFooter() && reader.getIndex().size() == 3,
+          "footer with too many chunks not ignored");
+}
+
+int main()
+{
+    testCorruptedFile(Compression::None);
+    testCorruptedFile(Compression::XorRle);
+    testCorruptedFile(Compression::Gorilla);
+    testNumberOfChunks();
+
+    std::remove(logFile.c_str());
+    std::remove(corruptedFile.c_str());
+
+    return wearable::test::exitStatus();
+}
@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Logger/RawCapture.h"
+#include "Wearable/TestUtils/Check.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace wearable::logger::raw;
+using wearable::test::check;
+
+static const std::string captureFile = "testRawCapture.iwraw";
+static const std::string corruptedFile = "testRawCaptureCorrupted.iwraw";
+
+// Layout: magic (8), version (4), streams (4), then the length and the name of each stream
+static const std::vector<std::string> streams = {"/a", "/bb"};
+static const size_t firstRecord = 16 + 4 + 2 + 4 + 3;
+
+static std::vector<char> readFile(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::in | std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), {});
+}
+
+static void writeFile(const std::string& fileName, const std::vector<char>& bytes)
+{
+    std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), bytes.size());
+}
+
+template <typename T>
+static void overwrite(std::vector<char>& bytes, const size_t offset, const T value)
+{
+    std::memcpy(&bytes.at(offset), &value, sizeof(T));
+}
+
+// Number of records read before the end of the file or an error
+static size_t readAll(const std::string& fileName, std::string& error)
+{
+    CaptureReader reader;
+    if (!reader.open(fileName)) {
+        error = reader.getLastError();
+        return 0;
+    }
+    size_t nRecords = 0;
+    Record record;
+    while (reader.next(record)) {
+        ++nRecords;
+    }
+    error = reader.getLastError();
+    return nRecords;
+}
+
+static void testCorruptedFile()
+{
+    CaptureWriter writer;
+    check(writer.open(captureFile, streams), "failed to open the writer");
+    const std::string message = "a message of the stream";
+    for (int i = 0; i < 10; ++i) {
+        writer.append(i % 2, i, 0.1 * i, 0.1 * i + 0.01, message.data(), message.size());
+    }
+    check(writer.close(), "failed to close the writer");
+
+    std::string error;
+    check(readAll(captureFile, error) == 10 && error.empty(), "valid capture not read: " + error);
+
+    const std::vector<char> valid = readFile(captureFile);
+
+    std::vector<char> bytes = valid;
+    overwrite<uint32_t>(bytes, 12, 0xFFFFFFFF);
+    writeFile(corruptedFile, bytes);
+    check(readAll(corruptedFile, error) == 0 && !error.empty(),
+          "number of streams beyond the file accepted");
+
+    bytes = valid;
+    overwrite<uint32_t>(bytes, 16, 0x7FFFFFFF);
+    writeFile(corruptedFile, bytes);
+    check(readAll(corruptedFile, error) == 0 && !error.empty(),
+          "stream name beyond the file accepted");
+
+    // Record: stream (4), sequence number (4), time (8), reception time (8), size (4), message
+    const size_t recordSize = 28 + message.size();
+    bytes = valid;
+    overwrite<uint32_t>(bytes, firstRecord + recordSize + 24, 0xFFFFFFFF);
+    writeFile(corruptedFile, bytes);
+    check(readAll(corruptedFile, error) == 1 && !error.empty(),
+          "message beyond the file accepted");
+
+    bytes = valid;
+    overwrite<uint32_t>(bytes, firstRecord + 2 * recordSize, 2);
+    writeFile(corruptedFile, bytes);
+    check(readAll(corruptedFile, error) == 2 && !error.empty(), "unknown stream accepted");
+
+    // A truncated record ends the capture
+    for (size_t size = firstRecord; size < valid.size(); ++size) {
+        bytes.assign(valid.begin(), valid.begin() + size);
+        writeFile(corruptedFile, bytes);
+        check(readAll(corruptedFile, error) == (size - firstRecord) / recordSize,
+              "wrong records of the capture truncated to " + std::to_string(size) + " bytes");
+    }
+}
+
+int main()
+{
+    testCorruptedFile();
+
+    std::remove(captureFile.c_str());
+    std::remove(corruptedFile.c_str());
+
+    return wearable::test::exitStatus();
+}
@@ -0,0 +1,238 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Logger/TimeSeriesCodec.h"
+#include "Wearable/TestUtils/Check.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace wearable::logger::codec;
+using wearable::test::check;
+
+static std::mt19937_64 generator(5);
+
+// The XOR codec is lossless: the decoded values have the same bits, NaN payloads included
+static bool sameBits(const std::vector<double>& a, const std::vector<double>& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+static void checkXor(const std::vector<double>& values, const std::string& name)
+{
+    std::vector<uint8_t> encoded;
+    encodeXor(values.data(), values.size(), encoded);
+
+    std::vector<double> decoded(values.size());
+    const size_t bytes = decodeXor(encoded.data(), encoded.size(), values.size(), decoded.data());
+    check(bytes == encoded.size(), name + ": read " + std::to_string(bytes) + " bytes of "
+                                       + std::to_string(encoded.size()));
+    check(sameBits(decoded, values), name + ": wrong values");
+
+    // Any truncation is detected
+    for (size_t size = 0; size < encoded.size(); ++size) {
+        check(decodeXor(encoded.data(), size, values.size(), decoded.data()) == 0,
+              name + ": truncated to " + std::to_string(size) + " bytes accepted");
+    }
+}
+
+static void checkDeltaOfDelta(const std::vector<int64_t>& values, const std::string& name)
+{
+    std::vector<uint8_t> encoded;
+    encodeDeltaOfDelta(values.data(), values.size(), encoded);
+
+    std::vector<int64_t> decoded(values.size());
+    const size_t bytes =
+        decodeDeltaOfDelta(encoded.data(), encoded.size(), values.size(), decoded.data());
+    check(bytes == encoded.size(), name + ": read " + std::to_string(bytes) + " bytes of "
+                                       + std::to_string(encoded.size()));
+    check(decoded == values, name + ": wrong values");
+
+    for (size_t size = 0; size < encoded.size(); ++size) {
+        check(decodeDeltaOfDelta(encoded.data(), size, values.size(), decoded.data()) == 0,
+              name + ": truncated to " + std::to_string(size) + " bytes accepted");
+    }
+}
+
+static void testXor()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    const double denormal = std::numeric_limits<double>::denorm_min();
+
+    checkXor({1.5}, "single value");
+    checkXor(std::vector<double>(1000, 9.81), "constant");
+    checkXor({0.0, -0.0, nan, -nan, inf, -inf, denormal, -denormal, 1e308, 0.0, 0.0},
+             "special values");
+
+    uint64_t payloadBits = 0x7FF0000000000ABCull;
+    double payloadNan = 0;
+    std::memcpy(&payloadNan, &payloadBits, sizeof(double));
+    checkXor({payloadNan, 1.0, payloadNan}, "NaN with a payload");
+
+    std::vector<double> values;
+    for (size_t i = 0; i < 500; ++i) {
+        values.push_back(0.001 * i);
+    }
+    checkXor(values, "ramp");
+
+    // Values converted from float readings, with few significant bits
+    std::normal_distribution<float> reading(0, 10);
+    values.clear();
+    for (size_t i = 0; i < 500; ++i) {
+        values.push_back(reading(generator));
+    }
+    checkXor(values, "float readings");
+
+    // Full precision noise, and values changing the leading zeros of the residuals
+    std::uniform_int_distribution<uint64_t> anyBits;
+    values.clear();
+    for (size_t i = 0; i < 500; ++i) {
+        const uint64_t bits = anyBits(generator) >> (i % 64);
+        double value = 0;
+        std::memcpy(&value, &bits, sizeof(double));
+        values.push_back(i % 3 == 0 ? value : std::ldexp(1.0 + i, static_cast<int>(i % 40)));
+    }
+    checkXor(values, "random bits");
+
+    // Repeated values take one bit
+    std::vector<uint8_t> encoded;
+    const std::vector<double> constant(1000, -3.25);
+    encodeXor(constant.data(), constant.size(), encoded);
+    check(encoded.size() == 8 + (999 + 7) / 8, "constant series not coded with one bit each");
+
+    // Series appended one after the other start at a byte boundary
+    encoded.clear();
+    const std::vector<double> first = {1.0, 2.0, 3.0};
+    const std::vector<double> second = {-7.5, -7.5, 100.0, 0.1};
+    encodeXor(first.data(), first.size(), encoded);
+    const size_t firstSize = encoded.size();
+    encodeXor(second.data(), second.size(), encoded);
+    std::vector<double> decoded(second.size());
+    check(decodeXor(encoded.data() + firstSize,
+                    encoded.size() - firstSize,
+                    second.size(),
+                    decoded.data())
+                  == encoded.size() - firstSize
+              && sameBits(decoded, second),
+          "second series of the buffer");
+}
+
+static void testDeltaOfDelta()
+{
+    const int64_t min = std::numeric_limits<int64_t>::min();
+    const int64_t max = std::numeric_limits<int64_t>::max();
+
+    checkDeltaOfDelta({42}, "single value");
+    checkDeltaOfDelta({min, max, min, 0, -1, max, max, min}, "extreme values");
+
+    std::vector<int64_t> values;
+    for (int64_t i = 0; i < 1000; ++i) {
+        values.push_back(1000000 + 10 * i);
+    }
+    checkDeltaOfDelta(values, "regular sequence");
+
+    std::vector<uint8_t> encoded;
+    encodeDeltaOfDelta(values.data(), values.size(), encoded);
+    // The first delta takes 9 bits, then one bit per value
+    check(encoded.size() <= 8 + (9 + 998 + 7) / 8, "regular sequence not coded with one bit each");
+
+    // Irregularities of every class of the code
+    std::uniform_int_distribution<int64_t> jitter(-3000, 3000);
+    values.clear();
+    int64_t time = -5000;
+    for (size_t i = 0; i < 1000; ++i) {
+        time += 1000 + (i % 7 == 0 ? jitter(generator) : 0) + (i % 101 == 0 ? 1000000 : 0);
+        values.push_back(time);
+    }
+    checkDeltaOfDelta(values, "irregular sequence");
+
+    std::uniform_int_distribution<int64_t> anyValue(min, max);
+    values.clear();
+    for (size_t i = 0; i < 300; ++i) {
+        values.push_back(anyValue(generator));
+    }
+    checkDeltaOfDelta(values, "random values");
+}
+
+static void testCorruptedInput()
+{
+    double values[4] = {};
+
+    // 10 before any window: the first residual must store its window
+    const std::vector<uint8_t> withoutWindow = {0, 0, 0, 0, 0, 0, 0, 0, 0x80};
+    check(decodeXor(withoutWindow.data(), withoutWindow.size(), 2, values) == 0,
+          "residual without a window accepted");
+
+    // 11 with 63 leading zeros and 64 meaningful bits
+    const std::vector<uint8_t> wideWindow = {0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, 0xF0, 0, 0, 0,
+                                             0, 0, 0, 0, 0, 0};
+    check(decodeXor(wideWindow.data(), wideWindow.size(), 2, values) == 0,
+          "window wider than 64 bits accepted");
+
+    // Random bytes never read out of the input nor return more bytes than given
+    std::uniform_int_distribution<int> anyByte(0, 255);
+    std::uniform_int_distribution<size_t> anySize(0, 64);
+    std::vector<double> decoded(200);
+    std::vector<int64_t> decodedIntegers(200);
+    for (size_t i = 0; i < 2000; ++i) {
+        std::vector<uint8_t> input(anySize(generator));
+        for (uint8_t& byte : input) {
+            byte = static_cast<uint8_t>(anyByte(generator));
+        }
+        const size_t n = 1 + i % decoded.size();
+        check(decodeXor(input.data(), input.size(), n, decoded.data()) <= input.size(),
+              "XOR decoding past the input");
+        check(decodeDeltaOfDelta(input.data(), input.size(), n, decodedIntegers.data())
+                  <= input.size(),
+              "delta of delta decoding past the input");
+    }
+}
+
+static void testBits()
+{
+    std::vector<uint8_t> out;
+    BitWriter writer(out);
+    std::uniform_int_distribution<unsigned> anyWidth(1, 64);
+    std::uniform_int_distribution<uint64_t> anyBits;
+
+    std::vector<std::pair<uint64_t, unsigned>> written;
+    size_t totalBits = 0;
+    for (size_t i = 0; i < 1000; ++i) {
+        const unsigned width = anyWidth(generator);
+        const uint64_t value = width == 64 ? anyBits(generator)
+                                           : anyBits(generator) & ((uint64_t(1) << width) - 1);
+        writer.write(value, width);
+        written.emplace_back(value, width);
+        totalBits += width;
+    }
+    writer.flush();
+    check(out.size() == (totalBits + 7) / 8, "wrong number of bytes written");
+
+    BitReader reader(out.data(), out.size());
+    bool same = true;
+    for (const auto& entry : written) {
+        same = same && reader.read(entry.second) == entry.first;
+    }
+    check(same, "bits read differ from the written ones");
+    check(!reader.overflow() && reader.getBytesRead() == out.size(), "wrong bytes read");
+
+    reader.read(8);
+    check(reader.overflow(), "read past the end not reported");
+}
+
+int main()
+{
+    testXor();
+    testDeltaOfDelta();
+    testCorruptedInput();
+    testBits();
+
+    return wearable::test::exitStatus();
+}
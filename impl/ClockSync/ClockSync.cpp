@@ -0,0 +1,272 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/ClockSync/ClockSync.h"
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/Time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+using namespace wearable::clocksync;
+
+const std::string LogPrefix = "ClockSync :";
+
+// ==============
+// ClockEstimator
+// ==============
+
+ClockEstimator::ClockEstimator(const size_t window)
+    : m_window(std::max(window, MinExchanges))
+{}
+
+bool ClockEstimator::addExchange(const double clientSend,
+                                 const double serverReceive,
+                                 const double serverTransmit,
+                                 const double clientReceive)
+{
+    const double delay = (clientReceive - clientSend) - (serverTransmit - serverReceive);
+    if (!std::isfinite(delay) || !(clientReceive >= clientSend)
+        || !(serverTransmit >= serverReceive) || delay < 0) {
+        return false;
+    }
+
+    const double offset = ((serverReceive - clientSend) + (serverTransmit - clientReceive)) / 2;
+    m_exchanges.push_back({(clientSend + clientReceive) / 2, offset, delay});
+    if (m_exchanges.size() > m_window) {
+        m_exchanges.pop_front();
+    }
+    m_count++;
+
+    update();
+    return true;
+}
+
+void ClockEstimator::update()
+{
+    // The quarter of the exchanges with the lowest delay, the ones delayed by the queues of the
+    // network or of the hosts being discarded
+    m_selected.assign(m_exchanges.begin(), m_exchanges.end());
+    const size_t selected = std::max<size_t>(1, m_selected.size() / 4);
+    std::nth_element(m_selected.begin(),
+                     m_selected.begin() + (selected - 1),
+                     m_selected.end(),
+                     [](const Exchange& a, const Exchange& b) { return a.delay < b.delay; });
+    m_selected.resize(selected);
+
+    double time = 0;
+    double offset = 0;
+    double firstTime = m_selected.front().time;
+    double lastTime = m_selected.front().time;
+    m_delay = m_selected.front().delay;
+    for (const Exchange& exchange : m_selected) {
+        time += exchange.time;
+        offset += exchange.offset;
+        firstTime = std::min(firstTime, exchange.time);
+        lastTime = std::max(lastTime, exchange.time);
+        m_delay = std::min(m_delay, exchange.delay);
+    }
+    m_referenceTime = time / selected;
+    m_offset = offset / selected;
+
+    // Least squares fit of the drift, when the exchanges are spread enough
+    m_drift = 0;
+    if (selected >= 2 && lastTime - firstTime >= MinDriftSpan) {
+        double covariance = 0;
+        double variance = 0;
+        for (const Exchange& exchange : m_selected) {
+            covariance += (exchange.time - m_referenceTime) * (exchange.offset - m_offset);
+            variance += (exchange.time - m_referenceTime) * (exchange.time - m_referenceTime);
+        }
+        const double drift = covariance / variance;
+        m_drift = std::abs(drift) <= MaxDrift ? drift : 0.0;
+    }
+}
+
+ClockEstimate ClockEstimator::getEstimate(const double localTime) const
+{
+    ClockEstimate estimate;
+    estimate.valid = valid();
+    estimate.offset = m_offset + m_drift * (localTime - m_referenceTime);
+    estimate.drift = m_drift;
+    estimate.delay = m_delay;
+    estimate.exchanges = m_count;
+    return estimate;
+}
+
+double ClockEstimator::toLocalTime(const double remoteTime) const
+{
+    return (remoteTime - m_offset + m_drift * m_referenceTime) / (1 + m_drift);
+}
+
+double ClockEstimator::toRemoteTime(const double localTime) const
+{
+    return localTime + m_offset + m_drift * (localTime - m_referenceTime);
+}
+
+void ClockEstimator::reset()
+{
+    m_exchanges.clear();
+    m_count = 0;
+    m_referenceTime = 0;
+    m_offset = 0;
+    m_drift = 0;
+    m_delay = 0;
+}
+
+// ===============
+// ClockSyncServer
+// ===============
+
+class ClockSyncServer::Impl
+{
+public:
+    yarp::os::Port port;
+};
+
+ClockSyncServer::ClockSyncServer()
+    : pImpl{new Impl()}
+{}
+
+ClockSyncServer::~ClockSyncServer()
+{
+    close();
+}
+
+bool ClockSyncServer::open(const std::string& portName)
+{
+    if (!pImpl->port.open(portName)) {
+        yError() << LogPrefix << "Failed to open port" << portName;
+        return false;
+    }
+
+    if (!yarp().attachAsServer(pImpl->port)) {
+        yError() << LogPrefix << "Failed to attach" << portName << "to the RPC service";
+        pImpl->port.close();
+        return false;
+    }
+
+    return true;
+}
+
+void ClockSyncServer::close()
+{
+    pImpl->port.close();
+}
+
+wearable::msg::ClockEcho ClockSyncServer::echo(const double clientTime)
+{
+    msg::ClockEcho reply;
+    reply.clientTime = clientTime;
+    reply.receiveTime = yarp::os::Time::now();
+    reply.transmitTime = yarp::os::Time::now();
+    return reply;
+}
+
+// ===============
+// ClockSyncClient
+// ===============
+
+class ClockSyncClient::Impl
+{
+public:
+    std::string serverPortName;
+    yarp::os::Port port;
+    msg::WearableClockService service;
+    bool connected = false;
+    bool synchronized = false;
+
+    mutable std::mutex mutex;
+    ClockEstimator estimator;
+};
+
+ClockSyncClient::ClockSyncClient(const double period)
+    : PeriodicThread(period)
+    , pImpl{new Impl()}
+{}
+
+ClockSyncClient::~ClockSyncClient()
+{
+    close();
+}
+
+bool ClockSyncClient::open(const std::string& serverPortName)
+{
+    pImpl->serverPortName = serverPortName;
+
+    if (!pImpl->port.open("...")) {
+        yError() << LogPrefix << "Failed to open the local port of the client of"
+                 << serverPortName;
+        return false;
+    }
+
+    if (!pImpl->service.yarp().attachAsClient(pImpl->port)) {
+        yError() << LogPrefix << "Failed to attach the client of" << serverPortName;
+        pImpl->port.close();
+        return false;
+    }
+
+    return start();
+}
+
+void ClockSyncClient::close()
+{
+    if (isRunning()) {
+        stop();
+    }
+    pImpl->port.close();
+}
+
+void ClockSyncClient::run()
+{
+    if (!pImpl->connected) {
+        pImpl->connected = yarp::os::Network::connect(pImpl->port.getName(), pImpl->serverPortName);
+        if (!pImpl->connected) {
+            return;
+        }
+    }
+
+    const double clientSend = yarp::os::Time::now();
+    const msg::ClockEcho reply = pImpl->service.echo(clientSend);
+    const double clientReceive = yarp::os::Time::now();
+
+    // A failed request returns a default reply
+    if (reply.clientTime != clientSend) {
+        yWarning() << LogPrefix << "Lost the connection to" << pImpl->serverPortName;
+        pImpl->connected = false;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    if (!pImpl->estimator.addExchange(
+            clientSend, reply.receiveTime, reply.transmitTime, clientReceive)) {
+        return;
+    }
+
+    if (!pImpl->synchronized && pImpl->estimator.valid()) {
+        pImpl->synchronized = true;
+        const ClockEstimate estimate = pImpl->estimator.getEstimate(clientReceive);
+        yInfo() << LogPrefix << "Synchronized with" << pImpl->serverPortName << ": offset"
+                << estimate.offset << "s, round trip delay" << estimate.delay << "s";
+    }
+}
+
+ClockEstimate ClockSyncClient::getEstimate() const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    return pImpl->estimator.getEstimate(yarp::os::Time::now());
+}
+
+bool ClockSyncClient::toLocalTime(const double remoteTime, double& localTime) const
+{
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    if (!pImpl->estimator.valid()) {
+        return false;
+    }
+    localTime = pImpl->estimator.toLocalTime(remoteTime);
+    return true;
+}
@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_CLOCKSYNC_H
+#define WEARABLE_CLOCKSYNC_H
+
+#include "thrift/WearableClockService.h"
+
+#include <yarp/os/PeriodicThread.h>
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Estimation of the clock of a producer of wearable data with respect to the local one, from
+// NTP-like exchanges: the client sends its time, and the server returns it with the times it
+// received the request and sent the reply. For an exchange sent at t0 and received back at t3,
+// with the server times t1 and t2:
+//
+//   offset = ((t1 - t0) + (t2 - t3)) / 2    delay = (t3 - t0) - (t2 - t1)
+//
+// The error of the offset of an exchange is bounded by half of its delay. The estimator keeps
+// the last exchanges, selects the quarter with the lowest delay, and fits on them the offset and
+// the drift, the rate of change of the offset.
+
+namespace wearable {
+    namespace clocksync {
+        constexpr size_t DefaultWindow = 64;
+        constexpr size_t MinExchanges = 4;
+        // Smallest time span of the selected exchanges for estimating the drift, and largest
+        // valid drift
+        constexpr double MinDriftSpan = 1.0;
+        constexpr double MaxDrift = 1e-3;
+        constexpr double DefaultPeriod = 0.5;
+
+        struct ClockEstimate
+        {
+            bool valid = false;
+            // Remote time minus local time, at the local time of the estimate
+            double offset = 0;
+            double drift = 0;
+            // Lowest round trip delay of the exchanges
+            double delay = 0;
+            size_t exchanges = 0;
+        };
+
+        class ClockEstimator;
+        class ClockSyncServer;
+        class ClockSyncClient;
+    } // namespace clocksync
+} // namespace wearable
+
+class wearable::clocksync::ClockEstimator
+{
+private:
+    struct Exchange
+    {
+        double time;
+        double offset;
+        double delay;
+    };
+
+    size_t m_window;
+    std::deque<Exchange> m_exchanges;
+    std::vector<Exchange> m_selected;
+    size_t m_count = 0;
+
+    // Offset at the reference time, and its drift
+    double m_referenceTime = 0;
+    double m_offset = 0;
+    double m_drift = 0;
+    double m_delay = 0;
+
+    void update();
+
+public:
+    explicit ClockEstimator(const size_t window = DefaultWindow);
+
+    // Add an exchange sent at clientSend and received back at clientReceive in the local
+    // clock, received at serverReceive and answered at serverTransmit in the remote one.
+    // Return false if its times are not consistent.
+    bool addExchange(const double clientSend,
+                     const double serverReceive,
+                     const double serverTransmit,
+                     const double clientReceive);
+
+    bool valid() const { return m_exchanges.size() >= MinExchanges; }
+    ClockEstimate getEstimate(const double localTime) const;
+
+    double toLocalTime(const double remoteTime) const;
+    double toRemoteTime(const double localTime) const;
+
+    void reset();
+};
+
+// Service answering the exchanges on a YARP RPC port, with the local clock
+class wearable::clocksync::ClockSyncServer : public wearable::msg::WearableClockService
+{
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+
+public:
+    ClockSyncServer();
+    ~ClockSyncServer() override;
+
+    bool open(const std::string& portName);
+    void close();
+
+    msg::ClockEcho echo(const double clientTime) override;
+};
+
+// Client sending an exchange to the port of a server every period, and estimating its clock.
+// The connection is retried every period until the server is available.
+class wearable::clocksync::ClockSyncClient : public yarp::os::PeriodicThread
+{
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+
+public:
+    explicit ClockSyncClient(const double period = DefaultPeriod);
+    ~ClockSyncClient() override;
+
+    bool open(const std::string& serverPortName);
+    void close();
+
+    // PeriodicThread
+    void run() override;
+
+    ClockEstimate getEstimate() const;
+
+    // Map a time of the server to the local clock. Return false until the estimate is valid.
+    bool toLocalTime(const double remoteTime, double& localTime) const;
+};
+
+#endif // WEARABLE_CLOCKSYNC_H
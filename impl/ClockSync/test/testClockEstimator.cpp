@@ -0,0 +1,171 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/ClockSync/ClockSync.h"
+#include "Wearable/TestUtils/Check.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace wearable::clocksync;
+using wearable::test::check;
+
+static std::mt19937 generator(11);
+
+// Remote clock running at 1 + drift times the local one, with the given offset at time zero
+struct RemoteClock
+{
+    double offset = 0;
+    double drift = 0;
+
+    double at(const double localTime) const { return offset + (1 + drift) * localTime; }
+};
+
+// Exchange sent at the local time t0, with the given delays of the request and of the reply and
+// processing time of the server
+static bool exchange(ClockEstimator& estimator,
+                     const RemoteClock& clock,
+                     const double t0,
+                     const double forward,
+                     const double processing,
+                     const double backward)
+{
+    return estimator.addExchange(t0,
+                                 clock.at(t0 + forward),
+                                 clock.at(t0 + forward + processing),
+                                 t0 + forward + processing + backward);
+}
+
+static void testOffset()
+{
+    const RemoteClock clock{1234.5678, 0};
+    ClockEstimator estimator;
+    std::uniform_real_distribution<double> delay(0.2e-3, 2e-3);
+
+    for (size_t i = 0; i < MinExchanges; ++i) {
+        check(!estimator.valid(), "valid before " + std::to_string(MinExchanges) + " exchanges");
+        check(exchange(estimator, clock, i * 0.5, delay(generator), 1e-5, delay(generator)),
+              "valid exchange rejected");
+    }
+    check(estimator.valid(), "not valid after " + std::to_string(MinExchanges) + " exchanges");
+
+    for (size_t i = MinExchanges; i < 100; ++i) {
+        exchange(estimator, clock, i * 0.5, delay(generator), 1e-5, delay(generator));
+    }
+
+    // The error of each exchange is half of the difference of its delays, at most 0.9 ms
+    const ClockEstimate estimate = estimator.getEstimate(50);
+    check(estimate.valid && estimate.exchanges == 100, "wrong validity or number of exchanges");
+    check(std::abs(estimate.offset - clock.offset) <= 0.9e-3,
+          "offset error " + std::to_string(estimate.offset - clock.offset));
+    check(estimate.delay >= 0.4e-3 && estimate.delay <= 4e-3, "wrong delay");
+    check(std::abs(estimate.drift) <= 1e-4, "drift estimated from a constant offset");
+}
+
+static void testDrift()
+{
+    const RemoteClock clock{-20.0, 50e-6};
+    ClockEstimator estimator(128);
+    std::uniform_real_distribution<double> delay(0.5e-3, 0.6e-3);
+
+    for (size_t i = 0; i < 120; ++i) {
+        check(exchange(estimator, clock, 100 + i * 0.5, delay(generator), 1e-5, delay(generator)),
+              "valid exchange rejected");
+    }
+
+    const double now = 160;
+    const ClockEstimate estimate = estimator.getEstimate(now);
+    check(std::abs(estimate.drift - clock.drift) <= 5e-6,
+          "drift " + std::to_string(estimate.drift) + " instead of "
+              + std::to_string(clock.drift));
+    check(std::abs(estimate.offset - (clock.at(now) - now)) <= 0.2e-3,
+          "offset with drift " + std::to_string(estimate.offset));
+
+    // The conversions are each the inverse of the other, and follow the remote clock
+    for (const double local : {100.0, 130.0, 160.0, 200.0}) {
+        const double remote = estimator.toRemoteTime(local);
+        check(std::abs(remote - clock.at(local)) <= 1e-3,
+              "remote time at " + std::to_string(local));
+        check(std::abs(estimator.toLocalTime(remote) - local) <= 1e-9,
+              "local time of " + std::to_string(remote));
+    }
+}
+
+static void testOutliers()
+{
+    // Half of the exchanges are delayed by the queues in a single direction, biasing their
+    // offsets
+    const RemoteClock clock{5.0, 0};
+    ClockEstimator estimator;
+    std::uniform_real_distribution<double> queue(5e-3, 50e-3);
+
+    for (size_t i = 0; i < 64; ++i) {
+        const double forward = i % 2 == 0 ? 0.1e-3 : queue(generator);
+        exchange(estimator, clock, i * 0.5, forward, 1e-5, 0.1e-3);
+    }
+
+    const ClockEstimate estimate = estimator.getEstimate(32);
+    check(std::abs(estimate.offset - clock.offset) <= 0.1e-3,
+          "offset error " + std::to_string(estimate.offset - clock.offset)
+              + " with queued exchanges");
+    check(estimate.delay <= 0.21e-3, "delay of the queued exchanges");
+}
+
+static void testInvalidExchanges()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    ClockEstimator estimator;
+
+    check(!estimator.addExchange(10, 20, 20.001, 9.9), "reply before the request accepted");
+    check(!estimator.addExchange(10, 20.001, 20, 10.01), "transmit before receive accepted");
+    check(!estimator.addExchange(10, 20, 20.5, 10.01), "negative delay accepted");
+    check(!estimator.addExchange(nan, 20, 20, 10.01), "NaN time accepted");
+    check(!estimator.addExchange(10, 20, inf, 10.01), "infinite time accepted");
+    check(estimator.getEstimate(10).exchanges == 0, "invalid exchanges counted");
+
+    // A drift beyond the largest valid one is not estimated
+    const RemoteClock fast{0, 10 * MaxDrift};
+    for (size_t i = 0; i < 40; ++i) {
+        exchange(estimator, fast, i * 0.5, 1e-4, 0, 1e-4);
+    }
+    check(estimator.getEstimate(20).drift == 0, "drift beyond the largest one estimated");
+
+    estimator.reset();
+    check(!estimator.valid() && estimator.getEstimate(0).exchanges == 0, "not reset");
+}
+
+static void testWindow()
+{
+    // After a step of the offset, the exchanges of the old one leave the window
+    const size_t window = 16;
+    ClockEstimator estimator(window);
+    RemoteClock clock{1.0, 0};
+
+    for (size_t i = 0; i < window; ++i) {
+        exchange(estimator, clock, i * 0.5, 1e-4, 0, 1e-4);
+    }
+    clock.offset = 2.0;
+    for (size_t i = window; i < 2 * window; ++i) {
+        exchange(estimator, clock, i * 0.5, 1e-4, 0, 1e-4);
+    }
+
+    const ClockEstimate estimate = estimator.getEstimate(2 * window * 0.5);
+    check(std::abs(estimate.offset - clock.offset) <= 1e-9, "old exchanges kept in the window");
+    check(estimate.exchanges == 2 * window, "wrong number of exchanges");
+}
+
+int main()
+{
+    testOffset();
+    testDrift();
+    testOutliers();
+    testInvalidExchanges();
+    testWindow();
+
+    return wearable::test::exitStatus();
+}
@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Estimation/Differentiator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#define WEARABLES_RESTRICT __restrict
+#else
+#define WEARABLES_RESTRICT __restrict__
+#endif
+
+using namespace wearable::estimation;
+
+constexpr double Pi = 3.14159265358979323846;
+constexpr size_t MaxWindow = 1000;
+
+// Weights of the causal Savitzky-Golay filter estimating the derivative of the given order at
+// the last of window evenly spaced samples, for a unit time step. The polynomial is fitted at
+// the times t_k = -k of the samples, k = 0 being the last one: with A_kj = t_k^j, the
+// coefficients are (A^T A)^-1 A^T y, and the derivative at 0 is order! times the coefficient of
+// the same order.
+static bool savitzkyGolayWeights(const size_t window,
+                                 const size_t polynomialOrder,
+                                 const size_t order,
+                                 std::vector<double>& weights)
+{
+    const size_t n = polynomialOrder + 1;
+
+    // Augmented matrix [A^T A | A^T], reduced with Gauss-Jordan elimination
+    std::vector<std::vector<double>> m(n, std::vector<double>(n + window, 0.0));
+    for (size_t k = 0; k < window; ++k) {
+        const double t = -static_cast<double>(k);
+        std::vector<double> powers(2 * n, 1.0);
+        for (size_t j = 1; j < 2 * n; ++j) {
+            powers[j] = powers[j - 1] * t;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                m[i][j] += powers[i + j];
+            }
+            m[i][n + k] = powers[i];
+        }
+    }
+
+    for (size_t col = 0; col < n; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < n; ++row) {
+            if (std::abs(m[row][col]) > std::abs(m[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (m[pivot][col] == 0) {
+            return false;
+        }
+        std::swap(m[col], m[pivot]);
+
+        const double inverse = 1.0 / m[col][col];
+        for (double& value : m[col]) {
+            value *= inverse;
+        }
+        for (size_t row = 0; row < n; ++row) {
+            if (row == col || m[row][col] == 0) {
+                continue;
+            }
+            const double factor = m[row][col];
+            for (size_t j = 0; j < n + window; ++j) {
+                m[row][j] -= factor * m[col][j];
+            }
+        }
+    }
+
+    double factorial = 1;
+    for (size_t i = 2; i <= order; ++i) {
+        factorial *= i;
+    }
+
+    weights.resize(window);
+    for (size_t k = 0; k < window; ++k) {
+        weights[k] = factorial * m[order][n + k];
+    }
+    return true;
+}
+
+// The kernels take the arrays as restrict arguments, so that the compiler knows that they do not
+// overlap and vectorizes the loops over the channels.
+
+static void accumulateTap(const size_t channels,
+                          const double w0,
+                          const double w1,
+                          const double w2,
+                          const double* WEARABLES_RESTRICT sample,
+                          double* WEARABLES_RESTRICT value,
+                          double* WEARABLES_RESTRICT first,
+                          double* WEARABLES_RESTRICT second)
+{
+    for (size_t c = 0; c < channels; ++c) {
+        value[c] += w0 * sample[c];
+        first[c] += w1 * sample[c];
+        second[c] += w2 * sample[c];
+    }
+}
+
+static void filterDifferences(const size_t channels,
+                              const double firstAlpha,
+                              const double secondAlpha,
+                              const double inverseDt,
+                              const double* WEARABLES_RESTRICT last,
+                              const double* WEARABLES_RESTRICT previous,
+                              double* WEARABLES_RESTRICT first,
+                              double* WEARABLES_RESTRICT second)
+{
+    for (size_t c = 0; c < channels; ++c) {
+        const double firstRaw = (last[c] - previous[c]) * inverseDt;
+        const double firstFiltered = first[c] + firstAlpha * (firstRaw - first[c]);
+        const double secondRaw = (firstFiltered - first[c]) * inverseDt;
+        second[c] += secondAlpha * (secondRaw - second[c]);
+        first[c] = firstFiltered;
+    }
+}
+
+bool Differentiator::configure(const Settings& settings, const size_t channels, std::string& error)
+{
+    m_settings = settings;
+    m_channels = channels;
+
+    if (settings.method == Method::SavitzkyGolay) {
+        if (settings.polynomialOrder < 2) {
+            error = "The polynomial order must be at least 2 to estimate the second derivative";
+            return false;
+        }
+        if (settings.window <= settings.polynomialOrder || settings.window > MaxWindow) {
+            error = "The window must be longer than the polynomial order and at most "
+                    + std::to_string(MaxWindow) + " samples";
+            return false;
+        }
+        if (!(savitzkyGolayWeights(
+                  settings.window, settings.polynomialOrder, 0, m_valueWeights)
+              && savitzkyGolayWeights(
+                  settings.window, settings.polynomialOrder, 1, m_firstWeights)
+              && savitzkyGolayWeights(
+                  settings.window, settings.polynomialOrder, 2, m_secondWeights))) {
+            error = "Failed to compute the Savitzky-Golay weights";
+            return false;
+        }
+    }
+    else if (!(settings.cutoffFrequency > 0)) {
+        error = "The cutoff frequency must be positive";
+        return false;
+    }
+
+    m_history.assign(getLatency() * channels, 0.0);
+    m_times.assign(getLatency(), 0.0);
+    m_value.assign(channels, 0.0);
+    m_first.assign(channels, 0.0);
+    m_second.assign(channels, 0.0);
+    reset();
+    return true;
+}
+
+void Differentiator::reset()
+{
+    m_head = 0;
+    m_count = 0;
+    std::fill(m_first.begin(), m_first.end(), 0.0);
+    std::fill(m_second.begin(), m_second.end(), 0.0);
+}
+
+size_t Differentiator::getLatency() const
+{
+    // The filtered difference needs the last two samples, and three to start the second
+    // derivative
+    return m_settings.method == Method::SavitzkyGolay ? m_settings.window : 3;
+}
+
+bool Differentiator::isReady() const
+{
+    return m_count >= getLatency();
+}
+
+const double* Differentiator::getSample(const size_t k) const
+{
+    const size_t rows = getLatency();
+    return m_history.data() + ((m_head + rows - k) % rows) * m_channels;
+}
+
+bool Differentiator::update(const double time, const double* values)
+{
+    const size_t rows = getLatency();
+    const double previousTime = m_times[m_head];
+
+    if (m_count > 0) {
+        m_head = (m_head + 1) % rows;
+    }
+    std::copy(values, values + m_channels, m_history.begin() + m_head * m_channels);
+    m_times[m_head] = time;
+    m_count = std::min(m_count + 1, rows);
+
+    if (m_settings.method == Method::SavitzkyGolay) {
+        if (!isReady()) {
+            std::copy(values, values + m_channels, m_value.begin());
+            return false;
+        }
+        updateSavitzkyGolay();
+        return true;
+    }
+
+    std::copy(values, values + m_channels, m_value.begin());
+    if (m_count < 2) {
+        return false;
+    }
+    updateFilteredDifference(time - previousTime);
+    return isReady();
+}
+
+void Differentiator::updateSavitzkyGolay()
+{
+    const size_t window = m_settings.window;
+
+    // Mean time step of the window, from the oldest to the last sample
+    const double dt = (m_times[m_head] - m_times[(m_head + 1) % window]) / (window - 1);
+    const double scale1 = dt > 0 ? 1.0 / dt : 0.0;
+    const double scale2 = scale1 * scale1;
+
+    std::fill(m_value.begin(), m_value.end(), 0.0);
+    std::fill(m_first.begin(), m_first.end(), 0.0);
+    std::fill(m_second.begin(), m_second.end(), 0.0);
+
+    for (size_t k = 0; k < window; ++k) {
+        accumulateTap(m_channels,
+                      m_valueWeights[k],
+                      m_firstWeights[k] * scale1,
+                      m_secondWeights[k] * scale2,
+                      getSample(k),
+                      m_value.data(),
+                      m_first.data(),
+                      m_second.data());
+    }
+}
+
+void Differentiator::updateFilteredDifference(const double dt)
+{
+    if (!(dt > 0)) {
+        return;
+    }
+
+    const double rc = 1.0 / (2 * Pi * m_settings.cutoffFrequency);
+    const double alpha = dt / (rc + dt);
+
+    // The first difference initializes the first derivative
+    filterDifferences(m_channels,
+                      m_count == 2 ? 1.0 : alpha,
+                      m_count == 2 ? 0.0 : alpha,
+                      1.0 / dt,
+                      getSample(0),
+                      getSample(1),
+                      m_first.data(),
+                      m_second.data());
+}
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_ESTIMATION_DIFFERENTIATOR_H
+#define WEARABLE_ESTIMATION_DIFFERENTIATOR_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace wearable {
+    namespace estimation {
+        class Differentiator;
+    } // namespace estimation
+} // namespace wearable
+
+// Causal estimation of the first and second derivatives of a set of signals sampled together.
+// The samples of all the channels are stored contiguously, and each derivative is computed by
+// one loop over the channels per tap of the kernel, that the compiler vectorizes.
+//
+// - SavitzkyGolay: a polynomial is fitted to the last window samples by least squares, and its
+//   value and derivatives at the last sample are the estimates. The time step is the mean one of
+//   the window, the samples are expected to be (almost) evenly spaced.
+// - FilteredDifference: backward differences of the signal and of the first derivative,
+//   smoothed by first order low-pass filters with the given cutoff frequency.
+class wearable::estimation::Differentiator
+{
+public:
+    enum class Method
+    {
+        SavitzkyGolay,
+        FilteredDifference,
+    };
+
+    struct Settings
+    {
+        Method method = Method::SavitzkyGolay;
+        // Savitzky-Golay
+        size_t window = 11;
+        size_t polynomialOrder = 2;
+        // Filtered difference
+        double cutoffFrequency = 10.0;
+    };
+
+private:
+    Settings m_settings;
+    size_t m_channels = 0;
+
+    // Weights of the samples from the last one to the oldest one
+    std::vector<double> m_valueWeights;
+    std::vector<double> m_firstWeights;
+    std::vector<double> m_secondWeights;
+
+    // Last samples as a ring buffer of rows of m_channels values, and their times
+    std::vector<double> m_history;
+    std::vector<double> m_times;
+    size_t m_head = 0;
+    size_t m_count = 0;
+
+    std::vector<double> m_value;
+    std::vector<double> m_first;
+    std::vector<double> m_second;
+
+    void updateSavitzkyGolay();
+    void updateFilteredDifference(const double dt);
+
+public:
+    // Return false and the reason in error if the settings are not valid
+    bool configure(const Settings& settings, const size_t channels, std::string& error);
+
+    // Drop the past samples, e.g. after a gap in the input
+    void reset();
+
+    // Add a sample of all the channels, return true when the estimates are available
+    bool update(const double time, const double* values);
+    bool isReady() const;
+
+    size_t getChannels() const { return m_channels; }
+    // Number of samples needed before the first estimates
+    size_t getLatency() const;
+
+    // Estimates at the last sample, m_channels values each. The value is the smoothed signal
+    // with Savitzky-Golay and the last sample with the filtered difference.
+    const double* getValue() const { return m_value.data(); }
+    const double* getFirstDerivative() const { return m_first.data(); }
+    const double* getSecondDerivative() const { return m_second.data(); }
+
+    // Values of all the channels at the k-th last sample (0 is the last one), k < getLatency()
+    const double* getSample(const size_t k) const;
+};
+
+#endif // WEARABLE_ESTIMATION_DIFFERENTIATOR_H
@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Estimation/Differentiator.h"
+#include "Wearable/TestUtils/Check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using wearable::estimation::Differentiator;
+using wearable::test::check;
+
+static bool near(const double value, const double expected, const double tolerance)
+{
+    return std::abs(value - expected) <= tolerance * std::max(1.0, std::abs(expected));
+}
+
+static Differentiator::Settings makeSavitzkyGolay(const size_t window, const size_t order)
+{
+    Differentiator::Settings settings;
+    settings.method = Differentiator::Method::SavitzkyGolay;
+    settings.window = window;
+    settings.polynomialOrder = order;
+    return settings;
+}
+
+// The weights of the filter, read as the estimates of the channels fed with unit impulses: the
+// channel k is 1 at the k-th last sample and 0 elsewhere
+static void checkWeights(const size_t window,
+                         const size_t order,
+                         const double dt,
+                         const std::vector<double>& value,
+                         const std::vector<double>& first,
+                         const std::vector<double>& second)
+{
+    const std::string name = "weights of window " + std::to_string(window) + " and order "
+                             + std::to_string(order);
+
+    Differentiator differentiator;
+    std::string error;
+    check(differentiator.configure(makeSavitzkyGolay(window, order), window, error),
+          name + ": " + error);
+
+    std::vector<double> sample(window);
+    bool ready = false;
+    for (size_t i = 0; i < window; ++i) {
+        for (size_t k = 0; k < window; ++k) {
+            sample[k] = i + k + 1 == window ? 1.0 : 0.0;
+        }
+        ready = differentiator.update(i * dt, sample.data());
+    }
+    check(ready && differentiator.isReady(), name + ": not ready after the window");
+
+    for (size_t k = 0; k < window; ++k) {
+        check(near(differentiator.getValue()[k], value[k], 1e-12),
+              name + ": value weight " + std::to_string(k));
+        check(near(differentiator.getFirstDerivative()[k] * dt, first[k], 1e-12),
+              name + ": first derivative weight " + std::to_string(k));
+        check(near(differentiator.getSecondDerivative()[k] * dt * dt, second[k], 1e-12),
+              name + ": second derivative weight " + std::to_string(k));
+    }
+}
+
+// Polynomials up to the order of the filter are differentiated exactly, whatever the channel
+static void checkPolynomial(const size_t window, const size_t order, const double dt)
+{
+    const std::string name = "polynomial with window " + std::to_string(window) + " and order "
+                             + std::to_string(order);
+    const size_t channels = 7;
+
+    Differentiator differentiator;
+    std::string error;
+    check(differentiator.configure(makeSavitzkyGolay(window, order), channels, error),
+          name + ": " + error);
+
+    // p_c(t) = sum_j a_cj t^j, with degree min(c, order)
+    const auto coefficient = [](const size_t c, const size_t j) {
+        return 0.5 + 0.25 * c - 0.3 * j;
+    };
+    const auto evaluate = [&](const size_t c, const double t, const size_t derivative) {
+        double result = 0;
+        for (size_t j = derivative; j <= std::min(c, order); ++j) {
+            double term = coefficient(c, j);
+            for (size_t d = 0; d < derivative; ++d) {
+                term *= j - d;
+            }
+            result += term * std::pow(t, static_cast<double>(j - derivative));
+        }
+        return result;
+    };
+
+    std::vector<double> sample(channels);
+    const double start = 1.5;
+    for (size_t i = 0; i < 3 * window; ++i) {
+        const double t = start + i * dt;
+        for (size_t c = 0; c < channels; ++c) {
+            sample[c] = evaluate(c, t, 0);
+        }
+        if (!differentiator.update(t, sample.data())) {
+            check(i + 1 < window, name + ": not ready after the window");
+            continue;
+        }
+        for (size_t c = 0; c < channels; ++c) {
+            const std::string channel = name + ", channel " + std::to_string(c);
+            check(near(differentiator.getValue()[c], evaluate(c, t, 0), 1e-8), channel + ": value");
+            check(near(differentiator.getFirstDerivative()[c], evaluate(c, t, 1), 1e-6),
+                  channel + ": first derivative");
+            check(near(differentiator.getSecondDerivative()[c], evaluate(c, t, 2), 1e-4),
+                  channel + ": second derivative");
+        }
+    }
+}
+
+static void testFilteredDifference()
+{
+    Differentiator::Settings settings;
+    settings.method = Differentiator::Method::FilteredDifference;
+    settings.cutoffFrequency = 20;
+
+    Differentiator differentiator;
+    std::string error;
+    check(differentiator.configure(settings, 1, error), "filtered difference: " + error);
+    check(differentiator.getLatency() == 3, "filtered difference: wrong latency");
+
+    // The derivatives of a parabola converge to the exact ones, but for the lag of the filters
+    const double dt = 1e-3;
+    for (size_t i = 0; i < 2000; ++i) {
+        const double t = i * dt;
+        const double value = 3 * t * t + 2 * t;
+        differentiator.update(t, &value);
+    }
+    const double t = 1999 * dt;
+    check(near(differentiator.getFirstDerivative()[0], 6 * t + 2, 0.01),
+          "filtered difference: first derivative");
+    check(near(differentiator.getSecondDerivative()[0], 6, 0.01),
+          "filtered difference: second derivative");
+
+    differentiator.reset();
+    check(!differentiator.isReady() && differentiator.getFirstDerivative()[0] == 0,
+          "filtered difference: not reset");
+}
+
+static void testInvalidSettings()
+{
+    Differentiator differentiator;
+    std::string error;
+    check(!differentiator.configure(makeSavitzkyGolay(11, 1), 1, error), "order 1 accepted");
+    check(!differentiator.configure(makeSavitzkyGolay(3, 3), 1, error),
+          "window not longer than the order accepted");
+    check(!differentiator.configure(makeSavitzkyGolay(1001, 2), 1, error),
+          "window too long accepted");
+
+    Differentiator::Settings settings;
+    settings.method = Differentiator::Method::FilteredDifference;
+    settings.cutoffFrequency = 0;
+    check(!differentiator.configure(settings, 1, error), "zero cutoff frequency accepted");
+}
+
+int main()
+{
+    // End point weights of the quadratic fit of 5 samples, from the last one
+    checkWeights(5,
+                 2,
+                 0.01,
+                 {31.0 / 35, 9.0 / 35, -3.0 / 35, -5.0 / 35, 3.0 / 35},
+                 {54.0 / 70, -13.0 / 70, -40.0 / 70, -27.0 / 70, 26.0 / 70},
+                 {2.0 / 7, -1.0 / 7, -2.0 / 7, -1.0 / 7, 2.0 / 7});
+    // With 3 samples the fit interpolates them: backward differences
+    checkWeights(3, 2, 0.5, {1, 0, 0}, {1.5, -2, 0.5}, {1, -2, 1});
+
+    checkPolynomial(5, 2, 0.01);
+    checkPolynomial(11, 2, 0.01);
+    checkPolynomial(21, 3, 0.002);
+    checkPolynomial(9, 4, 0.1);
+
+    testFilteredDifference();
+    testInvalidSettings();
+
+    return wearable::test::exitStatus();
+}
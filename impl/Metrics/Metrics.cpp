@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Metrics/Metrics.h"
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/Time.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace wearable::metrics;
+
+const std::string LogPrefix = "Metrics :";
+
+// =======
+// Metrics
+// =======
+
+Metrics::Metrics(const std::string& component)
+    : m_component(component)
+    , m_startTime(yarp::os::Time::now())
+{
+    for (auto& bucket : m_tickHistogram) {
+        bucket = 0;
+    }
+}
+
+void Metrics::addTick(const double duration)
+{
+    const int64_t durationNs = static_cast<int64_t>(duration * 1e9);
+
+    m_ticks.fetch_add(1, std::memory_order_relaxed);
+    m_tickSum.fetch_add(durationNs, std::memory_order_relaxed);
+
+    int64_t max = m_tickMax.load(std::memory_order_relaxed);
+    while (durationNs > max
+           && !m_tickMax.compare_exchange_weak(max, durationNs, std::memory_order_relaxed)) {
+    }
+
+    const size_t bucket =
+        std::lower_bound(TickHistogramBounds.begin(), TickHistogramBounds.end(), duration)
+        - TickHistogramBounds.begin();
+    m_tickHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    const double period = m_period.load(std::memory_order_relaxed);
+    if (period > 0 && duration > period) {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SensorCounter* Metrics::addSensor(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_sensorsMutex);
+    m_sensors.emplace_back(name);
+    return &m_sensors.back();
+}
+
+wearable::msg::ComponentMetrics Metrics::getMetrics() const
+{
+    const double now = yarp::os::Time::now();
+
+    msg::ComponentMetrics metrics;
+    metrics.component = m_component;
+    metrics.time = now;
+    metrics.uptime = now - m_startTime.load(std::memory_order_relaxed);
+    metrics.period = m_period.load(std::memory_order_relaxed);
+    metrics.ticks = m_ticks.load(std::memory_order_relaxed);
+    metrics.overruns = m_overruns.load(std::memory_order_relaxed);
+    metrics.tickMean =
+        metrics.ticks > 0 ? m_tickSum.load(std::memory_order_relaxed) / 1e9 / metrics.ticks : 0;
+    metrics.tickMax = m_tickMax.load(std::memory_order_relaxed) / 1e9;
+    metrics.tickHistogramBounds.assign(TickHistogramBounds.begin(), TickHistogramBounds.end());
+    for (const auto& bucket : m_tickHistogram) {
+        metrics.tickHistogram.push_back(bucket.load(std::memory_order_relaxed));
+    }
+    metrics.framesIn = m_framesIn.load(std::memory_order_relaxed);
+    metrics.framesOut = m_framesOut.load(std::memory_order_relaxed);
+    metrics.drops = m_drops.load(std::memory_order_relaxed);
+    metrics.bytesSent = m_bytesSent.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_sensorsMutex);
+    metrics.sensors.reserve(m_sensors.size());
+    for (const auto& sensor : m_sensors) {
+        msg::SensorMetrics sensorMetrics;
+        sensorMetrics.name = sensor.m_name;
+        sensorMetrics.updates = sensor.m_updates.load(std::memory_order_relaxed);
+
+        const double first = sensor.m_firstUpdateTime.load(std::memory_order_relaxed);
+        const double last = sensor.m_lastUpdateTime.load(std::memory_order_relaxed);
+        sensorMetrics.updateRate =
+            sensorMetrics.updates > 1 && last > first ? (sensorMetrics.updates - 1) / (last - first)
+                                                      : 0;
+        sensorMetrics.dataAge = sensorMetrics.updates > 0 ? now - last : -1;
+        metrics.sensors.push_back(sensorMetrics);
+    }
+
+    return metrics;
+}
+
+void Metrics::reset()
+{
+    m_startTime = yarp::os::Time::now();
+    m_ticks = 0;
+    m_overruns = 0;
+    m_tickSum = 0;
+    m_tickMax = 0;
+    for (auto& bucket : m_tickHistogram) {
+        bucket = 0;
+    }
+    m_framesIn = 0;
+    m_framesOut = 0;
+    m_drops = 0;
+    m_bytesSent = 0;
+
+    std::lock_guard<std::mutex> lock(m_sensorsMutex);
+    for (auto& sensor : m_sensors) {
+        sensor.m_updates = 0;
+    }
+}
+
+// =============
+// MetricsServer
+// =============
+
+class MetricsServer::Impl
+{
+public:
+    yarp::os::Port port;
+    Metrics* metrics = nullptr;
+};
+
+MetricsServer::MetricsServer()
+    : pImpl{new Impl()}
+{}
+
+MetricsServer::~MetricsServer()
+{
+    close();
+}
+
+bool MetricsServer::open(const std::string& portName, Metrics* metrics)
+{
+    pImpl->metrics = metrics;
+
+    if (!pImpl->port.open(portName)) {
+        yError() << LogPrefix << "Failed to open port" << portName;
+        return false;
+    }
+
+    if (!yarp().attachAsServer(pImpl->port)) {
+        yError() << LogPrefix << "Failed to attach" << portName << "to the RPC service";
+        pImpl->port.close();
+        return false;
+    }
+
+    return true;
+}
+
+void MetricsServer::close()
+{
+    pImpl->port.close();
+}
+
+wearable::msg::ComponentMetrics MetricsServer::getMetrics()
+{
+    if (!pImpl->metrics) {
+        return {};
+    }
+    return pImpl->metrics->getMetrics();
+}
+
+bool MetricsServer::resetMetrics()
+{
+    if (!pImpl->metrics) {
+        return false;
+    }
+    pImpl->metrics->reset();
+    return true;
+}
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_METRICS_H
+#define WEARABLE_METRICS_H
+
+#include "thrift/WearableMetricsService.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Runtime metrics of the wearables components. The counters are atomics updated from the
+// loops of the components, and they are read from the thread of the RPC service.
+
+namespace wearable {
+    namespace metrics {
+        class SensorCounter;
+        class Metrics;
+        class MetricsServer;
+
+        // Upper bounds of the tick duration histogram buckets in seconds
+        constexpr std::array<double, 11> TickHistogramBounds = {
+            {50e-6, 100e-6, 200e-6, 500e-6, 1e-3, 2e-3, 5e-3, 10e-3, 20e-3, 50e-3, 100e-3}};
+    } // namespace metrics
+} // namespace wearable
+
+class wearable::metrics::SensorCounter
+{
+private:
+    friend class Metrics;
+    const std::string m_name;
+    std::atomic<int64_t> m_updates{0};
+    std::atomic<double> m_firstUpdateTime{0};
+    std::atomic<double> m_lastUpdateTime{0};
+
+public:
+    explicit SensorCounter(const std::string& name)
+        : m_name(name)
+    {}
+
+    // Count an update of the sensor data, with the time of the data
+    void update(const double time)
+    {
+        if (m_updates.fetch_add(1, std::memory_order_relaxed) == 0) {
+            m_firstUpdateTime.store(time, std::memory_order_relaxed);
+        }
+        m_lastUpdateTime.store(time, std::memory_order_relaxed);
+    }
+};
+
+class wearable::metrics::Metrics
+{
+private:
+    const std::string m_component;
+    std::atomic<double> m_startTime{0};
+    std::atomic<double> m_period{0};
+
+    std::atomic<int64_t> m_ticks{0};
+    std::atomic<int64_t> m_overruns{0};
+    std::atomic<int64_t> m_tickSum{0}; // ns
+    std::atomic<int64_t> m_tickMax{0}; // ns
+    std::array<std::atomic<int64_t>, TickHistogramBounds.size() + 1> m_tickHistogram;
+
+    std::atomic<int64_t> m_framesIn{0};
+    std::atomic<int64_t> m_framesOut{0};
+    std::atomic<int64_t> m_drops{0};
+    std::atomic<int64_t> m_bytesSent{0};
+
+    // The deque keeps the counters at the same address when new sensors are added
+    mutable std::mutex m_sensorsMutex;
+    std::deque<SensorCounter> m_sensors;
+
+public:
+    explicit Metrics(const std::string& component);
+
+    Metrics(const Metrics& other) = delete;
+    Metrics& operator=(const Metrics& other) = delete;
+
+    // Set the period of the component, used to count the overruns
+    void setPeriod(const double period) { m_period.store(period, std::memory_order_relaxed); }
+
+    void addTick(const double duration);
+
+    void addFramesIn(const int64_t frames = 1)
+    {
+        m_framesIn.fetch_add(frames, std::memory_order_relaxed);
+    }
+    void addFramesOut(const int64_t frames = 1)
+    {
+        m_framesOut.fetch_add(frames, std::memory_order_relaxed);
+    }
+    void addDrops(const int64_t drops = 1) { m_drops.fetch_add(drops, std::memory_order_relaxed); }
+    void addBytesSent(const int64_t bytes)
+    {
+        m_bytesSent.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    // Add a sensor, returning its counter. The counter stays valid as long as this object.
+    SensorCounter* addSensor(const std::string& name);
+
+    msg::ComponentMetrics getMetrics() const;
+    void reset();
+};
+
+// Service exposing the metrics on a YARP RPC port
+class wearable::metrics::MetricsServer : public wearable::msg::WearableMetricsService
+{
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+
+public:
+    MetricsServer();
+    ~MetricsServer() override;
+
+    bool open(const std::string& portName, Metrics* metrics);
+    void close();
+
+    msg::ComponentMetrics getMetrics() override;
+    bool resetMetrics() override;
+};
+
+#endif // WEARABLE_METRICS_H
@@ -0,0 +1,321 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Fusion/OrientationFusion.h"
+
+#include <cmath>
+
+#if defined(_MSC_VER)
+#define WEARABLES_RESTRICT __restrict
+#else
+#define WEARABLES_RESTRICT __restrict__
+#endif
+
+using namespace wearable::fusion;
+
+// Reciprocal of the norm. The tiny offset, absorbed by the rounding for any vector that is not
+// almost zero, keeps the result finite for a zero vector, whose normalization stays zero. The
+// loops calling it have no branches, so that the compiler vectorizes them.
+static inline double inverseNorm(const double squaredNorm)
+{
+    return 1.0 / std::sqrt(squaredNorm + 1e-300);
+}
+
+// The kernels take the arrays as restrict arguments, so that the compiler knows that they do not
+// overlap and vectorizes the loops.
+
+static void updateWithoutMagnetometer(const size_t n,
+                                      const double gain,
+                                      const double dt,
+                                      const double* WEARABLES_RESTRICT axs,
+                                      const double* WEARABLES_RESTRICT ays,
+                                      const double* WEARABLES_RESTRICT azs,
+                                      const double* WEARABLES_RESTRICT gxs,
+                                      const double* WEARABLES_RESTRICT gys,
+                                      const double* WEARABLES_RESTRICT gzs,
+                                      double* WEARABLES_RESTRICT qws,
+                                      double* WEARABLES_RESTRICT qxs,
+                                      double* WEARABLES_RESTRICT qys,
+                                      double* WEARABLES_RESTRICT qzs)
+{
+    for (size_t i = 0; i < n; ++i) {
+        const double q0 = qws[i], q1 = qxs[i], q2 = qys[i], q3 = qzs[i];
+        const double gx = gxs[i], gy = gys[i], gz = gzs[i];
+
+        // Rate of change of the quaternion from the gyroscope
+        double qDot0 = 0.5 * (-q1 * gx - q2 * gy - q3 * gz);
+        double qDot1 = 0.5 * (q0 * gx + q2 * gz - q3 * gy);
+        double qDot2 = 0.5 * (q0 * gy - q1 * gz + q3 * gx);
+        double qDot3 = 0.5 * (q0 * gz + q1 * gy - q2 * gx);
+
+        // Gradient descent step towards the measured gravity
+        const double accSquaredNorm = axs[i] * axs[i] + ays[i] * ays[i] + azs[i] * azs[i];
+        const double accInverseNorm = inverseNorm(accSquaredNorm);
+        const double ax = axs[i] * accInverseNorm;
+        const double ay = ays[i] * accInverseNorm;
+        const double az = azs[i] * accInverseNorm;
+
+        const double q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+        const double s0 = 4 * q0 * q2q2 + 2 * q2 * ax + 4 * q0 * q1q1 - 2 * q1 * ay;
+        const double s1 = 4 * q1 * q3q3 - 2 * q3 * ax + 4 * q0q0 * q1 - 2 * q0 * ay - 4 * q1
+                          + 8 * q1 * q1q1 + 8 * q1 * q2q2 + 4 * q1 * az;
+        const double s2 = 4 * q0q0 * q2 + 2 * q0 * ax + 4 * q2 * q3q3 - 2 * q3 * ay - 4 * q2
+                          + 8 * q2 * q1q1 + 8 * q2 * q2q2 + 4 * q2 * az;
+        const double s3 = 4 * q1q1 * q3 - 2 * q1 * ax + 4 * q2q2 * q3 - 2 * q2 * ay;
+
+        // The correction is disabled (weight 0 instead of 1) with a zero accelerometer
+        const double accWeight = accSquaredNorm * accInverseNorm * accInverseNorm;
+        const double stepInverseNorm = inverseNorm(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+        const double stepGain = gain * accWeight * stepInverseNorm;
+        qDot0 -= stepGain * s0;
+        qDot1 -= stepGain * s1;
+        qDot2 -= stepGain * s2;
+        qDot3 -= stepGain * s3;
+
+        const double w = q0 + qDot0 * dt;
+        const double x = q1 + qDot1 * dt;
+        const double y = q2 + qDot2 * dt;
+        const double z = q3 + qDot3 * dt;
+        const double qInverseNorm = inverseNorm(w * w + x * x + y * y + z * z);
+        qws[i] = w * qInverseNorm;
+        qxs[i] = x * qInverseNorm;
+        qys[i] = y * qInverseNorm;
+        qzs[i] = z * qInverseNorm;
+    }
+}
+
+static void updateWithMagnetometer(const size_t n,
+                                   const double gain,
+                                   const double dt,
+                                   const double* WEARABLES_RESTRICT axs,
+                                   const double* WEARABLES_RESTRICT ays,
+                                   const double* WEARABLES_RESTRICT azs,
+                                   const double* WEARABLES_RESTRICT gxs,
+                                   const double* WEARABLES_RESTRICT gys,
+                                   const double* WEARABLES_RESTRICT gzs,
+                                   const double* WEARABLES_RESTRICT mxs,
+                                   const double* WEARABLES_RESTRICT mys,
+                                   const double* WEARABLES_RESTRICT mzs,
+                                   double* WEARABLES_RESTRICT qws,
+                                   double* WEARABLES_RESTRICT qxs,
+                                   double* WEARABLES_RESTRICT qys,
+                                   double* WEARABLES_RESTRICT qzs)
+{
+    for (size_t i = 0; i < n; ++i) {
+        const double q0 = qws[i], q1 = qxs[i], q2 = qys[i], q3 = qzs[i];
+        const double gx = gxs[i], gy = gys[i], gz = gzs[i];
+
+        double qDot0 = 0.5 * (-q1 * gx - q2 * gy - q3 * gz);
+        double qDot1 = 0.5 * (q0 * gx + q2 * gz - q3 * gy);
+        double qDot2 = 0.5 * (q0 * gy - q1 * gz + q3 * gx);
+        double qDot3 = 0.5 * (q0 * gz + q1 * gy - q2 * gx);
+
+        const double accSquaredNorm = axs[i] * axs[i] + ays[i] * ays[i] + azs[i] * azs[i];
+        const double accInverseNorm = inverseNorm(accSquaredNorm);
+        const double ax = axs[i] * accInverseNorm;
+        const double ay = ays[i] * accInverseNorm;
+        const double az = azs[i] * accInverseNorm;
+
+        // A zero magnetometer zeroes the reference field, leaving only the gravity terms
+        const double magInverseNorm =
+            inverseNorm(mxs[i] * mxs[i] + mys[i] * mys[i] + mzs[i] * mzs[i]);
+        const double mx = mxs[i] * magInverseNorm;
+        const double my = mys[i] * magInverseNorm;
+        const double mz = mzs[i] * magInverseNorm;
+
+        const double q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+        const double q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+        const double q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+        // Reference direction of the magnetic field in the world frame
+        const double hx = mx * q0q0 - 2 * q0 * my * q3 + 2 * q0 * mz * q2 + mx * q1q1
+                          + 2 * q1 * my * q2 + 2 * q1 * mz * q3 - mx * q2q2 - mx * q3q3;
+        const double hy = 2 * q0 * mx * q3 + my * q0q0 - 2 * q0 * mz * q1 + 2 * q1 * mx * q2
+                          - my * q1q1 + my * q2q2 + 2 * q2 * mz * q3 - my * q3q3;
+        const double bx2 = std::sqrt(hx * hx + hy * hy);
+        const double bz2 = -2 * q0 * mx * q2 + 2 * q0 * my * q1 + mz * q0q0 + 2 * q1 * mx * q3
+                           - mz * q1q1 + 2 * q2 * my * q3 - mz * q2q2 + mz * q3q3;
+        const double bx4 = 2 * bx2;
+        const double bz4 = 2 * bz2;
+
+        // Errors of the gravity and of the magnetic field predicted by the estimate
+        const double fgx = 2 * q1q3 - 2 * q0q2 - ax;
+        const double fgy = 2 * q0q1 + 2 * q2q3 - ay;
+        const double fgz = 1 - 2 * q1q1 - 2 * q2q2 - az;
+        const double fbx = bx2 * (0.5 - q2q2 - q3q3) + bz2 * (q1q3 - q0q2) - mx;
+        const double fby = bx2 * (q1q2 - q0q3) + bz2 * (q0q1 + q2q3) - my;
+        const double fbz = bx2 * (q0q2 + q1q3) + bz2 * (0.5 - q1q1 - q2q2) - mz;
+
+        const double s0 = -2 * q2 * fgx + 2 * q1 * fgy - bz2 * q2 * fbx
+                          + (-bx2 * q3 + bz2 * q1) * fby + bx2 * q2 * fbz;
+        const double s1 = 2 * q3 * fgx + 2 * q0 * fgy - 4 * q1 * fgz + bz2 * q3 * fbx
+                          + (bx2 * q2 + bz2 * q0) * fby + (bx2 * q3 - bz4 * q1) * fbz;
+        const double s2 = -2 * q0 * fgx + 2 * q3 * fgy - 4 * q2 * fgz
+                          + (-bx4 * q2 - bz2 * q0) * fbx + (bx2 * q1 + bz2 * q3) * fby
+                          + (bx2 * q0 - bz4 * q2) * fbz;
+        const double s3 = 2 * q1 * fgx + 2 * q2 * fgy + (-bx4 * q3 + bz2 * q1) * fbx
+                          + (-bx2 * q0 + bz2 * q2) * fby + bx2 * q1 * fbz;
+
+        const double accWeight = accSquaredNorm * accInverseNorm * accInverseNorm;
+        const double stepInverseNorm = inverseNorm(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+        const double stepGain = gain * accWeight * stepInverseNorm;
+        qDot0 -= stepGain * s0;
+        qDot1 -= stepGain * s1;
+        qDot2 -= stepGain * s2;
+        qDot3 -= stepGain * s3;
+
+        const double w = q0 + qDot0 * dt;
+        const double x = q1 + qDot1 * dt;
+        const double y = q2 + qDot2 * dt;
+        const double z = q3 + qDot3 * dt;
+        const double qInverseNorm = inverseNorm(w * w + x * x + y * y + z * z);
+        qws[i] = w * qInverseNorm;
+        qxs[i] = x * qInverseNorm;
+        qys[i] = y * qInverseNorm;
+        qzs[i] = z * qInverseNorm;
+    }
+}
+
+OrientationFilterBank::OrientationFilterBank(const bool useMagnetometer)
+    : m_useMagnetometer(useMagnetometer)
+{}
+
+void OrientationFilterBank::resize(const size_t size)
+{
+    for (auto* v : {&m_ax, &m_ay, &m_az, &m_gx, &m_gy, &m_gz, &m_mx, &m_my, &m_mz, &m_qx, &m_qy,
+                    &m_qz}) {
+        v->resize(size, 0.0);
+    }
+    m_qw.resize(size, 1.0);
+    m_initialized.resize(size, 0);
+    m_pendingInitialization = true;
+}
+
+void OrientationFilterBank::setInput(const size_t i,
+                                     const double* acc,
+                                     const double* gyro,
+                                     const double* mag)
+{
+    static const double zero[3] = {0, 0, 0};
+    const double* m = mag ? mag : zero;
+    setInput(i, acc[0], acc[1], acc[2], gyro[0], gyro[1], gyro[2], m[0], m[1], m[2]);
+}
+
+void OrientationFilterBank::setInput(const size_t i,
+                                     const double ax,
+                                     const double ay,
+                                     const double az,
+                                     const double gx,
+                                     const double gy,
+                                     const double gz,
+                                     const double mx,
+                                     const double my,
+                                     const double mz)
+{
+    m_ax[i] = ax;
+    m_ay[i] = ay;
+    m_az[i] = az;
+    m_gx[i] = gx;
+    m_gy[i] = gy;
+    m_gz[i] = gz;
+    m_mx[i] = mx;
+    m_my[i] = my;
+    m_mz[i] = mz;
+}
+
+void OrientationFilterBank::getOrientation(const size_t i, double* quaternion) const
+{
+    quaternion[0] = m_qw[i];
+    quaternion[1] = m_qx[i];
+    quaternion[2] = m_qy[i];
+    quaternion[3] = m_qz[i];
+}
+
+void OrientationFilterBank::reset(const size_t i)
+{
+    m_initialized[i] = 0;
+    m_pendingInitialization = true;
+}
+
+// Roll and pitch from the gravity measured by the accelerometer, and yaw from the magnetometer
+// projected on the horizontal plane
+void OrientationFilterBank::initialize()
+{
+    m_pendingInitialization = false;
+
+    for (size_t i = 0; i < size(); ++i) {
+        if (m_initialized[i]) {
+            continue;
+        }
+
+        const double ax = m_ax[i], ay = m_ay[i], az = m_az[i];
+        if (ax == 0 && ay == 0 && az == 0) {
+            m_pendingInitialization = true;
+            continue;
+        }
+
+        const double roll = std::atan2(ay, az);
+        const double pitch = std::atan2(-ax, std::sqrt(ay * ay + az * az));
+        double yaw = 0;
+
+        if (m_useMagnetometer && (m_mx[i] != 0 || m_my[i] != 0 || m_mz[i] != 0)) {
+            const double mx = m_mx[i], my = m_my[i], mz = m_mz[i];
+            const double horizontalX = mx * std::cos(pitch)
+                                       + (my * std::sin(roll) + mz * std::cos(roll))
+                                             * std::sin(pitch);
+            const double horizontalY = my * std::cos(roll) - mz * std::sin(roll);
+            yaw = std::atan2(-horizontalY, horizontalX);
+        }
+
+        const double cr = std::cos(roll / 2), sr = std::sin(roll / 2);
+        const double cp = std::cos(pitch / 2), sp = std::sin(pitch / 2);
+        const double cy = std::cos(yaw / 2), sy = std::sin(yaw / 2);
+
+        m_qw[i] = cr * cp * cy + sr * sp * sy;
+        m_qx[i] = sr * cp * cy - cr * sp * sy;
+        m_qy[i] = cr * sp * cy + sr * cp * sy;
+        m_qz[i] = cr * cp * sy - sr * sp * cy;
+        m_initialized[i] = 1;
+    }
+}
+
+void OrientationFilterBank::update(const double dt)
+{
+    if (m_pendingInitialization) {
+        initialize();
+    }
+
+    if (!m_useMagnetometer) {
+        updateWithoutMagnetometer(size(),
+                                  m_gain,
+                                  dt,
+                                  m_ax.data(),
+                                  m_ay.data(),
+                                  m_az.data(),
+                                  m_gx.data(),
+                                  m_gy.data(),
+                                  m_gz.data(),
+                                  m_qw.data(),
+                                  m_qx.data(),
+                                  m_qy.data(),
+                                  m_qz.data());
+        return;
+    }
+
+    updateWithMagnetometer(size(),
+                           m_gain,
+                           dt,
+                           m_ax.data(),
+                           m_ay.data(),
+                           m_az.data(),
+                           m_gx.data(),
+                           m_gy.data(),
+                           m_gz.data(),
+                           m_mx.data(),
+                           m_my.data(),
+                           m_mz.data(),
+                           m_qw.data(),
+                           m_qx.data(),
+                           m_qy.data(),
+                           m_qz.data());
+}
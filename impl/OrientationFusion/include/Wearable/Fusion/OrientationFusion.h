@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_FUSION_ORIENTATIONFUSION_H
+#define WEARABLE_FUSION_ORIENTATIONFUSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wearable {
+    namespace fusion {
+        class OrientationFilterBank;
+    } // namespace fusion
+} // namespace wearable
+
+// Bank of Madgwick orientation filters updated together. The inputs and the states of the filters
+// are stored as a structure of arrays, and all the filters are updated by the same branch free
+// loop, that the compiler vectorizes.
+//
+// Without the magnetometer, each filter fuses the accelerometer and the gyroscope (the heading
+// drifts). With the magnetometer, the heading is corrected towards the magnetic north. The
+// estimated orientation is the one of the sensor frame with respect to a world frame with the z
+// axis up (and the x axis towards the magnetic north when the magnetometer is used), as a
+// quaternion w x y z.
+class wearable::fusion::OrientationFilterBank
+{
+private:
+    bool m_useMagnetometer;
+    double m_gain = 0.1;
+
+    // Inputs
+    std::vector<double> m_ax, m_ay, m_az;
+    std::vector<double> m_gx, m_gy, m_gz;
+    std::vector<double> m_mx, m_my, m_mz;
+    // States
+    std::vector<double> m_qw, m_qx, m_qy, m_qz;
+    // The filters are initialized from the first accelerometer (and magnetometer) input
+    std::vector<uint8_t> m_initialized;
+    bool m_pendingInitialization = false;
+
+    void initialize();
+
+public:
+    explicit OrientationFilterBank(const bool useMagnetometer = false);
+
+    void resize(const size_t size);
+    size_t size() const { return m_qw.size(); }
+    bool usesMagnetometer() const { return m_useMagnetometer; }
+
+    // Gain of the gradient descent correction, in rad/s
+    void setGain(const double gain) { m_gain = gain; }
+    double getGain() const { return m_gain; }
+
+    // Set the inputs of the filter i: the accelerometer (any unit), the gyroscope in rad/s, and
+    // the magnetometer (any unit, ignored without the magnetometer). A zero accelerometer or
+    // magnetometer disables the corresponding correction, so that setting all the inputs to zero
+    // holds the orientation.
+    void setInput(const size_t i,
+                  const double* acc,
+                  const double* gyro,
+                  const double* mag = nullptr);
+    void setInput(const size_t i,
+                  const double ax,
+                  const double ay,
+                  const double az,
+                  const double gx,
+                  const double gy,
+                  const double gz,
+                  const double mx = 0,
+                  const double my = 0,
+                  const double mz = 0);
+
+    // Update all the filters with the last inputs, dt is the time since the previous update
+    void update(const double dt);
+
+    // Orientation of the filter i, as w x y z
+    void getOrientation(const size_t i, double* quaternion) const;
+
+    // Initialize the filter i again from its next input
+    void reset(const size_t i);
+};
+
+#endif // WEARABLE_FUSION_ORIENTATIONFUSION_H
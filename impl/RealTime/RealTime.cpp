@@ -0,0 +1,300 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/RealTime/RealTime.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Searchable.h>
+#include <yarp/os/Value.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+using namespace wearable::realtime;
+
+// Number of cpus that can be set in the affinity: the bits of the mask on Windows, the size of
+// cpu_set_t on Linux
+#if defined(_WIN32)
+constexpr int MaxCpus = static_cast<int>(sizeof(DWORD_PTR) * 8);
+#elif defined(CPU_SETSIZE)
+constexpr int MaxCpus = CPU_SETSIZE;
+#else
+constexpr int MaxCpus = 1024;
+#endif
+
+// ===============
+// Thread settings
+// ===============
+
+bool wearable::realtime::parseThreadSettings(const yarp::os::Searchable& config,
+                                             ThreadSettings& settings,
+                                             std::string& error)
+{
+    settings = {};
+
+    if (config.check("schedPolicy")) {
+        const std::string policy = config.find("schedPolicy").asString();
+        if (policy == "other") {
+            settings.policy = SchedulingPolicy::Other;
+        }
+        else if (policy == "fifo") {
+            settings.policy = SchedulingPolicy::Fifo;
+        }
+        else if (policy == "rr") {
+            settings.policy = SchedulingPolicy::RoundRobin;
+        }
+        else {
+            error = "schedPolicy option must be other, fifo or rr, found " + policy;
+            return false;
+        }
+    }
+
+    if (config.check("schedPriority")) {
+        if (!config.find("schedPriority").isInt32()) {
+            error = "schedPriority option is not an integer";
+            return false;
+        }
+        settings.priority = config.find("schedPriority").asInt32();
+    }
+
+    if (settings.policy != SchedulingPolicy::Other && settings.priority <= 0) {
+        error = "schedPriority option must be positive with the fifo and rr policies";
+        return false;
+    }
+
+    if (config.check("cpuAffinity")) {
+        const yarp::os::Value& value = config.find("cpuAffinity");
+        if (value.isInt32()) {
+            settings.cpuAffinity.push_back(value.asInt32());
+        }
+        else if (value.isList()) {
+            const yarp::os::Bottle* cpus = value.asList();
+            for (size_t i = 0; i < cpus->size(); ++i) {
+                if (!cpus->get(i).isInt32()) {
+                    error = "cpuAffinity option must contain integers";
+                    return false;
+                }
+                settings.cpuAffinity.push_back(cpus->get(i).asInt32());
+            }
+        }
+        else {
+            error = "cpuAffinity option is not an integer or a list of integers";
+            return false;
+        }
+
+        // The cpus index the bits of the affinity mask
+        for (const int cpu : settings.cpuAffinity) {
+            if (cpu < 0 || cpu >= MaxCpus) {
+                error = "cpuAffinity option must contain cpus between 0 and "
+                        + std::to_string(MaxCpus - 1) + ", found " + std::to_string(cpu);
+                return false;
+            }
+        }
+    }
+
+    if (config.check("lockMemory")) {
+        if (!config.find("lockMemory").isBool()) {
+            error = "lockMemory option is not a bool";
+            return false;
+        }
+        settings.lockMemory = config.find("lockMemory").asBool();
+    }
+
+    if (config.check("jitterReportPeriod")) {
+        settings.jitterReportPeriod = config.find("jitterReportPeriod").asFloat64();
+        if (settings.jitterReportPeriod < 0) {
+            error = "jitterReportPeriod option must not be negative";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool wearable::realtime::applyThreadSettings(const ThreadSettings& settings, std::string& error)
+{
+    bool ok = true;
+    std::stringstream errors;
+
+#if defined(_WIN32)
+    if (settings.policy != SchedulingPolicy::Other) {
+        // There are no real-time policies, the priority is mapped to the highest thread priorities
+        const int priority =
+            settings.priority >= 50 ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+        if (!SetThreadPriority(GetCurrentThread(), priority)) {
+            errors << "failed to set the thread priority (error " << GetLastError() << "); ";
+            ok = false;
+        }
+    }
+
+    if (!settings.cpuAffinity.empty()) {
+        DWORD_PTR mask = 0;
+        for (const int cpu : settings.cpuAffinity) {
+            mask |= DWORD_PTR(1) << cpu;
+        }
+        if (!SetThreadAffinityMask(GetCurrentThread(), mask)) {
+            errors << "failed to set the cpu affinity (error " << GetLastError() << "); ";
+            ok = false;
+        }
+    }
+
+    if (settings.lockMemory) {
+        errors << "memory locking is not supported on this platform; ";
+        ok = false;
+    }
+#else
+    if (settings.policy != SchedulingPolicy::Other) {
+        const int policy = settings.policy == SchedulingPolicy::Fifo ? SCHED_FIFO : SCHED_RR;
+        sched_param param{};
+        param.sched_priority = std::min(std::max(settings.priority, sched_get_priority_min(policy)),
+                                        sched_get_priority_max(policy));
+        const int result = pthread_setschedparam(pthread_self(), policy, &param);
+        if (result != 0) {
+            errors << "failed to set the scheduling policy (" << std::strerror(result) << "); ";
+            ok = false;
+        }
+    }
+
+    if (!settings.cpuAffinity.empty()) {
+#if defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (const int cpu : settings.cpuAffinity) {
+            CPU_SET(cpu, &cpus);
+        }
+        const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (result != 0) {
+            errors << "failed to set the cpu affinity (" << std::strerror(result) << "); ";
+            ok = false;
+        }
+#else
+        errors << "cpu affinity is not supported on this platform; ";
+        ok = false;
+#endif
+    }
+
+    // The lock is process wide, it also covers the memory allocated after this call
+    if (settings.lockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        errors << "failed to lock the memory (" << std::strerror(errno) << "); ";
+        ok = false;
+    }
+#endif
+
+    error = errors.str();
+    return ok;
+}
+
+std::string wearable::realtime::toString(const ThreadSettings& settings)
+{
+    std::stringstream description;
+    switch (settings.policy) {
+        case SchedulingPolicy::Other:
+            description << "policy other";
+            break;
+        case SchedulingPolicy::Fifo:
+            description << "policy fifo priority " << settings.priority;
+            break;
+        case SchedulingPolicy::RoundRobin:
+            description << "policy rr priority " << settings.priority;
+            break;
+    }
+
+    if (!settings.cpuAffinity.empty()) {
+        description << ", cpus";
+        for (const int cpu : settings.cpuAffinity) {
+            description << " " << cpu;
+        }
+    }
+    if (settings.lockMemory) {
+        description << ", memory locked";
+    }
+    return description.str();
+}
+
+// ================
+// JitterStatistics
+// ================
+
+void JitterStatistics::tickStart()
+{
+    const Clock::time_point now = Clock::now();
+
+    if (m_started && m_period > 0) {
+        const double interval = std::chrono::duration<double>(now - m_tickStart).count();
+        const double jitter = interval - m_period;
+
+        // Welford's algorithm
+        ++m_intervals;
+        const double delta = jitter - m_jitterMean;
+        m_jitterMean += delta / m_intervals;
+        m_jitterM2 += delta * (jitter - m_jitterMean);
+        m_jitterMax = std::max(m_jitterMax, std::abs(jitter));
+    }
+    else if (!m_started) {
+        m_lastReport = now;
+    }
+
+    m_started = true;
+    m_tickStart = now;
+}
+
+void JitterStatistics::tickEnd()
+{
+    const double duration = std::chrono::duration<double>(Clock::now() - m_tickStart).count();
+
+    ++m_ticks;
+    m_durationMean += (duration - m_durationMean) / m_ticks;
+    m_durationMax = std::max(m_durationMax, duration);
+    if (m_period > 0 && duration > m_period) {
+        ++m_overruns;
+    }
+}
+
+bool JitterStatistics::reportDue()
+{
+    if (m_reportPeriod <= 0 || !m_started) {
+        return false;
+    }
+
+    const Clock::time_point now = Clock::now();
+    if (std::chrono::duration<double>(now - m_lastReport).count() < m_reportPeriod) {
+        return false;
+    }
+    m_lastReport = now;
+    return true;
+}
+
+double JitterStatistics::getJitterStd() const
+{
+    return m_intervals > 1 ? std::sqrt(m_jitterM2 / (m_intervals - 1)) : 0;
+}
+
+std::string JitterStatistics::summary() const
+{
+    std::stringstream summary;
+    summary << m_ticks << " ticks, period " << m_period * 1e3 << " ms, jitter mean "
+            << m_jitterMean * 1e3 << " ms std " << getJitterStd() * 1e3 << " ms max "
+            << m_jitterMax * 1e3 << " ms, duration mean " << m_durationMean * 1e3 << " ms max "
+            << m_durationMax * 1e3 << " ms, " << m_overruns << " overruns";
+    return summary.str();
+}
+
+void JitterStatistics::reset()
+{
+    const double period = m_period;
+    const double reportPeriod = m_reportPeriod;
+    *this = JitterStatistics();
+    m_period = period;
+    m_reportPeriod = reportPeriod;
+}
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_REALTIME_H
+#define WEARABLE_REALTIME_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Real-time settings of the threads running the loops of the wearables components, and
+// statistics of their timing.
+//
+// The settings are read from the following options of the device configuration:
+//   schedPolicy         other (default), fifo or rr
+//   schedPriority       priority of the fifo and rr policies
+//   cpuAffinity         cpu, or list of the cpus, where the thread can run (below 64 on Windows)
+//   lockMemory          lock the memory of the process, preventing page faults in the loops
+//   jitterReportPeriod  period in seconds of the timing report, 0 (default) reports only at close
+//
+// The real-time policies and the memory locking usually require elevated privileges, e.g.
+// CAP_SYS_NICE and CAP_IPC_LOCK or the rtprio and memlock limits on Linux.
+
+namespace yarp {
+    namespace os {
+        class Searchable;
+    }
+} // namespace yarp
+
+namespace wearable {
+    namespace realtime {
+        enum class SchedulingPolicy
+        {
+            Other,
+            Fifo,
+            RoundRobin,
+        };
+
+        struct ThreadSettings
+        {
+            SchedulingPolicy policy = SchedulingPolicy::Other;
+            int priority = 0;
+            std::vector<int> cpuAffinity;
+            bool lockMemory = false;
+            double jitterReportPeriod = 0;
+        };
+
+        // Read the settings from the device configuration
+        bool parseThreadSettings(const yarp::os::Searchable& config,
+                                 ThreadSettings& settings,
+                                 std::string& error);
+
+        // Apply the settings to the calling thread. Nothing is done with the default settings.
+        bool applyThreadSettings(const ThreadSettings& settings, std::string& error);
+
+        // Describe the settings, e.g. to log them when they are applied
+        std::string toString(const ThreadSettings& settings);
+
+        class JitterStatistics;
+        class ScopedTick;
+    } // namespace realtime
+} // namespace wearable
+
+// Online statistics of the timing of a periodic loop. The jitter is the difference between
+// the time elapsed from the previous tick and the nominal period, and the overruns are the ticks
+// lasting more than the period. The statistics are not synchronized, they must be read from the
+// thread of the loop or after the loop has stopped.
+class wearable::realtime::JitterStatistics
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    double m_period = 0;
+    double m_reportPeriod = 0;
+
+    bool m_started = false;
+    Clock::time_point m_tickStart;
+    Clock::time_point m_lastReport;
+
+    size_t m_ticks = 0;
+    size_t m_intervals = 0;
+    size_t m_overruns = 0;
+    double m_jitterMean = 0;
+    double m_jitterM2 = 0;
+    double m_jitterMax = 0;
+    double m_durationMean = 0;
+    double m_durationMax = 0;
+
+public:
+    void setPeriod(const double period) { m_period = period; }
+    void setReportPeriod(const double reportPeriod) { m_reportPeriod = reportPeriod; }
+
+    void tickStart();
+    void tickEnd();
+
+    // True once every report period, to log the summary from the loop
+    bool reportDue();
+
+    size_t getTicks() const { return m_ticks; }
+    size_t getOverruns() const { return m_overruns; }
+    double getJitterMean() const { return m_jitterMean; }
+    double getJitterStd() const;
+    double getJitterMax() const { return m_jitterMax; }
+    double getDurationMean() const { return m_durationMean; }
+    double getDurationMax() const { return m_durationMax; }
+
+    std::string summary() const;
+    void reset();
+};
+
+// Measure a tick from this line to the end of the scope
+class wearable::realtime::ScopedTick
+{
+private:
+    JitterStatistics& m_statistics;
+
+public:
+    explicit ScopedTick(JitterStatistics& statistics)
+        : m_statistics(statistics)
+    {
+        m_statistics.tickStart();
+    }
+
+    ~ScopedTick() { m_statistics.tickEnd(); }
+
+    ScopedTick(const ScopedTick& other) = delete;
+    ScopedTick& operator=(const ScopedTick& other) = delete;
+};
+
+#endif // WEARABLE_REALTIME_H
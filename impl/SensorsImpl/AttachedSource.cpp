@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/IWear/impl/AttachedSource.h"
+
+#include <yarp/os/LogStream.h>
+
+using namespace wearable;
+using namespace wearable::impl;
+
+bool AttachedSource::attach(yarp::dev::PolyDriver* poly, const std::string& logPrefix)
+{
+    if (!poly) {
+        yError() << logPrefix << "Passed PolyDriver is nullptr.";
+        return false;
+    }
+
+    if (m_iWear || !poly->view(m_iWear) || !m_iWear) {
+        yError() << logPrefix << "Failed to view the IWear interface from the PolyDriver.";
+        return false;
+    }
+
+    // The stamp of the attached device is forwarded when available
+    if (!poly->view(m_timed)) {
+        m_timed = nullptr;
+    }
+
+    m_lastTimestamp = {};
+    m_samples = 0;
+    m_waitingCounter = 0;
+    return true;
+}
+
+void AttachedSource::detach()
+{
+    m_iWear = nullptr;
+    m_timed = nullptr;
+}
+
+WearableName AttachedSource::getWearableName() const
+{
+    WearableName name = m_iWear->getWearableName();
+    if (name.size() >= wearable::Separator.size()
+        && name.compare(name.size() - wearable::Separator.size(),
+                        wearable::Separator.size(),
+                        wearable::Separator)
+               == 0) {
+        name.erase(name.size() - wearable::Separator.size());
+    }
+    return name;
+}
+
+bool AttachedSource::isProvidingData(const WearStatus status, const std::string& logPrefix)
+{
+    if (status == WearStatus::Calibrating || status == WearStatus::WaitingForFirstRead
+        || status == WearStatus::Error || status == WearStatus::Unknown) {
+        if (m_waitingCounter++ % 1000 == 0) {
+            yInfo() << logPrefix << "The attached IWear is not Ok (" << static_cast<int>(status)
+                    << "). Waiting...";
+        }
+        return false;
+    }
+    m_waitingCounter = 0;
+    return true;
+}
+
+bool AttachedSource::nextSample(TimeStamp& timestamp, double& dt)
+{
+    timestamp = m_iWear->getTimeStamp();
+    if (m_samples > 0 && timestamp.sequenceNumber == m_lastTimestamp.sequenceNumber
+        && timestamp.time == m_lastTimestamp.time) {
+        return false;
+    }
+
+    dt = m_samples > 0 ? timestamp.time - m_lastTimestamp.time : 0;
+    m_lastTimestamp = timestamp;
+    m_samples++;
+    return true;
+}
+
+yarp::os::Stamp AttachedSource::getStamp(const TimeStamp& timestamp) const
+{
+    return m_timed ? m_timed->getLastInputStamp()
+                   : yarp::os::Stamp(static_cast<int>(timestamp.sequenceNumber), timestamp.time);
+}
@@ -3,8 +3,72 @@
 
 #include "Wearable/IWear/Sensors/impl/SensorsImpl.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace wearable::sensor::impl;
 
+// =================
+// SampleBlockBuffer
+// =================
+
+void SampleBlockBuffer::setHistory(const double history)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_history = history;
+}
+
+bool SampleBlockBuffer::append(const wearable::sensor::SampleBlock& block)
+{
+    if (block.channels == 0 || block.values.size() % block.channels != 0
+        || !(block.samplePeriod > 0)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_values.empty() || block.firstSample != m_firstSample + m_values.size() / m_channels
+        || block.samplePeriod != m_samplePeriod || block.channels != m_channels) {
+        m_values.clear();
+        m_firstSample = block.firstSample;
+        m_samplePeriod = block.samplePeriod;
+        m_channels = block.channels;
+    }
+    m_values.insert(m_values.end(), block.values.begin(), block.values.end());
+
+    // Keep the samples of the history, and at least the ones of the last block
+    const size_t samples = m_values.size() / m_channels;
+    const size_t kept = std::min(
+        samples,
+        std::max(block.values.size() / m_channels,
+                 static_cast<size_t>(std::ceil(m_history / m_samplePeriod))));
+    m_values.erase(m_values.begin(), m_values.begin() + (samples - kept) * m_channels);
+    m_firstSample += samples - kept;
+    m_startTime = block.startTime - (block.firstSample - m_firstSample) * m_samplePeriod;
+    return true;
+}
+
+bool SampleBlockBuffer::read(size_t& nextSample, wearable::sensor::SampleBlock& block) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    block.values.clear();
+    if (m_values.empty()) {
+        return true;
+    }
+
+    // A reader ahead of the samples follows a restart of the acquisition
+    const size_t endSample = m_firstSample + m_values.size() / m_channels;
+    const size_t first =
+        nextSample < m_firstSample || nextSample > endSample ? m_firstSample : nextSample;
+
+    block.firstSample = first;
+    block.startTime = m_startTime + (first - m_firstSample) * m_samplePeriod;
+    block.samplePeriod = m_samplePeriod;
+    block.channels = m_channels;
+    block.values.assign(m_values.begin() + (first - m_firstSample) * m_channels, m_values.end());
+    nextSample = endSample;
+    return true;
+}
+
 // =============
 // Accelerometer
 // =============
@@ -20,6 +84,11 @@ bool Accelerometer::getLinearAcceleration(wearable::Vector3& linearAcceleration)
     return true;
 }
 
+bool Accelerometer::getSampleBlock(size_t& nextSample, wearable::sensor::SampleBlock& block) const
+{
+    return m_samples.read(nextSample, block);
+}
+
 void Accelerometer::setBuffer(const wearable::Vector3& data)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -48,6 +117,11 @@ bool EmgSensor::getNormalizationValue(double& normalizationValue) const
     return true;
 }
 
+bool EmgSensor::getSampleBlock(size_t& nextSample, wearable::sensor::SampleBlock& block) const
+{
+    return m_samples.read(nextSample, block);
+}
+
 void EmgSensor::setBuffer(const double value, const double normalization)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -139,6 +213,11 @@ bool Gyroscope::getAngularRate(wearable::Vector3& angularRate) const
     return true;
 }
 
+bool Gyroscope::getSampleBlock(size_t& nextSample, wearable::sensor::SampleBlock& block) const
+{
+    return m_samples.read(nextSample, block);
+}
+
 void Gyroscope::setBuffer(const wearable::Vector3& data)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -160,6 +239,11 @@ bool Magnetometer::getMagneticField(wearable::Vector3& magneticField) const
     return true;
 }
 
+bool Magnetometer::getSampleBlock(size_t& nextSample, wearable::sensor::SampleBlock& block) const
+{
+    return m_samples.read(nextSample, block);
+}
+
 void Magnetometer::setBuffer(const wearable::Vector3& data)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
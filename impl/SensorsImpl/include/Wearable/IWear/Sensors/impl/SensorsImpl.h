@@ -5,12 +5,14 @@
 #define SENSORSIMPL_H
 
 #include "Wearable/IWear/IWear.h"
+#include <deque>
 #include <mutex>
 #include <vector>
 
 namespace wearable {
     namespace sensor {
         namespace impl {
+            class SampleBlockBuffer;
             class Accelerometer;
             class EmgSensor;
             class Force3DSensor;
@@ -31,10 +33,34 @@ namespace wearable {
     } // namespace sensor
 } // namespace wearable
 
+// Samples of the last seconds of history of a sensor delivering sample blocks, read by any
+// number of readers with their own next sample. The time of the stored samples follows the start
+// time of the last block.
+class wearable::sensor::impl::SampleBlockBuffer
+{
+private:
+    mutable std::mutex m_mutex;
+    double m_history = 1.0;
+    size_t m_firstSample = 0;
+    double m_startTime = 0;
+    double m_samplePeriod = 0;
+    size_t m_channels = 0;
+    std::deque<double> m_values;
+
+public:
+    void setHistory(const double history);
+
+    // The stored samples are dropped if the block does not follow them, or if its sample period
+    // or number of channels changed. Return false if the block is not valid.
+    bool append(const wearable::sensor::SampleBlock& block);
+    bool read(size_t& nextSample, wearable::sensor::SampleBlock& block) const;
+};
+
 class wearable::sensor::impl::Accelerometer : public wearable::sensor::IAccelerometer
 {
 public:
     wearable::Vector3 m_buffer;
+    wearable::sensor::impl::SampleBlockBuffer m_samples;
     mutable std::mutex m_mutex;
 
     Accelerometer(wearable::sensor::SensorName n = {},
@@ -42,6 +68,7 @@ public:
     ~Accelerometer() override = default;
 
     bool getLinearAcceleration(wearable::Vector3& linearAcceleration) const override;
+    bool getSampleBlock(size_t& nextSample, wearable::sensor::SampleBlock& block) const override;
 
     void setBuffer(const wearable::Vector3& data);
     inline void setStatus(const wearable::sensor::SensorStatus status) { m_status = status; }
@@ -52,6 +79,7 @@ class wearable::sensor::impl::EmgSensor : public wearable::sensor::IEmgSensor
 public:
     double m_value;
     double m_normalization;
+    wearable::sensor::impl::SampleBlockBuffer m_samples;
     mutable std::mutex m_mutex;
 
     EmgSensor(wearable::sensor::SensorName n, wearable::sensor::SensorStatus s);
@@ -59,6 +87,7 @@ public:
 
     bool getEmgSignal(double& emgSignal) const override;
     bool getNormalizationValue(double& normalizationValue) const override;
+    bool getSampleBlock(size_t& nextSample, wearable::sensor::SampleBlock& block) const override;
 
     void setBuffer(const double value, const double normalization);
     inline void setStatus(const wearable::sensor::SensorStatus status) { m_status = status; }
@@ -117,6 +146,7 @@ class wearable::sensor::impl::Gyroscope : public wearable::sensor::IGyroscope
 {
 public:
     wearable::Vector3 m_buffer;
+    wearable::sensor::impl::SampleBlockBuffer m_samples;
     mutable std::mutex m_mutex;
 
     Gyroscope(wearable::sensor::SensorName n = {},
@@ -124,6 +154,7 @@ public:
     ~Gyroscope() override = default;
 
     bool getAngularRate(wearable::Vector3& angularRate) const override;
+    bool getSampleBlock(size_t& nextSample, wearable::sensor::SampleBlock& block) const override;
 
     void setBuffer(const wearable::Vector3& data);
     inline void setStatus(const wearable::sensor::SensorStatus status) { m_status = status; }
@@ -133,6 +164,7 @@ class wearable::sensor::impl::Magnetometer : public wearable::sensor::IMagnetome
 {
 public:
     wearable::Vector3 m_buffer;
+    wearable::sensor::impl::SampleBlockBuffer m_samples;
     mutable std::mutex m_mutex;
 
     Magnetometer(wearable::sensor::SensorName n = {},
@@ -140,6 +172,7 @@ public:
     ~Magnetometer() override = default;
 
     bool getMagneticField(wearable::Vector3& magneticField) const override;
+    bool getSampleBlock(size_t& nextSample, wearable::sensor::SampleBlock& block) const override;
 
     void setBuffer(const wearable::Vector3& data);
     inline void setStatus(const wearable::sensor::SensorStatus status) { m_status = status; }
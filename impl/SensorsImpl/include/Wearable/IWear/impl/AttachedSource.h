@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_IMPL_ATTACHEDSOURCE_H
+#define WEARABLE_IMPL_ATTACHEDSOURCE_H
+
+#include "Wearable/IWear/IWear.h"
+
+#include <yarp/dev/IPreciselyTimed.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/os/Stamp.h>
+
+#include <string>
+
+namespace wearable {
+    namespace impl {
+        class AttachedSource;
+    } // namespace impl
+} // namespace wearable
+
+// IWear device attached to a device processing its data, as the caches and the estimators.
+// It tracks the samples of the attached device: a new sample changes its sequence number or its
+// time, since most devices keep the sequence number to zero.
+// It is not thread safe, it is meant to be used by the attach and the loop of the device.
+class wearable::impl::AttachedSource
+{
+private:
+    IWear* m_iWear = nullptr;
+    yarp::dev::IPreciselyTimed* m_timed = nullptr;
+
+    TimeStamp m_lastTimestamp;
+    size_t m_samples = 0;
+    size_t m_waitingCounter = 0;
+
+public:
+    // View the IWear interface of the driver, and its IPreciselyTimed interface when available.
+    // Fail if a device is already attached.
+    bool attach(yarp::dev::PolyDriver* poly, const std::string& logPrefix);
+    void detach();
+
+    explicit operator bool() const { return m_iWear != nullptr; }
+    IWear* operator->() const { return m_iWear; }
+
+    // Name of the attached device, without the trailing separator
+    WearableName getWearableName() const;
+
+    // Return false, logging it every 1000 calls, while the attached device does not provide data
+    bool isProvidingData(const WearStatus status, const std::string& logPrefix);
+
+    // Return true if the attached device has a new sample, with its timestamp and the time elapsed
+    // since the previous one, and count it
+    bool nextSample(TimeStamp& timestamp, double& dt);
+    // Number of samples since the attach
+    size_t getSamples() const { return m_samples; }
+
+    // Stamp of the attached device when available, otherwise the given timestamp of the device
+    // processing its data
+    yarp::os::Stamp getStamp(const TimeStamp& timestamp) const;
+};
+
+#endif // WEARABLE_IMPL_ATTACHEDSOURCE_H
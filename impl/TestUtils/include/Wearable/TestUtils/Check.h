@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_TESTUTILS_CHECK_H
+#define WEARABLE_TESTUTILS_CHECK_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Checks of the unit tests. A failed check is reported and counted, without stopping the test,
+// and the exit status of the test tells whether any check failed.
+
+namespace wearable {
+    namespace test {
+        inline size_t& failures()
+        {
+            static size_t count = 0;
+            return count;
+        }
+
+        inline void check(const bool condition, const std::string& message)
+        {
+            if (!condition) {
+                std::cerr << "FAILED: " << message << std::endl;
+                ++failures();
+            }
+        }
+
+        inline int exitStatus()
+        {
+            if (failures() > 0) {
+                std::cerr << failures() << " checks failed" << std::endl;
+                return EXIT_FAILURE;
+            }
+            return EXIT_SUCCESS;
+        }
+    } // namespace test
+} // namespace wearable
+
+#endif // WEARABLE_TESTUTILS_CHECK_H
@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/Tracing/Tracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace wearable::tracing;
+
+constexpr size_t DefaultBufferSize = 1 << 16;
+
+namespace {
+    // Ring buffer written only by its thread. The events are published by incrementing the
+    // number of written events after storing them, and a reader discards the events that could
+    // have been overwritten while it was copying them, including the slot being written.
+    struct ThreadBuffer
+    {
+        uint32_t id = 0;
+        const char* name = nullptr;
+        std::vector<Event> events;
+        std::atomic<uint64_t> written{0};
+    };
+
+    class Registry
+    {
+    public:
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::atomic<bool> enabled{false};
+        std::string fileName;
+        size_t bufferSize = DefaultBufferSize;
+
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+        Registry()
+        {
+            if (const char* file = std::getenv("WEARABLES_TRACE_FILE")) {
+                fileName = file;
+                enabled = !fileName.empty();
+            }
+            if (const char* size = std::getenv("WEARABLES_TRACE_BUFFER_SIZE")) {
+                bufferSize = std::max<long>(std::atol(size), 1);
+            }
+        }
+
+        ~Registry()
+        {
+            if (!fileName.empty()) {
+                enabled = false;
+                dump(fileName);
+            }
+        }
+
+        std::shared_ptr<ThreadBuffer> registerThread(const char* name)
+        {
+            auto buffer = std::make_shared<ThreadBuffer>();
+            buffer->name = name;
+            buffer->events.resize(bufferSize);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            buffer->id = static_cast<uint32_t>(buffers.size() + 1);
+            buffers.push_back(buffer);
+            return buffer;
+        }
+    };
+
+    Registry& registry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    void writeString(std::ostream& out, const char* text)
+    {
+        out << '"';
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                out << '\\';
+            }
+            out << *c;
+        }
+        out << '"';
+    }
+} // namespace
+
+bool wearable::tracing::isEnabled()
+{
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+void wearable::tracing::setEnabled(const bool enabled)
+{
+    registry().enabled = enabled;
+}
+
+uint64_t wearable::tracing::now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now() - registry().start)
+                                     .count());
+}
+
+void wearable::tracing::record(const Event& event)
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer = registry().registerThread(event.name);
+
+    const uint64_t position = buffer->written.load(std::memory_order_relaxed);
+    buffer->events[position % buffer->events.size()] = event;
+    buffer->written.store(position + 1, std::memory_order_release);
+}
+
+bool wearable::tracing::dump(const std::string& fileName)
+{
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        buffers = registry().buffers;
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+
+    bool first = true;
+    std::vector<Event> events;
+    for (const auto& buffer : buffers) {
+        const uint64_t size = buffer->events.size();
+
+        // Copy the events, then drop the ones overwritten in the meantime. The writer may be
+        // storing the event at position written, not published yet, in the slot of the event at
+        // written - size: the first valid event is the one at written - size + 1.
+        const uint64_t end = buffer->written.load(std::memory_order_acquire);
+        const uint64_t begin = end > size ? end - size : 0;
+        events.clear();
+        for (uint64_t position = begin; position < end; ++position) {
+            events.push_back(buffer->events[position % size]);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t written = buffer->written.load(std::memory_order_relaxed);
+        const uint64_t valid = written + 1 > size ? written + 1 - size : 0;
+        const size_t discarded = static_cast<size_t>(std::min(end, std::max(begin, valid)) - begin);
+
+        file << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0"
+             << ", \"tid\": " << buffer->id << ", \"args\": {\"name\": ";
+        writeString(file, buffer->name);
+        file << "}}";
+        first = false;
+
+        for (size_t i = discarded; i < events.size(); ++i) {
+            const Event& event = events[i];
+            file << ",\n{\"name\": ";
+            writeString(file, event.name);
+            file << ", \"pid\": 0, \"tid\": " << buffer->id << ", \"ts\": " << event.time / 1e3;
+            if (event.type == EventType::Span) {
+                file << ", \"ph\": \"X\", \"dur\": " << event.duration / 1e3 << "}";
+            }
+            else {
+                file << ", \"ph\": \"C\", \"args\": {\"value\": " << event.value << "}}";
+            }
+        }
+    }
+
+    file << std::endl << "]}" << std::endl;
+    return file.good();
+}
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_TRACING_H
+#define WEARABLE_TRACING_H
+
+#include <cstdint>
+#include <string>
+
+// Tracing of the run loops. The spans and the counters are compiled only when the project is
+// configured with WEARABLES_ENABLE_TRACING, otherwise the macros expand to nothing.
+//
+// Each thread records its events in its own ring buffer, without locks, keeping the most recent
+// events. When the WEARABLES_TRACE_FILE environment variable is set, the events are recorded
+// and dumped to the file at exit in the Chrome trace format, which can be opened with
+// chrome://tracing or https://ui.perfetto.dev.
+//
+// The names of the spans and of the counters must be string literals.
+
+namespace wearable {
+    namespace tracing {
+        enum class EventType : uint8_t
+        {
+            Span,
+            Counter,
+        };
+
+        struct Event
+        {
+            const char* name;
+            EventType type;
+            uint64_t time; // ns from the start of the trace
+            union
+            {
+                uint64_t duration; // ns
+                double value;
+            };
+        };
+
+        // True if the events are being recorded
+        bool isEnabled();
+
+        // Start and stop recording, e.g. when the trace is dumped programmatically
+        void setEnabled(const bool enabled);
+
+        uint64_t now();
+        void record(const Event& event);
+
+        // Write the events recorded so far. The events of the running threads that are
+        // overwritten while dumping are discarded.
+        bool dump(const std::string& fileName);
+
+        class Span;
+    } // namespace tracing
+} // namespace wearable
+
+class wearable::tracing::Span
+{
+private:
+    const char* m_name;
+    uint64_t m_start;
+
+public:
+    explicit Span(const char* name)
+        : m_name(isEnabled() ? name : nullptr)
+        , m_start(m_name ? now() : 0)
+    {}
+
+    ~Span()
+    {
+        if (m_name) {
+            Event event;
+            event.name = m_name;
+            event.type = EventType::Span;
+            event.time = m_start;
+            event.duration = now() - m_start;
+            record(event);
+        }
+    }
+
+    Span(const Span& other) = delete;
+    Span& operator=(const Span& other) = delete;
+};
+
+#ifdef WEARABLES_TRACING_ENABLED
+
+#define WEARABLES_TRACE_CONCAT_IMPL(a, b) a##b
+#define WEARABLES_TRACE_CONCAT(a, b) WEARABLES_TRACE_CONCAT_IMPL(a, b)
+
+// Trace the time spent from this line to the end of the scope
+#define WEARABLES_TRACE_SCOPE(spanName) \
+    const wearable::tracing::Span WEARABLES_TRACE_CONCAT(wearablesTraceSpan, __LINE__)(spanName)
+
+// Trace the value of a counter
+#define WEARABLES_TRACE_COUNTER(counterName, counterValue)         \
+    do {                                                           \
+        if (wearable::tracing::isEnabled()) {                      \
+            wearable::tracing::Event wearablesTraceEvent;          \
+            wearablesTraceEvent.name = counterName;                \
+            wearablesTraceEvent.type =                             \
+                wearable::tracing::EventType::Counter;             \
+            wearablesTraceEvent.time = wearable::tracing::now();   \
+            wearablesTraceEvent.value =                            \
+                static_cast<double>(counterValue);                 \
+            wearable::tracing::record(wearablesTraceEvent);        \
+        }                                                          \
+    } while (false)
+
+#else
+
+#define WEARABLES_TRACE_SCOPE(spanName) static_cast<void>(0)
+#define WEARABLES_TRACE_COUNTER(counterName, counterValue) static_cast<void>(0)
+
+#endif // WEARABLES_TRACING_ENABLED
+
+#endif // WEARABLE_TRACING_H
@@ -0,0 +1,380 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/WireEncoding/Quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+using namespace wearable::encoding;
+
+constexpr int32_t Fixed16Max = 32767;
+constexpr int16_t Fixed16NaN = -32768;
+// Stored components of SmallestThree, in [-SmallestThreeMax, SmallestThreeMax]
+constexpr double SmallestThreeMax = 0.70710678118654752440;
+constexpr uint32_t SmallestThreeSteps = 32766;
+constexpr size_t SmallestThreeBits = 15;
+constexpr double UInt16Max = 65534;
+constexpr uint16_t UInt16NaN = 65535;
+constexpr double Float16Max = 65504;
+constexpr uint16_t Float16NaN = 0x7E00;
+
+static void appendBytes(const uint64_t bits, const size_t bytes, std::string& buffer)
+{
+    for (size_t i = 0; i < bytes; ++i) {
+        buffer.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+}
+
+static bool readBytes(const std::string& buffer,
+                      size_t& offset,
+                      const size_t bytes,
+                      uint64_t& bits)
+{
+    if (offset > buffer.size() || buffer.size() - offset < bytes) {
+        return false;
+    }
+    bits = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        bits |= static_cast<uint64_t>(static_cast<unsigned char>(buffer[offset + i])) << (8 * i);
+    }
+    offset += bytes;
+    return true;
+}
+
+static void appendFloat32(const double value, std::string& buffer)
+{
+    const float single = static_cast<float>(value);
+    uint32_t bits;
+    std::memcpy(&bits, &single, sizeof(bits));
+    appendBytes(bits, sizeof(bits), buffer);
+}
+
+static bool readFloat32(const std::string& buffer, size_t& offset, double& value)
+{
+    uint64_t bits;
+    if (!readBytes(buffer, offset, sizeof(uint32_t), bits)) {
+        return false;
+    }
+    const uint32_t bits32 = static_cast<uint32_t>(bits);
+    float single;
+    std::memcpy(&single, &bits32, sizeof(single));
+    value = single;
+    return true;
+}
+
+static void appendFixed16(const double value, const double range, std::string& buffer)
+{
+    int16_t fixed = Fixed16NaN;
+    if (!std::isnan(value)) {
+        const double scaled = std::round(value / range * Fixed16Max);
+        fixed = static_cast<int16_t>(
+            std::max(-static_cast<double>(Fixed16Max), std::min(scaled, double(Fixed16Max))));
+    }
+    appendBytes(static_cast<uint16_t>(fixed), sizeof(fixed), buffer);
+}
+
+static bool readFixed16(const std::string& buffer,
+                        size_t& offset,
+                        const double range,
+                        double& value)
+{
+    uint64_t bits;
+    if (!readBytes(buffer, offset, sizeof(int16_t), bits)) {
+        return false;
+    }
+    const int16_t fixed = static_cast<int16_t>(static_cast<uint16_t>(bits));
+    value = fixed == Fixed16NaN ? std::numeric_limits<double>::quiet_NaN()
+                                : fixed * range / Fixed16Max;
+    return true;
+}
+
+static void appendUInt16(const double value, std::string& buffer)
+{
+    uint16_t integer = UInt16NaN;
+    if (!std::isnan(value)) {
+        integer = static_cast<uint16_t>(std::max(0.0, std::min(std::round(value), UInt16Max)));
+    }
+    appendBytes(integer, sizeof(integer), buffer);
+}
+
+static bool readUInt16(const std::string& buffer, size_t& offset, double& value)
+{
+    uint64_t bits;
+    if (!readBytes(buffer, offset, sizeof(uint16_t), bits)) {
+        return false;
+    }
+    value = bits == UInt16NaN ? std::numeric_limits<double>::quiet_NaN()
+                              : static_cast<double>(bits);
+    return true;
+}
+
+// Conversion to half precision with rounding to the nearest even, done by std::nearbyint with
+// the default rounding mode
+static void appendFloat16(const double value, std::string& buffer)
+{
+    uint16_t bits = Float16NaN;
+    if (!std::isnan(value)) {
+        const uint16_t sign = std::signbit(value) ? 0x8000 : 0;
+        const double magnitude = std::abs(value);
+
+        if (magnitude >= Float16Max) {
+            bits = sign | 0x7BFF;
+        }
+        else if (magnitude < std::ldexp(1.0, -14)) {
+            // Subnormal, in units of 2^-24. Rounding up to 1024 gives the smallest normal half.
+            bits = sign | static_cast<uint16_t>(std::nearbyint(std::ldexp(magnitude, 24)));
+        }
+        else {
+            // magnitude = fraction 2^exponent, with fraction in [0.5, 1)
+            int exponent;
+            const double fraction = std::frexp(magnitude, &exponent);
+            uint16_t mantissa = static_cast<uint16_t>(std::nearbyint((2 * fraction - 1) * 1024));
+            int biased = exponent - 1 + 15;
+            if (mantissa == 1024) {
+                mantissa = 0;
+                ++biased;
+            }
+            bits = biased >= 31 ? (sign | 0x7BFF)
+                                : (sign | static_cast<uint16_t>(biased << 10) | mantissa);
+        }
+    }
+    appendBytes(bits, sizeof(bits), buffer);
+}
+
+static bool readFloat16(const std::string& buffer, size_t& offset, double& value)
+{
+    uint64_t bits;
+    if (!readBytes(buffer, offset, sizeof(uint16_t), bits)) {
+        return false;
+    }
+    const int biased = static_cast<int>((bits >> 10) & 0x1F);
+    const double mantissa = static_cast<double>(bits & 0x3FF);
+    if (biased == 31) {
+        value = mantissa == 0 ? std::numeric_limits<double>::infinity()
+                              : std::numeric_limits<double>::quiet_NaN();
+    }
+    else if (biased == 0) {
+        value = std::ldexp(mantissa, -24);
+    }
+    else {
+        value = std::ldexp(1 + mantissa / 1024, biased - 15);
+    }
+    if (bits & 0x8000) {
+        value = -value;
+    }
+    return true;
+}
+
+static void appendSmallestThree(const double* wxyz, std::string& buffer)
+{
+    const double norm =
+        std::sqrt(wxyz[0] * wxyz[0] + wxyz[1] * wxyz[1] + wxyz[2] * wxyz[2] + wxyz[3] * wxyz[3]);
+
+    // The identity, for quaternions that cannot be normalized
+    uint64_t bits = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        bits |= static_cast<uint64_t>(SmallestThreeSteps / 2) << (SmallestThreeBits * i);
+    }
+
+    if (norm > 0 && std::isfinite(norm)) {
+        size_t largest = 0;
+        for (size_t i = 1; i < 4; ++i) {
+            if (std::abs(wxyz[i]) > std::abs(wxyz[largest])) {
+                largest = i;
+            }
+        }
+        const double scale = (wxyz[largest] < 0 ? -1.0 : 1.0) / norm;
+
+        bits = static_cast<uint64_t>(largest) << (3 * SmallestThreeBits);
+        size_t stored = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            if (i == largest) {
+                continue;
+            }
+            const double component = std::max(
+                -SmallestThreeMax, std::min(wxyz[i] * scale, SmallestThreeMax));
+            const uint64_t step = static_cast<uint64_t>(
+                std::round((component / SmallestThreeMax + 1) * (SmallestThreeSteps / 2)));
+            bits |= step << (SmallestThreeBits * (2 - stored++));
+        }
+    }
+
+    appendBytes(bits, 6, buffer);
+}
+
+static bool readSmallestThree(const std::string& buffer, size_t& offset, double* wxyz)
+{
+    uint64_t bits;
+    if (!readBytes(buffer, offset, 6, bits)) {
+        return false;
+    }
+
+    const size_t largest = static_cast<size_t>((bits >> (3 * SmallestThreeBits)) & 0x3);
+    const uint64_t mask = (uint64_t(1) << SmallestThreeBits) - 1;
+
+    double sumOfSquares = 0;
+    size_t stored = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+        const uint64_t step = (bits >> (SmallestThreeBits * (2 - stored++))) & mask;
+        wxyz[i] = (static_cast<double>(step) / (SmallestThreeSteps / 2) - 1) * SmallestThreeMax;
+        sumOfSquares += wxyz[i] * wxyz[i];
+    }
+    wxyz[largest] = std::sqrt(std::max(0.0, 1 - sumOfSquares));
+    return true;
+}
+
+bool wearable::encoding::parseValueEncoding(const std::string& name, ValueEncoding& encoding)
+{
+    if (name == "float32") {
+        encoding = ValueEncoding::Float32;
+    }
+    else if (name == "fixed16") {
+        encoding = ValueEncoding::Fixed16;
+    }
+    else if (name == "smallestThree") {
+        encoding = ValueEncoding::SmallestThree;
+    }
+    else if (name == "uint16") {
+        encoding = ValueEncoding::UInt16;
+    }
+    else if (name == "float16") {
+        encoding = ValueEncoding::Float16;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+std::string wearable::encoding::toString(const ValueEncoding encoding)
+{
+    switch (encoding) {
+        case ValueEncoding::Float32:
+            return "float32";
+        case ValueEncoding::Fixed16:
+            return "fixed16";
+        case ValueEncoding::SmallestThree:
+            return "smallestThree";
+        case ValueEncoding::UInt16:
+            return "uint16";
+        case ValueEncoding::Float16:
+            return "float16";
+    }
+    return "";
+}
+
+size_t wearable::encoding::getValueSize(const ValueEncoding encoding)
+{
+    return encoding == ValueEncoding::Float32 || encoding == ValueEncoding::SmallestThree ? 4 : 2;
+}
+
+size_t wearable::encoding::getQuaternionSize(const ValueEncoding encoding)
+{
+    return encoding == ValueEncoding::SmallestThree ? 6 : 4 * getValueSize(encoding);
+}
+
+void wearable::encoding::appendValue(const double value,
+                                     const ValueEncoding encoding,
+                                     const double range,
+                                     std::string& buffer)
+{
+    switch (encoding) {
+        case ValueEncoding::Fixed16:
+            appendFixed16(value, range, buffer);
+            break;
+        case ValueEncoding::UInt16:
+            appendUInt16(value, buffer);
+            break;
+        case ValueEncoding::Float16:
+            appendFloat16(value, buffer);
+            break;
+        default:
+            appendFloat32(value, buffer);
+            break;
+    }
+}
+
+bool wearable::encoding::readValue(const std::string& buffer,
+                                   size_t& offset,
+                                   const ValueEncoding encoding,
+                                   const double range,
+                                   double& value)
+{
+    switch (encoding) {
+        case ValueEncoding::Fixed16:
+            return readFixed16(buffer, offset, range, value);
+        case ValueEncoding::UInt16:
+            return readUInt16(buffer, offset, value);
+        case ValueEncoding::Float16:
+            return readFloat16(buffer, offset, value);
+        default:
+            return readFloat32(buffer, offset, value);
+    }
+}
+
+void wearable::encoding::appendQuaternion(const double* wxyz,
+                                          const ValueEncoding encoding,
+                                          std::string& buffer)
+{
+    if (encoding == ValueEncoding::SmallestThree) {
+        appendSmallestThree(wxyz, buffer);
+        return;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        appendValue(wxyz[i], encoding, 1.0, buffer);
+    }
+}
+
+bool wearable::encoding::readQuaternion(const std::string& buffer,
+                                        size_t& offset,
+                                        const ValueEncoding encoding,
+                                        double* wxyz)
+{
+    if (encoding == ValueEncoding::SmallestThree) {
+        return readSmallestThree(buffer, offset, wxyz);
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        if (!readValue(buffer, offset, encoding, 1.0, wxyz[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double wearable::encoding::getValueErrorBound(const ValueEncoding encoding,
+                                              const double range,
+                                              const double value)
+{
+    if (encoding == ValueEncoding::Fixed16) {
+        // Plus the rounding of the scaling in double precision
+        return std::max(0.0, std::abs(value) - range) + range / (2 * Fixed16Max)
+               + range * std::numeric_limits<double>::epsilon();
+    }
+    if (encoding == ValueEncoding::UInt16) {
+        return std::max({0.0, value - UInt16Max, -value}) + 0.5;
+    }
+    if (encoding == ValueEncoding::Float16) {
+        return std::max(0.0, std::abs(value) - Float16Max)
+               + std::max(std::min(std::abs(value), Float16Max) * std::ldexp(1.0, -11),
+                          std::ldexp(1.0, -25));
+    }
+    // Below the smallest normal float the rounding error is at most half of the smallest
+    // subnormal one
+    return std::abs(value) * std::ldexp(1.0, -24) + std::numeric_limits<float>::denorm_min();
+}
+
+double wearable::encoding::getQuaternionErrorBound(const ValueEncoding encoding)
+{
+    if (encoding == ValueEncoding::SmallestThree) {
+        const double componentError = SmallestThreeMax / SmallestThreeSteps;
+        return 3 * componentError + 3 * componentError * componentError;
+    }
+    return getValueErrorBound(encoding, 1.0, 1.0);
+}
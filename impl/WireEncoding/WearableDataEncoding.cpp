@@ -0,0 +1,786 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/WireEncoding/WearableDataEncoding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+using namespace wearable;
+using namespace wearable::encoding;
+using sensor::SensorType;
+
+constexpr size_t MaxTaxels = 65534;
+// Bytes of the index and of the number of taxels of a run of sparse skin taxels
+constexpr size_t RunHeaderSize = 4;
+// References of the taxels out of the runs of the sparse skin sensors
+constexpr uint8_t ZeroReference = 0;
+constexpr uint8_t PreviousReference = 1;
+
+// =======
+// Helpers
+// =======
+
+// Call the visitor with each map of sensors of the frame and the type of its sensors
+template <typename Visitor>
+static void visitSensorMaps(msg::WearableData& data, Visitor&& visitor)
+{
+    visitor(data.accelerometers, SensorType::Accelerometer);
+    visitor(data.emgSensors, SensorType::EmgSensor);
+    visitor(data.force3DSensors, SensorType::Force3DSensor);
+    visitor(data.forceTorque6DSensors, SensorType::ForceTorque6DSensor);
+    visitor(data.freeBodyAccelerationSensors, SensorType::FreeBodyAccelerationSensor);
+    visitor(data.gyroscopes, SensorType::Gyroscope);
+    visitor(data.magnetometers, SensorType::Magnetometer);
+    visitor(data.orientationSensors, SensorType::OrientationSensor);
+    visitor(data.poseSensors, SensorType::PoseSensor);
+    visitor(data.positionSensors, SensorType::PositionSensor);
+    visitor(data.skinSensors, SensorType::SkinSensor);
+    visitor(data.temperatureSensors, SensorType::TemperatureSensor);
+    visitor(data.torque3DSensors, SensorType::Torque3DSensor);
+    visitor(data.virtualLinkKinSensors, SensorType::VirtualLinkKinSensor);
+    visitor(data.virtualJointKinSensors, SensorType::VirtualJointKinSensor);
+    visitor(data.virtualSphericalJointKinSensors, SensorType::VirtualSphericalJointKinSensor);
+}
+
+static msg::ValueEncoding toMessage(const ValueEncoding encoding)
+{
+    switch (encoding) {
+        case ValueEncoding::Fixed16:
+            return msg::ValueEncoding::FIXED16;
+        case ValueEncoding::SmallestThree:
+            return msg::ValueEncoding::SMALLEST_THREE;
+        case ValueEncoding::UInt16:
+            return msg::ValueEncoding::UINT16;
+        case ValueEncoding::Float16:
+            return msg::ValueEncoding::FLOAT16;
+        default:
+            return msg::ValueEncoding::FLOAT32;
+    }
+}
+
+static bool fromMessage(const msg::ValueEncoding encoding, ValueEncoding& output)
+{
+    switch (encoding) {
+        case msg::ValueEncoding::FLOAT32:
+            output = ValueEncoding::Float32;
+            return true;
+        case msg::ValueEncoding::FIXED16:
+            output = ValueEncoding::Fixed16;
+            return true;
+        case msg::ValueEncoding::SMALLEST_THREE:
+            output = ValueEncoding::SmallestThree;
+            return true;
+        case msg::ValueEncoding::UINT16:
+            output = ValueEncoding::UInt16;
+            return true;
+        case msg::ValueEncoding::FLOAT16:
+            output = ValueEncoding::Float16;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Bytes of the encoded values of a sensor. The values that are not a quaternion are encoded as
+// Float32 with SmallestThree.
+static size_t getEncodedSize(const size_t values,
+                             const bool quaternion,
+                             const ValueEncoding encoding)
+{
+    const ValueEncoding valueEncoding =
+        encoding == ValueEncoding::SmallestThree ? ValueEncoding::Float32 : encoding;
+    return quaternion ? getQuaternionSize(encoding) + (values - 4) * getValueSize(valueEncoding)
+                      : values * getValueSize(valueEncoding);
+}
+
+static void encodeValues(const std::vector<double>& values,
+                         const bool quaternion,
+                         const ValueEncoding encoding,
+                         const double range,
+                         std::string& buffer)
+{
+    size_t first = 0;
+    if (quaternion) {
+        appendQuaternion(values.data(), encoding, buffer);
+        first = 4;
+    }
+
+    const ValueEncoding valueEncoding =
+        encoding == ValueEncoding::SmallestThree ? ValueEncoding::Float32 : encoding;
+    for (size_t i = first; i < values.size(); ++i) {
+        appendValue(values[i], valueEncoding, range, buffer);
+    }
+}
+
+static bool decodeValues(const std::string& buffer,
+                         size_t& offset,
+                         const bool quaternion,
+                         const ValueEncoding encoding,
+                         const double range,
+                         std::vector<double>& values)
+{
+    size_t first = 0;
+    if (quaternion) {
+        if (!readQuaternion(buffer, offset, encoding, values.data())) {
+            return false;
+        }
+        first = 4;
+    }
+
+    const ValueEncoding valueEncoding =
+        encoding == ValueEncoding::SmallestThree ? ValueEncoding::Float32 : encoding;
+    for (size_t i = first; i < values.size(); ++i) {
+        if (!readValue(buffer, offset, valueEncoding, range, values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void appendUInt16(const size_t value, std::string& buffer)
+{
+    buffer.push_back(static_cast<char>(value & 0xFF));
+    buffer.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+static bool readUInt16(const std::string& buffer, size_t& offset, size_t& value)
+{
+    if (offset > buffer.size() || buffer.size() - offset < 2) {
+        return false;
+    }
+    value = static_cast<unsigned char>(buffer[offset])
+            | (static_cast<size_t>(static_cast<unsigned char>(buffer[offset + 1])) << 8);
+    offset += 2;
+    return true;
+}
+
+// Scaling of the skin taxels, used by UInt16 and Float16
+static bool isScaled(const ValueEncoding encoding)
+{
+    return encoding == ValueEncoding::UInt16 || encoding == ValueEncoding::Float16;
+}
+
+static void appendTaxel(const double value, const EncodingSettings& settings, std::string& buffer)
+{
+    appendValue(isScaled(settings.encoding) ? (value - settings.offset) / settings.scale : value,
+                settings.encoding,
+                settings.range,
+                buffer);
+}
+
+static bool readTaxel(const std::string& buffer,
+                      size_t& offset,
+                      const EncodingSettings& settings,
+                      double& value)
+{
+    if (!readValue(buffer, offset, settings.encoding, settings.range, value)) {
+        return false;
+    }
+    if (isScaled(settings.encoding)) {
+        value = settings.offset + settings.scale * value;
+    }
+    return true;
+}
+
+// Check the settings of the sensors of a type, used both by the encoder and by the decoder
+static bool checkSettings(const SensorType type,
+                          const EncodingSettings& settings,
+                          std::string& error)
+{
+    const std::string typeName = sensor::sensorTypeToString(type);
+    size_t nValues = 0;
+    bool quaternion = false;
+    const bool skin = type == SensorType::SkinSensor;
+
+    if (!skin && !getValuesLayout(type, nValues, quaternion)) {
+        error = "The sensors of type " + typeName + " cannot be encoded";
+        return false;
+    }
+    if (settings.encoding == ValueEncoding::SmallestThree && !quaternion) {
+        error = "The smallestThree encoding needs sensors with an orientation, the ones of type "
+                + typeName + " have none";
+        return false;
+    }
+    if ((isScaled(settings.encoding) || settings.sparse) && !skin) {
+        error = "The uint16, float16 and sparse encodings are used only by the skin sensors";
+        return false;
+    }
+    if (settings.encoding == ValueEncoding::Fixed16 && !(settings.range > 0)) {
+        error = "The range of the fixed16 encoding of " + typeName + " must be positive";
+        return false;
+    }
+    if (isScaled(settings.encoding) && !(settings.scale > 0 && std::isfinite(settings.offset))) {
+        error = "The scale of the encoding of " + typeName
+                + " must be positive, and its offset finite";
+        return false;
+    }
+    return true;
+}
+
+// =============
+// Sensor values
+// =============
+
+void wearable::encoding::appendValues(const double input, std::vector<double>& values)
+{
+    values.push_back(input);
+}
+
+void wearable::encoding::appendValues(const std::vector<double>& input,
+                                      std::vector<double>& values)
+{
+    values.insert(values.end(), input.begin(), input.end());
+}
+
+void wearable::encoding::appendValues(const msg::VectorXYZ& input, std::vector<double>& values)
+{
+    values.insert(values.end(), {input.x, input.y, input.z});
+}
+
+void wearable::encoding::appendValues(const msg::VectorRPY& input, std::vector<double>& values)
+{
+    values.insert(values.end(), {input.r, input.p, input.y});
+}
+
+void wearable::encoding::appendValues(const msg::QuaternionWXYZ& input,
+                                      std::vector<double>& values)
+{
+    values.insert(values.end(), {input.w, input.x, input.y, input.z});
+}
+
+void wearable::encoding::appendValues(const msg::EmgData& input, std::vector<double>& values)
+{
+    values.insert(values.end(), {input.value, input.normalization});
+}
+
+void wearable::encoding::appendValues(const msg::ForceTorque6DSensorData& input,
+                                      std::vector<double>& values)
+{
+    appendValues(input.force, values);
+    appendValues(input.torque, values);
+}
+
+void wearable::encoding::appendValues(const msg::PoseSensorData& input,
+                                      std::vector<double>& values)
+{
+    appendValues(input.orientation, values);
+    appendValues(input.position, values);
+}
+
+void wearable::encoding::appendValues(const msg::VirtualLinkKinSensorData& input,
+                                      std::vector<double>& values)
+{
+    appendValues(input.orientation, values);
+    appendValues(input.position, values);
+    appendValues(input.linearVelocity, values);
+    appendValues(input.angularVelocity, values);
+    appendValues(input.linearAcceleration, values);
+    appendValues(input.angularAcceleration, values);
+}
+
+void wearable::encoding::appendValues(const msg::VirtualJointKinSensorData& input,
+                                      std::vector<double>& values)
+{
+    values.insert(values.end(), {input.position, input.velocity, input.acceleration});
+}
+
+void wearable::encoding::appendValues(const msg::VirtualSphericalJointKinSensorData& input,
+                                      std::vector<double>& values)
+{
+    appendValues(input.angle, values);
+    appendValues(input.velocity, values);
+    appendValues(input.acceleration, values);
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    double& output)
+{
+    output = values[index++];
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    std::vector<double>& output)
+{
+    output.assign(values.begin() + index, values.end());
+    index = values.size();
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    msg::VectorXYZ& output)
+{
+    readValues(values, index, output.x);
+    readValues(values, index, output.y);
+    readValues(values, index, output.z);
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    msg::VectorRPY& output)
+{
+    readValues(values, index, output.r);
+    readValues(values, index, output.p);
+    readValues(values, index, output.y);
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    msg::QuaternionWXYZ& output)
+{
+    readValues(values, index, output.w);
+    readValues(values, index, output.x);
+    readValues(values, index, output.y);
+    readValues(values, index, output.z);
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    msg::EmgData& output)
+{
+    readValues(values, index, output.value);
+    readValues(values, index, output.normalization);
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    msg::ForceTorque6DSensorData& output)
+{
+    readValues(values, index, output.force);
+    readValues(values, index, output.torque);
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    msg::PoseSensorData& output)
+{
+    readValues(values, index, output.orientation);
+    readValues(values, index, output.position);
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    msg::VirtualLinkKinSensorData& output)
+{
+    readValues(values, index, output.orientation);
+    readValues(values, index, output.position);
+    readValues(values, index, output.linearVelocity);
+    readValues(values, index, output.angularVelocity);
+    readValues(values, index, output.linearAcceleration);
+    readValues(values, index, output.angularAcceleration);
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    msg::VirtualJointKinSensorData& output)
+{
+    readValues(values, index, output.position);
+    readValues(values, index, output.velocity);
+    readValues(values, index, output.acceleration);
+}
+
+void wearable::encoding::readValues(const std::vector<double>& values,
+                                    size_t& index,
+                                    msg::VirtualSphericalJointKinSensorData& output)
+{
+    readValues(values, index, output.angle);
+    readValues(values, index, output.velocity);
+    readValues(values, index, output.acceleration);
+}
+
+bool wearable::encoding::getValuesLayout(const SensorType type, size_t& values, bool& quaternion)
+{
+    quaternion = false;
+    switch (type) {
+        case SensorType::Accelerometer:
+        case SensorType::Force3DSensor:
+        case SensorType::FreeBodyAccelerationSensor:
+        case SensorType::Gyroscope:
+        case SensorType::Magnetometer:
+        case SensorType::PositionSensor:
+        case SensorType::Torque3DSensor:
+        case SensorType::VirtualJointKinSensor:
+            values = 3;
+            return true;
+        case SensorType::EmgSensor:
+            values = 2;
+            return true;
+        case SensorType::ForceTorque6DSensor:
+            values = 6;
+            return true;
+        case SensorType::TemperatureSensor:
+            values = 1;
+            return true;
+        case SensorType::VirtualSphericalJointKinSensor:
+            values = 9;
+            return true;
+        case SensorType::OrientationSensor:
+            values = 4;
+            quaternion = true;
+            return true;
+        case SensorType::PoseSensor:
+            values = 7;
+            quaternion = true;
+            return true;
+        case SensorType::VirtualLinkKinSensor:
+            values = 19;
+            quaternion = true;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ========
+// Decoding
+// ========
+
+template <typename Sensors>
+static bool decodeSensors(const msg::EncodedSensors& encoded,
+                          const bool quaternion,
+                          const ValueEncoding encoding,
+                          std::vector<double>& values,
+                          Sensors& sensors)
+{
+    size_t offset = 0;
+    for (const msg::SensorInfo& info : encoded.info) {
+        if (!decodeValues(encoded.data, offset, quaternion, encoding, encoded.range, values)) {
+            return false;
+        }
+        auto& sensor = sensors[info.name];
+        sensor.info = info;
+        size_t index = 0;
+        readValues(values, index, sensor.data);
+    }
+    return true;
+}
+
+bool WearableDataDecoder::decodeSkin(const msg::EncodedSensors& encoded,
+                                     const EncodingSettings& settings,
+                                     std::map<std::string, msg::SkinSensor>& sensors,
+                                     std::string& error)
+{
+    const std::string& data = encoded.data;
+    size_t offset = 0;
+
+    // The taxels out of the runs with the zero reference
+    double zero = 0;
+    if (settings.sparse) {
+        std::string zeroCode;
+        appendTaxel(0.0, settings, zeroCode);
+        size_t zeroOffset = 0;
+        readTaxel(zeroCode, zeroOffset, settings, zero);
+    }
+
+    for (const msg::SensorInfo& info : encoded.info) {
+        size_t nTaxels = 0;
+        if (!readUInt16(data, offset, nTaxels)) {
+            error = "The encoded skin sensors are truncated";
+            return false;
+        }
+        m_values.resize(nTaxels);
+
+        bool known = true;
+        if (!settings.sparse) {
+            for (double& value : m_values) {
+                if (!readTaxel(data, offset, settings, value)) {
+                    error = "The encoded skin sensors are truncated";
+                    return false;
+                }
+            }
+        }
+        else {
+            size_t nRuns = 0;
+            if (offset >= data.size()) {
+                error = "The encoded skin sensors are truncated";
+                return false;
+            }
+            const uint8_t reference = static_cast<uint8_t>(data[offset++]);
+            if (!readUInt16(data, offset, nRuns)) {
+                error = "The encoded skin sensors are truncated";
+                return false;
+            }
+
+            if (reference == ZeroReference) {
+                std::fill(m_values.begin(), m_values.end(), zero);
+            }
+            else if (reference == PreviousReference) {
+                // Without the previous taxels the sensor is skipped until its next full frame
+                const auto previous = m_skinValues.find(info.name);
+                known = previous != m_skinValues.end() && previous->second.size() == nTaxels;
+                if (known) {
+                    std::copy(previous->second.begin(), previous->second.end(), m_values.begin());
+                }
+            }
+            else {
+                error = "Unknown reference of the taxels of " + info.name;
+                return false;
+            }
+
+            double value = 0;
+            for (size_t run = 0; run < nRuns; ++run) {
+                size_t first = 0;
+                size_t length = 0;
+                if (!readUInt16(data, offset, first) || !readUInt16(data, offset, length)) {
+                    error = "The encoded skin sensors are truncated";
+                    return false;
+                }
+                if (first + length > nTaxels) {
+                    error = "A run of taxels of " + info.name + " is out of its "
+                            + std::to_string(nTaxels) + " taxels";
+                    return false;
+                }
+                for (size_t taxel = first; taxel < first + length; ++taxel) {
+                    if (!readTaxel(data, offset, settings, value)) {
+                        error = "The encoded skin sensors are truncated";
+                        return false;
+                    }
+                    m_values[taxel] = value;
+                }
+            }
+
+            if (known) {
+                m_skinValues[info.name].assign(m_values.begin(), m_values.end());
+            }
+        }
+
+        if (known) {
+            msg::SkinSensor& sensor = sensors[info.name];
+            sensor.info = info;
+            sensor.data.assign(m_values.begin(), m_values.end());
+        }
+    }
+
+    if (offset != data.size()) {
+        error = "The encoded skin sensors have " + std::to_string(data.size() - offset)
+                + " bytes in excess";
+        return false;
+    }
+    return true;
+}
+
+bool WearableDataDecoder::decode(msg::ExtendedWearableData& frame, std::string& error)
+{
+    msg::WearableData& data = frame.data;
+    for (const msg::EncodedSensors& encoded : frame.encodedSensors) {
+        const SensorType type = sensor::sensorTypeFromString(encoded.type);
+
+        EncodingSettings settings;
+        if (!fromMessage(encoded.encoding, settings.encoding)) {
+            error = "Unknown encoding of the sensors of type " + encoded.type;
+            return false;
+        }
+        settings.range = encoded.range;
+        settings.scale = encoded.scale;
+        settings.offset = encoded.offset;
+        settings.sparse = encoded.sparse;
+        if (!checkSettings(type, settings, error)) {
+            return false;
+        }
+
+        if (type == SensorType::SkinSensor) {
+            if (!decodeSkin(encoded, settings, data.skinSensors, error)) {
+                return false;
+            }
+            continue;
+        }
+
+        size_t nValues = 0;
+        bool quaternion = false;
+        getValuesLayout(type, nValues, quaternion);
+
+        const size_t expectedSize =
+            encoded.info.size() * getEncodedSize(nValues, quaternion, settings.encoding);
+        if (encoded.data.size() != expectedSize) {
+            error = "The encoded " + encoded.type + " sensors have "
+                    + std::to_string(encoded.data.size()) + " bytes instead of "
+                    + std::to_string(expectedSize);
+            return false;
+        }
+
+        m_values.resize(nValues);
+        bool decoded = false;
+        visitSensorMaps(data, [&](auto& sensors, const SensorType sensorsType) {
+            if (sensorsType == type) {
+                decoded = decodeSensors(encoded, quaternion, settings.encoding, m_values, sensors);
+            }
+        });
+        if (!decoded) {
+            error = "Failed to decode the sensors of type " + encoded.type;
+            return false;
+        }
+    }
+
+    frame.encodedSensors.clear();
+    return true;
+}
+
+bool wearable::encoding::decodeWearableData(msg::ExtendedWearableData& frame, std::string& error)
+{
+    WearableDataDecoder decoder;
+    return decoder.decode(frame, error);
+}
+
+// ========
+// Encoding
+// ========
+
+bool WearableDataEncoder::setEncoding(const SensorType type,
+                                      const EncodingSettings& settings,
+                                      std::string& error)
+{
+    if (!checkSettings(type, settings, error)) {
+        return false;
+    }
+    m_encodings[type] = settings;
+    return true;
+}
+
+void WearableDataEncoder::encodeTaxels(const std::string& name,
+                                       const std::vector<double>& taxels,
+                                       const EncodingSettings& settings,
+                                       const bool partial,
+                                       std::string& buffer)
+{
+    const size_t valueSize = getValueSize(settings.encoding);
+    const size_t nTaxels = taxels.size();
+
+    m_codes.clear();
+    for (const double taxel : taxels) {
+        appendTaxel(taxel, settings, m_codes);
+    }
+
+    appendUInt16(nTaxels, buffer);
+    if (!settings.sparse) {
+        buffer.append(m_codes);
+        return;
+    }
+
+    // The taxels are compared with the reference after the encoding, so that the ones out of
+    // the runs are decoded exactly as if they were sent
+    auto previous = m_skinCodes.find(name);
+    const bool delta =
+        partial && previous != m_skinCodes.end() && previous->second.size() == m_codes.size();
+    if (!delta) {
+        m_zeroCode.clear();
+        appendTaxel(0.0, settings, m_zeroCode);
+    }
+    const auto differs = [&](const size_t taxel) {
+        const char* reference =
+            delta ? &previous->second[taxel * valueSize] : m_zeroCode.data();
+        return std::memcmp(&m_codes[taxel * valueSize], reference, valueSize) != 0;
+    };
+
+    buffer.push_back(static_cast<char>(delta ? PreviousReference : ZeroReference));
+    const size_t runsPosition = buffer.size();
+    appendUInt16(0, buffer);
+
+    // Taxels separated by at most maxGap unchanged ones are sent in the same run
+    const size_t maxGap = RunHeaderSize / valueSize;
+    size_t nRuns = 0;
+    for (size_t first = 0; first < nTaxels;) {
+        if (!differs(first)) {
+            ++first;
+            continue;
+        }
+        size_t end = first + 1;
+        for (size_t taxel = end; taxel < nTaxels && taxel - end <= maxGap; ++taxel) {
+            if (differs(taxel)) {
+                end = taxel + 1;
+            }
+        }
+
+        appendUInt16(first, buffer);
+        appendUInt16(end - first, buffer);
+        buffer.append(m_codes, first * valueSize, (end - first) * valueSize);
+        ++nRuns;
+        first = end;
+    }
+
+    buffer[runsPosition] = static_cast<char>(nRuns & 0xFF);
+    buffer[runsPosition + 1] = static_cast<char>((nRuns >> 8) & 0xFF);
+
+    if (previous == m_skinCodes.end()) {
+        previous = m_skinCodes.emplace(name, std::string()).first;
+    }
+    previous->second.assign(m_codes);
+}
+
+void WearableDataEncoder::encodeSkin(msg::ExtendedWearableData& frame,
+                                     const EncodingSettings& settings)
+{
+    msg::WearableData& data = frame.data;
+    if (data.skinSensors.empty()) {
+        return;
+    }
+
+    msg::EncodedSensors encoded;
+    encoded.type = sensor::sensorTypeToString(SensorType::SkinSensor);
+    encoded.encoding = toMessage(settings.encoding);
+    encoded.range = settings.range;
+    encoded.scale = settings.scale;
+    encoded.offset = settings.offset;
+    encoded.sparse = settings.sparse;
+
+    // The sensors with too many taxels are left in the map
+    for (auto it = data.skinSensors.begin(); it != data.skinSensors.end();) {
+        if (it->second.data.size() > MaxTaxels) {
+            ++it;
+            continue;
+        }
+        encoded.info.push_back(it->second.info);
+        encodeTaxels(it->first, it->second.data, settings, frame.partial, encoded.data);
+        it = data.skinSensors.erase(it);
+    }
+
+    if (!encoded.info.empty()) {
+        frame.encodedSensors.push_back(std::move(encoded));
+    }
+}
+
+void WearableDataEncoder::encode(msg::ExtendedWearableData& frame)
+{
+    frame.encodedSensors.clear();
+    if (m_encodings.empty()) {
+        return;
+    }
+
+    visitSensorMaps(frame.data, [&](auto& sensors, const SensorType type) {
+        const auto typeEncoding = m_encodings.find(type);
+        if (typeEncoding == m_encodings.end() || sensors.empty()) {
+            return;
+        }
+        if (type == SensorType::SkinSensor) {
+            encodeSkin(frame, typeEncoding->second);
+            return;
+        }
+        const ValueEncoding encoding = typeEncoding->second.encoding;
+        const double range = typeEncoding->second.range;
+
+        size_t nValues = 0;
+        bool quaternion = false;
+        getValuesLayout(type, nValues, quaternion);
+
+        msg::EncodedSensors encoded;
+        encoded.type = sensor::sensorTypeToString(type);
+        encoded.encoding = toMessage(encoding);
+        encoded.range = range;
+        encoded.info.reserve(sensors.size());
+        encoded.data.reserve(sensors.size() * getEncodedSize(nValues, quaternion, encoding));
+
+        for (const auto& entry : sensors) {
+            encoded.info.push_back(entry.second.info);
+            m_values.clear();
+            appendValues(entry.second.data, m_values);
+            encodeValues(m_values, quaternion, encoding, range, encoded.data);
+        }
+
+        sensors.clear();
+        frame.encodedSensors.push_back(std::move(encoded));
+    });
+}
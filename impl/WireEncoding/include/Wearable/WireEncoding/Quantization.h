@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_WIREENCODING_QUANTIZATION_H
+#define WEARABLE_WIREENCODING_QUANTIZATION_H
+
+#include <cstddef>
+#include <string>
+
+namespace wearable {
+    namespace encoding {
+        enum class ValueEncoding
+        {
+            Float32,
+            Fixed16,
+            SmallestThree,
+            UInt16,
+            Float16,
+        };
+
+        // Names used in the configuration: float32, fixed16, smallestThree, uint16 and float16
+        bool parseValueEncoding(const std::string& name, ValueEncoding& encoding);
+        std::string toString(const ValueEncoding encoding);
+
+        // Bytes of an encoded value, and of an encoded quaternion
+        size_t getValueSize(const ValueEncoding encoding);
+        size_t getQuaternionSize(const ValueEncoding encoding);
+
+        // Values are appended to the buffer in little endian byte order, and read from the
+        // offset, that is moved after them. The read functions return false if the buffer ends
+        // before the value.
+        //
+        // - Float32: single precision float.
+        // - Fixed16: integer in [-32767, 32767] for [-range, range]. Values outside the range are
+        //   clamped, NaN is encoded as -32768.
+        // - SmallestThree: quaternions only. The largest component is dropped and made positive
+        //   (q and -q are the same rotation), the other three, in [-1/sqrt(2), 1/sqrt(2)], are
+        //   stored with 15 bits each, and the index of the dropped one with 2 bits, in 6 bytes.
+        //   The quaternion is normalized before the encoding, a zero or NaN quaternion is
+        //   decoded as the identity.
+        // - UInt16: integer in [0, 65534], the value rounded to the nearest one. Values outside
+        //   the interval are clamped, NaN is encoded as 65535.
+        // - Float16: half precision float, rounded to the nearest even. Values whose magnitude
+        //   exceeds 65504, the largest finite half, are clamped.
+        //
+        // UInt16 and Float16 are meant for the skin taxels, after their scaling. With
+        // SmallestThree the values that are not quaternions are encoded as Float32, and with the
+        // others the quaternions are encoded with range 1.
+        void appendValue(const double value,
+                         const ValueEncoding encoding,
+                         const double range,
+                         std::string& buffer);
+        bool readValue(const std::string& buffer,
+                       size_t& offset,
+                       const ValueEncoding encoding,
+                       const double range,
+                       double& value);
+
+        void appendQuaternion(const double* wxyz,
+                              const ValueEncoding encoding,
+                              std::string& buffer);
+        bool readQuaternion(const std::string& buffer,
+                            size_t& offset,
+                            const ValueEncoding encoding,
+                            double* wxyz);
+
+        // Bounds of the absolute error of a decoded value, and of the components of a decoded
+        // unit quaternion (up to the sign of the whole quaternion with SmallestThree):
+        //
+        // - Float32: |value| 2^-24, from the rounding to the nearest float.
+        // - Fixed16: range / 65534 inside the range, plus the distance from the range outside.
+        // - UInt16: 0.5 inside [0, 65534], plus the distance from the interval outside.
+        // - Float16: |value| 2^-11 for normal halves, 2^-25 below them, plus the distance from
+        //   [-65504, 65504] outside.
+        // - SmallestThree: ~6.5e-5. The three stored components have an error up to
+        //   e = 1 / (sqrt(2) 32766), half of the step, and the dropped one, computed from the
+        //   unit norm, up to 3 e + 3 e^2, since it is the largest one.
+        double getValueErrorBound(const ValueEncoding encoding,
+                                  const double range,
+                                  const double value);
+        double getQuaternionErrorBound(const ValueEncoding encoding);
+    } // namespace encoding
+} // namespace wearable
+
+#endif // WEARABLE_WIREENCODING_QUANTIZATION_H
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEARABLE_WIREENCODING_WEARABLEDATAENCODING_H
+#define WEARABLE_WIREENCODING_WEARABLEDATAENCODING_H
+
+#include "Wearable/IWear/Sensors/ISensor.h"
+#include "Wearable/WireEncoding/Quantization.h"
+#include "thrift/ExtendedWearableData.h"
+#include "thrift/WearableData.h"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wearable {
+    namespace encoding {
+        class WearableDataEncoder;
+        class WearableDataDecoder;
+
+        // Encoding of the values of the sensors of a type
+        struct EncodingSettings
+        {
+            ValueEncoding encoding = ValueEncoding::Float32;
+            // Fixed16
+            double range = 0;
+            // Skin sensors only: the taxels are encoded as (value - offset) / scale with UInt16
+            // and Float16, and with sparse only the runs of taxels that changed are sent
+            double scale = 1;
+            double offset = 0;
+            bool sparse = false;
+        };
+
+        // Values of the data of the sensors, in the order of the fields of the messages
+        void appendValues(const double input, std::vector<double>& values);
+        void appendValues(const std::vector<double>& input, std::vector<double>& values);
+        void appendValues(const msg::VectorXYZ& input, std::vector<double>& values);
+        void appendValues(const msg::VectorRPY& input, std::vector<double>& values);
+        void appendValues(const msg::QuaternionWXYZ& input, std::vector<double>& values);
+        void appendValues(const msg::EmgData& input, std::vector<double>& values);
+        void appendValues(const msg::ForceTorque6DSensorData& input, std::vector<double>& values);
+        void appendValues(const msg::PoseSensorData& input, std::vector<double>& values);
+        void appendValues(const msg::VirtualLinkKinSensorData& input, std::vector<double>& values);
+        void appendValues(const msg::VirtualJointKinSensorData& input, std::vector<double>& values);
+        void appendValues(const msg::VirtualSphericalJointKinSensorData& input,
+                          std::vector<double>& values);
+
+        // Inverse of appendValues, reading from the index of values, that is moved after them.
+        // A list takes all the remaining values.
+        void readValues(const std::vector<double>& values, size_t& index, double& output);
+        void readValues(const std::vector<double>& values,
+                        size_t& index,
+                        std::vector<double>& output);
+        void readValues(const std::vector<double>& values, size_t& index, msg::VectorXYZ& output);
+        void readValues(const std::vector<double>& values, size_t& index, msg::VectorRPY& output);
+        void readValues(const std::vector<double>& values,
+                        size_t& index,
+                        msg::QuaternionWXYZ& output);
+        void readValues(const std::vector<double>& values, size_t& index, msg::EmgData& output);
+        void readValues(const std::vector<double>& values,
+                        size_t& index,
+                        msg::ForceTorque6DSensorData& output);
+        void readValues(const std::vector<double>& values,
+                        size_t& index,
+                        msg::PoseSensorData& output);
+        void readValues(const std::vector<double>& values,
+                        size_t& index,
+                        msg::VirtualLinkKinSensorData& output);
+        void readValues(const std::vector<double>& values,
+                        size_t& index,
+                        msg::VirtualJointKinSensorData& output);
+        void readValues(const std::vector<double>& values,
+                        size_t& index,
+                        msg::VirtualSphericalJointKinSensorData& output);
+
+        // Number of values of the sensors of a type and if the first four are a quaternion.
+        // Return false for the skin sensors, whose number of values is variable.
+        bool getValuesLayout(const sensor::SensorType type, size_t& values, bool& quaternion);
+
+        // Decode a frame with a decoder without the previous frames. The skin sensors sent as
+        // the taxels that changed since the previous frame are left out.
+        bool decodeWearableData(msg::ExtendedWearableData& frame, std::string& error);
+    } // namespace encoding
+} // namespace wearable
+
+// Encoding of the values of the sensors of the configured types, done by the producer of the
+// frames. The sensors of each type are moved from their map to an entry of the encoded sensors,
+// with their info, and their values encoded one after the other. The error bounds of the
+// encodings are documented in Quantization.h.
+//
+// The skin sensors have a variable number of taxels. Each one is encoded as the uint16 number of
+// its taxels followed by:
+// - dense: the values of all the taxels.
+// - sparse: a uint8 reference, the uint16 number of runs of taxels, and for each run the uint16
+//   index of its first taxel, the uint16 number of its taxels and their values. The taxels out
+//   of the runs are the encoding of zero with reference 0, and keep the values of the previous
+//   frame with reference 1, used in the partial frames. Short gaps between two runs are sent
+//   within a single run, when cheaper than the header of the second one.
+// Skin sensors with more than 65534 taxels are not encoded.
+class wearable::encoding::WearableDataEncoder
+{
+private:
+    std::map<sensor::SensorType, EncodingSettings> m_encodings;
+    std::vector<double> m_values;
+
+    // Encoded taxels of the last frame of the sparse skin sensors, the reference of the partial
+    // frames
+    std::unordered_map<std::string, std::string> m_skinCodes;
+    std::string m_codes;
+    std::string m_zeroCode;
+
+    void encodeSkin(msg::ExtendedWearableData& frame, const EncodingSettings& settings);
+    void encodeTaxels(const std::string& name,
+                      const std::vector<double>& taxels,
+                      const EncodingSettings& settings,
+                      const bool partial,
+                      std::string& buffer);
+
+public:
+    // Return false and the reason in error if the sensors of the type cannot be encoded with
+    // the settings, or their range or scale is not positive.
+    bool setEncoding(const sensor::SensorType type,
+                     const EncodingSettings& settings,
+                     std::string& error);
+    bool empty() const { return m_encodings.empty(); }
+
+    void encode(msg::ExtendedWearableData& frame);
+};
+
+// Decoding of the frames of a producer, expanding their encoded sensors into the maps of their
+// types. It keeps the taxels of the sparse skin sensors, the reference of the partial frames:
+// the sensors received in a partial frame before their first full frame are left out.
+class wearable::encoding::WearableDataDecoder
+{
+private:
+    std::unordered_map<std::string, std::vector<double>> m_skinValues;
+    std::vector<double> m_values;
+
+    bool decodeSkin(const msg::EncodedSensors& encoded,
+                    const EncodingSettings& settings,
+                    std::map<std::string, msg::SkinSensor>& sensors,
+                    std::string& error);
+
+public:
+    // Clear the encoded sensors of the frame. Return false and the reason in error if they are
+    // not valid, leaving the frame partially decoded.
+    bool decode(msg::ExtendedWearableData& frame, std::string& error);
+};
+
+#endif // WEARABLE_WIREENCODING_WEARABLEDATAENCODING_H
@@ -0,0 +1,229 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/WireEncoding/Quantization.h"
+#include "Wearable/TestUtils/Check.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace wearable::encoding;
+using wearable::test::check;
+
+// Encode the value, decode it and check the error against the documented bound
+static void checkValue(const ValueEncoding encoding, const double range, const double value)
+{
+    const std::string name = toString(encoding) + " " + std::to_string(value);
+
+    std::string buffer;
+    appendValue(value, encoding, range, buffer);
+    check(buffer.size() == getValueSize(encoding), name + ": wrong size");
+
+    size_t offset = 0;
+    double decoded = 0;
+    check(readValue(buffer, offset, encoding, range, decoded), name + ": read failed");
+    check(offset == buffer.size(), name + ": wrong offset");
+    check(std::abs(decoded - value) <= getValueErrorBound(encoding, range, value),
+          name + ": decoded as " + std::to_string(decoded));
+}
+
+static void checkValues(const ValueEncoding encoding,
+                        const double range,
+                        const std::vector<double>& values)
+{
+    for (const double value : values) {
+        checkValue(encoding, range, value);
+    }
+}
+
+static void checkNaN(const ValueEncoding encoding, const double range)
+{
+    std::string buffer;
+    appendValue(std::nan(""), encoding, range, buffer);
+    size_t offset = 0;
+    double decoded = 0;
+    check(readValue(buffer, offset, encoding, range, decoded) && std::isnan(decoded),
+          toString(encoding) + ": NaN not decoded as NaN");
+}
+
+static void checkTruncated(const ValueEncoding encoding, const double range)
+{
+    std::string buffer;
+    appendValue(1.0, encoding, range, buffer);
+    for (size_t size = 0; size < buffer.size(); ++size) {
+        size_t offset = 0;
+        double decoded = 0;
+        check(!readValue(buffer.substr(0, size), offset, encoding, range, decoded),
+              toString(encoding) + ": read of " + std::to_string(size) + " bytes succeeded");
+    }
+}
+
+// Encode the unit quaternion, decode it and check the error of its components, up to the sign
+// of the whole quaternion
+static void checkQuaternion(const ValueEncoding encoding, const double* wxyz)
+{
+    const std::string name = toString(encoding) + " quaternion (" + std::to_string(wxyz[0]) + ", "
+                             + std::to_string(wxyz[1]) + ", " + std::to_string(wxyz[2]) + ", "
+                             + std::to_string(wxyz[3]) + ")";
+
+    std::string buffer;
+    appendQuaternion(wxyz, encoding, buffer);
+    check(buffer.size() == getQuaternionSize(encoding), name + ": wrong size");
+
+    size_t offset = 0;
+    double decoded[4] = {};
+    check(readQuaternion(buffer, offset, encoding, decoded), name + ": read failed");
+    check(offset == buffer.size(), name + ": wrong offset");
+
+    double error = 0;
+    double oppositeError = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        error = std::max(error, std::abs(decoded[i] - wxyz[i]));
+        oppositeError = std::max(oppositeError, std::abs(decoded[i] + wxyz[i]));
+    }
+    check(std::min(error, oppositeError) <= getQuaternionErrorBound(encoding),
+          name + ": error " + std::to_string(std::min(error, oppositeError)));
+}
+
+static void testValues()
+{
+    std::mt19937 generator(42);
+
+    // Float32
+    std::uniform_real_distribution<double> anyValue(-1e6, 1e6);
+    std::vector<double> values = {0.0, 1.0, -1.0, 0.1, 1e-30, -1e-42, 3.4e38, -123.456};
+    for (size_t i = 0; i < 1000; ++i) {
+        values.push_back(anyValue(generator));
+    }
+    checkValues(ValueEncoding::Float32, 0, values);
+    checkNaN(ValueEncoding::Float32, 0);
+    checkTruncated(ValueEncoding::Float32, 0);
+
+    // Fixed16, inside and outside the range
+    const double range = 20;
+    std::uniform_real_distribution<double> inRange(-range, range);
+    values = {0.0, range, -range, range / 65534, 1.5 * range, -3 * range, 1e300};
+    for (size_t i = 0; i < 1000; ++i) {
+        values.push_back(inRange(generator));
+    }
+    checkValues(ValueEncoding::Fixed16, range, values);
+    checkValues(ValueEncoding::Fixed16, 1e-3, {0.0, 1e-3, -5e-4, 1e-4});
+    checkNaN(ValueEncoding::Fixed16, range);
+    checkTruncated(ValueEncoding::Fixed16, range);
+
+    // UInt16, inside and outside [0, 65534]
+    std::uniform_real_distribution<double> inInterval(0, 65534);
+    values = {0.0, 0.5, 0.49, 65534, 65533.6, -1.0, -1e9, 65535, 1e9};
+    for (size_t i = 0; i < 1000; ++i) {
+        values.push_back(inInterval(generator));
+    }
+    checkValues(ValueEncoding::UInt16, 0, values);
+    checkNaN(ValueEncoding::UInt16, 0);
+    checkTruncated(ValueEncoding::UInt16, 0);
+
+    // Float16, normal and subnormal halves, and values beyond the largest finite one
+    std::uniform_real_distribution<double> exponent(-30, 16);
+    values = {0.0, 1.0, -2.0, 65504, -65504, 65520, 1e9, -1e9, 6.1e-5, 5.96e-8, 1e-9, 2.98e-8};
+    for (size_t i = 0; i < 1000; ++i) {
+        const double value = std::exp2(exponent(generator));
+        values.push_back(i % 2 == 0 ? value : -value);
+    }
+    checkValues(ValueEncoding::Float16, 0, values);
+    checkNaN(ValueEncoding::Float16, 0);
+    checkTruncated(ValueEncoding::Float16, 0);
+}
+
+static void testQuaternions()
+{
+    std::mt19937 generator(7);
+    std::normal_distribution<double> component(0, 1);
+
+    std::vector<std::vector<double>> quaternions = {
+        {1, 0, 0, 0},
+        {0, 1, 0, 0},
+        {0, 0, 0, -1},
+        {-1, 0, 0, 0},
+        {0.5, 0.5, 0.5, 0.5},
+        {std::sqrt(0.5), std::sqrt(0.5), 0, 0},
+        {std::sqrt(0.5), 0, -std::sqrt(0.5), 0},
+    };
+    for (size_t i = 0; i < 2000; ++i) {
+        std::vector<double> q(4);
+        double norm = 0;
+        for (double& value : q) {
+            value = component(generator);
+            norm += value * value;
+        }
+        for (double& value : q) {
+            value /= std::sqrt(norm);
+        }
+        quaternions.push_back(q);
+    }
+
+    for (const ValueEncoding encoding : {ValueEncoding::Float32,
+                                         ValueEncoding::Fixed16,
+                                         ValueEncoding::SmallestThree,
+                                         ValueEncoding::Float16}) {
+        for (const auto& q : quaternions) {
+            checkQuaternion(encoding, q.data());
+        }
+    }
+
+    // A zero or NaN quaternion is decoded as the identity with SmallestThree
+    for (const double value : {0.0, std::nan("")}) {
+        const double wxyz[4] = {value, value, value, value};
+        std::string buffer;
+        appendQuaternion(wxyz, ValueEncoding::SmallestThree, buffer);
+        size_t offset = 0;
+        double decoded[4] = {};
+        check(readQuaternion(buffer, offset, ValueEncoding::SmallestThree, decoded)
+                  && std::abs(std::abs(decoded[0]) - 1) <= 1e-9 && decoded[1] == 0
+                  && decoded[2] == 0 && decoded[3] == 0,
+              "smallestThree: degenerate quaternion not decoded as the identity");
+    }
+
+    // Truncated quaternions
+    const double identity[4] = {1, 0, 0, 0};
+    for (const ValueEncoding encoding : {ValueEncoding::Float32,
+                                         ValueEncoding::Fixed16,
+                                         ValueEncoding::SmallestThree,
+                                         ValueEncoding::Float16}) {
+        std::string buffer;
+        appendQuaternion(identity, encoding, buffer);
+        for (size_t size = 0; size < buffer.size(); ++size) {
+            size_t offset = 0;
+            double decoded[4] = {};
+            check(!readQuaternion(buffer.substr(0, size), offset, encoding, decoded),
+                  toString(encoding) + ": read of a quaternion of " + std::to_string(size)
+                      + " bytes succeeded");
+        }
+    }
+}
+
+static void testNames()
+{
+    for (const ValueEncoding encoding : {ValueEncoding::Float32,
+                                         ValueEncoding::Fixed16,
+                                         ValueEncoding::SmallestThree,
+                                         ValueEncoding::UInt16,
+                                         ValueEncoding::Float16}) {
+        ValueEncoding parsed = ValueEncoding::Float32;
+        check(parseValueEncoding(toString(encoding), parsed) && parsed == encoding,
+              "parse of " + toString(encoding));
+    }
+    ValueEncoding parsed = ValueEncoding::Float32;
+    check(!parseValueEncoding("float64", parsed), "parse of an unknown encoding succeeded");
+}
+
+int main()
+{
+    testValues();
+    testQuaternions();
+    testNames();
+
+    return wearable::test::exitStatus();
+}
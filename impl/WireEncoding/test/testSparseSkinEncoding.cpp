@@ -0,0 +1,268 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/WireEncoding/WearableDataEncoding.h"
+#include "Wearable/TestUtils/Check.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace wearable;
+using namespace wearable::encoding;
+using sensor::SensorType;
+using wearable::test::check;
+
+static std::mt19937 generator(3);
+
+static EncodingSettings makeSparseSettings(const ValueEncoding encoding,
+                                           const double scale = 1,
+                                           const double offset = 0)
+{
+    EncodingSettings settings;
+    settings.encoding = encoding;
+    settings.scale = scale;
+    settings.offset = offset;
+    settings.sparse = true;
+    return settings;
+}
+
+static WearableDataEncoder makeEncoder(const EncodingSettings& settings)
+{
+    WearableDataEncoder encoder;
+    std::string error;
+    if (!encoder.setEncoding(SensorType::SkinSensor, settings, error)) {
+        std::cerr << error << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    return encoder;
+}
+
+static msg::ExtendedWearableData makeFrame(const std::vector<std::vector<double>>& skins,
+                                           const bool partial)
+{
+    msg::ExtendedWearableData frame;
+    frame.partial = partial;
+    for (size_t i = 0; i < skins.size(); ++i) {
+        msg::SkinSensor skin;
+        skin.info.name = "skin" + std::to_string(i);
+        skin.info.status = msg::SensorStatus::OK;
+        skin.data = skins[i];
+        frame.data.skinSensors[skin.info.name] = skin;
+    }
+    return frame;
+}
+
+// Taxels with few of them different from zero
+static std::vector<double> makeTaxels(const size_t nTaxels, const double activeRatio)
+{
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<double> taxels(nTaxels, 0.0);
+    for (double& taxel : taxels) {
+        if (unit(generator) < activeRatio) {
+            taxel = 1 + 250 * unit(generator);
+        }
+    }
+    return taxels;
+}
+
+static bool withinBound(const std::vector<double>& decoded,
+                        const std::vector<double>& taxels,
+                        const EncodingSettings& settings)
+{
+    if (decoded.size() != taxels.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < taxels.size(); ++i) {
+        const double encoded = (taxels[i] - settings.offset) / settings.scale;
+        const double bound = settings.scale * getValueErrorBound(settings.encoding, 0, encoded);
+        if (std::abs(decoded[i] - taxels[i]) > bound + 1e-9) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Number of runs of the first encoded skin sensor
+static size_t getRuns(const msg::ExtendedWearableData& frame)
+{
+    const std::string& data = frame.encodedSensors.at(0).data;
+    return static_cast<uint8_t>(data.at(3)) | static_cast<uint8_t>(data.at(4)) << 8;
+}
+
+// Encode and decode a keyframe and then partial frames changing a few taxels, checking the
+// decoded taxels and that the partial frames are smaller than the keyframe
+static void testPartialFrames(const EncodingSettings& settings)
+{
+    const std::string name = "sparse " + toString(settings.encoding);
+    WearableDataEncoder encoder = makeEncoder(settings);
+    WearableDataDecoder decoder;
+    std::string error;
+
+    std::vector<std::vector<double>> skins = {makeTaxels(500, 0.3), makeTaxels(64, 0.0)};
+    size_t keyframeSize = 0;
+    std::uniform_int_distribution<size_t> anyTaxel(0, 499);
+
+    for (size_t i = 0; i < 20; ++i) {
+        const bool partial = i % 10 != 0;
+        if (partial) {
+            for (size_t change = 0; change < 5; ++change) {
+                skins[0][anyTaxel(generator)] = change % 2 == 0 ? 0.0 : 100.0 + i;
+            }
+        }
+
+        msg::ExtendedWearableData frame = makeFrame(skins, partial);
+        encoder.encode(frame);
+        check(frame.encodedSensors.size() == 1, name + ": skin sensors not encoded");
+        const size_t size = frame.encodedSensors.at(0).data.size();
+        if (!partial) {
+            keyframeSize = size;
+        }
+        else {
+            check(size < keyframeSize / 4, name + ": partial frame of " + std::to_string(size)
+                                               + " bytes, keyframe of "
+                                               + std::to_string(keyframeSize));
+        }
+
+        check(decoder.decode(frame, error), name + ": " + error);
+        for (size_t skin = 0; skin < skins.size(); ++skin) {
+            const auto& decoded = frame.data.skinSensors["skin" + std::to_string(skin)];
+            check(withinBound(decoded.data, skins[skin], settings),
+                  name + ": wrong taxels of skin" + std::to_string(skin) + " in frame "
+                      + std::to_string(i));
+        }
+    }
+}
+
+// Unchanged taxels between two runs are sent within a single run when cheaper than a new run
+static void testRuns()
+{
+    const EncodingSettings settings = makeSparseSettings(ValueEncoding::UInt16);
+    WearableDataEncoder encoder = makeEncoder(settings);
+
+    std::vector<double> taxels(100, 0.0);
+    msg::ExtendedWearableData frame = makeFrame({taxels}, false);
+    encoder.encode(frame);
+    check(getRuns(frame) == 0, "runs of a skin without contacts");
+
+    // Two taxels of uint16 separated by two zeros cost less than the 4 bytes of a run header
+    taxels[10] = 5;
+    taxels[13] = 5;
+    taxels[50] = 7;
+    frame = makeFrame({taxels}, false);
+    encoder.encode(frame);
+    check(getRuns(frame) == 2, "gap not merged, or distant taxels merged");
+
+    msg::ExtendedWearableData decodedFrame = frame;
+    std::string error;
+    check(decodeWearableData(decodedFrame, error)
+              && decodedFrame.data.skinSensors["skin0"].data == taxels,
+          "wrong decoding of merged runs: " + error);
+
+    // A partial frame without changes has no runs
+    frame = makeFrame({taxels}, true);
+    encoder.encode(frame);
+    check(getRuns(frame) == 0, "runs of a partial frame without changes");
+}
+
+// A partial frame without the previous taxels of a sensor leaves it out, until a full frame
+static void testMissingReference()
+{
+    const EncodingSettings settings = makeSparseSettings(ValueEncoding::Float16, 2, -1);
+    WearableDataEncoder encoder = makeEncoder(settings);
+    std::vector<double> taxels = makeTaxels(40, 0.5);
+
+    msg::ExtendedWearableData keyframe = makeFrame({taxels}, false);
+    encoder.encode(keyframe);
+
+    taxels[3] = 42;
+    msg::ExtendedWearableData partial = makeFrame({taxels}, true);
+    encoder.encode(partial);
+
+    WearableDataDecoder decoder;
+    std::string error;
+    msg::ExtendedWearableData frame = partial;
+    check(decoder.decode(frame, error), "partial frame before the keyframe rejected: " + error);
+    check(frame.data.skinSensors.empty(), "sensor decoded without its previous taxels");
+
+    frame = keyframe;
+    check(decoder.decode(frame, error) && frame.data.skinSensors.size() == 1,
+          "keyframe not decoded: " + error);
+    frame = partial;
+    check(decoder.decode(frame, error)
+              && withinBound(frame.data.skinSensors["skin0"].data, taxels, settings),
+          "partial frame after the keyframe not decoded: " + error);
+
+    // A change of the number of taxels is sent with the zero reference
+    taxels.resize(60, 3.0);
+    frame = makeFrame({taxels}, true);
+    encoder.encode(frame);
+    check(frame.encodedSensors.at(0).data.at(2) == 0, "new taxels sent as a partial frame");
+    check(decoder.decode(frame, error)
+              && withinBound(frame.data.skinSensors["skin0"].data, taxels, settings),
+          "resized sensor not decoded: " + error);
+}
+
+static void checkRejected(msg::ExtendedWearableData frame, const std::string& name)
+{
+    WearableDataDecoder decoder;
+    std::string error;
+    check(!decoder.decode(frame, error), name + " accepted");
+    check(!error.empty(), name + " rejected without an error");
+}
+
+static void testCorruptedRuns()
+{
+    WearableDataEncoder encoder = makeEncoder(makeSparseSettings(ValueEncoding::UInt16));
+    std::vector<double> taxels(20, 0.0);
+    taxels[5] = 10;
+    taxels[6] = 11;
+    msg::ExtendedWearableData valid = makeFrame({taxels}, false);
+    encoder.encode(valid);
+
+    // Layout: taxels (2), reference (1), runs (2), first (2), length (2), values (2 each)
+    check(valid.encodedSensors.at(0).data.size() == 13, "unexpected size of the sparse skin");
+
+    msg::ExtendedWearableData frame = valid;
+    frame.encodedSensors[0].data[2] = 7;
+    checkRejected(frame, "unknown reference");
+
+    frame = valid;
+    frame.encodedSensors[0].data[5] = 19;
+    checkRejected(frame, "run out of the taxels");
+
+    frame = valid;
+    frame.encodedSensors[0].data[7] = static_cast<char>(0xFF);
+    frame.encodedSensors[0].data[8] = static_cast<char>(0xFF);
+    checkRejected(frame, "run longer than the taxels");
+
+    frame = valid;
+    frame.encodedSensors[0].data[3] = 2;
+    checkRejected(frame, "missing run");
+
+    for (size_t size = 0; size < valid.encodedSensors[0].data.size(); ++size) {
+        frame = valid;
+        frame.encodedSensors[0].data.resize(size);
+        checkRejected(frame, "sparse skin truncated to " + std::to_string(size) + " bytes");
+    }
+
+    frame = valid;
+    frame.encodedSensors[0].data.append("xx");
+    checkRejected(frame, "sparse skin with bytes in excess");
+}
+
+int main()
+{
+    testPartialFrames(makeSparseSettings(ValueEncoding::UInt16));
+    testPartialFrames(makeSparseSettings(ValueEncoding::UInt16, 0.01, -2));
+    testPartialFrames(makeSparseSettings(ValueEncoding::Float16, 0.5, 1));
+    testPartialFrames(makeSparseSettings(ValueEncoding::Float32));
+    testRuns();
+    testMissingReference();
+    testCorruptedRuns();
+
+    return wearable::test::exitStatus();
+}
@@ -0,0 +1,410 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "Wearable/WireEncoding/WearableDataEncoding.h"
+#include "Wearable/TestUtils/Check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace wearable;
+using namespace wearable::encoding;
+using sensor::SensorType;
+using wearable::test::check;
+
+static std::mt19937 generator(1);
+
+static double random(const double min, const double max)
+{
+    return std::uniform_real_distribution<double>(min, max)(generator);
+}
+
+static msg::QuaternionWXYZ randomQuaternion()
+{
+    msg::QuaternionWXYZ q;
+    std::normal_distribution<double> component(0, 1);
+    q.w = component(generator);
+    q.x = component(generator);
+    q.y = component(generator);
+    q.z = component(generator);
+    const double norm = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    q.w /= norm;
+    q.x /= norm;
+    q.y /= norm;
+    q.z /= norm;
+    return q;
+}
+
+static msg::VectorXYZ randomVector(const double range)
+{
+    msg::VectorXYZ v;
+    v.x = random(-range, range);
+    v.y = random(-range, range);
+    v.z = random(-range, range);
+    return v;
+}
+
+static msg::SensorInfo makeInfo(const std::string& name)
+{
+    msg::SensorInfo info;
+    info.name = name;
+    info.status = msg::SensorStatus::OK;
+    return info;
+}
+
+// Frame with sensors of several types, the skin ones with the given number of taxels in
+// [0, maxTaxel]
+static msg::ExtendedWearableData makeFrame(const size_t nTaxels, const double maxTaxel)
+{
+    msg::ExtendedWearableData frame;
+    frame.data.producerName = "test";
+    for (size_t i = 0; i < 5; ++i) {
+        const std::string index = std::to_string(i);
+
+        msg::Accelerometer accelerometer;
+        accelerometer.info = makeInfo("acc" + index);
+        accelerometer.data = randomVector(40);
+        frame.data.accelerometers[accelerometer.info.name] = accelerometer;
+
+        msg::OrientationSensor orientation;
+        orientation.info = makeInfo("orientation" + index);
+        orientation.data = randomQuaternion();
+        frame.data.orientationSensors[orientation.info.name] = orientation;
+
+        msg::PoseSensor pose;
+        pose.info = makeInfo("pose" + index);
+        pose.data.orientation = randomQuaternion();
+        pose.data.position = randomVector(3);
+        frame.data.poseSensors[pose.info.name] = pose;
+
+        msg::TemperatureSensor temperature;
+        temperature.info = makeInfo("temperature" + index);
+        temperature.data = random(-20, 60);
+        frame.data.temperatureSensors[temperature.info.name] = temperature;
+
+        msg::SkinSensor skin;
+        skin.info = makeInfo("skin" + index);
+        for (size_t taxel = 0; taxel < nTaxels; ++taxel) {
+            skin.data.push_back(random(0, maxTaxel));
+        }
+        frame.data.skinSensors[skin.info.name] = skin;
+    }
+    return frame;
+}
+
+static bool withinBound(const double decoded,
+                        const double value,
+                        const EncodingSettings& settings,
+                        const bool scaled)
+{
+    if (scaled) {
+        const double encoded = (value - settings.offset) / settings.scale;
+        return std::abs(decoded - value)
+               <= settings.scale * getValueErrorBound(settings.encoding, 0, encoded) + 1e-9;
+    }
+    return std::abs(decoded - value)
+           <= getValueErrorBound(settings.encoding, settings.range, value);
+}
+
+static bool withinBound(const msg::VectorXYZ& decoded,
+                        const msg::VectorXYZ& value,
+                        const EncodingSettings& settings)
+{
+    return withinBound(decoded.x, value.x, settings, false)
+           && withinBound(decoded.y, value.y, settings, false)
+           && withinBound(decoded.z, value.z, settings, false);
+}
+
+// Quaternions are compared up to their sign
+static bool withinBound(const msg::QuaternionWXYZ& decoded,
+                        const msg::QuaternionWXYZ& value,
+                        const ValueEncoding encoding)
+{
+    const double bound = getQuaternionErrorBound(encoding);
+    const double error = std::max({std::abs(decoded.w - value.w),
+                                   std::abs(decoded.x - value.x),
+                                   std::abs(decoded.y - value.y),
+                                   std::abs(decoded.z - value.z)});
+    const double oppositeError = std::max({std::abs(decoded.w + value.w),
+                                           std::abs(decoded.x + value.x),
+                                           std::abs(decoded.y + value.y),
+                                           std::abs(decoded.z + value.z)});
+    return std::min(error, oppositeError) <= bound;
+}
+
+static EncodingSettings makeSettings(const ValueEncoding encoding,
+                                     const double range = 0,
+                                     const double scale = 1,
+                                     const double offset = 0)
+{
+    EncodingSettings settings;
+    settings.encoding = encoding;
+    settings.range = range;
+    settings.scale = scale;
+    settings.offset = offset;
+    return settings;
+}
+
+// Encode a frame with the given settings of the skin, decode it and check every value against
+// the bounds of the encodings
+static void testRoundTrip(const EncodingSettings& skinSettings, const double maxTaxel)
+{
+    const std::string name = "round trip with " + toString(skinSettings.encoding) + " skin";
+
+    const EncodingSettings accelerometers = makeSettings(ValueEncoding::Fixed16, 50);
+    const EncodingSettings orientations = makeSettings(ValueEncoding::SmallestThree);
+    const EncodingSettings poses = makeSettings(ValueEncoding::Fixed16, 5);
+
+    WearableDataEncoder encoder;
+    std::string error;
+    check(encoder.setEncoding(SensorType::Accelerometer, accelerometers, error), error);
+    check(encoder.setEncoding(SensorType::OrientationSensor, orientations, error), error);
+    check(encoder.setEncoding(SensorType::PoseSensor, poses, error), error);
+    check(encoder.setEncoding(SensorType::SkinSensor, skinSettings, error), error);
+
+    const msg::ExtendedWearableData original = makeFrame(200, maxTaxel);
+    msg::ExtendedWearableData frame = original;
+    encoder.encode(frame);
+
+    check(frame.encodedSensors.size() == 4, name + ": wrong number of encoded types");
+    check(frame.data.accelerometers.empty() && frame.data.orientationSensors.empty()
+              && frame.data.poseSensors.empty() && frame.data.skinSensors.empty(),
+          name + ": encoded sensors left in the maps");
+    check(frame.data.temperatureSensors.size() == original.data.temperatureSensors.size(),
+          name + ": sensors without encoding removed");
+
+    WearableDataDecoder decoder;
+    check(decoder.decode(frame, error), name + ": " + error);
+    check(frame.encodedSensors.empty(), name + ": encoded sensors not cleared");
+
+    check(frame.data.accelerometers.size() == original.data.accelerometers.size(),
+          name + ": wrong number of accelerometers");
+    for (const auto& entry : original.data.accelerometers) {
+        const auto& decoded = frame.data.accelerometers[entry.first];
+        check(decoded.info.name == entry.second.info.name
+                  && decoded.info.status == entry.second.info.status,
+              name + ": wrong info of " + entry.first);
+        check(withinBound(decoded.data, entry.second.data, accelerometers),
+              name + ": " + entry.first);
+    }
+
+    check(frame.data.orientationSensors.size() == original.data.orientationSensors.size(),
+          name + ": wrong number of orientation sensors");
+    for (const auto& entry : original.data.orientationSensors) {
+        const auto& decoded = frame.data.orientationSensors[entry.first];
+        check(withinBound(decoded.data, entry.second.data, ValueEncoding::SmallestThree),
+              name + ": " + entry.first);
+    }
+
+    // The quaternions of fixed16 are encoded with range 1
+    check(frame.data.poseSensors.size() == original.data.poseSensors.size(),
+          name + ": wrong number of pose sensors");
+    for (const auto& entry : original.data.poseSensors) {
+        const auto& decoded = frame.data.poseSensors[entry.first];
+        check(withinBound(decoded.data.orientation, entry.second.data.orientation, poses.encoding)
+                  && withinBound(decoded.data.position, entry.second.data.position, poses),
+              name + ": " + entry.first);
+    }
+
+    for (const auto& entry : original.data.temperatureSensors) {
+        check(frame.data.temperatureSensors[entry.first].data == entry.second.data,
+              name + ": " + entry.first + " changed");
+    }
+
+    const bool scaled = skinSettings.encoding == ValueEncoding::UInt16
+                        || skinSettings.encoding == ValueEncoding::Float16;
+    check(frame.data.skinSensors.size() == original.data.skinSensors.size(),
+          name + ": wrong number of skin sensors");
+    for (const auto& entry : original.data.skinSensors) {
+        const auto& decoded = frame.data.skinSensors[entry.first];
+        bool valid = decoded.data.size() == entry.second.data.size();
+        for (size_t taxel = 0; valid && taxel < decoded.data.size(); ++taxel) {
+            valid = withinBound(
+                decoded.data[taxel], entry.second.data[taxel], skinSettings, scaled);
+        }
+        check(valid, name + ": " + entry.first);
+    }
+}
+
+static void testInvalidSettings()
+{
+    WearableDataEncoder encoder;
+    std::string error;
+
+    check(!encoder.setEncoding(SensorType::Invalid, makeSettings(ValueEncoding::Float32), error),
+          "invalid sensor type accepted");
+    check(!encoder.setEncoding(
+              SensorType::Accelerometer, makeSettings(ValueEncoding::SmallestThree), error),
+          "smallestThree accepted without a quaternion");
+    check(!encoder.setEncoding(
+              SensorType::Accelerometer, makeSettings(ValueEncoding::Fixed16), error),
+          "fixed16 accepted without a range");
+    check(!encoder.setEncoding(
+              SensorType::Accelerometer, makeSettings(ValueEncoding::Fixed16, -1), error),
+          "fixed16 accepted with a negative range");
+    check(!encoder.setEncoding(
+              SensorType::Accelerometer, makeSettings(ValueEncoding::UInt16), error),
+          "uint16 accepted for accelerometers");
+    check(!encoder.setEncoding(SensorType::Gyroscope, makeSettings(ValueEncoding::Float16), error),
+          "float16 accepted for gyroscopes");
+
+    EncodingSettings sparse = makeSettings(ValueEncoding::Float32);
+    sparse.sparse = true;
+    check(!encoder.setEncoding(SensorType::Magnetometer, sparse, error),
+          "sparse accepted for magnetometers");
+
+    check(!encoder.setEncoding(
+              SensorType::SkinSensor, makeSettings(ValueEncoding::UInt16, 0, 0), error),
+          "uint16 accepted with a zero scale");
+    check(!encoder.setEncoding(
+              SensorType::SkinSensor, makeSettings(ValueEncoding::Float16, 0, 1, NAN), error),
+          "float16 accepted with a NaN offset");
+    check(encoder.empty(), "invalid settings stored");
+
+    check(encoder.setEncoding(
+              SensorType::SkinSensor, makeSettings(ValueEncoding::UInt16, 0, 0.1, -5), error),
+          "valid skin settings rejected: " + error);
+    check(!encoder.empty(), "valid settings not stored");
+}
+
+// Frame with the accelerometers encoded with fixed16 and the skin sensors with dense uint16
+static msg::ExtendedWearableData makeEncodedFrame()
+{
+    WearableDataEncoder encoder;
+    std::string error;
+    encoder.setEncoding(SensorType::Accelerometer, makeSettings(ValueEncoding::Fixed16, 50), error);
+    encoder.setEncoding(SensorType::SkinSensor, makeSettings(ValueEncoding::UInt16), error);
+
+    msg::ExtendedWearableData frame = makeFrame(10, 255);
+    encoder.encode(frame);
+    return frame;
+}
+
+static msg::EncodedSensors& getEncoded(msg::ExtendedWearableData& frame, const SensorType type)
+{
+    for (msg::EncodedSensors& encoded : frame.encodedSensors) {
+        if (encoded.type == sensor::sensorTypeToString(type)) {
+            return encoded;
+        }
+    }
+    std::cerr << "Missing encoded " << sensor::sensorTypeToString(type) << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+static void checkRejected(msg::ExtendedWearableData frame, const std::string& name)
+{
+    std::string error;
+    check(!decodeWearableData(frame, error), name + " accepted");
+    check(!error.empty(), name + " rejected without an error");
+}
+
+static void testCorruptedInput()
+{
+    const msg::ExtendedWearableData valid = makeEncodedFrame();
+    {
+        msg::ExtendedWearableData frame = valid;
+        std::string error;
+        check(decodeWearableData(frame, error), "valid frame rejected: " + error);
+    }
+
+    // Truncated and in excess values of the sensors of fixed size
+    for (const SensorType type : {SensorType::Accelerometer, SensorType::SkinSensor}) {
+        const std::string typeName = sensor::sensorTypeToString(type);
+        msg::ExtendedWearableData frame = valid;
+        const size_t size = getEncoded(frame, type).data.size();
+        for (size_t truncated = 0; truncated < size; ++truncated) {
+            frame = valid;
+            getEncoded(frame, type).data.resize(truncated);
+            checkRejected(frame,
+                          typeName + " truncated to " + std::to_string(truncated) + " bytes");
+        }
+
+        frame = valid;
+        getEncoded(frame, type).data.push_back('\0');
+        checkRejected(frame, typeName + " with a byte in excess");
+
+        frame = valid;
+        getEncoded(frame, type).info.push_back(makeInfo("missing"));
+        checkRejected(frame, typeName + " with a sensor without data");
+    }
+
+    msg::ExtendedWearableData frame = valid;
+    getEncoded(frame, SensorType::Accelerometer).encoding = static_cast<msg::ValueEncoding>(42);
+    checkRejected(frame, "unknown encoding");
+
+    frame = valid;
+    getEncoded(frame, SensorType::Accelerometer).type = "Barometer";
+    checkRejected(frame, "unknown sensor type");
+
+    frame = valid;
+    getEncoded(frame, SensorType::Accelerometer).encoding = msg::ValueEncoding::SMALLEST_THREE;
+    checkRejected(frame, "smallestThree accelerometers");
+
+    frame = valid;
+    getEncoded(frame, SensorType::Accelerometer).range = 0;
+    checkRejected(frame, "fixed16 without a range");
+
+    frame = valid;
+    getEncoded(frame, SensorType::Accelerometer).encoding = msg::ValueEncoding::UINT16;
+    checkRejected(frame, "uint16 accelerometers");
+
+    frame = valid;
+    getEncoded(frame, SensorType::SkinSensor).scale = -1;
+    checkRejected(frame, "skin with a negative scale");
+
+    // A skin sensor with more taxels than in the data
+    frame = valid;
+    getEncoded(frame, SensorType::SkinSensor).data[0] = static_cast<char>(0xFF);
+    checkRejected(frame, "skin with too many taxels");
+
+    // Random bytes must never crash the decoder
+    for (size_t i = 0; i < 1000; ++i) {
+        frame = valid;
+        for (msg::EncodedSensors& encoded : frame.encodedSensors) {
+            for (char& byte : encoded.data) {
+                if (random(0, 1) < 0.2) {
+                    byte = static_cast<char>(random(0, 256));
+                }
+            }
+            encoded.data.resize(static_cast<size_t>(random(0, encoded.data.size() + 8)));
+        }
+        std::string error;
+        decodeWearableData(frame, error);
+    }
+}
+
+static void testTooManyTaxels()
+{
+    WearableDataEncoder encoder;
+    std::string error;
+    encoder.setEncoding(SensorType::SkinSensor, makeSettings(ValueEncoding::UInt16), error);
+
+    msg::ExtendedWearableData frame;
+    msg::SkinSensor skin;
+    skin.info = makeInfo("large");
+    skin.data.assign(65535, 1.0);
+    frame.data.skinSensors[skin.info.name] = skin;
+    encoder.encode(frame);
+
+    check(frame.encodedSensors.empty() && frame.data.skinSensors.size() == 1,
+          "skin sensor with more than 65534 taxels encoded");
+}
+
+int main()
+{
+    testRoundTrip(makeSettings(ValueEncoding::Float32), 1000);
+    testRoundTrip(makeSettings(ValueEncoding::Fixed16, 300), 255);
+    testRoundTrip(makeSettings(ValueEncoding::UInt16), 255);
+    testRoundTrip(makeSettings(ValueEncoding::UInt16, 0, 0.01, -2), 600);
+    testRoundTrip(makeSettings(ValueEncoding::Float16, 0, 2, 10), 1e4);
+    testInvalidSettings();
+    testCorruptedInput();
+    testTooManyTaxels();
+
+    return wearable::test::exitStatus();
+}
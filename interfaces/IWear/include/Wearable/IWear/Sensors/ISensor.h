@@ -8,6 +8,8 @@
 
 #include <array>
 #include <atomic>
+#include <cstddef>
+#include <vector>
 
 namespace wearable {
 
@@ -91,6 +93,58 @@ namespace wearable {
             }
         }
 
+        inline std::string sensorTypeToString(const SensorType sensorType)
+        {
+            switch (sensorType) {
+                case SensorType::Accelerometer:
+                    return "Accelerometer";
+                case SensorType::EmgSensor:
+                    return "EmgSensor";
+                case SensorType::Force3DSensor:
+                    return "Force3DSensor";
+                case SensorType::ForceTorque6DSensor:
+                    return "ForceTorque6DSensor";
+                case SensorType::FreeBodyAccelerationSensor:
+                    return "FreeBodyAccelerationSensor";
+                case SensorType::Gyroscope:
+                    return "Gyroscope";
+                case SensorType::Magnetometer:
+                    return "Magnetometer";
+                case SensorType::OrientationSensor:
+                    return "OrientationSensor";
+                case SensorType::PoseSensor:
+                    return "PoseSensor";
+                case SensorType::PositionSensor:
+                    return "PositionSensor";
+                case SensorType::SkinSensor:
+                    return "SkinSensor";
+                case SensorType::TemperatureSensor:
+                    return "TemperatureSensor";
+                case SensorType::Torque3DSensor:
+                    return "Torque3DSensor";
+                case SensorType::VirtualLinkKinSensor:
+                    return "VirtualLinkKinSensor";
+                case SensorType::VirtualJointKinSensor:
+                    return "VirtualJointKinSensor";
+                case SensorType::VirtualSphericalJointKinSensor:
+                    return "VirtualSphericalJointKinSensor";
+                default:
+                    return "Invalid";
+            }
+        }
+
+        // Samples of a sensor acquired at a rate higher than the one of the reads of its values.
+        // The values of the samples follow one another, each one with a value per channel.
+        struct SampleBlock
+        {
+            // Index of the first sample since the start of the acquisition, and its time
+            size_t firstSample = 0;
+            double startTime = 0;
+            double samplePeriod = 0;
+            size_t channels = 1;
+            std::vector<double> values;
+        };
+
         class ISensor;
     } // namespace sensor
 } // namespace wearable
@@ -118,6 +172,15 @@ public:
     inline SensorName getSensorName() const;
     inline SensorStatus getSensorStatus() const;
     inline SensorType getSensorType() const;
+
+    // Sensors sampled faster than they are read can also deliver their samples in blocks. The
+    // block gets the samples from nextSample, or from the oldest one still stored if it was
+    // already dropped, to the last one, and nextSample is moved after them. Return false if the
+    // sensor does not deliver sample blocks.
+    virtual bool getSampleBlock(size_t& /*nextSample*/, SampleBlock& /*block*/) const
+    {
+        return false;
+    }
 };
 
 inline wearable::ElementType wearable::sensor::ISensor::getWearableElementType() const
@@ -0,0 +1,185 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <Wearable/Logger/BinaryLog.h>
+#include <Wearable/Logger/RawCapture.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace wearable::logger;
+using namespace wearable::logger::binary;
+
+void printUsage(const std::string& executable)
+{
+    std::cout << "Usage: " << executable << " <file.iwlog|file.iwraw> [options]" << std::endl
+              << std::endl
+              << "Without options, print the channels and the chunks stored in the file."
+              << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --channel <name>  print the samples of the channel as csv" << std::endl
+              << "  --from <time>     first time of the printed samples" << std::endl
+              << "  --to <time>       last time of the printed samples" << std::endl
+              << std::endl
+              << "For raw captures, print the number of messages and the time range of each stream."
+              << std::endl;
+}
+
+int printRawCaptureInfo(const std::string& fileName)
+{
+    raw::CaptureReader reader;
+    if (!reader.open(fileName)) {
+        std::cerr << reader.getLastError() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    struct StreamInfo
+    {
+        size_t nMessages = 0;
+        size_t nBytes = 0;
+        double startTime = 0;
+        double endTime = 0;
+    };
+    std::map<uint32_t, StreamInfo> streams;
+
+    raw::Record record;
+    while (reader.next(record)) {
+        StreamInfo& info = streams[record.stream];
+        if (info.nMessages == 0) {
+            info.startTime = record.time;
+        }
+        info.nMessages++;
+        info.nBytes += record.message.size();
+        info.endTime = record.time;
+    }
+    if (!reader.getLastError().empty()) {
+        std::cerr << "Stopped reading the capture: " << reader.getLastError() << std::endl;
+    }
+
+    std::cout << std::setprecision(16);
+    std::cout << "Streams (" << reader.getStreams().size() << "):" << std::endl;
+    for (size_t i = 0; i < reader.getStreams().size(); ++i) {
+        const StreamInfo& info = streams[static_cast<uint32_t>(i)];
+        std::cout << "  " << reader.getStreams()[i] << ": " << info.nMessages << " messages, "
+                  << info.nBytes << " bytes, [" << info.startTime << ", " << info.endTime << "]"
+                  << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void printInfo(const Reader& reader)
+{
+    std::cout << std::setprecision(16);
+    std::cout << "Samples: " << reader.getNumberOfSamples() << std::endl;
+    std::cout << "Time range: [" << reader.getStartTime() << ", " << reader.getEndTime() << "]"
+              << std::endl;
+    if (!reader.hasFooter()) {
+        std::cout << "The footer is missing, the index has been rebuilt from the chunks"
+                  << std::endl;
+    }
+
+    std::cout << std::endl << "Channels (" << reader.getChannels().size() << "):" << std::endl;
+    for (const auto& channel : reader.getChannels()) {
+        std::cout << "  " << channel.name << " [" << channel.type << "] (" << channel.size
+                  << " values, prefixed with the sensor status)" << std::endl;
+    }
+
+    std::cout << std::endl << "Chunks (" << reader.getIndex().size() << "):" << std::endl;
+    for (const auto& entry : reader.getIndex()) {
+        std::cout << "  offset " << entry.offset << ", " << entry.nSamples << " samples, ["
+                  << entry.startTime << ", " << entry.endTime << "]" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || std::string(argv[1]) == "--help") {
+        printUsage(argv[0]);
+        return argc < 2 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    const std::string fileName = argv[1];
+    std::string channelName;
+    double startTime = std::numeric_limits<double>::lowest();
+    double endTime = std::numeric_limits<double>::max();
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value of option " << option << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (option == "--channel") {
+            channelName = argv[++i];
+        }
+        else if (option == "--from") {
+            startTime = std::atof(argv[++i]);
+        }
+        else if (option == "--to") {
+            endTime = std::atof(argv[++i]);
+        }
+        else {
+            std::cerr << "Unknown option " << option << std::endl;
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const std::string rawExtension = ".iwraw";
+    if (fileName.size() > rawExtension.size()
+        && fileName.compare(fileName.size() - rawExtension.size(),
+                            rawExtension.size(),
+                            rawExtension)
+               == 0) {
+        return printRawCaptureInfo(fileName);
+    }
+
+    Reader reader;
+    if (!reader.open(fileName)) {
+        std::cerr << reader.getLastError() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (channelName.empty()) {
+        printInfo(reader);
+        return EXIT_SUCCESS;
+    }
+
+    const size_t channel = reader.getChannelIndex(channelName);
+    if (channel == reader.getChannels().size()) {
+        std::cerr << "Channel " << channelName << " not found" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<double> time;
+    std::vector<double> values;
+    if (!reader.readChannel(channel, startTime, endTime, time, values)) {
+        std::cerr << reader.getLastError() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const size_t size = reader.getChannels()[channel].size;
+    std::cout << std::setprecision(16) << "time,status";
+    for (size_t i = 1; i < size; ++i) {
+        std::cout << ",value" << i - 1;
+    }
+    std::cout << std::endl;
+
+    for (size_t sample = 0; sample < time.size(); ++sample) {
+        std::cout << time[sample];
+        for (size_t i = 0; i < size; ++i) {
+            std::cout << "," << values[sample * size + i];
+        }
+        std::cout << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,354 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <Wearable/Logger/BinaryLog.h>
+#include <Wearable/Logger/TimeSeriesCodec.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace wearable::logger;
+
+const std::string BenchmarkName = "IWearCodecBenchmark";
+
+struct Options
+{
+    std::string file;
+    size_t blockSize = 1000;
+    size_t repetitions = 5;
+};
+
+// All the samples of the log, one contiguous series per column
+struct Recording
+{
+    std::vector<binary::Channel> channels;
+    std::vector<size_t> channelOffsets;
+    size_t nSamples = 0;
+    std::vector<double> time;
+    std::vector<int32_t> sequenceNumber;
+    std::vector<std::vector<uint8_t>> valid;
+    std::vector<std::vector<double>> columns;
+};
+
+struct CodecResult
+{
+    size_t rawBytes = 0;
+    size_t encodedBytes = 0;
+    double encodeTime = 0;
+    double decodeTime = 0;
+    bool lossless = true;
+};
+
+struct FileResult
+{
+    std::string compression;
+    size_t fileBytes = 0;
+    double writeTime = 0;
+    double readTime = 0;
+    bool lossless = true;
+};
+
+void printUsage(const std::string& executable)
+{
+    std::cout << "Usage: " << executable << " <file.iwlog> [options]" << std::endl
+              << std::endl
+              << "Measure the compression ratio and the encoding and decoding throughput of the"
+              << std::endl
+              << "time series codecs on the data of a binary log, and print a JSON report."
+              << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --block <n>        samples encoded together (default 1000)" << std::endl
+              << "  --repetitions <n>  repetitions of each measurement (default 5)" << std::endl;
+}
+
+double elapsed(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool load(const std::string& fileName, Recording& recording)
+{
+    binary::Reader reader;
+    if (!reader.open(fileName)) {
+        std::cerr << reader.getLastError() << std::endl;
+        return false;
+    }
+
+    recording.channels = reader.getChannels();
+    size_t nValues = 0;
+    for (size_t c = 0; c < recording.channels.size(); ++c) {
+        recording.channelOffsets.push_back(reader.getChannelOffset(c));
+        nValues += recording.channels[c].size;
+    }
+    recording.valid.resize(recording.channels.size());
+    recording.columns.resize(nValues);
+
+    binary::Chunk chunk;
+    for (size_t i = 0; i < reader.getIndex().size(); ++i) {
+        if (!reader.readChunk(i, chunk)) {
+            std::cerr << reader.getLastError() << std::endl;
+            return false;
+        }
+
+        const size_t n = chunk.nSamples;
+        recording.nSamples += n;
+        recording.time.insert(recording.time.end(), chunk.time.begin(), chunk.time.end());
+        recording.sequenceNumber.insert(recording.sequenceNumber.end(),
+                                        chunk.sequenceNumber.begin(),
+                                        chunk.sequenceNumber.end());
+        for (size_t c = 0; c < recording.valid.size(); ++c) {
+            recording.valid[c].insert(recording.valid[c].end(),
+                                      chunk.valid.begin() + c * n,
+                                      chunk.valid.begin() + (c + 1) * n);
+        }
+        for (size_t v = 0; v < nValues; ++v) {
+            recording.columns[v].insert(recording.columns[v].end(),
+                                        chunk.values.begin() + v * n,
+                                        chunk.values.begin() + (v + 1) * n);
+        }
+    }
+
+    return recording.nSamples > 0;
+}
+
+// Encode and decode the columns in blocks of samples with the XOR codec, accumulating the
+// results by sensor type. The first value of each channel is the sensor status.
+void benchmarkColumns(const Recording& recording,
+                      const Options& options,
+                      std::map<std::string, CodecResult>& results)
+{
+    std::vector<uint8_t> encoded;
+    std::vector<double> decoded(options.blockSize);
+
+    for (size_t c = 0; c < recording.channels.size(); ++c) {
+        for (size_t v = 0; v < recording.channels[c].size; ++v) {
+            const std::string type = v == 0 ? "status" : recording.channels[c].type;
+            const std::vector<double>& column = recording.columns[recording.channelOffsets[c] + v];
+            CodecResult& result = results[type];
+
+            for (size_t start = 0; start < column.size(); start += options.blockSize) {
+                const size_t n = std::min(options.blockSize, column.size() - start);
+
+                auto tic = std::chrono::steady_clock::now();
+                for (size_t r = 0; r < options.repetitions; ++r) {
+                    encoded.clear();
+                    codec::encodeXor(&column[start], n, encoded);
+                }
+                result.encodeTime += elapsed(tic) / options.repetitions;
+
+                tic = std::chrono::steady_clock::now();
+                size_t read = 0;
+                for (size_t r = 0; r < options.repetitions; ++r) {
+                    read = codec::decodeXor(encoded.data(), encoded.size(), n, decoded.data());
+                }
+                result.decodeTime += elapsed(tic) / options.repetitions;
+
+                result.rawBytes += n * sizeof(double);
+                result.encodedBytes += encoded.size();
+                result.lossless = result.lossless && read == encoded.size()
+                                  && std::memcmp(decoded.data(), &column[start], n * sizeof(double))
+                                         == 0;
+            }
+        }
+    }
+}
+
+// Write the recording to a binary log with the given compression and read it back
+FileResult benchmarkFile(const Recording& recording,
+                         const Options& options,
+                         const binary::Compression compression,
+                         const std::string& name)
+{
+    FileResult result;
+    result.compression = name;
+
+    const std::string fileName = options.file + "." + name + ".benchmark.iwlog";
+    std::vector<double> values(recording.columns.size());
+    std::vector<uint8_t> valid(recording.channels.size());
+
+    for (size_t r = 0; r < options.repetitions; ++r) {
+        binary::WriterOptions writerOptions;
+        writerOptions.chunkSize = options.blockSize;
+        writerOptions.compression = compression;
+
+        auto tic = std::chrono::steady_clock::now();
+        binary::Writer writer;
+        if (!writer.open(fileName, recording.channels, writerOptions)) {
+            std::cerr << writer.getLastError() << std::endl;
+            result.lossless = false;
+            return result;
+        }
+        for (size_t s = 0; s < recording.nSamples; ++s) {
+            for (size_t v = 0; v < values.size(); ++v) {
+                values[v] = recording.columns[v][s];
+            }
+            for (size_t c = 0; c < valid.size(); ++c) {
+                valid[c] = recording.valid[c][s];
+            }
+            writer.append(
+                recording.time[s], recording.sequenceNumber[s], values.data(), valid.data());
+        }
+        writer.close();
+        result.writeTime += elapsed(tic) / options.repetitions;
+        result.fileBytes = writer.getBytesWritten();
+
+        tic = std::chrono::steady_clock::now();
+        binary::Reader reader;
+        binary::Chunk chunk;
+        size_t sample = 0;
+        bool ok = reader.open(fileName);
+        for (size_t i = 0; ok && i < reader.getIndex().size(); ++i) {
+            ok = reader.readChunk(i, chunk);
+            for (size_t s = 0; ok && s < chunk.nSamples; ++s, ++sample) {
+                ok = std::memcmp(&chunk.time[s], &recording.time[sample], sizeof(double)) == 0
+                     && chunk.sequenceNumber[s] == recording.sequenceNumber[sample];
+                for (size_t v = 0; ok && v < values.size(); ++v) {
+                    ok = std::memcmp(&chunk.values[v * chunk.nSamples + s],
+                                     &recording.columns[v][sample],
+                                     sizeof(double))
+                         == 0;
+                }
+            }
+        }
+        result.readTime += elapsed(tic) / options.repetitions;
+        result.lossless = result.lossless && ok && sample == recording.nSamples;
+        reader.close();
+    }
+
+    std::remove(fileName.c_str());
+    return result;
+}
+
+void writeReport(std::ostream& out,
+                 const Options& options,
+                 const Recording& recording,
+                 const std::map<std::string, CodecResult>& columns,
+                 const std::vector<FileResult>& files)
+{
+    // Throughputs are reported in MB/s of raw doubles
+    const auto throughput = [](const size_t bytes, const double time) {
+        return time > 0 ? bytes / time / 1e6 : 0.0;
+    };
+
+    out << std::setprecision(3) << std::fixed;
+    out << "{" << std::endl;
+    out << "  \"benchmark\": \"" << BenchmarkName << "\"," << std::endl;
+    out << "  \"file\": \"" << options.file << "\"," << std::endl;
+    out << "  \"configuration\": {\"blockSize\": " << options.blockSize
+        << ", \"repetitions\": " << options.repetitions << "}," << std::endl;
+    out << "  \"samples\": " << recording.nSamples << ", \"channels\": "
+        << recording.channels.size() << ", \"columns\": " << recording.columns.size() << ","
+        << std::endl;
+
+    CodecResult total;
+    out << "  \"xorCodec\": {" << std::endl;
+    for (const auto& entry : columns) {
+        const CodecResult& r = entry.second;
+        total.rawBytes += r.rawBytes;
+        total.encodedBytes += r.encodedBytes;
+        total.encodeTime += r.encodeTime;
+        total.decodeTime += r.decodeTime;
+        total.lossless = total.lossless && r.lossless;
+
+        out << "    \"" << entry.first << "\": {\"ratio\": "
+            << static_cast<double>(r.rawBytes) / std::max<size_t>(r.encodedBytes, 1)
+            << ", \"bitsPerValue\": " << 64.0 * r.encodedBytes / std::max<size_t>(r.rawBytes, 1)
+            << ", \"encodeMBps\": " << throughput(r.rawBytes, r.encodeTime)
+            << ", \"decodeMBps\": " << throughput(r.rawBytes, r.decodeTime)
+            << ", \"lossless\": " << (r.lossless ? "true" : "false") << "}," << std::endl;
+    }
+    out << "    \"total\": {\"ratio\": "
+        << static_cast<double>(total.rawBytes) / std::max<size_t>(total.encodedBytes, 1)
+        << ", \"bitsPerValue\": "
+        << 64.0 * total.encodedBytes / std::max<size_t>(total.rawBytes, 1)
+        << ", \"encodeMBps\": " << throughput(total.rawBytes, total.encodeTime)
+        << ", \"decodeMBps\": " << throughput(total.rawBytes, total.decodeTime)
+        << ", \"lossless\": " << (total.lossless ? "true" : "false") << "}" << std::endl;
+    out << "  }," << std::endl;
+
+    const size_t rawFileBytes = files.empty() ? 0 : files.front().fileBytes;
+    const size_t rawBytes = recording.nSamples * recording.columns.size() * sizeof(double);
+    out << "  \"binaryLog\": [" << std::endl;
+    for (size_t i = 0; i < files.size(); ++i) {
+        const FileResult& r = files[i];
+        out << "    {\"compression\": \"" << r.compression << "\", \"bytes\": " << r.fileBytes
+            << ", \"ratio\": "
+            << static_cast<double>(rawFileBytes) / std::max<size_t>(r.fileBytes, 1)
+            << ", \"writeMBps\": " << throughput(rawBytes, r.writeTime)
+            << ", \"readMBps\": " << throughput(rawBytes, r.readTime)
+            << ", \"lossless\": " << (r.lossless ? "true" : "false") << "}"
+            << (i + 1 < files.size() ? "," : "") << std::endl;
+    }
+    out << "  ]" << std::endl;
+    out << "}" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || std::string(argv[1]) == "--help") {
+        printUsage(argv[0]);
+        return argc < 2 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    Options options;
+    options.file = argv[1];
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value of option " << option << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (option == "--block") {
+            options.blockSize = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (option == "--repetitions") {
+            options.repetitions = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else {
+            std::cerr << "Unknown option " << option << std::endl;
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (options.blockSize == 0 || options.repetitions == 0) {
+        std::cerr << "The block size and the repetitions must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Recording recording;
+    if (!load(options.file, recording)) {
+        std::cerr << "Failed to read the samples of " << options.file << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::map<std::string, CodecResult> columns;
+    benchmarkColumns(recording, options, columns);
+
+    std::vector<FileResult> files;
+    files.push_back(benchmarkFile(recording, options, binary::Compression::None, "none"));
+    files.push_back(benchmarkFile(recording, options, binary::Compression::XorRle, "xor"));
+    files.push_back(benchmarkFile(recording, options, binary::Compression::Gorilla, "gorilla"));
+
+    writeReport(std::cout, options, recording, columns, files);
+
+    bool lossless = true;
+    for (const auto& file : files) {
+        lossless = lossless && file.lossless;
+    }
+    for (const auto& column : columns) {
+        lossless = lossless && column.second.lossless;
+    }
+    return lossless ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,526 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <Wearable/WireEncoding/WearableDataEncoding.h>
+
+#include <yarp/os/DummyConnector.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace wearable;
+using namespace wearable::encoding;
+using sensor::SensorType;
+
+const std::string BenchmarkName = "IWearEncodingBenchmark";
+const std::string WearableName = "XsensSuit";
+// Distinct frames cycled through by the measurements
+constexpr size_t InputFrames = 16;
+
+constexpr size_t Insoles = 2;
+// Skin taxels are 12 bit ADC readings, most of them zero
+constexpr double TaxelMax = 4095;
+constexpr double ContactRatio = 0.25;
+constexpr double ChangeRatio = 0.1;
+
+struct Options
+{
+    size_t segments = 23;
+    size_t taxels = 1024;
+    double duration = 1.0;
+};
+
+struct TypeEncoding
+{
+    SensorType type;
+    EncodingSettings settings;
+};
+
+// Encodings of the sensor types, the types not listed are sent as double. With partial, all the
+// frames but the first one are partial, as in the send-on-change mode.
+struct Configuration
+{
+    std::string name;
+    std::vector<TypeEncoding> encodings;
+    bool partial = false;
+};
+
+struct Result
+{
+    std::string name;
+    size_t bytesPerFrame = 0;
+    double encodeUsPerFrame = 0;
+    double decodeUsPerFrame = 0;
+    // Largest error of a quaternion component, and largest ratio between the error of a value
+    // and its bound
+    double maxQuaternionError = 0;
+    double maxErrorToBound = 0;
+    bool withinBounds = true;
+};
+
+void printUsage(const std::string& executable)
+{
+    std::cout << "Usage: " << executable << " [options]" << std::endl
+              << std::endl
+              << "Measure the size of the frames of an Xsens-like suit with skin insoles with the"
+              << std::endl
+              << "encodings of the sensor values, the cost of encoding and decoding them, and"
+              << std::endl
+              << "check the errors"
+              << std::endl
+              << "against their bounds. Print a JSON report, and fail if a bound is exceeded."
+              << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --segments <n>      number of segments of the suit (default 23)" << std::endl
+              << "  --taxels <n>        number of taxels of each of the two insoles (default 1024)"
+              << std::endl
+              << "  --duration <s>      duration of each measurement (default 1)" << std::endl;
+}
+
+double elapsed(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+TypeEncoding makeEncoding(const SensorType type,
+                          const ValueEncoding encoding,
+                          const double range = 0,
+                          const bool sparse = false)
+{
+    TypeEncoding typeEncoding = {type, {}};
+    typeEncoding.settings.encoding = encoding;
+    typeEncoding.settings.range = range;
+    typeEncoding.settings.sparse = sparse;
+    return typeEncoding;
+}
+
+std::vector<Configuration> getConfigurations()
+{
+    // Quaternions with smallestThree and vectors with fixed16, the skin being configured
+    const auto compact = [](const TypeEncoding& skin) -> std::vector<TypeEncoding> {
+        return {makeEncoding(SensorType::Accelerometer, ValueEncoding::Fixed16, 50.0),
+                makeEncoding(SensorType::Gyroscope, ValueEncoding::Fixed16, 35.0),
+                makeEncoding(SensorType::Magnetometer, ValueEncoding::Fixed16, 2.0),
+                makeEncoding(SensorType::OrientationSensor, ValueEncoding::SmallestThree),
+                makeEncoding(SensorType::VirtualLinkKinSensor, ValueEncoding::SmallestThree),
+                skin};
+    };
+
+    return {
+        {"float64", {}, false},
+        {"float32",
+         {makeEncoding(SensorType::Accelerometer, ValueEncoding::Float32),
+          makeEncoding(SensorType::Gyroscope, ValueEncoding::Float32),
+          makeEncoding(SensorType::Magnetometer, ValueEncoding::Float32),
+          makeEncoding(SensorType::OrientationSensor, ValueEncoding::Float32),
+          makeEncoding(SensorType::VirtualLinkKinSensor, ValueEncoding::Float32),
+          makeEncoding(SensorType::SkinSensor, ValueEncoding::Float32)},
+         false},
+        {"fixed16",
+         {makeEncoding(SensorType::Accelerometer, ValueEncoding::Fixed16, 50.0),
+          makeEncoding(SensorType::Gyroscope, ValueEncoding::Fixed16, 35.0),
+          makeEncoding(SensorType::Magnetometer, ValueEncoding::Fixed16, 2.0),
+          makeEncoding(SensorType::OrientationSensor, ValueEncoding::Fixed16, 1.0),
+          makeEncoding(SensorType::VirtualLinkKinSensor, ValueEncoding::Fixed16, 100.0),
+          makeEncoding(SensorType::SkinSensor, ValueEncoding::Fixed16, TaxelMax)},
+         false},
+        {"smallestThree",
+         compact(makeEncoding(SensorType::SkinSensor, ValueEncoding::UInt16)),
+         false},
+        {"skinFloat16",
+         compact(makeEncoding(SensorType::SkinSensor, ValueEncoding::Float16)),
+         false},
+        {"skinSparse",
+         compact(makeEncoding(SensorType::SkinSensor, ValueEncoding::UInt16, 0, true)),
+         false},
+        {"skinSparseChanged",
+         compact(makeEncoding(SensorType::SkinSensor, ValueEncoding::UInt16, 0, true)),
+         true},
+    };
+}
+
+// Frames of a suit with an IMU and a link per segment, moving randomly, and two skin insoles
+// whose taxels in contact change slowly
+std::vector<msg::ExtendedWearableData> generateFrames(const size_t segments, const size_t taxels)
+{
+    std::mt19937 generator(42);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+
+    const auto vector = [&](const double scale) -> msg::VectorXYZ {
+        return {scale * uniform(generator),
+                scale * uniform(generator),
+                scale * uniform(generator)};
+    };
+    const auto quaternion = [&]() -> msg::QuaternionWXYZ {
+        double q[4] = {normal(generator), normal(generator), normal(generator), normal(generator)};
+        const double norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        return {q[0] / norm, q[1] / norm, q[2] / norm, q[3] / norm};
+    };
+    const msg::SensorInfo info = {"", msg::SensorStatus::OK};
+
+    std::vector<std::vector<double>> insoles(Insoles, std::vector<double>(taxels, 0.0));
+    const auto updateInsoles = [&](const bool first) {
+        for (std::vector<double>& insole : insoles) {
+            for (double& taxel : insole) {
+                if (first || std::abs(uniform(generator)) < ChangeRatio) {
+                    const bool contact = std::abs(uniform(generator)) < ContactRatio;
+                    taxel = contact ? std::round(TaxelMax * std::abs(uniform(generator))) : 0.0;
+                }
+            }
+        }
+    };
+
+    std::vector<msg::ExtendedWearableData> frames(InputFrames);
+    for (msg::ExtendedWearableData& extendedFrame : frames) {
+        msg::WearableData& frame = extendedFrame.data;
+        frame.producerName = WearableName;
+        updateInsoles(&extendedFrame == &frames.front());
+        for (size_t insole = 0; insole < Insoles && taxels > 0; ++insole) {
+            msg::SensorInfo insoleInfo = info;
+            insoleInfo.name = WearableName + "::skin::Insole" + std::to_string(insole);
+            frame.skinSensors[insoleInfo.name] = {insoleInfo, insoles[insole]};
+        }
+        for (size_t segment = 0; segment < segments; ++segment) {
+            const std::string name = "Segment" + std::to_string(segment);
+            const auto sensorInfo = [&](const std::string& prefix) {
+                msg::SensorInfo sensorInfo = info;
+                sensorInfo.name = WearableName + "::" + prefix + "::" + name;
+                return sensorInfo;
+            };
+
+            frame.accelerometers[sensorInfo("acc").name] = {sensorInfo("acc"), vector(20)};
+            frame.gyroscopes[sensorInfo("gyro").name] = {sensorInfo("gyro"), vector(10)};
+            frame.magnetometers[sensorInfo("mag").name] = {sensorInfo("mag"), vector(1)};
+            frame.orientationSensors[sensorInfo("orient").name] = {sensorInfo("orient"),
+                                                                   quaternion()};
+            frame.virtualLinkKinSensors[sensorInfo("vLink").name] = {
+                sensorInfo("vLink"),
+                {quaternion(), vector(2), vector(3), vector(10), vector(20), vector(50)}};
+        }
+    }
+    return frames;
+}
+
+size_t getSerializedSize(const msg::ExtendedWearableData& frame)
+{
+    yarp::os::DummyConnector connector;
+    frame.write(connector.getWriter());
+    return connector.getReader().getSize();
+}
+
+// Compare the values of the sensors of a type of a decoded frame with the original ones
+template <typename Sensors>
+void compareSensors(const Sensors& original,
+                    const Sensors& decoded,
+                    const SensorType type,
+                    const Configuration& configuration,
+                    Result& result)
+{
+    ValueEncoding encoding = ValueEncoding::Float32;
+    double range = 0;
+    bool encoded = false;
+    for (const TypeEncoding& typeEncoding : configuration.encodings) {
+        if (typeEncoding.type == type) {
+            encoding = typeEncoding.settings.encoding;
+            range = typeEncoding.settings.range;
+            encoded = true;
+        }
+    }
+
+    size_t nValues = 0;
+    bool quaternion = false;
+    getValuesLayout(type, nValues, quaternion);
+    const ValueEncoding valueEncoding =
+        encoding == ValueEncoding::SmallestThree ? ValueEncoding::Float32 : encoding;
+
+    std::vector<double> originalValues;
+    std::vector<double> decodedValues;
+    for (const auto& sensor : original) {
+        const auto decodedSensor = decoded.find(sensor.first);
+        if (decodedSensor == decoded.end()
+            || decodedSensor->second.info.status != sensor.second.info.status) {
+            result.withinBounds = false;
+            continue;
+        }
+
+        originalValues.clear();
+        decodedValues.clear();
+        appendValues(sensor.second.data, originalValues);
+        appendValues(decodedSensor->second.data, decodedValues);
+
+        // The quaternions are compared up to their sign
+        size_t first = 0;
+        if (quaternion) {
+            double dot = 0;
+            for (size_t i = 0; i < 4; ++i) {
+                dot += originalValues[i] * decodedValues[i];
+            }
+            const double sign = dot < 0 ? -1.0 : 1.0;
+            const double bound = encoded ? getQuaternionErrorBound(encoding) : 0.0;
+            for (size_t i = 0; i < 4; ++i) {
+                const double error = std::abs(sign * decodedValues[i] - originalValues[i]);
+                result.maxQuaternionError = std::max(result.maxQuaternionError, error);
+                result.maxErrorToBound =
+                    std::max(result.maxErrorToBound, bound > 0 ? error / bound : error);
+                result.withinBounds = result.withinBounds && error <= bound;
+            }
+            first = 4;
+        }
+
+        for (size_t i = first; i < originalValues.size(); ++i) {
+            const double error = std::abs(decodedValues[i] - originalValues[i]);
+            const double bound =
+                encoded ? getValueErrorBound(valueEncoding, range, originalValues[i]) : 0.0;
+            result.maxErrorToBound =
+                std::max(result.maxErrorToBound, bound > 0 ? error / bound : error);
+            result.withinBounds = result.withinBounds && error <= bound;
+        }
+    }
+}
+
+void compareSkin(const std::map<std::string, msg::SkinSensor>& original,
+                 const std::map<std::string, msg::SkinSensor>& decoded,
+                 const Configuration& configuration,
+                 Result& result)
+{
+    const EncodingSettings* settings = nullptr;
+    for (const TypeEncoding& typeEncoding : configuration.encodings) {
+        if (typeEncoding.type == SensorType::SkinSensor) {
+            settings = &typeEncoding.settings;
+        }
+    }
+    const bool scaled = settings
+                        && (settings->encoding == ValueEncoding::UInt16
+                            || settings->encoding == ValueEncoding::Float16);
+
+    for (const auto& sensor : original) {
+        const auto decodedSensor = decoded.find(sensor.first);
+        if (decodedSensor == decoded.end()
+            || decodedSensor->second.data.size() != sensor.second.data.size()) {
+            result.withinBounds = false;
+            continue;
+        }
+
+        for (size_t i = 0; i < sensor.second.data.size(); ++i) {
+            const double value = sensor.second.data[i];
+            const double error = std::abs(decodedSensor->second.data[i] - value);
+            double bound = 0;
+            if (scaled) {
+                bound = settings->scale
+                        * getValueErrorBound(settings->encoding,
+                                             settings->range,
+                                             (value - settings->offset) / settings->scale);
+            }
+            else if (settings) {
+                bound = getValueErrorBound(settings->encoding, settings->range, value);
+            }
+            result.maxErrorToBound =
+                std::max(result.maxErrorToBound, bound > 0 ? error / bound : error);
+            result.withinBounds = result.withinBounds && error <= bound;
+        }
+    }
+}
+
+bool checkErrors(const msg::WearableData& original,
+                 const msg::WearableData& decoded,
+                 const Configuration& configuration,
+                 Result& result)
+{
+    compareSensors(original.accelerometers,
+                   decoded.accelerometers,
+                   SensorType::Accelerometer,
+                   configuration,
+                   result);
+    compareSensors(
+        original.gyroscopes, decoded.gyroscopes, SensorType::Gyroscope, configuration, result);
+    compareSensors(original.magnetometers,
+                   decoded.magnetometers,
+                   SensorType::Magnetometer,
+                   configuration,
+                   result);
+    compareSensors(original.orientationSensors,
+                   decoded.orientationSensors,
+                   SensorType::OrientationSensor,
+                   configuration,
+                   result);
+    compareSensors(original.virtualLinkKinSensors,
+                   decoded.virtualLinkKinSensors,
+                   SensorType::VirtualLinkKinSensor,
+                   configuration,
+                   result);
+    compareSkin(original.skinSensors, decoded.skinSensors, configuration, result);
+    return result.withinBounds;
+}
+
+bool benchmark(std::vector<msg::ExtendedWearableData> frames,
+               const Configuration& configuration,
+               const double duration,
+               Result& result)
+{
+    result.name = configuration.name;
+
+    WearableDataEncoder encoder;
+    for (const TypeEncoding& typeEncoding : configuration.encodings) {
+        std::string error;
+        if (!encoder.setEncoding(typeEncoding.type, typeEncoding.settings, error)) {
+            std::cerr << "Invalid encoding of " << configuration.name << ": " << error
+                      << std::endl;
+            return false;
+        }
+    }
+
+    for (size_t i = 1; i < frames.size(); ++i) {
+        frames[i].partial = configuration.partial;
+    }
+
+    // The frames are encoded and decoded in order, as the sparse skin sensors of the partial
+    // frames refer to the previous ones
+    std::vector<msg::ExtendedWearableData> encodedFrames = frames;
+    size_t bytes = 0;
+    for (msg::ExtendedWearableData& frame : encodedFrames) {
+        encoder.encode(frame);
+        bytes += getSerializedSize(frame);
+    }
+    result.bytesPerFrame = bytes / encodedFrames.size();
+
+    // Only the encoding and the decoding are timed, the copies of the frames they modify are not
+    msg::ExtendedWearableData frame;
+    size_t count = 0;
+    double time = 0;
+    auto start = std::chrono::steady_clock::now();
+    do {
+        frame = frames[count % InputFrames];
+        const auto encodeStart = std::chrono::steady_clock::now();
+        encoder.encode(frame);
+        time += elapsed(encodeStart);
+        ++count;
+    } while (elapsed(start) < duration);
+    result.encodeUsPerFrame = time * 1e6 / count;
+
+    WearableDataDecoder decoder;
+    count = 0;
+    time = 0;
+    start = std::chrono::steady_clock::now();
+    do {
+        frame = encodedFrames[count % InputFrames];
+        const auto decodeStart = std::chrono::steady_clock::now();
+        std::string error;
+        if (!decoder.decode(frame, error)) {
+            std::cerr << "Failed to decode the frames of " << configuration.name << ": " << error
+                      << std::endl;
+            return false;
+        }
+        time += elapsed(decodeStart);
+        ++count;
+    } while (elapsed(start) < duration);
+    result.decodeUsPerFrame = time * 1e6 / count;
+
+    WearableDataDecoder checkDecoder;
+    for (size_t i = 0; i < InputFrames; ++i) {
+        frame = encodedFrames[i];
+        std::string error;
+        if (!checkDecoder.decode(frame, error)) {
+            return false;
+        }
+        checkErrors(frames[i].data, frame.data, configuration, result);
+    }
+    return true;
+}
+
+void writeReport(std::ostream& out,
+                 const Options& options,
+                 const std::vector<Result>& results,
+                 const bool withinBounds)
+{
+    const size_t baseline = results.empty() ? 0 : results.front().bytesPerFrame;
+
+    out << std::setprecision(3) << std::fixed;
+    out << "{" << std::endl;
+    out << "  \"benchmark\": \"" << BenchmarkName << "\"," << std::endl;
+    out << "  \"configuration\": {\"segments\": " << options.segments
+        << ", \"taxels\": " << options.taxels << ", \"sensors\": "
+        << 5 * options.segments + (options.taxels > 0 ? Insoles : 0)
+        << ", \"duration\": " << options.duration << "}," << std::endl;
+    out << "  \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"encoding\": \"" << r.name << "\", \"bytesPerFrame\": " << r.bytesPerFrame
+            << ", \"sizeRatio\": "
+            << (baseline > 0 ? static_cast<double>(r.bytesPerFrame) / baseline : 0.0)
+            << ", \"encodeUsPerFrame\": " << r.encodeUsPerFrame
+            << ", \"decodeUsPerFrame\": " << r.decodeUsPerFrame << std::scientific
+            << ", \"maxQuaternionError\": " << r.maxQuaternionError << std::fixed
+            << ", \"maxErrorToBound\": " << r.maxErrorToBound
+            << ", \"withinBounds\": " << (r.withinBounds ? "true" : "false") << "}"
+            << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "  ]," << std::endl;
+    out << "  \"withinBounds\": " << (withinBounds ? "true" : "false") << std::endl;
+    out << "}" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--help") {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value of option " << option << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (option == "--segments") {
+            options.segments = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (option == "--taxels") {
+            options.taxels = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (option == "--duration") {
+            options.duration = std::strtod(argv[++i], nullptr);
+        }
+        else {
+            std::cerr << "Unknown option " << option << std::endl;
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (options.segments == 0 || options.duration <= 0) {
+        std::cerr << "The number of segments and the duration must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<msg::ExtendedWearableData> frames =
+        generateFrames(options.segments, options.taxels);
+
+    std::vector<Result> results;
+    bool withinBounds = true;
+    for (const Configuration& configuration : getConfigurations()) {
+        Result result;
+        if (!benchmark(frames, configuration, options.duration, result)) {
+            return EXIT_FAILURE;
+        }
+        withinBounds = withinBounds && result.withinBounds;
+        results.push_back(result);
+    }
+
+    writeReport(std::cout, options, results, withinBounds);
+    return withinBounds ? EXIT_SUCCESS : EXIT_FAILURE;
+}
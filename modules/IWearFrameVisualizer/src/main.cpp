@@ -11,11 +11,17 @@
 #include <yarp/os/RFModule.h>
 #include <yarp/sig/Vector.h>
 
+#include <algorithm>
+#include <atomic>
 #include <csignal>
 #include <cstdlib>
+#include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 #include <Wearable/IWear/IWear.h>
@@ -66,12 +72,74 @@ void handleSigInt()
 
 struct FrameViewer
 {
-    std::shared_ptr<FrameViewer> parent{nullptr};
     std::string name;
+    std::string parentName;
+    // Index of the parent in the frames vector, -1 for the root frames
+    int parent = -1;
+    // Index of the associated sensor in the snapshots, -1 for the fixed frames
+    int sensor = -1;
     size_t vizIndex;
-    iDynTree::Transform transform;
+    // Fixed transform from the parent, used only by the fixed frames
+    iDynTree::Transform fixedTransform;
+    iDynTree::Transform worldTransform;
 };
 
+// Poses of the link sensors read by the data thread
+struct PoseSnapshot
+{
+    std::vector<iDynTree::Transform> poses;
+    std::vector<bool> valid;
+    // Time at which the sensors have been read
+    double readTime = 0;
+    size_t sequenceNumber = 0;
+};
+
+// Sort the frames such that every parent precedes its children.
+// Return false if a parent is missing or if the frames contain a cycle.
+bool sortFrames(const std::vector<FrameViewer>& frames,
+                std::vector<size_t>& order,
+                const std::string& logPrefix)
+{
+    std::vector<std::vector<size_t>> children(frames.size());
+    std::vector<size_t> roots;
+
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (frames[i].parent < 0) {
+            roots.push_back(i);
+        }
+        else {
+            children[frames[i].parent].push_back(i);
+        }
+    }
+
+    order.clear();
+    order.reserve(frames.size());
+    std::vector<size_t> toVisit(roots.rbegin(), roots.rend());
+    while (!toVisit.empty()) {
+        const size_t frame = toVisit.back();
+        toVisit.pop_back();
+        order.push_back(frame);
+        toVisit.insert(toVisit.end(), children[frame].rbegin(), children[frame].rend());
+    }
+
+    if (order.size() != frames.size()) {
+        yError() << logPrefix << "The frames_map contains a cycle, the frames not reachable from"
+                 << "a root frame are:";
+        std::vector<bool> visited(frames.size(), false);
+        for (const size_t frame : order) {
+            visited[frame] = true;
+        }
+        for (size_t i = 0; i < frames.size(); ++i) {
+            if (!visited[i]) {
+                yError() << logPrefix << "  " << frames[i].name;
+            }
+        }
+        return false;
+    }
+
+    return true;
+}
+
 int main(int argc, char* argv[])
 {
     std::string portNameIn = "WearableData:I";
@@ -86,6 +154,10 @@ int main(int argc, char* argv[])
 
     config.configure(argc, argv);
 
+    // Period of the thread reading the sensors, decoupled from the rendering rate
+    const double dataPeriod = config.check("data_period", yarp::os::Value(0.01)).asFloat64();
+    const bool showOverlay = config.check("show_overlay", yarp::os::Value(true)).asBool();
+
     // =========================
     // Start the visualizer
     // =========================
@@ -143,7 +215,7 @@ int main(int argc, char* argv[])
     }
 
     // =========================
-    // create the map of link names and wearble sensors
+    // create the list of link names and wearble sensors
     // =========================
     std::vector<std::string> linkNameList;
     yarp::os::Bottle* linkListYarp;
@@ -157,8 +229,8 @@ int main(int argc, char* argv[])
         linkNameList.push_back(linkListYarp->get(i).asString());
     }
 
-    std::map<std::string, wearable::SensorPtr<const wearable::sensor::IVirtualLinkKinSensor>>
-        linkSensorsMap;
+    std::vector<wearable::SensorPtr<const wearable::sensor::IVirtualLinkKinSensor>> linkSensors;
+    std::map<std::string, int> linkSensorsIndices;
 
     for (auto linkName : linkNameList) {
         auto sensor = iWear->getVirtualLinkKinSensor(linkName);
@@ -167,11 +239,12 @@ int main(int argc, char* argv[])
                      << "from the IWear interface";
             return EXIT_FAILURE;
         }
-        linkSensorsMap[linkName] = sensor;
+        linkSensorsIndices[linkName] = static_cast<int>(linkSensors.size());
+        linkSensors.push_back(sensor);
         yInfo() << logPrefix
                 << "sensor name to add the sensors vector: " << sensor->getSensorName();
     }
-    yInfo() << logPrefix << "linkSensorsMap.size(): " << linkSensorsMap.size();
+    yInfo() << logPrefix << "linkSensors.size(): " << linkSensors.size();
 
     // =========================
     // Get the fixed frames
@@ -184,14 +257,13 @@ int main(int argc, char* argv[])
     }
     newFramesListYarp = config.find("new_fixed_frames").asList();
 
-    for (size_t i = 0; i < linkListYarp->size(); i++) {
+    for (size_t i = 0; i < newFramesListYarp->size(); i++) {
         newFramesList.push_back(newFramesListYarp->get(i).asString());
     }
 
     // =========================
     // Get the frames map
     // =========================
-    std::vector<std::string> FramesMapList;
     yarp::os::Bottle* FramesMapYarp;
     if (!(config.check("frames_map") && config.find("frames_map").isList())) {
         yError() << logPrefix << "Unable to find frames_map in the config file.";
@@ -202,69 +274,47 @@ int main(int argc, char* argv[])
     // =========================
     // Make Frame Viewers
     // =========================
-    std::vector<std::shared_ptr<FrameViewer>> frames;
+    std::vector<FrameViewer> frames;
+    std::map<std::string, size_t> framesIndices;
 
     // create all the frame viwers
     for (size_t i = 0; i < FramesMapYarp->size(); i++) {
-        std::shared_ptr<FrameViewer> frame = std::make_shared<FrameViewer>();
         yarp::os::Bottle* frameMapYarp = FramesMapYarp->get(i).asList();
-        if (frameMapYarp->size() != 5) {
+        if (!frameMapYarp || frameMapYarp->size() != 5) {
             yError() << logPrefix << "the map does not have expected size. frameMap: ("
-                     << frameMapYarp->toString() << ") , expected size: " << 5
-                     << " , actual size: " << frameMapYarp->size();
+                     << FramesMapYarp->get(i).toString() << ") , expected size: " << 5;
             return EXIT_FAILURE;
         }
-        frame->name = frameMapYarp->get(0).asString();
-        frame->vizIndex = visualizer.frames().addFrame(iDynTree::Transform::Identity(),
-                                                       frameMapYarp->get(2).asFloat64());
-        //      visualizer.frames()
-        //          .getFrameLabel(frame->vizIndex)
-        //          ->setText(frame->name); // to be merged
-        frames.push_back(frame);
-    }
 
-    // check for the parent frame
-    for (size_t i = 0; i < FramesMapYarp->size(); i++) {
-        yarp::os::Bottle* frameMapYarp = FramesMapYarp->get(i).asList();
-        if (frameMapYarp->size() != 5) {
-            yError() << logPrefix << "the map does not have expected size. frameMap: ("
-                     << frameMapYarp->toString() << ") , expected size: " << 5
-                     << " , actual size: " << frameMapYarp->size();
-            return EXIT_FAILURE;
-        }
+        FrameViewer frame;
+        frame.name = frameMapYarp->get(0).asString();
+        frame.parentName = frameMapYarp->get(1).asString();
 
-        std::string parentName = frameMapYarp->get(1).asString();
-        std::string Name = frameMapYarp->get(0).asString();
-        if (frames[i]->name != Name) {
-            yError() << logPrefix
-                     << "the frame viewer name is not equal to the one from the "
-                        "frame map list. Frame Viewer Name: "
-                     << frames[i]->name << " , yarp map name: " << Name;
+        if (framesIndices.find(frame.name) != framesIndices.end()) {
+            yError() << logPrefix << "The frame" << frame.name
+                     << "is listed more than once in frames_map";
             return EXIT_FAILURE;
         }
 
-        for (auto& frame : frames) {
-            if (frame->name == parentName) {
-                frames[i]->parent = frame;
-                break;
-            }
+        const auto sensorIt = linkSensorsIndices.find(frame.name);
+        if (sensorIt != linkSensorsIndices.end()) {
+            frame.sensor = sensorIt->second;
         }
 
         // check for the fixed transformations
-
         iDynTree::Transform transformation;
         transformation.setPosition(iDynTree::Position::Zero());
         transformation.setRotation(iDynTree::Rotation::Identity()); // x is front (north), z is up.
 
         yarp::os::Bottle* positionList = frameMapYarp->get(3).asList();
         yarp::os::Bottle* quatList = frameMapYarp->get(4).asList();
-        if (positionList->size() == 3) {
+        if (positionList && positionList->size() == 3) {
             iDynTree::Position position(positionList->get(0).asFloat64(),
                                         positionList->get(1).asFloat64(),
                                         positionList->get(2).asFloat64());
             transformation.setPosition(position);
         }
-        if (quatList->size() == 4) {
+        if (quatList && quatList->size() == 4) {
             iDynTree::Vector4 quat;
             quat[0] = quatList->get(0).asFloat64();
             quat[1] = quatList->get(1).asFloat64();
@@ -285,61 +335,191 @@ int main(int argc, char* argv[])
             rotation.fromQuaternion(quat); //(real: w, imaginary: x y z)
             transformation.setRotation(rotation);
         }
-        frames[i]->transform = transformation;
+        frame.fixedTransform = transformation;
+        frame.worldTransform = transformation;
+
+        frame.vizIndex = visualizer.frames().addFrame(iDynTree::Transform::Identity(),
+                                                      frameMapYarp->get(2).asFloat64());
+        //      visualizer.frames()
+        //          .getFrameLabel(frame.vizIndex)
+        //          ->setText(frame.name); // to be merged
+
+        framesIndices[frame.name] = frames.size();
+        frames.push_back(frame);
     }
 
-    // print frames info
-    yInfo() << "Frames information:";
+    // resolve the parent frames
     for (auto& frame : frames) {
-        yInfo() << "name: " << frame->name;
-        if (frame->parent)
-            yInfo() << "parent: " << frame->parent->name;
+        if (frame.parentName.empty()) {
+            continue;
+        }
 
-        yInfo() << "initial transformation from the parent: \n" << frame->transform.toString();
+        const auto parentIt = framesIndices.find(frame.parentName);
+        if (parentIt == framesIndices.end()) {
+            yError() << logPrefix << "The parent frame" << frame.parentName << "of" << frame.name
+                     << "is not in frames_map";
+            return EXIT_FAILURE;
+        }
+        frame.parent = static_cast<int>(parentIt->second);
+    }
+
+    // The frames are updated in this order, so that every parent is updated before its children
+    std::vector<size_t> updateOrder;
+    if (!sortFrames(frames, updateOrder, logPrefix)) {
+        return EXIT_FAILURE;
+    }
+
+    // print frames info
+    yInfo() << "Frames information:";
+    for (const size_t i : updateOrder) {
+        const auto& frame = frames[i];
+        yInfo() << "name: " << frame.name;
+        if (frame.parent >= 0)
+            yInfo() << "parent: " << frame.parentName;
+
+        yInfo() << "initial transformation from the parent: \n"
+                << frame.fixedTransform.toString();
     }
     yInfo() << "=================";
     yInfo() << "===  Running  ===";
     yInfo() << "=================";
 
+    // =========================
+    // Data thread
+    // =========================
+
+    // The data thread reads the sensors at dataPeriod and publishes the poses in sharedSnapshot,
+    // the render loop takes the latest snapshot at the display rate
+    std::mutex snapshotMutex;
+    PoseSnapshot sharedSnapshot;
+    bool newSnapshot = false;
+    std::atomic<bool> stopDataThread{false};
+
+    std::thread dataThread([&]() {
+        PoseSnapshot snapshot;
+        snapshot.poses.resize(linkSensors.size(), iDynTree::Transform::Identity());
+        snapshot.valid.resize(linkSensors.size(), false);
+        std::vector<bool> warned(linkSensors.size(), false);
+
+        wearable::Quaternion orientation;
+        wearable::Vector3 position;
+        iDynTree::Vector4 quat;
+        iDynTree::Rotation rotation;
+
+        while (!stopDataThread && !isClosing) {
+            const double start = yarp::os::Time::now();
+
+            for (size_t i = 0; i < linkSensors.size(); ++i) {
+                const auto& sensor = linkSensors[i];
+
+                // A sensor with a non-Ok status keeps its last valid pose
+                if (sensor->getSensorStatus() != wearable::WearStatus::Ok
+                    || !sensor->getLinkPose(position, orientation)) {
+                    if (!warned[i]) {
+                        yWarning() << logPrefix
+                                   << "sensor status is not OK, sensor name:"
+                                   << sensor->getSensorName();
+                        warned[i] = true;
+                    }
+                    continue;
+                }
+                if (warned[i]) {
+                    yInfo() << logPrefix << "sensor status is OK again, sensor name:"
+                            << sensor->getSensorName();
+                    warned[i] = false;
+                }
+
+                quat[0] = orientation[0];
+                quat[1] = orientation[1];
+                quat[2] = orientation[2];
+                quat[3] = orientation[3];
+                rotation.fromQuaternion(quat); //(real: w, imaginary: x y z)
+                snapshot.poses[i].setRotation(rotation);
+                snapshot.poses[i].setPosition(
+                    iDynTree::Position(position[0], position[1], position[2]));
+                snapshot.valid[i] = true;
+            }
+            snapshot.readTime = yarp::os::Time::now();
+            snapshot.sequenceNumber++;
+
+            {
+                std::lock_guard<std::mutex> lock(snapshotMutex);
+                sharedSnapshot.poses = snapshot.poses;
+                sharedSnapshot.valid = snapshot.valid;
+                sharedSnapshot.readTime = snapshot.readTime;
+                sharedSnapshot.sequenceNumber = snapshot.sequenceNumber;
+                newSnapshot = true;
+            }
+
+            yarp::os::Time::delay(std::max(0.0, dataPeriod - (yarp::os::Time::now() - start)));
+        }
+    });
+
     // =========================
     // Visualization loop
     // =========================
 
-    iDynTree::Transform frameTransform;
-    iDynTree::Rotation frameRotation;
-    iDynTree::Vector4 quat;
+    PoseSnapshot snapshot;
+    bool hasSnapshot = false;
+
+    // Frame time smoothed with an exponential moving average
+    double lastRenderTime = yarp::os::Time::now();
+    double frameTime = 0;
+    constexpr double FrameTimeSmoothing = 0.05;
+
+    if (showOverlay) {
+        visualizer.getLabel("overlay").setSize(0.1);
+        visualizer.getLabel("overlay").setPosition(iDynTree::Position(0, 0, 1));
+    }
 
     while (visualizer.run() && !isClosing) {
 
-        for (auto& frame : frames) {
-            if (frame->parent) { // if not it is inertial frame
-
-                // link
-                auto sensor = linkSensorsMap[frame->name];
-                if (sensor) {
-                    wearable::Quaternion orientation;
-                    wearable::Vector3 position;
-                    if (sensor->getSensorStatus() != wearable::WearStatus::Ok) {
-                        yWarning()
-                            << "senor status is not OK, sensor name:" << sensor->getSensorName();
-                        break;
-                    }
-                    sensor->getLinkPose(position, orientation);
-                    iDynTree::Position framePosition(position[0], position[1], position[2]);
-                    quat[0] = orientation[0];
-                    quat[1] = orientation[1];
-                    quat[2] = orientation[2];
-                    quat[3] = orientation[3];
-                    frameRotation.fromQuaternion(quat); //(real: w, imaginary: x y z)
-                    frameTransform.setPosition(framePosition);
-                    frameTransform.setRotation(frameRotation);
-                    frame->transform = frame->parent->transform * frameTransform;
+        {
+            std::lock_guard<std::mutex> lock(snapshotMutex);
+            if (newSnapshot) {
+                std::swap(snapshot, sharedSnapshot);
+                newSnapshot = false;
+                hasSnapshot = true;
+            }
+        }
+
+        if (hasSnapshot) {
+            for (const size_t i : updateOrder) {
+                auto& frame = frames[i];
+                if (frame.parent < 0) { // inertial frame
+                    frame.worldTransform = frame.fixedTransform;
+                    visualizer.frames().updateFrame(frame.vizIndex, frame.worldTransform);
+                    continue;
+                }
+
+                const iDynTree::Transform& parentTransform = frames[frame.parent].worldTransform;
+                if (frame.sensor < 0) {
+                    frame.worldTransform = parentTransform * frame.fixedTransform;
                 }
-                visualizer.frames().updateFrame(frame->vizIndex, frame->transform);
+                else if (snapshot.valid[frame.sensor]) {
+                    frame.worldTransform = parentTransform * snapshot.poses[frame.sensor];
+                }
+                visualizer.frames().updateFrame(frame.vizIndex, frame.worldTransform);
             }
         }
+
+        const double now = yarp::os::Time::now();
+        frameTime += FrameTimeSmoothing * ((now - lastRenderTime) - frameTime);
+        lastRenderTime = now;
+
+        if (showOverlay) {
+            std::ostringstream overlay;
+            overlay << std::fixed << std::setprecision(1) << "frame time: " << frameTime * 1e3
+                    << " ms, data age: "
+                    << (hasSnapshot ? (now - snapshot.readTime) * 1e3 : 0.0) << " ms";
+            visualizer.getLabel("overlay").setText(overlay.str());
+        }
+
         visualizer.draw();
     }
 
+    stopDataThread = true;
+    dataThread.join();
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,279 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <Wearable/Fusion/OrientationFusion.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace wearable::fusion;
+
+const std::string BenchmarkName = "IWearFusionBenchmark";
+constexpr double Pi = 3.14159265358979323846;
+constexpr double SamplePeriod = 0.01;
+// Distinct input samples cycled through by the updates of each IMU
+constexpr size_t InputSamples = 16;
+
+struct Options
+{
+    std::vector<size_t> imus = {1, 10, 100, 1000, 10000};
+    double duration = 1.0;
+};
+
+struct Result
+{
+    size_t imus = 0;
+    bool magnetometer = false;
+    double batchedImusPerMs = 0;
+    double perImuImusPerMs = 0;
+};
+
+// Noisy readings of IMUs at rest with random orientations
+struct Inputs
+{
+    size_t nImus = 0;
+    std::vector<double> acc;
+    std::vector<double> gyro;
+    std::vector<double> mag;
+
+    const double* getAcc(const size_t sample, const size_t imu) const
+    {
+        return &acc[3 * (sample * nImus + imu)];
+    }
+    const double* getGyro(const size_t sample, const size_t imu) const
+    {
+        return &gyro[3 * (sample * nImus + imu)];
+    }
+    const double* getMag(const size_t sample, const size_t imu) const
+    {
+        return &mag[3 * (sample * nImus + imu)];
+    }
+};
+
+void printUsage(const std::string& executable)
+{
+    std::cout << "Usage: " << executable << " [options]" << std::endl
+              << std::endl
+              << "Measure the throughput of the orientation filters updated in a batch, and one"
+              << std::endl
+              << "IMU at a time, on one core, and print a JSON report." << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --imus <list>       comma separated numbers of IMUs (default "
+                 "1,10,100,1000,10000)"
+              << std::endl
+              << "  --duration <s>      duration of each measurement (default 1)" << std::endl;
+}
+
+double elapsed(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Inputs generateInputs(const size_t nImus)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> angle(-Pi, Pi);
+    std::normal_distribution<double> noise(0.0, 0.01);
+
+    Inputs inputs;
+    inputs.nImus = nImus;
+    inputs.acc.resize(3 * nImus * InputSamples);
+    inputs.gyro.resize(3 * nImus * InputSamples);
+    inputs.mag.resize(3 * nImus * InputSamples);
+
+    for (size_t imu = 0; imu < nImus; ++imu) {
+        // Gravity and magnetic field in the frame of a sensor with random roll, pitch and yaw
+        const double roll = angle(generator) / 2;
+        const double pitch = angle(generator) / 4;
+        const double yaw = angle(generator);
+        const double cr = std::cos(roll), sr = std::sin(roll);
+        const double cp = std::cos(pitch), sp = std::sin(pitch);
+        const double cy = std::cos(yaw), sy = std::sin(yaw);
+        const double gravity[3] = {-9.81 * sp, 9.81 * sr * cp, 9.81 * cr * cp};
+        const double field[3] = {0.3 * cy * cp + 0.4 * sp,
+                                 0.3 * (cy * sp * sr - sy * cr) - 0.4 * cp * sr,
+                                 0.3 * (cy * sp * cr + sy * sr) - 0.4 * cp * cr};
+
+        for (size_t sample = 0; sample < InputSamples; ++sample) {
+            for (size_t axis = 0; axis < 3; ++axis) {
+                const size_t i = 3 * (sample * nImus + imu) + axis;
+                inputs.acc[i] = gravity[axis] + noise(generator);
+                inputs.gyro[i] = noise(generator);
+                inputs.mag[i] = field[axis] + noise(generator) / 10;
+            }
+        }
+    }
+
+    return inputs;
+}
+
+// Update all the IMUs together, return the IMU updates per millisecond
+double benchmarkBatched(const Inputs& inputs,
+                        const bool magnetometer,
+                        const double duration,
+                        double& checksum)
+{
+    OrientationFilterBank filters(magnetometer);
+    filters.resize(inputs.nImus);
+
+    size_t updates = 0;
+    const auto start = std::chrono::steady_clock::now();
+    do {
+        for (size_t repetition = 0; repetition < InputSamples; ++repetition) {
+            const size_t sample = updates % InputSamples;
+            for (size_t imu = 0; imu < inputs.nImus; ++imu) {
+                filters.setInput(imu,
+                                 inputs.getAcc(sample, imu),
+                                 inputs.getGyro(sample, imu),
+                                 inputs.getMag(sample, imu));
+            }
+            filters.update(SamplePeriod);
+            ++updates;
+        }
+    } while (elapsed(start) < duration);
+    const double time = elapsed(start);
+
+    double quaternion[4];
+    filters.getOrientation(inputs.nImus - 1, quaternion);
+    checksum += quaternion[0];
+
+    return updates * inputs.nImus / (time * 1e3);
+}
+
+// Update the IMUs one at a time, each with its own filter, as done by consumers running a
+// filter per IMU
+double benchmarkPerImu(const Inputs& inputs,
+                       const bool magnetometer,
+                       const double duration,
+                       double& checksum)
+{
+    std::vector<std::unique_ptr<OrientationFilterBank>> filters;
+    for (size_t imu = 0; imu < inputs.nImus; ++imu) {
+        filters.emplace_back(new OrientationFilterBank(magnetometer));
+        filters.back()->resize(1);
+    }
+
+    size_t updates = 0;
+    const auto start = std::chrono::steady_clock::now();
+    do {
+        for (size_t repetition = 0; repetition < InputSamples; ++repetition) {
+            const size_t sample = updates % InputSamples;
+            for (size_t imu = 0; imu < inputs.nImus; ++imu) {
+                filters[imu]->setInput(0,
+                                       inputs.getAcc(sample, imu),
+                                       inputs.getGyro(sample, imu),
+                                       inputs.getMag(sample, imu));
+                filters[imu]->update(SamplePeriod);
+            }
+            ++updates;
+        }
+    } while (elapsed(start) < duration);
+    const double time = elapsed(start);
+
+    double quaternion[4];
+    filters.back()->getOrientation(0, quaternion);
+    checksum += quaternion[0];
+
+    return updates * inputs.nImus / (time * 1e3);
+}
+
+void writeReport(std::ostream& out,
+                 const Options& options,
+                 const std::vector<Result>& results,
+                 const double checksum)
+{
+    out << std::setprecision(3) << std::fixed;
+    out << "{" << std::endl;
+    out << "  \"benchmark\": \"" << BenchmarkName << "\"," << std::endl;
+    out << "  \"configuration\": {\"duration\": " << options.duration << ", \"threads\": 1},"
+        << std::endl;
+    out << "  \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"imus\": " << r.imus
+            << ", \"magnetometer\": " << (r.magnetometer ? "true" : "false")
+            << ", \"batchedImusPerMs\": " << r.batchedImusPerMs
+            << ", \"perImuImusPerMs\": " << r.perImuImusPerMs << ", \"speedup\": "
+            << (r.perImuImusPerMs > 0 ? r.batchedImusPerMs / r.perImuImusPerMs : 0.0) << "}"
+            << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "  ]," << std::endl;
+    // Printed so that the filters are not optimized away
+    out << "  \"checksum\": " << checksum << std::endl;
+    out << "}" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--help") {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value of option " << option << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (option == "--imus") {
+            options.imus.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                options.imus.push_back(std::strtoul(item.c_str(), nullptr, 10));
+            }
+        }
+        else if (option == "--duration") {
+            options.duration = std::strtod(argv[++i], nullptr);
+        }
+        else {
+            std::cerr << "Unknown option " << option << std::endl;
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (const size_t imus : options.imus) {
+        if (imus == 0) {
+            std::cerr << "The numbers of IMUs must be positive" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (options.imus.empty() || options.duration <= 0) {
+        std::cerr << "The numbers of IMUs and the duration must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Result> results;
+    double checksum = 0;
+    for (const size_t imus : options.imus) {
+        const Inputs inputs = generateInputs(imus);
+        for (const bool magnetometer : {false, true}) {
+            Result result;
+            result.imus = imus;
+            result.magnetometer = magnetometer;
+            result.batchedImusPerMs =
+                benchmarkBatched(inputs, magnetometer, options.duration, checksum);
+            result.perImuImusPerMs =
+                benchmarkPerImu(inputs, magnetometer, options.duration, checksum);
+            results.push_back(result);
+        }
+    }
+
+    writeReport(std::cout, options, results, checksum);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,744 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <Wearable/IWear/IWear.h>
+
+#include <yarp/dev/IWrapper.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/PortReader.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+using namespace wearable;
+
+const std::string BenchmarkName = "IWearPipelineBenchmark";
+const std::string SyntheticName = "Synthetic";
+
+struct Options
+{
+    std::vector<int> sensors = {10, 50, 200};
+    std::vector<double> rates = {100, 500, 1000};
+    std::vector<std::string> types = {
+        "Accelerometer", "Gyroscope", "Magnetometer", "OrientationSensor"};
+    double duration = 5.0;
+    double warmup = 1.0;
+    double pollPeriod = 0.0002;
+    int skinTaxels = 64;
+    std::string carrier = "tcp";
+    std::string output;
+    bool localMode = true;
+};
+
+struct Statistics
+{
+    double mean = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double max = 0;
+};
+
+struct RunResult
+{
+    int sensors = 0;
+    double rate = 0;
+    size_t valuesPerFrame = 0;
+    double duration = 0;
+
+    size_t producedFrames = 0;
+    size_t sentFrames = 0;
+    size_t consumedFrames = 0;
+    size_t lostFrames = 0;
+    size_t duplicatedFrames = 0;
+    size_t outOfOrderFrames = 0;
+
+    Statistics transportLatency;
+    Statistics consumerLatency;
+
+    size_t bytes = 0;
+    std::map<std::string, double> cpu;
+    bool ok = false;
+    std::string error;
+};
+
+void printUsage(const std::string& executable)
+{
+    std::cout << "Usage: " << executable << " [options]" << std::endl
+              << std::endl
+              << "Run iwear_synthetic -> iwear_wrapper -> iwear_remapper -> consumer in this"
+              << std::endl
+              << "process for every combination of sensor count and rate, and print a JSON report."
+              << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --sensors <n,...>     sensors of each type (default 10,50,200)" << std::endl
+              << "  --rates <hz,...>      producer and wrapper rates (default 100,500,1000)"
+              << std::endl
+              << "  --types <type,...>    sensor types (default "
+                 "Accelerometer,Gyroscope,Magnetometer,OrientationSensor)"
+              << std::endl
+              << "  --duration <s>        measured time of each run (default 5)" << std::endl
+              << "  --warmup <s>          time discarded at the beginning of each run (default 1)"
+              << std::endl
+              << "  --poll-period <s>     period of the consumer (default 0.0002)" << std::endl
+              << "  --skin-taxels <n>     taxels of the skin sensors (default 64)" << std::endl
+              << "  --carrier <carrier>   carrier of the connections (default tcp)" << std::endl
+              << "  --output <file>       write the report to the file instead of stdout"
+              << std::endl
+              << "  --no-local-mode       use the running yarpserver instead of the in-process "
+                 "name server"
+              << std::endl;
+}
+
+template <typename T>
+bool parseList(const std::string& text, std::vector<T>& values)
+{
+    values.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        std::stringstream itemStream(item);
+        T value;
+        if (!(itemStream >> value)) {
+            return false;
+        }
+        values.push_back(value);
+    }
+    return !values.empty();
+}
+
+// ================
+// CPU OF THE STAGES
+// ================
+
+// The threads of each stage are the threads created while opening it. The cpu time is read
+// from /proc, hence it is available only on Linux.
+
+std::set<long> listThreads()
+{
+    std::set<long> threads;
+#ifdef __linux__
+    DIR* directory = opendir("/proc/self/task");
+    if (!directory) {
+        return threads;
+    }
+    while (dirent* entry = readdir(directory)) {
+        const long tid = std::atol(entry->d_name);
+        if (tid > 0) {
+            threads.insert(tid);
+        }
+    }
+    closedir(directory);
+#endif
+    return threads;
+}
+
+std::set<long> newThreads(const std::set<long>& before)
+{
+    std::set<long> threads;
+    for (const long tid : listThreads()) {
+        if (before.find(tid) == before.end()) {
+            threads.insert(tid);
+        }
+    }
+    return threads;
+}
+
+double getThreadCpuTime(const long tid)
+{
+#ifdef __linux__
+    std::ifstream file("/proc/self/task/" + std::to_string(tid) + "/stat");
+    std::string stat;
+    if (!std::getline(file, stat)) {
+        return 0;
+    }
+
+    // The fields after the thread name start from the state, utime and stime follow 11 fields
+    std::stringstream stream(stat.substr(stat.rfind(')') + 2));
+    std::string field;
+    for (int i = 0; i < 11; ++i) {
+        stream >> field;
+    }
+    double utime = 0;
+    double stime = 0;
+    stream >> utime >> stime;
+    return (utime + stime) / static_cast<double>(sysconf(_SC_CLK_TCK));
+#else
+    (void) tid;
+    return 0;
+#endif
+}
+
+double getThreadsCpuTime(const std::set<long>& threads)
+{
+    double time = 0;
+    for (const long tid : threads) {
+        time += getThreadCpuTime(tid);
+    }
+    return time;
+}
+
+double getProcessCpuTime()
+{
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+// ============
+// BYTE COUNTER
+// ============
+
+// Reader counting the size of the messages streamed by the wrapper, without decoding them
+class ByteCounter : public yarp::os::PortReader
+{
+public:
+    std::atomic<size_t> bytes{0};
+    std::atomic<size_t> messages{0};
+
+    bool read(yarp::os::ConnectionReader& connection) override
+    {
+        bytes += connection.getSize();
+        messages++;
+        return true;
+    }
+};
+
+// ========
+// CONSUMER
+// ========
+
+// Consumer polling the IWear interface of the remapper. Every new frame is checked against the
+// clock sensor of iwear_synthetic, storing the generation time and the sequence number, and all
+// the sensors of the benchmarked types are read as a real consumer would do.
+class Consumer
+{
+private:
+    const IWear* m_iWear;
+    const double m_pollPeriod;
+    SensorPtr<const sensor::IVirtualJointKinSensor> m_clock;
+    VectorOfSensorPtr<const sensor::ISensor> m_sensors;
+
+    std::thread m_thread;
+    std::atomic<bool> m_closing{false};
+    std::atomic<bool> m_measuring{false};
+
+    std::mutex m_mutex;
+    size_t m_lastSequenceNumber = 0;
+    size_t m_lastProducerSequenceNumber = 0;
+
+public:
+    size_t frames = 0;
+    size_t lost = 0;
+    size_t duplicated = 0;
+    size_t outOfOrder = 0;
+    std::vector<double> transportLatencies;
+    std::vector<double> consumerLatencies;
+
+    Consumer(const IWear* iWear,
+             const double pollPeriod,
+             const std::vector<sensor::SensorType>& types)
+        : m_iWear(iWear)
+        , m_pollPeriod(pollPeriod)
+    {
+        m_clock = m_iWear->getVirtualJointKinSensor(
+            SyntheticName + wearable::Separator + sensor::IVirtualJointKinSensor::getPrefix()
+            + "clock");
+        for (const auto type : types) {
+            for (const auto& s : m_iWear->getSensors(type)) {
+                m_sensors.push_back(s);
+            }
+        }
+    }
+
+    ~Consumer() { stop(); }
+
+    bool isValid() const { return m_clock != nullptr; }
+
+    void start() { m_thread = std::thread(&Consumer::loop, this); }
+
+    void stop()
+    {
+        m_closing = true;
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    void setMeasuring(const bool measuring)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_measuring = measuring;
+    }
+
+    void loop()
+    {
+        std::vector<double> buffer;
+        Vector3 vector3;
+        Quaternion quaternion;
+
+        while (!m_closing) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(m_pollPeriod));
+
+            const TimeStamp timestamp = m_iWear->getTimeStamp();
+            if (timestamp.sequenceNumber == m_lastSequenceNumber) {
+                continue;
+            }
+
+            double generationTime = 0;
+            double producerSequenceNumber = 0;
+            m_clock->getJointPosition(generationTime);
+            m_clock->getJointVelocity(producerSequenceNumber);
+            const double now = yarp::os::Time::now();
+
+            // Discard the frame if the remapper received a newer one while reading the clock
+            if (m_iWear->getTimeStamp().sequenceNumber != timestamp.sequenceNumber) {
+                continue;
+            }
+            m_lastSequenceNumber = timestamp.sequenceNumber;
+
+            for (const auto& s : m_sensors) {
+                switch (s->getSensorType()) {
+                    case sensor::SensorType::OrientationSensor:
+                        static_cast<const sensor::IOrientationSensor*>(s.get())
+                            ->getOrientationAsQuaternion(quaternion);
+                        break;
+                    case sensor::SensorType::SkinSensor:
+                        static_cast<const sensor::ISkinSensor*>(s.get())->getPressure(buffer);
+                        break;
+                    case sensor::SensorType::Accelerometer:
+                        static_cast<const sensor::IAccelerometer*>(s.get())
+                            ->getLinearAcceleration(vector3);
+                        break;
+                    case sensor::SensorType::Gyroscope:
+                        static_cast<const sensor::IGyroscope*>(s.get())->getAngularRate(vector3);
+                        break;
+                    case sensor::SensorType::Magnetometer:
+                        static_cast<const sensor::IMagnetometer*>(s.get())
+                            ->getMagneticField(vector3);
+                        break;
+                    default:
+                        s->getSensorStatus();
+                        break;
+                }
+            }
+
+            const size_t sequenceNumber = static_cast<size_t>(producerSequenceNumber);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_measuring && m_lastProducerSequenceNumber != 0) {
+                if (sequenceNumber == m_lastProducerSequenceNumber) {
+                    // The wrapper streamed again the same sample
+                    duplicated++;
+                }
+                else if (sequenceNumber < m_lastProducerSequenceNumber) {
+                    outOfOrder++;
+                }
+                else {
+                    lost += sequenceNumber - m_lastProducerSequenceNumber - 1;
+                    frames++;
+                    transportLatencies.push_back(timestamp.time - generationTime);
+                    consumerLatencies.push_back(now - generationTime);
+                }
+            }
+            m_lastProducerSequenceNumber = std::max(m_lastProducerSequenceNumber, sequenceNumber);
+        }
+    }
+
+    void lock() { m_mutex.lock(); }
+    void unlock() { m_mutex.unlock(); }
+};
+
+Statistics computeStatistics(std::vector<double> values)
+{
+    Statistics statistics;
+    if (values.empty()) {
+        return statistics;
+    }
+
+    std::sort(values.begin(), values.end());
+    const auto percentile = [&values](const double p) {
+        const size_t rank = static_cast<size_t>(std::ceil(p * values.size()));
+        return values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+    };
+
+    double sum = 0;
+    for (const double value : values) {
+        sum += value;
+    }
+    statistics.mean = sum / values.size();
+    statistics.p50 = percentile(0.5);
+    statistics.p99 = percentile(0.99);
+    statistics.p999 = percentile(0.999);
+    statistics.max = values.back();
+    return statistics;
+}
+
+// ===
+// RUN
+// ===
+
+size_t getSensorSize(const std::string& type, const int skinTaxels)
+{
+    const std::map<std::string, size_t> sizes = {
+        {"EmgSensor", 2},
+        {"ForceTorque6DSensor", 6},
+        {"OrientationSensor", 4},
+        {"PoseSensor", 7},
+        {"SkinSensor", static_cast<size_t>(skinTaxels)},
+        {"TemperatureSensor", 1},
+        {"VirtualLinkKinSensor", 19},
+        {"VirtualSphericalJointKinSensor", 9},
+    };
+    const auto it = sizes.find(type);
+    return it == sizes.end() ? 3 : it->second;
+}
+
+RunResult run(const Options& options, const int index, const int nSensors, const double rate)
+{
+    RunResult result;
+    result.sensors = nSensors;
+    result.rate = rate;
+
+    const std::string prefix = "/" + BenchmarkName + "/" + std::to_string(index);
+    const std::string dataPortName = prefix + "/data:o";
+    const double period = 1.0 / rate;
+
+    std::vector<sensor::SensorType> types;
+    std::string sensorsList = "(";
+    for (const auto& type : options.types) {
+        types.push_back(sensor::sensorTypeFromString(type));
+        sensorsList += "(" + type + " " + std::to_string(nSensors) + ") ";
+        result.valuesPerFrame += nSensors * getSensorSize(type, options.skinTaxels);
+    }
+    sensorsList += ")";
+
+    std::set<long> threads = listThreads();
+    std::map<std::string, std::set<long>> stageThreads;
+
+    // Producer
+    yarp::os::Property syntheticOptions;
+    syntheticOptions.put("device", "iwear_synthetic");
+    syntheticOptions.put("wearableName", SyntheticName);
+    syntheticOptions.put("period", period);
+    syntheticOptions.put("skinTaxels", options.skinTaxels);
+    syntheticOptions.put("signal", "random");
+    syntheticOptions.fromString("(clockSensor true) (sensors " + sensorsList + ")",
+                                /*wipe=*/false);
+
+    yarp::dev::PolyDriver synthetic;
+    IWear* producer = nullptr;
+    if (!synthetic.open(syntheticOptions) || !synthetic.view(producer) || !producer) {
+        result.error = "Failed to open iwear_synthetic";
+        return result;
+    }
+    stageThreads["producer"] = newThreads(threads);
+    threads = listThreads();
+
+    // Wrapper
+    yarp::os::Property wrapperOptions;
+    wrapperOptions.put("device", "iwear_wrapper");
+    wrapperOptions.put("period", period);
+    wrapperOptions.put("dataPortName", dataPortName);
+
+    yarp::dev::PolyDriver wrapper;
+    yarp::dev::IWrapper* iWrapper = nullptr;
+    if (!wrapper.open(wrapperOptions) || !wrapper.view(iWrapper) || !iWrapper
+        || !iWrapper->attach(&synthetic)) {
+        result.error = "Failed to open iwear_wrapper";
+        return result;
+    }
+    stageThreads["wrapper"] = newThreads(threads);
+    threads = listThreads();
+
+    // Remapper
+    yarp::os::Property remapperOptions;
+    remapperOptions.put("device", "iwear_remapper");
+    remapperOptions.put("carrier", options.carrier);
+    remapperOptions.fromString("(wearableDataPorts (" + dataPortName + "))", /*wipe=*/false);
+
+    yarp::dev::PolyDriver remapper;
+    IWear* iWear = nullptr;
+    if (!remapper.open(remapperOptions) || !remapper.view(iWear) || !iWear) {
+        result.error = "Failed to open iwear_remapper";
+        iWrapper->detach();
+        return result;
+    }
+    stageThreads["remapper"] = newThreads(threads);
+
+    // Wait the first frame before looking for the sensors
+    const double timeout = yarp::os::Time::now() + 10.0;
+    while (iWear->getTimeStamp().sequenceNumber == 0 && yarp::os::Time::now() < timeout) {
+        yarp::os::Time::delay(0.01);
+    }
+
+    // Consumer
+    threads = listThreads();
+    Consumer consumer(iWear, options.pollPeriod, types);
+    if (!consumer.isValid()) {
+        result.error = "The clock sensor has not been received by iwear_remapper";
+        remapper.close();
+        iWrapper->detach();
+        return result;
+    }
+    consumer.start();
+    stageThreads["consumer"] = newThreads(threads);
+
+    // Byte counter, connected to the wrapper like the remapper
+    ByteCounter counter;
+    yarp::os::Port counterPort;
+    counterPort.setReader(counter);
+    if (!counterPort.open(prefix + "/bytes:i")
+        || !yarp::os::Network::connect(dataPortName, prefix + "/bytes:i", options.carrier)) {
+        result.error = "Failed to connect the byte counter";
+    }
+
+    yarp::os::Time::delay(options.warmup);
+
+    // Measure
+    std::map<std::string, double> stageCpuStart;
+    for (const auto& stage : stageThreads) {
+        stageCpuStart[stage.first] = getThreadsCpuTime(stage.second);
+    }
+    const double processCpuStart = getProcessCpuTime();
+    const size_t producedStart = producer->getTimeStamp().sequenceNumber;
+    const size_t bytesStart = counter.bytes;
+    const size_t messagesStart = counter.messages;
+    const double timeStart = yarp::os::Time::now();
+    consumer.setMeasuring(true);
+
+    yarp::os::Time::delay(options.duration);
+
+    consumer.setMeasuring(false);
+    const double timeEnd = yarp::os::Time::now();
+    const size_t bytesEnd = counter.bytes;
+    const size_t messagesEnd = counter.messages;
+    const size_t producedEnd = producer->getTimeStamp().sequenceNumber;
+    const double processCpuEnd = getProcessCpuTime();
+
+    result.duration = timeEnd - timeStart;
+    for (const auto& stage : stageThreads) {
+        result.cpu[stage.first] = 100.0
+                                  * (getThreadsCpuTime(stage.second) - stageCpuStart[stage.first])
+                                  / result.duration;
+    }
+    result.cpu["process"] = 100.0 * (processCpuEnd - processCpuStart) / result.duration;
+
+    result.producedFrames = producedEnd - producedStart;
+    result.sentFrames = messagesEnd - messagesStart;
+    result.bytes = bytesEnd - bytesStart;
+
+    consumer.lock();
+    result.consumedFrames = consumer.frames;
+    result.lostFrames = consumer.lost;
+    result.duplicatedFrames = consumer.duplicated;
+    result.outOfOrderFrames = consumer.outOfOrder;
+    result.transportLatency = computeStatistics(consumer.transportLatencies);
+    result.consumerLatency = computeStatistics(consumer.consumerLatencies);
+    consumer.unlock();
+
+    // Close the pipeline from the consumer to the producer
+    consumer.stop();
+    counterPort.close();
+    remapper.close();
+    iWrapper->detach();
+    wrapper.close();
+    synthetic.close();
+
+    result.ok = result.error.empty();
+    return result;
+}
+
+// ======
+// REPORT
+// ======
+
+void writeStatistics(std::ostream& out, const std::string& name, const Statistics& statistics)
+{
+    // Latencies are reported in milliseconds
+    out << "      \"" << name << "\": {\"mean\": " << statistics.mean * 1e3
+        << ", \"p50\": " << statistics.p50 * 1e3 << ", \"p99\": " << statistics.p99 * 1e3
+        << ", \"p999\": " << statistics.p999 * 1e3 << ", \"max\": " << statistics.max * 1e3
+        << "}";
+}
+
+void writeReport(std::ostream& out, const Options& options, const std::vector<RunResult>& results)
+{
+    out << std::setprecision(6) << std::fixed;
+    out << "{" << std::endl;
+    out << "  \"benchmark\": \"" << BenchmarkName << "\"," << std::endl;
+    out << "  \"configuration\": {\"duration\": " << options.duration
+        << ", \"warmup\": " << options.warmup << ", \"pollPeriod\": " << options.pollPeriod
+        << ", \"carrier\": \"" << options.carrier << "\", \"localMode\": "
+        << (options.localMode ? "true" : "false") << ", \"types\": [";
+    for (size_t i = 0; i < options.types.size(); ++i) {
+        out << (i > 0 ? ", " : "") << "\"" << options.types[i] << "\"";
+    }
+    out << "]}," << std::endl;
+
+    out << "  \"runs\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const RunResult& r = results[i];
+        const double duration = r.duration > 0 ? r.duration : 1;
+
+        out << "    {" << std::endl;
+        out << "      \"sensorsPerType\": " << r.sensors << "," << std::endl;
+        out << "      \"rate\": " << r.rate << "," << std::endl;
+        out << "      \"valuesPerFrame\": " << r.valuesPerFrame << "," << std::endl;
+        out << "      \"ok\": " << (r.ok ? "true" : "false") << "," << std::endl;
+        if (!r.ok) {
+            out << "      \"error\": \"" << r.error << "\"" << std::endl;
+            out << "    }" << (i + 1 < results.size() ? "," : "") << std::endl;
+            continue;
+        }
+        out << "      \"duration\": " << r.duration << "," << std::endl;
+        out << "      \"fps\": {\"producer\": " << r.producedFrames / duration
+            << ", \"wire\": " << r.sentFrames / duration
+            << ", \"consumer\": " << r.consumedFrames / duration << "}," << std::endl;
+        out << "      \"frames\": {\"produced\": " << r.producedFrames
+            << ", \"sent\": " << r.sentFrames << ", \"consumed\": " << r.consumedFrames
+            << ", \"lost\": " << r.lostFrames << ", \"duplicated\": " << r.duplicatedFrames
+            << ", \"outOfOrder\": " << r.outOfOrderFrames << "}," << std::endl;
+        writeStatistics(out, "latencyMs", r.transportLatency);
+        out << "," << std::endl;
+        writeStatistics(out, "consumerLatencyMs", r.consumerLatency);
+        out << "," << std::endl;
+        out << "      \"cpuPercent\": {";
+        bool first = true;
+        for (const auto& stage : r.cpu) {
+            out << (first ? "" : ", ") << "\"" << stage.first << "\": " << stage.second;
+            first = false;
+        }
+        out << "}," << std::endl;
+        out << "      \"wire\": {\"bytes\": " << r.bytes << ", \"bytesPerSecond\": "
+            << r.bytes / duration << ", \"bytesPerFrame\": "
+            << (r.sentFrames > 0 ? static_cast<double>(r.bytes) / r.sentFrames : 0.0) << "}"
+            << std::endl;
+        out << "    }" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "  ]" << std::endl;
+    out << "}" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--help") {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        if (option == "--no-local-mode") {
+            options.localMode = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value of option " << option << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const std::string value = argv[++i];
+        bool valid = true;
+        if (option == "--sensors") {
+            valid = parseList(value, options.sensors);
+        }
+        else if (option == "--rates") {
+            valid = parseList(value, options.rates);
+        }
+        else if (option == "--types") {
+            valid = parseList(value, options.types);
+            for (const auto& type : options.types) {
+                valid = valid && sensor::sensorTypeFromString(type) != sensor::SensorType::Invalid;
+            }
+        }
+        else if (option == "--duration") {
+            options.duration = std::atof(value.c_str());
+        }
+        else if (option == "--warmup") {
+            options.warmup = std::atof(value.c_str());
+        }
+        else if (option == "--poll-period") {
+            options.pollPeriod = std::atof(value.c_str());
+        }
+        else if (option == "--skin-taxels") {
+            options.skinTaxels = std::atoi(value.c_str());
+        }
+        else if (option == "--carrier") {
+            options.carrier = value;
+        }
+        else if (option == "--output") {
+            options.output = value;
+        }
+        else {
+            std::cerr << "Unknown option " << option << std::endl;
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value " << value << " of option " << option << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The local mode registers the ports in an in-process name server
+    yarp::os::Network::setLocalMode(options.localMode);
+    yarp::os::Network network;
+
+    std::vector<RunResult> results;
+    int index = 0;
+    for (const int nSensors : options.sensors) {
+        for (const double rate : options.rates) {
+            std::cerr << "Running " << nSensors << " sensors per type at " << rate << " Hz"
+                      << std::endl;
+            results.push_back(run(options, index++, nSensors, rate));
+            if (!results.back().ok) {
+                std::cerr << results.back().error << std::endl;
+            }
+        }
+    }
+
+    if (options.output.empty()) {
+        writeReport(std::cout, options, results);
+    }
+    else {
+        std::ofstream file(options.output);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open " << options.output << std::endl;
+            return EXIT_FAILURE;
+        }
+        writeReport(file, options, results);
+    }
+
+    for (const auto& result : results) {
+        if (!result.ok) {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
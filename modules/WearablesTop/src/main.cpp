@@ -0,0 +1,315 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "thrift/WearableMetricsService.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/Time.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace wearable;
+
+const std::string MetricsPortSuffix = "/metrics:rpc";
+// Period of the discovery of new components and of the reconnection of the unreachable ones
+constexpr double ReconnectPeriod = 5.0;
+
+struct Options
+{
+    std::vector<std::string> ports;
+    double period = 1.0;
+    bool once = false;
+    bool sensors = false;
+    bool reset = false;
+};
+
+// Connection to the metrics service of a component
+struct Component
+{
+    std::string portName;
+    yarp::os::Port port;
+    msg::WearableMetricsService service;
+    bool opened = false;
+
+    bool valid = false;
+    msg::ComponentMetrics last;
+    msg::ComponentMetrics current;
+};
+
+void printUsage(const std::string& executable)
+{
+    std::cout << "Usage: " << executable << " [options] [metrics ports...]" << std::endl
+              << std::endl
+              << "Show the runtime metrics of the wearables components. Without ports, all the"
+              << std::endl
+              << "ports ending with " << MetricsPortSuffix
+              << " registered in the name server are monitored, and the new ones are" << std::endl
+              << "discovered every " << ReconnectPeriod << " s." << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --period <s>   refresh period (default 1)" << std::endl
+              << "  --once         print the metrics once and exit" << std::endl
+              << "  --sensors      show the rate and the age of the data of each sensor"
+              << std::endl
+              << "  --reset        reset the metrics of the components before starting"
+              << std::endl;
+}
+
+bool endsWith(const std::string& text, const std::string& suffix)
+{
+    return text.size() >= suffix.size()
+           && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Query the name server for the registered metrics ports
+std::vector<std::string> discoverPorts()
+{
+    yarp::os::Bottle cmd;
+    yarp::os::Bottle reply;
+    cmd.addString("list");
+    if (!yarp::os::Network::write(yarp::os::Network::getNameServerContact(), cmd, reply)) {
+        std::cerr << "Failed to query the name server" << std::endl;
+        return {};
+    }
+
+    // The reply format depends on the name server, the port names are picked from its tokens
+    std::vector<std::string> ports;
+    std::stringstream stream(reply.toString());
+    std::string token;
+    while (stream >> token) {
+        token.erase(std::remove_if(token.begin(),
+                                   token.end(),
+                                   [](const char c) { return c == '(' || c == ')' || c == '"'; }),
+                    token.end());
+        if (!token.empty() && token[0] == '/' && endsWith(token, MetricsPortSuffix)
+            && std::find(ports.begin(), ports.end(), token) == ports.end()) {
+            ports.push_back(token);
+        }
+    }
+    return ports;
+}
+
+// Connect to the metrics port of the component, opening the local port at the first attempt
+bool connect(Component& component)
+{
+    if (!component.opened) {
+        if (!component.port.open("...")) {
+            return false;
+        }
+        component.opened = true;
+        if (!component.service.yarp().attachAsClient(component.port)) {
+            return false;
+        }
+    }
+    if (!yarp::os::Network::connect(component.port.getName(), component.portName)) {
+        std::cerr << "Failed to connect to " << component.portName << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Add and connect the components of the ports not monitored yet
+void addComponents(std::vector<std::unique_ptr<Component>>& components,
+                   const std::vector<std::string>& ports,
+                   const bool reset)
+{
+    for (const auto& portName : ports) {
+        if (std::any_of(components.begin(),
+                        components.end(),
+                        [&portName](const std::unique_ptr<Component>& component) {
+                            return component->portName == portName;
+                        })) {
+            continue;
+        }
+        components.emplace_back(new Component());
+        components.back()->portName = portName;
+        if (connect(*components.back()) && reset) {
+            components.back()->service.resetMetrics();
+        }
+    }
+}
+
+// Upper bound of the histogram bucket containing the given quantile of the tick durations
+double tickQuantile(const msg::ComponentMetrics& metrics, const double quantile)
+{
+    int64_t total = 0;
+    for (const auto count : metrics.tickHistogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    int64_t cumulative = 0;
+    for (size_t i = 0; i < metrics.tickHistogram.size(); ++i) {
+        cumulative += metrics.tickHistogram[i];
+        if (cumulative >= quantile * total) {
+            return i < metrics.tickHistogramBounds.size() ? metrics.tickHistogramBounds[i]
+                                                          : metrics.tickMax;
+        }
+    }
+    return metrics.tickMax;
+}
+
+// Rate of a counter between the last two polls, or since the start at the first poll
+double rate(const Component& component, const int64_t msg::ComponentMetrics::*counter)
+{
+    const auto& current = component.current;
+    const auto& last = component.last;
+
+    if (last.time > 0 && current.time > last.time && current.uptime >= last.uptime) {
+        return (current.*counter - last.*counter) / (current.time - last.time);
+    }
+    return current.uptime > 0 ? current.*counter / current.uptime : 0;
+}
+
+void printTable(std::vector<std::unique_ptr<Component>>& components, const Options& options)
+{
+    std::cout << std::left << std::setw(40) << "COMPONENT" << std::right << std::setw(9)
+              << "UPTIME" << std::setw(9) << "TICK/s" << std::setw(9) << "IN/s" << std::setw(9)
+              << "OUT/s" << std::setw(8) << "DROPS" << std::setw(8) << "OVERRUN" << std::setw(9)
+              << "MEAN ms" << std::setw(9) << "P50 ms" << std::setw(9) << "P99 ms"
+              << std::setw(9) << "MAX ms" << std::setw(10) << "KB/s" << std::endl;
+
+    for (const auto& component : components) {
+        if (!component->valid) {
+            std::cout << std::left << std::setw(40) << component->portName << "  unreachable"
+                      << std::endl;
+            continue;
+        }
+
+        const auto& metrics = component->current;
+        std::cout << std::fixed << std::left << std::setw(40)
+                  << metrics.component.substr(0, 39) << std::right << std::setprecision(0)
+                  << std::setw(9) << metrics.uptime << std::setprecision(1) << std::setw(9)
+                  << rate(*component, &msg::ComponentMetrics::ticks) << std::setw(9)
+                  << rate(*component, &msg::ComponentMetrics::framesIn) << std::setw(9)
+                  << rate(*component, &msg::ComponentMetrics::framesOut) << std::setw(8)
+                  << metrics.drops << std::setw(8) << metrics.overruns << std::setprecision(3)
+                  << std::setw(9) << metrics.tickMean * 1e3 << std::setw(9)
+                  << tickQuantile(metrics, 0.5) * 1e3 << std::setw(9)
+                  << tickQuantile(metrics, 0.99) * 1e3 << std::setw(9) << metrics.tickMax * 1e3
+                  << std::setprecision(1) << std::setw(10)
+                  << rate(*component, &msg::ComponentMetrics::bytesSent) / 1e3 << std::endl;
+
+        if (options.sensors) {
+            for (const auto& sensor : metrics.sensors) {
+                std::cout << "    " << std::left << std::setw(56) << sensor.name.substr(0, 55)
+                          << std::right << std::setprecision(1) << std::setw(10)
+                          << sensor.updateRate << " Hz" << std::setprecision(3) << std::setw(10)
+                          << (sensor.dataAge >= 0 ? sensor.dataAge * 1e3 : 0) << " ms"
+                          << std::setw(12) << sensor.updates << std::endl;
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (option == "--help") {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        else if (option == "--once") {
+            options.once = true;
+        }
+        else if (option == "--sensors") {
+            options.sensors = true;
+        }
+        else if (option == "--reset") {
+            options.reset = true;
+        }
+        else if (option == "--period") {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value of option " << option << std::endl;
+                return EXIT_FAILURE;
+            }
+            options.period = std::atof(argv[++i]);
+            if (options.period <= 0) {
+                std::cerr << "Invalid value of option " << option << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (!option.empty() && option[0] == '/') {
+            options.ports.push_back(option);
+        }
+        else {
+            std::cerr << "Unknown option " << option << std::endl;
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    yarp::os::Network network;
+    if (!yarp::os::Network::checkNetwork(5.0)) {
+        std::cerr << "YARP server wasn't found active." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Without ports, the components started later are discovered while running
+    const bool discover = options.ports.empty();
+    if (discover) {
+        options.ports = discoverPorts();
+    }
+    if (options.ports.empty() && options.once) {
+        std::cerr << "No metrics port found" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::unique_ptr<Component>> components;
+    addComponents(components, options.ports, options.reset);
+    double lastReconnectTime = yarp::os::Time::now();
+
+    while (true) {
+        // The components restarted after becoming unreachable are connected again
+        if (yarp::os::Time::now() - lastReconnectTime >= ReconnectPeriod) {
+            lastReconnectTime = yarp::os::Time::now();
+            for (auto& component : components) {
+                if (!component->valid) {
+                    connect(*component);
+                }
+            }
+            if (discover) {
+                addComponents(components, discoverPorts(), false);
+            }
+        }
+
+        for (auto& component : components) {
+            component->last = component->current;
+            component->current = component->service.getMetrics();
+            component->valid = !component->current.component.empty();
+        }
+
+        if (!options.once) {
+            // Clear the terminal and move the cursor to the top
+            std::cout << "\033[2J\033[H";
+        }
+        printTable(components, options);
+        std::cout << std::flush;
+
+        if (options.once) {
+            break;
+        }
+        yarp::os::Time::delay(options.period);
+    }
+
+    for (auto& component : components) {
+        component->port.close();
+    }
+
+    return EXIT_SUCCESS;
+}
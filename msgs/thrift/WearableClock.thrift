@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+namespace yarp wearable.msg
+
+// ===============
+// Clock exchanges
+// ===============
+
+// Times of a clock synchronization exchange, in seconds. The client time is returned as it was
+// sent, and the other times are in the clock of the server.
+struct ClockEcho {
+  1: double clientTime;
+  2: double receiveTime;
+  3: double transmitTime;
+}
+
+/**
+ * Methods definition for the clock synchronization service exposed by the producers of the
+ * wearable data
+ */
+service WearableClockService {
+
+    /**
+     * Echo a clock synchronization request
+     * @param clientTime time of the request in the clock of the client
+     * @return the client time, and the times the request was received and answered
+     */
+    ClockEcho echo(1: double clientTime);
+}
@@ -169,6 +169,52 @@ struct VirtualSphericalJointKinSensor {
   2: VirtualSphericalJointKinSensorData data;
 }
 
+// ===============
+// Encoded sensors
+// ===============
+
+// Compact encodings of the values of the sensors, selected per sensor type by the producer
+enum ValueEncoding {
+  FLOAT32,
+  FIXED16,
+  SMALLEST_THREE,
+  UINT16,
+  FLOAT16,
+}
+
+// Sensors of a type whose values are encoded, instead of being in the map of the type. The
+// encoded values of each sensor follow the ones of the previous sensor of info in data.
+struct EncodedSensors {
+  1: string type;
+  2: ValueEncoding encoding = ValueEncoding.FLOAT32;
+  3: double range;
+  4: list<SensorInfo> info;
+  5: binary data;
+  // Skin sensors: with UINT16 and FLOAT16 the taxels are offset + scale * the encoded values, and
+  // with sparse only the runs of taxels that differ from zero, or from the previous frame in the
+  // partial frames, are sent
+  6: double scale = 1.0;
+  7: double offset = 0.0;
+  8: bool sparse = false;
+}
+
+// =============
+// Sample blocks
+// =============
+
+// Samples of a sensor acquired since the previous frame, for the sensors sampled faster than the
+// frames are sent. The values of the samples follow one another, each one with a value per
+// channel, and the time of the sample i is startTime + i * samplePeriod.
+struct SampleBlock {
+  1: SensorInfo info;
+  2: string type;
+  3: i64 firstSample;
+  4: double startTime;
+  5: double samplePeriod;
+  6: i32 channels = 1;
+  7: list<double> values;
+}
+
 // ========================
 // Complete WearData struct
 // ========================
@@ -192,3 +238,19 @@ struct WearableData {
 16: optional map<string,VirtualJointKinSensor> virtualJointKinSensors;
 17: optional map<string,VirtualSphericalJointKinSensor> virtualSphericalJointKinSensors;
 }
+
+// ====================
+// Extended wire format
+// ====================
+
+// Frame of the extended wire format of IWearWrapper, streamed on <dataPortName>/extended:o only
+// when the extensions are enabled. The WearableData messages of the data port keep their layout.
+struct ExtendedWearableData {
+  1: WearableData data;
+  // True when data contains only the sensors that changed since the previous frames of the
+  // producer, the others keeping their last values. Frames with all the sensors are keyframes.
+  2: bool partial = false;
+  // Sensors of the types encoded by the producer, that are not in the maps of data
+  3: list<EncodedSensors> encodedSensors;
+  4: list<SampleBlock> sampleBlocks;
+}
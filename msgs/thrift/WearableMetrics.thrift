@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+namespace yarp wearable.msg
+
+// =======
+// Metrics
+// =======
+
+struct SensorMetrics {
+  1: string name;
+  2: i64 updates;
+  3: double updateRate;
+  4: double dataAge;
+}
+
+struct ComponentMetrics {
+  1: string component;
+  2: double time;
+  3: double uptime;
+  4: double period;
+  5: i64 ticks;
+  6: i64 overruns;
+  7: double tickMean;
+  8: double tickMax;
+  // Upper bounds of the tick duration histogram buckets, the last bucket is unbounded
+  9: list<double> tickHistogramBounds;
+  10: list<i64> tickHistogram;
+  11: i64 framesIn;
+  12: i64 framesOut;
+  13: i64 drops;
+  14: i64 bytesSent;
+  15: list<SensorMetrics> sensors;
+}
+
+/**
+ * Methods definition for the metrics service exposed by the wearables components
+ */
+service WearableMetricsService {
+
+    /**
+     * Get the metrics accumulated since the component started or since the last reset
+     * @return the metrics of the component
+     */
+    ComponentMetrics getMetrics();
+
+    /**
+     * Reset the counters and the histogram
+     */
+    bool resetMetrics();
+}
@@ -31,6 +31,7 @@ public:
     ~IWearWrapper() override;
 
     // PeriodicThread
+    bool threadInit() override;
     void run() override;
     void threadRelease() override;
 
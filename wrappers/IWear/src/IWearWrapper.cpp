@@ -2,17 +2,36 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include "IWearWrapper.h"
+#include "Wearable/ClockSync/ClockSync.h"
 #include "Wearable/IWear/IWear.h"
+#include "Wearable/Metrics/Metrics.h"
+#include "Wearable/RealTime/RealTime.h"
+#include "Wearable/Tracing/Tracing.h"
+#include "Wearable/WireEncoding/WearableDataEncoding.h"
+#include "thrift/ExtendedWearableData.h"
 #include "thrift/WearableData.h"
 
 #include <yarp/dev/IPreciselyTimed.h>
+#include <yarp/os/Bottle.h>
 #include <yarp/os/BufferedPort.h>
+#include <yarp/os/DummyConnector.h>
 #include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
 
 const std::string WrapperName = "IWearWrapper";
 const std::string logPrefix = WrapperName + " :";
 constexpr double DefaultPeriod = 0.01;
 
+// The size of the streamed frames is measured every FrameSizeCheckPeriod frames
+constexpr size_t FrameSizeCheckPeriod = 100;
+constexpr double DefaultKeyframePeriod = 1.0;
+
 using namespace wearable;
 using namespace wearable::wrappers;
 
@@ -23,12 +42,75 @@ public:
 
     std::string dataPortName;
 
+    // Port of the extended wire format, opened only when its extensions are enabled. The frames
+    // are then built in the extended messages, and the full frames are copied to the data port
+    // only when it has readers.
+    yarp::os::BufferedPort<msg::ExtendedWearableData> extendedDataPort;
+    bool extendedFormat = false;
+    size_t plainFrameSize = 0;
+    size_t plainFramesSinceSizeCheck = 0;
+
     bool firstRun = true;
     size_t waitingFirstReadCounter = 1;
 
     wearable::IWear* iWear = nullptr;
     yarp::dev::IPreciselyTimed* iPreciselyTimed = nullptr;
 
+    // Runtime metrics, created and exposed on the metrics port only when enabled by the metrics
+    // option. The sensors are counted as updated when the timestamp of the data changes.
+    std::string metricsPortName;
+    std::unique_ptr<metrics::Metrics> metrics;
+    metrics::MetricsServer metricsServer;
+    std::vector<std::pair<SensorPtr<const sensor::ISensor>, metrics::SensorCounter*>>
+        sensorCounters;
+    double lastCountedTime = 0;
+    size_t frameSize = 0;
+    size_t framesSinceSizeCheck = 0;
+
+    // Clock synchronization service, enabled by the clockSync option, used by the readers to map
+    // the timestamps of the data to their clock
+    std::string clockPortName;
+    clocksync::ClockSyncServer clockServer;
+
+    // Real-time settings and timing of the loop
+    realtime::ThreadSettings threadSettings;
+    realtime::JitterStatistics jitter;
+
+    // Send-on-change mode. The frames contain only the sensors whose status changed, or whose
+    // values moved by more than the deadband of their type, since they were last sent. A full
+    // frame (keyframe) is sent every keyframePeriod and when a reader connects.
+    bool sendOnChange = false;
+    double keyframePeriod = DefaultKeyframePeriod;
+    std::map<sensor::SensorType, double> deadbands;
+    double lastKeyframeTime = 0;
+    size_t lastOutputCount = 0;
+    struct SentSensor
+    {
+        msg::SensorStatus status;
+        std::vector<double> values;
+    };
+    std::unordered_map<std::string, SentSensor> sentSensors;
+    std::vector<double> values;
+
+    template <typename SensorData>
+    void dropUnchanged(std::map<std::string, SensorData>& sensors,
+                       const sensor::SensorType type,
+                       const bool keyframe);
+    void dropUnchanged(msg::WearableData& data, const bool keyframe);
+
+    // Compact encodings of the values of the sensors of the configured types
+    encoding::WearableDataEncoder encoder;
+
+    // Sensors delivering sample blocks, with the next sample to send, enabled by sampleBlocks
+    bool sendSampleBlocks = false;
+    struct BlockReader
+    {
+        SensorPtr<const sensor::ISensor> sensor;
+        size_t nextSample;
+    };
+    std::vector<BlockReader> blockReaders;
+    sensor::SampleBlock sampleBlock;
+
     wearable::VectorOfSensorPtr<const wearable::sensor::IAccelerometer> accelerometers;
     wearable::VectorOfSensorPtr<const wearable::sensor::IEmgSensor> emgSensors;
     wearable::VectorOfSensorPtr<const wearable::sensor::IForce3DSensor> force3DSensors;
@@ -98,12 +180,93 @@ msg::QuaternionWXYZ convertQuaternion(const wearable::Quaternion& input)
     return {input[0], input[1], input[2], input[3]};
 }
 
+// Remove from the frame the sensors that did not change since they were last sent, and store the
+// values of the others. In a keyframe all the sensors are kept.
+template <typename SensorData>
+void IWearWrapper::impl::dropUnchanged(std::map<std::string, SensorData>& sensors,
+                                       const sensor::SensorType type,
+                                       const bool keyframe)
+{
+    const auto deadband = deadbands.find(type);
+    const double threshold = deadband == deadbands.end() ? 0.0 : deadband->second;
+
+    for (auto it = sensors.begin(); it != sensors.end();) {
+        values.clear();
+        encoding::appendValues(it->second.data, values);
+
+        auto sent = sentSensors.find(it->first);
+        bool changed = keyframe || sent == sentSensors.end()
+                       || sent->second.status != it->second.info.status
+                       || sent->second.values.size() != values.size();
+        for (size_t i = 0; !changed && i < values.size(); ++i) {
+            // NaN values are always sent
+            changed = !(std::abs(values[i] - sent->second.values[i]) <= threshold);
+        }
+
+        if (!changed) {
+            it = sensors.erase(it);
+            continue;
+        }
+
+        if (sent == sentSensors.end()) {
+            sent = sentSensors.emplace(it->first, SentSensor()).first;
+        }
+        sent->second.status = it->second.info.status;
+        sent->second.values.assign(values.begin(), values.end());
+        ++it;
+    }
+}
+
+void IWearWrapper::impl::dropUnchanged(msg::WearableData& data, const bool keyframe)
+{
+    using sensor::SensorType;
+    dropUnchanged(data.accelerometers, SensorType::Accelerometer, keyframe);
+    dropUnchanged(data.emgSensors, SensorType::EmgSensor, keyframe);
+    dropUnchanged(data.force3DSensors, SensorType::Force3DSensor, keyframe);
+    dropUnchanged(data.forceTorque6DSensors, SensorType::ForceTorque6DSensor, keyframe);
+    dropUnchanged(
+        data.freeBodyAccelerationSensors, SensorType::FreeBodyAccelerationSensor, keyframe);
+    dropUnchanged(data.gyroscopes, SensorType::Gyroscope, keyframe);
+    dropUnchanged(data.magnetometers, SensorType::Magnetometer, keyframe);
+    dropUnchanged(data.orientationSensors, SensorType::OrientationSensor, keyframe);
+    dropUnchanged(data.poseSensors, SensorType::PoseSensor, keyframe);
+    dropUnchanged(data.positionSensors, SensorType::PositionSensor, keyframe);
+    dropUnchanged(data.skinSensors, SensorType::SkinSensor, keyframe);
+    dropUnchanged(data.temperatureSensors, SensorType::TemperatureSensor, keyframe);
+    dropUnchanged(data.torque3DSensors, SensorType::Torque3DSensor, keyframe);
+    dropUnchanged(data.virtualLinkKinSensors, SensorType::VirtualLinkKinSensor, keyframe);
+    dropUnchanged(data.virtualJointKinSensors, SensorType::VirtualJointKinSensor, keyframe);
+    dropUnchanged(data.virtualSphericalJointKinSensors,
+                  SensorType::VirtualSphericalJointKinSensor,
+                  keyframe);
+}
+
 // ========================
 // PeriodicThread interface
 // ========================
 
+bool IWearWrapper::threadInit()
+{
+    std::string error;
+    if (!realtime::applyThreadSettings(pImpl->threadSettings, error)) {
+        yWarning() << logPrefix << "Failed to apply the thread settings:" << error;
+    }
+    yInfo() << logPrefix << "Loop thread settings:" << realtime::toString(pImpl->threadSettings);
+
+    pImpl->jitter.setPeriod(getPeriod());
+    return true;
+}
+
 void IWearWrapper::run()
 {
+    WEARABLES_TRACE_SCOPE("IWearWrapper::run");
+    const realtime::ScopedTick jitterTick(pImpl->jitter);
+    const double tickStartTime = yarp::os::Time::now();
+
+    if (pImpl->jitter.reportDue()) {
+        yInfo() << logPrefix << "Loop timing:" << pImpl->jitter.summary();
+    }
+
     if (!pImpl->iWear) {
         yError() << logPrefix << "The IWear pointer is null in the driver loop.";
         askToStop();
@@ -158,13 +321,35 @@ void IWearWrapper::run()
         pImpl->virtualLinkKinSensors = pImpl->iWear->getVirtualLinkKinSensors();
         pImpl->virtualJointKinSensors = pImpl->iWear->getVirtualJointKinSensors();
         pImpl->virtualSphericalJointKinSensors = pImpl->iWear->getVirtualSphericalJointKinSensors();
+
+        for (const auto& sensor : pImpl->iWear->getAllSensors()) {
+            if (pImpl->metrics) {
+                pImpl->sensorCounters.emplace_back(
+                    sensor, pImpl->metrics->addSensor(sensor->getSensorName()));
+            }
+
+            // The first read moves the next sample after the ones already stored by the sensor
+            size_t nextSample = 0;
+            if (pImpl->sendSampleBlocks
+                && sensor->getSampleBlock(nextSample, pImpl->sampleBlock)) {
+                pImpl->blockReaders.push_back({sensor, nextSample});
+                yInfo() << logPrefix << "Sending the sample blocks of" << sensor->getSensorName();
+            }
+        }
     }
 
-    msg::WearableData& data = pImpl->dataPort.prepare();
+    msg::ExtendedWearableData* extendedData =
+        pImpl->extendedFormat ? &pImpl->extendedDataPort.prepare() : nullptr;
+    msg::WearableData& data = extendedData ? extendedData->data : pImpl->dataPort.prepare();
     data.producerName = pImpl->iWear->getWearableName();
 
     yarp::os::Stamp timestamp = pImpl->iPreciselyTimed->getLastInputStamp();
-    pImpl->dataPort.setEnvelope(timestamp);
+    if (extendedData) {
+        pImpl->extendedDataPort.setEnvelope(timestamp);
+    }
+    else {
+        pImpl->dataPort.setEnvelope(timestamp);
+    }
 
     {
         for (const auto& sensor : pImpl->accelerometers) {
@@ -432,8 +617,113 @@ void IWearWrapper::run()
         }
     }
 
+    // The readers of the data port receive the full frames, without the extensions
+    if (extendedData && pImpl->dataPort.getOutputCount() > 0) {
+        WEARABLES_TRACE_SCOPE("IWearWrapper::writePlain");
+        msg::WearableData& plainData = pImpl->dataPort.prepare();
+        plainData = data;
+        if (pImpl->metrics) {
+            if (pImpl->plainFramesSinceSizeCheck++ % FrameSizeCheckPeriod == 0) {
+                yarp::os::DummyConnector connector;
+                plainData.write(connector.getWriter());
+                pImpl->plainFrameSize = connector.getReader().getSize();
+            }
+            pImpl->metrics->addBytesSent(pImpl->plainFrameSize * pImpl->dataPort.getOutputCount());
+        }
+        pImpl->dataPort.setEnvelope(timestamp);
+        pImpl->dataPort.write();
+    }
+
+    // The samples acquired since the previous frame, sent also in the partial frames
+    if (extendedData) {
+        extendedData->sampleBlocks.clear();
+    }
+    for (auto& reader : pImpl->blockReaders) {
+        sensor::SampleBlock& sampleBlock = pImpl->sampleBlock;
+        if (!reader.sensor->getSampleBlock(reader.nextSample, sampleBlock)
+            || sampleBlock.values.empty()) {
+            continue;
+        }
+        msg::SampleBlock block;
+        block.info = generateSensorStatus(reader.sensor.get());
+        block.type = sensor::sensorTypeToString(reader.sensor->getSensorType());
+        block.firstSample = static_cast<std::int64_t>(sampleBlock.firstSample);
+        block.startTime = sampleBlock.startTime;
+        block.samplePeriod = sampleBlock.samplePeriod;
+        block.channels = static_cast<std::int32_t>(sampleBlock.channels);
+        block.values.swap(sampleBlock.values);
+        extendedData->sampleBlocks.push_back(std::move(block));
+    }
+
+    // In send-on-change mode, a keyframe is sent periodically and when a reader connects, so that
+    // it receives all the sensors. The partial frames are sent also when empty, with the
+    // timestamp of the data.
+    bool keyframe = true;
+    if (pImpl->sendOnChange) {
+        WEARABLES_TRACE_SCOPE("IWearWrapper::dropUnchanged");
+        const size_t outputCount = pImpl->extendedDataPort.getOutputCount();
+        keyframe = outputCount > pImpl->lastOutputCount
+                   || tickStartTime - pImpl->lastKeyframeTime >= pImpl->keyframePeriod;
+        pImpl->lastOutputCount = outputCount;
+        if (keyframe) {
+            pImpl->lastKeyframeTime = tickStartTime;
+        }
+        pImpl->dropUnchanged(data, keyframe);
+    }
+    if (extendedData) {
+        extendedData->partial = !keyframe;
+    }
+
+    if (extendedData) {
+        WEARABLES_TRACE_SCOPE("IWearWrapper::encode");
+        pImpl->encoder.encode(*extendedData);
+    }
+
+    const size_t outputCount = extendedData ? pImpl->extendedDataPort.getOutputCount()
+                                            : pImpl->dataPort.getOutputCount();
+
+    // The data is serialized again only to measure the size of the frames, when the metrics are
+    // enabled and the port has readers. The size of the partial frames changes, and they are
+    // measured every time.
+    if (pImpl->metrics && outputCount > 0
+        && (!keyframe || pImpl->framesSinceSizeCheck++ % FrameSizeCheckPeriod == 0)) {
+        WEARABLES_TRACE_SCOPE("IWearWrapper::measureFrame");
+        yarp::os::DummyConnector connector;
+        if (extendedData) {
+            extendedData->write(connector.getWriter());
+        }
+        else {
+            data.write(connector.getWriter());
+        }
+        pImpl->frameSize = connector.getReader().getSize();
+    }
+
     // Stream the data though the port
-    pImpl->dataPort.write();
+    {
+        WEARABLES_TRACE_SCOPE("IWearWrapper::write");
+        if (extendedData) {
+            pImpl->extendedDataPort.write();
+        }
+        else {
+            pImpl->dataPort.write();
+        }
+    }
+
+    if (!pImpl->metrics) {
+        return;
+    }
+
+    pImpl->metrics->addBytesSent(pImpl->frameSize * outputCount);
+    if (timestamp.getTime() != pImpl->lastCountedTime) {
+        pImpl->lastCountedTime = timestamp.getTime();
+        for (const auto& counter : pImpl->sensorCounters) {
+            if (counter.first->getSensorStatus() == sensor::SensorStatus::Ok) {
+                counter.second->update(timestamp.getTime());
+            }
+        }
+    }
+    pImpl->metrics->addFramesOut();
+    pImpl->metrics->addTick(yarp::os::Time::now() - tickStartTime);
 }
 
 // ======================
@@ -456,11 +746,148 @@ bool IWearWrapper::open(yarp::os::Searchable& config)
     const double period = config.check("period", yarp::os::Value(DefaultPeriod)).asFloat64();
     setPeriod(period);
 
+    std::string error;
+    if (!realtime::parseThreadSettings(config, pImpl->threadSettings, error)) {
+        yError() << logPrefix << error;
+        return false;
+    }
+    pImpl->jitter.setReportPeriod(pImpl->threadSettings.jitterReportPeriod);
+
+    pImpl->sendOnChange = config.check("sendOnChange", yarp::os::Value(false)).asBool();
+    pImpl->keyframePeriod =
+        config.check("keyframePeriod", yarp::os::Value(DefaultKeyframePeriod)).asFloat64();
+    if (pImpl->keyframePeriod <= 0) {
+        yError() << logPrefix << "Parameter 'keyframePeriod' must be positive";
+        return false;
+    }
+
+    // The deadbands are configured as a list of (SensorType deadband), the default one being 0
+    if (config.check("deadbands")) {
+        const yarp::os::Bottle* deadbandsList = config.find("deadbands").asList();
+        for (size_t i = 0; deadbandsList && i < deadbandsList->size(); ++i) {
+            const yarp::os::Bottle* entry = deadbandsList->get(i).asList();
+            if (!entry || entry->size() != 2
+                || sensor::sensorTypeFromString(entry->get(0).asString())
+                       == sensor::SensorType::Invalid
+                || !(entry->get(1).isFloat64() || entry->get(1).isInt32())
+                || entry->get(1).asFloat64() < 0) {
+                yError() << logPrefix
+                         << "The elements of 'deadbands' must be (SensorType deadband), with a "
+                            "non negative deadband";
+                return false;
+            }
+            pImpl->deadbands[sensor::sensorTypeFromString(entry->get(0).asString())] =
+                entry->get(1).asFloat64();
+        }
+    }
+
+    if (pImpl->sendOnChange) {
+        yInfo() << logPrefix << "Sending only the changed sensors on"
+                << pImpl->dataPortName + "/extended:o" << ", with a keyframe every"
+                << pImpl->keyframePeriod << "s";
+        for (const auto& deadband : pImpl->deadbands) {
+            yInfo() << logPrefix << "Deadband of" << sensor::sensorTypeToString(deadband.first)
+                    << ":" << deadband.second;
+        }
+    }
+
+    // The encodings are configured as a list of (SensorType encoding [parameters] [sparse]),
+    // the parameters being the range of fixed16, and the scale and the optional offset of uint16
+    // and float16. The values of the other types are sent as double.
+    if (config.check("encodings")) {
+        const yarp::os::Bottle* encodingsList = config.find("encodings").asList();
+        for (size_t i = 0; encodingsList && i < encodingsList->size(); ++i) {
+            const yarp::os::Bottle* entry = encodingsList->get(i).asList();
+            encoding::EncodingSettings settings;
+            std::vector<double> parameters;
+            bool valid = entry && entry->size() >= 2
+                         && encoding::parseValueEncoding(entry->get(1).asString(),
+                                                         settings.encoding);
+            for (size_t j = 2; valid && j < entry->size(); ++j) {
+                const yarp::os::Value& value = entry->get(j);
+                if (value.isString() && value.asString() == "sparse") {
+                    settings.sparse = true;
+                }
+                else if ((value.isFloat64() || value.isInt32()) && !settings.sparse) {
+                    parameters.push_back(value.asFloat64());
+                }
+                else {
+                    valid = false;
+                }
+            }
+            if (valid && settings.encoding == encoding::ValueEncoding::Fixed16) {
+                valid = parameters.size() == 1;
+                settings.range = valid ? parameters[0] : 0.0;
+            }
+            else if (valid
+                     && (settings.encoding == encoding::ValueEncoding::UInt16
+                         || settings.encoding == encoding::ValueEncoding::Float16)) {
+                valid = parameters.size() == 1 || parameters.size() == 2;
+                settings.scale = valid ? parameters[0] : 0.0;
+                settings.offset = parameters.size() == 2 ? parameters[1] : 0.0;
+            }
+            else {
+                valid = valid && parameters.empty();
+            }
+
+            if (!valid) {
+                yError() << logPrefix
+                         << "The elements of 'encodings' must be (SensorType encoding "
+                            "[parameters] [sparse]), with encoding float32, fixed16 (range), "
+                            "smallestThree, uint16 or float16 (scale [offset])";
+                return false;
+            }
+            const sensor::SensorType type =
+                sensor::sensorTypeFromString(entry->get(0).asString());
+            if (!pImpl->encoder.setEncoding(type, settings, error)) {
+                yError() << logPrefix << "Invalid encoding of" << entry->get(0).asString() << ":"
+                         << error;
+                return false;
+            }
+            yInfo() << logPrefix << "Encoding of" << entry->get(0).asString() << ":"
+                    << encoding::toString(settings.encoding)
+                    << (settings.sparse ? "(sparse)" : "");
+        }
+    }
+
+    // The extensions are streamed only on the port of the extended wire format
+    pImpl->sendSampleBlocks = config.check("sampleBlocks", yarp::os::Value(false)).asBool();
+    pImpl->extendedFormat =
+        pImpl->sendOnChange || !pImpl->encoder.empty() || pImpl->sendSampleBlocks;
+
+    // The metrics and the RPC ports of the metrics and of the clock synchronization are enabled
+    // by the metrics and clockSync options, or by setting the names of the ports. They are not
+    // needed for streaming the data, hence failures are not fatal.
+    if (config.check("metrics", yarp::os::Value(false)).asBool()
+        || config.check("metricsPortName")) {
+        pImpl->metrics.reset(new metrics::Metrics(WrapperName + " " + pImpl->dataPortName));
+        pImpl->metrics->setPeriod(period);
+        pImpl->metricsPortName =
+            config.check("metricsPortName", yarp::os::Value(pImpl->dataPortName + "/metrics:rpc"))
+                .asString();
+        if (!pImpl->metricsServer.open(pImpl->metricsPortName, pImpl->metrics.get())) {
+            yWarning() << logPrefix << "Failed to open the metrics port" << pImpl->metricsPortName;
+        }
+    }
+
+    if (config.check("clockSync", yarp::os::Value(false)).asBool()
+        || config.check("clockPortName")) {
+        pImpl->clockPortName =
+            config.check("clockPortName", yarp::os::Value(pImpl->dataPortName + "/clock:rpc"))
+                .asString();
+        if (!pImpl->clockServer.open(pImpl->clockPortName)) {
+            yWarning() << logPrefix << "Failed to open the clock port" << pImpl->clockPortName;
+        }
+    }
+
     return true;
 }
 
 bool IWearWrapper::close()
 {
+    pImpl->metricsServer.close();
+    pImpl->clockServer.close();
+    pImpl->extendedDataPort.close();
     pImpl->dataPort.close();
     return true;
 }
@@ -489,6 +916,12 @@ bool IWearWrapper::attach(yarp::dev::PolyDriver* poly)
 
     // Open the port for streaming data
     pImpl->dataPort.open(pImpl->dataPortName);
+    if (pImpl->extendedFormat
+        && !pImpl->extendedDataPort.open(pImpl->dataPortName + "/extended:o")) {
+        yError() << logPrefix << "Failed to open the port of the extended wire format"
+                 << pImpl->dataPortName + "/extended:o";
+        return false;
+    }
 
     // Start the PeriodicThread loop
     if (!start()) {
@@ -502,7 +935,7 @@ bool IWearWrapper::attach(yarp::dev::PolyDriver* poly)
 
 void IWearWrapper::threadRelease()
 {
-
+    yInfo() << logPrefix << "Loop timing:" << pImpl->jitter.summary();
 }
 
 bool IWearWrapper::detach()
@@ -33,6 +33,7 @@ public:
     ~IWearLogger() override;
 
     // PeriodicThread
+    bool threadInit() override;
     void run() override;
     void threadRelease() override;
 
@@ -0,0 +1,256 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef IWEARLOGGER_SAMPLEQUEUE_H
+#define IWEARLOGGER_SAMPLEQUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace wearable {
+    namespace wrappers {
+        namespace logger {
+            struct Sample;
+            class SampleQueue;
+            class SampleRing;
+        } // namespace logger
+    } // namespace wrappers
+} // namespace wearable
+
+// Snapshot of all the logged sensors taken in a single logger tick.
+// The values of each sensor are stored contiguously (prefixed with the sensor status)
+// at the offset assigned to the sensor when the logger is configured.
+struct wearable::wrappers::logger::Sample
+{
+    double time = 0;
+    int sequenceNumber = 0;
+    std::vector<double> values;
+    std::vector<uint8_t> valid;
+};
+
+// Bounded single-producer queue of preallocated samples.
+// Every consumer reads all the samples in order and owns its own read cursor,
+// a slot is reused by the producer only once all the consumers released it.
+// No memory is allocated after construction. The consumers can block waiting for the samples,
+// the producer takes the mutex of the waiting consumers only when some of them are waiting.
+class wearable::wrappers::logger::SampleQueue
+{
+private:
+    struct Cursor
+    {
+        std::atomic<size_t> value;
+        char padding[64 - sizeof(std::atomic<size_t>)];
+    };
+
+    std::vector<Sample> m_slots;
+    Cursor m_head;
+    std::unique_ptr<Cursor[]> m_tails;
+    size_t m_nConsumers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::atomic<size_t> m_waiters{0};
+    bool m_interrupted = false;
+
+    inline size_t minTail() const;
+
+public:
+    SampleQueue(const size_t capacity,
+                const size_t nValues,
+                const size_t nSensors,
+                const size_t nConsumers = 1);
+
+    SampleQueue(const SampleQueue& other) = delete;
+    SampleQueue& operator=(const SampleQueue& other) = delete;
+
+    // Producer side
+    inline Sample* tryAcquire();
+    inline void publish();
+
+    // Consumer side
+    inline const Sample* front(const size_t consumer) const;
+    inline void pop(const size_t consumer);
+    // Wait until a sample is available to the consumer, the timeout expires or the queue is
+    // interrupted, returning the sample or nullptr
+    inline const Sample* wait(const size_t consumer, const double timeout);
+
+    // Wake up the waiting consumers, which do not wait anymore until resume() is called
+    inline void interrupt();
+    inline void resume();
+
+    inline size_t size() const;
+    inline size_t capacity() const;
+};
+
+inline wearable::wrappers::logger::SampleQueue::SampleQueue(const size_t capacity,
+                                                            const size_t nValues,
+                                                            const size_t nSensors,
+                                                            const size_t nConsumers)
+    : m_slots(std::max<size_t>(capacity, 1))
+    , m_tails(new Cursor[std::max<size_t>(nConsumers, 1)])
+    , m_nConsumers(std::max<size_t>(nConsumers, 1))
+{
+    for (auto& slot : m_slots) {
+        slot.values.resize(nValues, 0.0);
+        slot.valid.resize(nSensors, 0);
+    }
+
+    m_head.value.store(0);
+    for (size_t i = 0; i < m_nConsumers; ++i) {
+        m_tails[i].value.store(0);
+    }
+}
+
+inline size_t wearable::wrappers::logger::SampleQueue::minTail() const
+{
+    size_t tail = m_tails[0].value.load(std::memory_order_acquire);
+    for (size_t i = 1; i < m_nConsumers; ++i) {
+        tail = std::min(tail, m_tails[i].value.load(std::memory_order_acquire));
+    }
+    return tail;
+}
+
+inline wearable::wrappers::logger::Sample* wearable::wrappers::logger::SampleQueue::tryAcquire()
+{
+    const size_t head = m_head.value.load(std::memory_order_relaxed);
+    if (head - minTail() >= m_slots.size()) {
+        return nullptr;
+    }
+    return &m_slots[head % m_slots.size()];
+}
+
+inline void wearable::wrappers::logger::SampleQueue::publish()
+{
+    // Either the producer sees the waiter, or the waiter sees the new sample
+    m_head.value.fetch_add(1, std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_seq_cst) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_condition.notify_all();
+    }
+}
+
+inline const wearable::wrappers::logger::Sample*
+wearable::wrappers::logger::SampleQueue::front(const size_t consumer) const
+{
+    const size_t tail = m_tails[consumer].value.load(std::memory_order_relaxed);
+    if (tail == m_head.value.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &m_slots[tail % m_slots.size()];
+}
+
+inline void wearable::wrappers::logger::SampleQueue::pop(const size_t consumer)
+{
+    m_tails[consumer].value.fetch_add(1, std::memory_order_release);
+}
+
+inline const wearable::wrappers::logger::Sample*
+wearable::wrappers::logger::SampleQueue::wait(const size_t consumer, const double timeout)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+    m_condition.wait_for(lock, std::chrono::duration<double>(timeout), [this, consumer] {
+        return m_interrupted || front(consumer);
+    });
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return front(consumer);
+}
+
+inline void wearable::wrappers::logger::SampleQueue::interrupt()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_interrupted = true;
+    }
+    m_condition.notify_all();
+}
+
+inline void wearable::wrappers::logger::SampleQueue::resume()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_interrupted = false;
+}
+
+inline size_t wearable::wrappers::logger::SampleQueue::size() const
+{
+    return m_head.value.load(std::memory_order_acquire) - minTail();
+}
+
+inline size_t wearable::wrappers::logger::SampleQueue::capacity() const
+{
+    return m_slots.size();
+}
+
+// Fixed-size ring of preallocated samples, always keeping the most recent ones.
+// It is not thread safe, it is meant to be used only by the producer.
+class wearable::wrappers::logger::SampleRing
+{
+private:
+    std::vector<Sample> m_slots;
+    size_t m_next = 0;
+    size_t m_size = 0;
+
+public:
+    SampleRing(const size_t capacity, const size_t nValues, const size_t nSensors);
+
+    // Return the slot of a new sample, overwriting the oldest one when the ring is full
+    inline Sample& push();
+    // The i-th sample, starting from the oldest one
+    inline const Sample& at(const size_t i) const;
+    inline void clear();
+
+    inline size_t size() const;
+    inline size_t capacity() const;
+};
+
+inline wearable::wrappers::logger::SampleRing::SampleRing(const size_t capacity,
+                                                          const size_t nValues,
+                                                          const size_t nSensors)
+    : m_slots(std::max<size_t>(capacity, 1))
+{
+    for (auto& slot : m_slots) {
+        slot.values.resize(nValues, 0.0);
+        slot.valid.resize(nSensors, 0);
+    }
+}
+
+inline wearable::wrappers::logger::Sample& wearable::wrappers::logger::SampleRing::push()
+{
+    Sample& slot = m_slots[m_next];
+    m_next = (m_next + 1) % m_slots.size();
+    m_size = std::min(m_size + 1, m_slots.size());
+    return slot;
+}
+
+inline const wearable::wrappers::logger::Sample&
+wearable::wrappers::logger::SampleRing::at(const size_t i) const
+{
+    const size_t oldest = (m_next + m_slots.size() - m_size) % m_slots.size();
+    return m_slots[(oldest + i) % m_slots.size()];
+}
+
+inline void wearable::wrappers::logger::SampleRing::clear()
+{
+    m_size = 0;
+}
+
+inline size_t wearable::wrappers::logger::SampleRing::size() const
+{
+    return m_size;
+}
+
+inline size_t wearable::wrappers::logger::SampleRing::capacity() const
+{
+    return m_slots.size();
+}
+
+#endif // IWEARLOGGER_SAMPLEQUEUE_H
@@ -2,16 +2,33 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include "IWearLogger.h"
+#include "SampleQueue.h"
 #include "Wearable/IWear/IWear.h"
+#include "Wearable/Logger/BinaryLog.h"
+#include "Wearable/Logger/RawCapture.h"
+#include "Wearable/Metrics/Metrics.h"
+#include "Wearable/RealTime/RealTime.h"
+#include "Wearable/Tracing/Tracing.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <ctime>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <yarp/dev/IPreciselyTimed.h>
+#include <yarp/os/Bottle.h>
 #include <yarp/os/BufferedPort.h>
 #include <yarp/os/LogStream.h>
 #include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/PortReader.h>
+#include <yarp/os/Time.h>
 #include <yarp/sig/Vector.h>
 
 #include <robometry/BufferManager.h>
@@ -19,6 +36,15 @@
 const std::string WrapperName = "IWearLogger";
 const std::string logPrefix = WrapperName + " :";
 constexpr double DefaultPeriod = 0.01;
+constexpr size_t DefaultWriterThreads = 1;
+constexpr size_t DefaultQueueSize = 1000;
+constexpr size_t DefaultBinaryChunkSize = 1000;
+const std::string DefaultYarpMultiplexedPortPrefix = "/IWearLogger";
+const std::string DefaultRawCapturePortPrefix = "/IWearLogger/rawCapture";
+const std::string DefaultTriggerPortPrefix = "/IWearLogger";
+constexpr double DefaultPreTriggerTime = 5.0;
+constexpr double DefaultPostTriggerTime = 5.0;
+constexpr size_t InvalidIndex = std::numeric_limits<size_t>::max();
 
 namespace wearable {
     namespace wrappers {
@@ -54,6 +80,21 @@ struct wearable::wrappers::IWearLoggerSettings
     bool logVirtualJointKinSensors{false};
     bool logVirtualSphericalJointKinSensors{false};
     bool logSkinSensors{false};
+    size_t writerThreads{DefaultWriterThreads};
+    size_t queueSize{DefaultQueueSize};
+    size_t binaryChunkSize{DefaultBinaryChunkSize};
+    wearable::logger::binary::Compression binaryCompression{
+        wearable::logger::binary::Compression::XorRle};
+    double binaryMaxFileSize{0}; // MB, 0 disables the file rotation
+    bool yarpMultiplexed{false};
+    std::string yarpMultiplexedPortPrefix{DefaultYarpMultiplexedPortPrefix};
+    std::vector<std::string> rawCaptureDataPorts;
+    std::string rawCapturePortPrefix{DefaultRawCapturePortPrefix};
+    std::string rawCaptureCarrier;
+    bool triggeredCapture{false};
+    double preTriggerTime{DefaultPreTriggerTime};
+    double postTriggerTime{DefaultPostTriggerTime};
+    std::string triggerPortPrefix{DefaultTriggerPortPrefix};
 };
 
 using namespace wearable;
@@ -63,10 +104,173 @@ using WerableSensorName = std::string;
 using MatlabChannelName = std::string;
 using YarpBufferedPort = yarp::os::BufferedPort<yarp::sig::Vector>;
 
+// Position of the data of a logged sensor inside the samples and its outputs
+struct LoggedSensor
+{
+    WerableSensorName name;
+    sensor::SensorType type = sensor::SensorType::Invalid;
+    MatlabChannelName matlabChannelName;
+    YarpBufferedPort* yarpPort = nullptr;
+    size_t offset = 0;
+    size_t size = 0; // Including the sensor status
+    size_t writer = 0;
+};
+
+// Reply to any command received on the layout port with the layout of the multiplexed data
+class MultiplexedLayoutResponder : public yarp::os::PortReader
+{
+public:
+    yarp::os::Bottle layout;
+
+    bool read(yarp::os::ConnectionReader& connection) override
+    {
+        yarp::os::Bottle command;
+        if (!command.read(connection)) {
+            return false;
+        }
+
+        yarp::os::ConnectionWriter* writer = connection.getWriter();
+        if (!writer) {
+            return true;
+        }
+        return layout.write(*writer);
+    }
+};
+
+// Append every message received on a WearableData port to the raw capture, without decoding it.
+// The reader of the port copies the bytes of the connection as they were sent. The messages of
+// the carriers in text mode are parsed and stored in their binary form, read by the replay.
+class RawCaptureReceiver : public yarp::os::PortReader
+{
+private:
+    const uint32_t m_stream;
+    wearable::logger::raw::CaptureWriter& m_writer;
+    std::vector<char> m_message;
+    size_t m_failures = 0;
+
+public:
+    yarp::os::Port port;
+
+    RawCaptureReceiver(const uint32_t stream, wearable::logger::raw::CaptureWriter& writer)
+        : m_stream(stream)
+        , m_writer(writer)
+    {}
+
+    bool read(yarp::os::ConnectionReader& connection) override
+    {
+        const double receptionTime = yarp::os::Time::now();
+
+        yarp::os::Stamp envelope;
+        port.getEnvelope(envelope);
+
+        const char* data = nullptr;
+        size_t size = 0;
+        yarp::os::Bottle bottle;
+        if (connection.isTextMode()) {
+            if (!bottle.read(connection)) {
+                return false;
+            }
+            data = bottle.toBinary(&size);
+        }
+        else {
+            m_message.resize(connection.getSize());
+            if (!connection.expectBlock(m_message.data(), m_message.size())) {
+                return false;
+            }
+            data = m_message.data();
+            size = m_message.size();
+        }
+
+        if (!m_writer.append(m_stream,
+                             envelope.getCount(),
+                             envelope.isValid() ? envelope.getTime() : receptionTime,
+                             receptionTime,
+                             data,
+                             size)
+            && m_failures++ % 1000 == 0) {
+            yWarning() << logPrefix << "Failed to append the message received on"
+                       << port.getName() << "to the raw capture:" << m_writer.getLastError();
+        }
+        return true;
+    }
+};
+
+// Threshold on a value of a logged sensor starting the triggered capture
+struct TriggerThreshold
+{
+    WerableSensorName sensorName;
+    size_t valueIndex = 0; // Index in the sensor channel, 0 is the sensor status
+    double threshold = 0;
+    size_t sensorIndex = 0;
+    bool falling = false; // Trigger when the value drops below the threshold instead of rising above
+    bool crossed = false;
+};
+
+// Any message received on the trigger ports starts the triggered capture
+class TriggerReceiver
+    : public yarp::os::PortReader
+    , public yarp::os::TypedReaderCallback<yarp::os::Bottle>
+{
+private:
+    std::atomic<bool>& m_triggerRequested;
+    std::atomic<bool>& m_capturing;
+
+public:
+    TriggerReceiver(std::atomic<bool>& triggerRequested, std::atomic<bool>& capturing)
+        : m_triggerRequested(triggerRequested)
+        , m_capturing(capturing)
+    {}
+
+    // RPC port: "trigger" starts the capture, "status" returns whether the logger is capturing
+    bool read(yarp::os::ConnectionReader& connection) override
+    {
+        yarp::os::Bottle command;
+        if (!command.read(connection)) {
+            return false;
+        }
+
+        yarp::os::Bottle reply;
+        const std::string commandName = command.get(0).asString();
+        if (commandName == "trigger") {
+            m_triggerRequested = true;
+            reply.addString("ok");
+        }
+        else if (commandName == "status") {
+            reply.addString(m_capturing ? "capturing" : "waiting");
+        }
+        else {
+            reply.addString("unknown command, use trigger or status");
+        }
+
+        yarp::os::ConnectionWriter* writer = connection.getWriter();
+        if (!writer) {
+            return true;
+        }
+        return reply.write(*writer);
+    }
+
+    // Input port
+    using yarp::os::TypedReaderCallback<yarp::os::Bottle>::onRead;
+    void onRead(yarp::os::Bottle& /*message*/) override
+    {
+        m_triggerRequested = true;
+    }
+};
+
+struct LoggerStatistics
+{
+    std::atomic<size_t> samples{0};
+    std::atomic<size_t> droppedSamples{0};
+    std::atomic<size_t> maxQueueDepth{0};
+    std::atomic<size_t> triggers{0};
+};
+
 class IWearLogger::impl
 {
 public:
     LoggerType loggerType;
+    bool binaryLogger = false;
+    bool rawCapture = false;
     void setLoggerType(std::string& str);
 
     bool loadSettingsFromConfig(yarp::os::Searchable& config);
@@ -76,15 +280,45 @@ public:
 
     bool configureMatlabBufferManager(const std::string& sensorName, const size_t& channelSize);
     bool configureYarpBufferManager(const std::string& sensorName);
-    bool configureBufferManager();
-
-    inline void prepareYarpBottle(const std::vector<double>& sensorData, yarp::sig::Vector& b)
+    bool configureBufferManager(const double period);
+
+    void addLoggedSensor(const sensor::SensorType type,
+                         const std::string& sensorName,
+                         const size_t channelSize);
+    template <typename SensorInterface>
+    void resolveLoggedSensors(const sensor::SensorType type,
+                              const wearable::VectorOfSensorPtr<const SensorInterface>& sensors);
+    bool isLoggingEnabled(const sensor::SensorType type) const;
+    double* prepareSensorValues(logger::Sample& sample,
+                                const size_t index,
+                                const std::shared_ptr<const wearable::sensor::ISensor>& sensor);
+
+    inline const std::vector<size_t>& getLoggedSensorsIndices(const sensor::SensorType type) const
     {
-        b.clear();
-
-        for (const auto& e : sensorData) {
-            b.push_back(e);
-        }
+        return loggedSensorsIndices[static_cast<size_t>(type)];
+    }
+
+    const std::string& getLogFileBaseName();
+    bool openBinaryLogFile();
+    bool openRawCapture();
+    void closeRawCapture();
+    bool openMultiplexedPorts();
+    bool configureTriggeredCapture();
+    bool updateTriggeredCapture(const double now);
+    bool checkTriggerThresholds(const logger::Sample& sample);
+    void updateTickStatistics(const double tickStartTime);
+
+    void startWriters(const double period);
+    void stopWriters();
+    void writerLoop(const size_t writer, const double period);
+    void writeSample(const logger::Sample& sample,
+                     const size_t writer,
+                     std::vector<double>& saveVar);
+
+    inline void prepareYarpBottle(const double* begin, const double* end, yarp::sig::Vector& b)
+    {
+        b.resize(end - begin);
+        std::copy(begin, end, b.data());
     }
 
     inline std::vector<std::string> split(const std::string& s, const std::string& delimiter)
@@ -139,15 +373,6 @@ public:
         return ('/' + getValidName(sensorName, '/'));
     }
 
-    inline void
-    prefixVecWithSensorStatus(const std::shared_ptr<const wearable::sensor::ISensor>& sensor,
-                              std::vector<double>& saveVar)
-    {
-        // prefix sensor status
-        auto it = saveVar.begin();
-        saveVar.insert(it, static_cast<double>(sensor->getSensorStatus()));
-    }
-
     bool firstRun = true;
     size_t waitingFirstReadCounter = 1;
 
@@ -157,6 +382,8 @@ public:
     IWearLoggerSettings settings;
     robometry::BufferConfig bufferConfig;
     robometry::BufferManager bufferManager;
+    // The writer threads push the channels they own to the same buffer manager
+    std::mutex bufferManagerMutex;
 
     wearable::VectorOfSensorPtr<const wearable::sensor::IAccelerometer> accelerometers;
     wearable::VectorOfSensorPtr<const wearable::sensor::IEmgSensor> emgSensors;
@@ -183,6 +410,49 @@ public:
     std::unordered_map<WerableSensorName, MatlabChannelName> wearable2MatlabNameLookup;
     std::unordered_map<WerableSensorName, std::unique_ptr<YarpBufferedPort>>
         wearable2YarpPortLookup;
+
+    // Layout of the samples, shared between the loop and the writer threads
+    std::vector<LoggedSensor> loggedSensors;
+    std::unordered_map<WerableSensorName, size_t> loggedSensorsLookup;
+    std::vector<std::vector<size_t>> loggedSensorsIndices{
+        static_cast<size_t>(sensor::SensorType::Invalid)};
+    size_t nLoggedValues = 0;
+    std::vector<double> pressureVector;
+
+    std::unique_ptr<logger::SampleQueue> sampleQueue;
+    std::vector<std::thread> writers;
+    std::atomic<bool> writersRunning{false};
+    LoggerStatistics statistics;
+
+    // Runtime metrics, enabled by the metricsPortName option
+    std::unique_ptr<metrics::Metrics> metrics;
+    metrics::MetricsServer metricsServer;
+
+    // Real-time settings and timing of the loop
+    realtime::ThreadSettings threadSettings;
+    realtime::JitterStatistics jitter;
+
+    wearable::logger::binary::Writer binaryWriter;
+    std::string logFileBaseName;
+    size_t binaryFileCounter = 0;
+
+    wearable::logger::raw::CaptureWriter rawCaptureWriter;
+    std::vector<std::unique_ptr<RawCaptureReceiver>> rawCaptureReceivers;
+
+    std::unique_ptr<YarpBufferedPort> multiplexedPort;
+    std::unique_ptr<yarp::os::Port> multiplexedLayoutPort;
+    MultiplexedLayoutResponder multiplexedLayoutResponder;
+
+    std::unique_ptr<logger::SampleRing> preTriggerRing;
+    // Read when the queue is full, only to check the trigger thresholds
+    logger::Sample droppedSample;
+    std::vector<TriggerThreshold> triggerThresholds;
+    std::atomic<bool> triggerRequested{false};
+    std::atomic<bool> capturing{false};
+    double captureEndTime = 0;
+    TriggerReceiver triggerReceiver{triggerRequested, capturing};
+    std::unique_ptr<yarp::os::Port> triggerRpcPort;
+    std::unique_ptr<yarp::os::BufferedPort<yarp::os::Bottle>> triggerInputPort;
 };
 
 IWearLogger::IWearLogger()
@@ -200,8 +470,27 @@ IWearLogger::~IWearLogger()
 // PeriodicThread interface
 // ========================
 
+bool IWearLogger::threadInit()
+{
+    std::string error;
+    if (!realtime::applyThreadSettings(pImpl->threadSettings, error)) {
+        yWarning() << logPrefix << "Failed to apply the thread settings:" << error;
+    }
+    yInfo() << logPrefix << "Loop thread settings:" << realtime::toString(pImpl->threadSettings);
+
+    pImpl->jitter.setPeriod(getPeriod());
+    return true;
+}
+
 void IWearLogger::run()
 {
+    WEARABLES_TRACE_SCOPE("IWearLogger::run");
+    const realtime::ScopedTick jitterTick(pImpl->jitter);
+
+    if (pImpl->jitter.reportDue()) {
+        yInfo() << logPrefix << "Loop timing:" << pImpl->jitter.summary();
+    }
+
     if (!pImpl->iWear) {
         yError() << logPrefix << "The IWear pointer is null in the driver loop.";
         askToStop();
@@ -255,44 +544,84 @@ void IWearLogger::run()
         pImpl->virtualJointKinSensors = pImpl->iWear->getVirtualJointKinSensors();
         pImpl->virtualSphericalJointKinSensors = pImpl->iWear->getVirtualSphericalJointKinSensors();
         pImpl->skinSensors = pImpl->iWear->getSkinSensors();
+
+        // Match the sensors with the channels prepared when configuring the buffer manager
+        pImpl->resolveLoggedSensors(sensor::SensorType::Accelerometer, pImpl->accelerometers);
+        pImpl->resolveLoggedSensors(sensor::SensorType::EmgSensor, pImpl->emgSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::Force3DSensor, pImpl->force3DSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::ForceTorque6DSensor,
+                                    pImpl->forceTorque6DSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::FreeBodyAccelerationSensor,
+                                    pImpl->freeBodyAccelerationSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::Gyroscope, pImpl->gyroscopes);
+        pImpl->resolveLoggedSensors(sensor::SensorType::Magnetometer, pImpl->magnetometers);
+        pImpl->resolveLoggedSensors(sensor::SensorType::OrientationSensor,
+                                    pImpl->orientationSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::PoseSensor, pImpl->poseSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::PositionSensor, pImpl->positionSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::TemperatureSensor,
+                                    pImpl->temperatureSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::Torque3DSensor, pImpl->torque3DSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::VirtualLinkKinSensor,
+                                    pImpl->virtualLinkKinSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::VirtualJointKinSensor,
+                                    pImpl->virtualJointKinSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::VirtualSphericalJointKinSensor,
+                                    pImpl->virtualSphericalJointKinSensors);
+        pImpl->resolveLoggedSensors(sensor::SensorType::SkinSensor, pImpl->skinSensors);
+    }
+
+    const double tickStartTime = yarp::os::Time::now();
+
+    // In triggered mode, the samples are kept in the pre-trigger ring until a trigger is received
+    const bool capturing =
+        !pImpl->settings.triggeredCapture || pImpl->updateTriggeredCapture(tickStartTime);
+
+    // The loop only takes a snapshot of the sensors, the writer threads take care
+    // of forwarding it to the configured outputs
+    logger::Sample* sample =
+        capturing ? pImpl->sampleQueue->tryAcquire() : &pImpl->preTriggerRing->push();
+    if (!sample) {
+        if (pImpl->metrics) {
+            pImpl->metrics->addDrops();
+        }
+        if (pImpl->statistics.droppedSamples++ % 1000 == 0) {
+            yWarning() << logPrefix << "The sample queue is full, dropping samples ("
+                       << pImpl->statistics.droppedSamples << " dropped so far).";
+        }
+        // In triggered mode the sensors are read anyway, a trigger extends the capture
+        if (!pImpl->settings.triggeredCapture) {
+            pImpl->updateTickStatistics(tickStartTime);
+            return;
+        }
+        sample = &pImpl->droppedSample;
     }
 
     yarp::os::Stamp timestamp = pImpl->iPreciselyTimed->getLastInputStamp();
+    sample->time = timestamp.getTime();
+    sample->sequenceNumber = timestamp.getCount();
+    std::fill(sample->valid.begin(), sample->valid.end(), 0);
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logAccelerometers) {
-        for (const auto& sensor : pImpl->accelerometers) {
+        const auto& indices = pImpl->getLoggedSensorsIndices(sensor::SensorType::Accelerometer);
+        for (size_t i = 0; i < pImpl->accelerometers.size(); ++i) {
+            const auto& sensor = pImpl->accelerometers[i];
             wearable::Vector3 vector3;
             if (!sensor->getLinearAcceleration(vector3)) {
                 yWarning() << logPrefix << "[Accelerometers] "
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-
-                std::vector<double> saveVar{vector3.begin(), vector3.end()};
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                std::copy(vector3.begin(), vector3.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logEMGSensors) {
-        for (const auto& sensor : pImpl->emgSensors) {
+        const auto& indices = pImpl->getLoggedSensorsIndices(sensor::SensorType::EmgSensor);
+        for (size_t i = 0; i < pImpl->emgSensors.size(); ++i) {
+            const auto& sensor = pImpl->emgSensors[i];
             double value, normalization;
             // double normalizationValue;
             if (!sensor->getEmgSignal(value) || !sensor->getNormalizationValue(normalization)) {
@@ -300,218 +629,116 @@ void IWearLogger::run()
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar;
-                saveVar.emplace_back(value);
-                saveVar.emplace_back(normalization);
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                buffer[0] = value;
+                buffer[1] = normalization;
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logForce3DSensors) {
-        for (const auto& sensor : pImpl->force3DSensors) {
+        const auto& indices = pImpl->getLoggedSensorsIndices(sensor::SensorType::Force3DSensor);
+        for (size_t i = 0; i < pImpl->force3DSensors.size(); ++i) {
+            const auto& sensor = pImpl->force3DSensors[i];
             wearable::Vector3 vector3;
             if (!sensor->getForce3D(vector3)) {
                 yWarning() << logPrefix << "[Force3DSensors] "
                            << "Failed to read data, "
                            << "sensor status is ";
             }
-            else {
-                std::vector<double> saveVar{vector3.begin(), vector3.end()};
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                std::copy(vector3.begin(), vector3.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logForceTorque6DSensors) {
-        for (const auto& sensor : pImpl->forceTorque6DSensors) {
+        const auto& indices =
+            pImpl->getLoggedSensorsIndices(sensor::SensorType::ForceTorque6DSensor);
+        for (size_t i = 0; i < pImpl->forceTorque6DSensors.size(); ++i) {
+            const auto& sensor = pImpl->forceTorque6DSensors[i];
             wearable::Vector6 vector6;
             if (!sensor->getForceTorque6D(vector6)) {
                 yWarning() << logPrefix << "[ForceTorque6DSensors] "
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar{vector6.begin(), vector6.end()};
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                std::copy(vector6.begin(), vector6.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logFreeBodyAccelerationSensors) {
-        for (const auto& sensor : pImpl->freeBodyAccelerationSensors) {
+        const auto& indices =
+            pImpl->getLoggedSensorsIndices(sensor::SensorType::FreeBodyAccelerationSensor);
+        for (size_t i = 0; i < pImpl->freeBodyAccelerationSensors.size(); ++i) {
+            const auto& sensor = pImpl->freeBodyAccelerationSensors[i];
             wearable::Vector3 vector3;
             if (!sensor->getFreeBodyAcceleration(vector3)) {
                 yWarning() << logPrefix << "[FreeBodyAccelerationSensors] "
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar{vector3.begin(), vector3.end()};
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                std::copy(vector3.begin(), vector3.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logGyroscopes) {
-        for (const auto& sensor : pImpl->gyroscopes) {
+        const auto& indices = pImpl->getLoggedSensorsIndices(sensor::SensorType::Gyroscope);
+        for (size_t i = 0; i < pImpl->gyroscopes.size(); ++i) {
+            const auto& sensor = pImpl->gyroscopes[i];
             wearable::Vector3 vector3;
             if (!sensor->getAngularRate(vector3)) {
                 yWarning() << logPrefix << "[Gyroscopes] "
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar{vector3.begin(), vector3.end()};
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                std::copy(vector3.begin(), vector3.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logMagnetometers) {
-        for (const auto& sensor : pImpl->magnetometers) {
+        const auto& indices = pImpl->getLoggedSensorsIndices(sensor::SensorType::Magnetometer);
+        for (size_t i = 0; i < pImpl->magnetometers.size(); ++i) {
+            const auto& sensor = pImpl->magnetometers[i];
             wearable::Vector3 vector3;
             if (!sensor->getMagneticField(vector3)) {
                 yWarning() << logPrefix << "[Magnetometers] "
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar{vector3.begin(), vector3.end()};
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                std::copy(vector3.begin(), vector3.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logOrientationSensors) {
-        for (const auto& sensor : pImpl->orientationSensors) {
+        const auto& indices =
+            pImpl->getLoggedSensorsIndices(sensor::SensorType::OrientationSensor);
+        for (size_t i = 0; i < pImpl->orientationSensors.size(); ++i) {
+            const auto& sensor = pImpl->orientationSensors[i];
             wearable::Quaternion quaternion;
             if (!sensor->getOrientationAsQuaternion(quaternion)) {
                 yWarning() << logPrefix << "[OrientationSensors] "
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar{quaternion.begin(), quaternion.end()};
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                std::copy(quaternion.begin(), quaternion.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logPoseSensors) {
-        for (const auto& sensor : pImpl->poseSensors) {
+        const auto& indices = pImpl->getLoggedSensorsIndices(sensor::SensorType::PoseSensor);
+        for (size_t i = 0; i < pImpl->poseSensors.size(); ++i) {
+            const auto& sensor = pImpl->poseSensors[i];
             wearable::Vector3 vector3;
             wearable::Quaternion quaternion;
             if (!sensor->getPose(quaternion, vector3)) {
@@ -519,127 +746,67 @@ void IWearLogger::run()
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar;
-                std::copy(vector3.begin(), vector3.end(), std::back_inserter(saveVar));
-                std::copy(quaternion.begin(), quaternion.end(), std::back_inserter(saveVar));
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                buffer = std::copy(vector3.begin(), vector3.end(), buffer);
+                std::copy(quaternion.begin(), quaternion.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logPositionSensors) {
-        for (const auto& sensor : pImpl->positionSensors) {
+        const auto& indices = pImpl->getLoggedSensorsIndices(sensor::SensorType::PositionSensor);
+        for (size_t i = 0; i < pImpl->positionSensors.size(); ++i) {
+            const auto& sensor = pImpl->positionSensors[i];
             wearable::Vector3 vector3;
             if (!sensor->getPosition(vector3)) {
                 yWarning() << logPrefix << "[PositionSensors] "
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar{vector3.begin(), vector3.end()};
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                std::copy(vector3.begin(), vector3.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logTemperatureSensors) {
-        for (const auto& sensor : pImpl->temperatureSensors) {
+        const auto& indices =
+            pImpl->getLoggedSensorsIndices(sensor::SensorType::TemperatureSensor);
+        for (size_t i = 0; i < pImpl->temperatureSensors.size(); ++i) {
+            const auto& sensor = pImpl->temperatureSensors[i];
             double value;
             if (!sensor->getTemperature(value)) {
                 yWarning() << logPrefix << "[TemperatureSensors] "
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar;
-                saveVar.emplace_back(value);
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                buffer[0] = value;
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logTorque3DSensors) {
-        for (const auto& sensor : pImpl->torque3DSensors) {
+        const auto& indices = pImpl->getLoggedSensorsIndices(sensor::SensorType::Torque3DSensor);
+        for (size_t i = 0; i < pImpl->torque3DSensors.size(); ++i) {
+            const auto& sensor = pImpl->torque3DSensors[i];
             wearable::Vector3 vector3;
             if (!sensor->getTorque3D(vector3)) {
                 yWarning() << logPrefix << "[Torque3DSensors] "
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar{vector3.begin(), vector3.end()};
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                std::copy(vector3.begin(), vector3.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logVirtualLinkKinSensors) {
-        for (const auto& sensor : pImpl->virtualLinkKinSensors) {
+        const auto& indices =
+            pImpl->getLoggedSensorsIndices(sensor::SensorType::VirtualLinkKinSensor);
+        for (size_t i = 0; i < pImpl->virtualLinkKinSensors.size(); ++i) {
+            const auto& sensor = pImpl->virtualLinkKinSensors[i];
             wearable::Vector3 linearAcc;
             wearable::Vector3 angularAcc;
             wearable::Vector3 linearVel;
@@ -653,37 +820,22 @@ void IWearLogger::run()
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar;
-                std::copy(position.begin(), position.end(), std::back_inserter(saveVar));
-                std::copy(orientation.begin(), orientation.end(), std::back_inserter(saveVar));
-                std::copy(linearVel.begin(), linearVel.end(), std::back_inserter(saveVar));
-                std::copy(angularVel.begin(), angularVel.end(), std::back_inserter(saveVar));
-                std::copy(linearAcc.begin(), linearAcc.end(), std::back_inserter(saveVar));
-                std::copy(angularAcc.begin(), angularAcc.end(), std::back_inserter(saveVar));
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                buffer = std::copy(position.begin(), position.end(), buffer);
+                buffer = std::copy(orientation.begin(), orientation.end(), buffer);
+                buffer = std::copy(linearVel.begin(), linearVel.end(), buffer);
+                buffer = std::copy(angularVel.begin(), angularVel.end(), buffer);
+                buffer = std::copy(linearAcc.begin(), linearAcc.end(), buffer);
+                std::copy(angularAcc.begin(), angularAcc.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logVirtualJointKinSensors) {
-        for (const auto& sensor : pImpl->virtualJointKinSensors) {
+        const auto& indices =
+            pImpl->getLoggedSensorsIndices(sensor::SensorType::VirtualJointKinSensor);
+        for (size_t i = 0; i < pImpl->virtualJointKinSensors.size(); ++i) {
+            const auto& sensor = pImpl->virtualJointKinSensors[i];
             double jointPos;
             double jointVel;
             double jointAcc;
@@ -694,34 +846,19 @@ void IWearLogger::run()
                 askToStop();
                 return;
             }
-            else {
-                std::vector<double> saveVar;
-                saveVar.emplace_back(jointPos);
-                saveVar.emplace_back(jointVel);
-                saveVar.emplace_back(jointAcc);
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                buffer[0] = jointPos;
+                buffer[1] = jointVel;
+                buffer[2] = jointAcc;
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logVirtualSphericalJointKinSensors) {
-        for (const auto& sensor : pImpl->virtualSphericalJointKinSensors) {
+        const auto& indices =
+            pImpl->getLoggedSensorsIndices(sensor::SensorType::VirtualSphericalJointKinSensor);
+        for (size_t i = 0; i < pImpl->virtualSphericalJointKinSensors.size(); ++i) {
+            const auto& sensor = pImpl->virtualSphericalJointKinSensors[i];
             wearable::Vector3 jointAngles;
             wearable::Vector3 jointVel;
             wearable::Vector3 jointAcc;
@@ -731,64 +868,51 @@ void IWearLogger::run()
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else {
-                std::vector<double> saveVar;
-                std::copy(jointAngles.begin(), jointAngles.end(), std::back_inserter(saveVar));
-                std::copy(jointVel.begin(), jointVel.end(), std::back_inserter(saveVar));
-                std::copy(jointAcc.begin(), jointAcc.end(), std::back_inserter(saveVar));
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor)) {
+                buffer = std::copy(jointAngles.begin(), jointAngles.end(), buffer);
+                buffer = std::copy(jointVel.begin(), jointVel.end(), buffer);
+                std::copy(jointAcc.begin(), jointAcc.end(), buffer);
             }
         }
     }
 
     if (pImpl->settings.logAllQuantities || pImpl->settings.logSkinSensors)
     {
-        for (const auto& sensor : pImpl->skinSensors) {
-            std::vector<double> pressureVector;
-            if (!sensor->getPressure(pressureVector)) {
+        const auto& indices = pImpl->getLoggedSensorsIndices(sensor::SensorType::SkinSensor);
+        for (size_t i = 0; i < pImpl->skinSensors.size(); ++i) {
+            const auto& sensor = pImpl->skinSensors[i];
+            if (!sensor->getPressure(pImpl->pressureVector)) {
                 yWarning() << logPrefix << "[SkinSensors] "
                            << "Failed to read data, "
                            << "sensor status is " << static_cast<int>(sensor->getSensorStatus());
             }
-            else
+            else if (double* buffer = pImpl->prepareSensorValues(*sample, indices[i], sensor))
             {
-                std::vector<double> saveVar{pressureVector.begin(), pressureVector.end()};
-                pImpl->prefixVecWithSensorStatus(sensor, saveVar);
-
-                if (pImpl->loggerType == LoggerType::MATLAB
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    const auto& channelName =
-                        pImpl->wearable2MatlabNameLookup.at(sensor->getSensorName());
-                    pImpl->bufferManager.push_back(saveVar, timestamp.getTime(), channelName);
-                }
-
-                if (pImpl->loggerType == LoggerType::YARP
-                    || pImpl->loggerType == LoggerType::MATLAB_YARP) {
-                    auto& port = pImpl->wearable2YarpPortLookup.at(sensor->getSensorName());
-                    yarp::sig::Vector& data = port->prepare();
-                    pImpl->prepareYarpBottle(saveVar, data);
-                    port->setEnvelope(timestamp);
-                    port->write();
-                }
+                // The channel size is fixed when the logger is configured
+                const size_t nValues = std::min(pImpl->pressureVector.size(),
+                                                pImpl->loggedSensors[indices[i]].size - 1);
+                std::copy_n(pImpl->pressureVector.begin(), nValues, buffer);
             }
         }
     }
+
+    if (pImpl->settings.triggeredCapture && pImpl->checkTriggerThresholds(*sample)) {
+        pImpl->triggerRequested = true;
+    }
+
+    // The ticks not publishing a sample count as well for the metrics
+    if (!capturing || sample == &pImpl->droppedSample) {
+        pImpl->updateTickStatistics(tickStartTime);
+        return;
+    }
+
+    pImpl->sampleQueue->publish();
+    pImpl->statistics.samples++;
+    if (pImpl->metrics) {
+        pImpl->metrics->addFramesIn();
+    }
+
+    pImpl->updateTickStatistics(tickStartTime);
 }
 
 // ======================
@@ -805,6 +929,13 @@ bool IWearLogger::open(yarp::os::Searchable& config)
     const double period = config.check("period", yarp::os::Value(DefaultPeriod)).asFloat64();
     setPeriod(period);
 
+    std::string error;
+    if (!realtime::parseThreadSettings(config, pImpl->threadSettings, error)) {
+        yError() << logPrefix << error;
+        return false;
+    }
+    pImpl->jitter.setReportPeriod(pImpl->threadSettings.jitterReportPeriod);
+
     // Load settings in the class
     bool ok = pImpl->loadSettingsFromConfig(config);
     if (!ok) {
@@ -812,6 +943,30 @@ bool IWearLogger::open(yarp::os::Searchable& config)
         return false;
     }
 
+    // The metrics are enabled by the metrics option or by setting the name of their port. They
+    // are not needed for logging the data, hence failures are not fatal.
+    if (config.check("metrics", yarp::os::Value(false)).asBool()
+        || config.check("metricsPortName")) {
+        const std::string metricsPortName =
+            config
+                .check("metricsPortName",
+                       yarp::os::Value(pImpl->settings.yarpMultiplexedPortPrefix + "/metrics:rpc"))
+                .asString();
+        pImpl->metrics.reset(new metrics::Metrics(WrapperName + " " + metricsPortName));
+        pImpl->metrics->setPeriod(period);
+
+        if (!pImpl->metricsServer.open(metricsPortName, pImpl->metrics.get())) {
+            yWarning() << logPrefix << "Failed to open the metrics port" << metricsPortName;
+        }
+    }
+
+    // The raw capture does not need an attached IWear device, it starts right away
+    if (pImpl->rawCapture && !pImpl->openRawCapture()) {
+        yError() << logPrefix << "Failed to start the raw capture.";
+        pImpl->closeRawCapture();
+        return false;
+    }
+
     return true;
 }
 
@@ -829,6 +984,14 @@ void IWearLogger::impl::setLoggerType(std::string& str)
             this->loggerType = LoggerType::YARP;
         }
     }
+
+    if (!std::strcmp(str.c_str(), "binary")) {
+        this->binaryLogger = true;
+    }
+
+    if (!std::strcmp(str.c_str(), "raw")) {
+        this->rawCapture = true;
+    }
 }
 
 bool IWearLogger::impl::loadSettingsFromConfig(yarp::os::Searchable& config)
@@ -872,6 +1035,14 @@ bool IWearLogger::impl::loadSettingsFromConfig(yarp::os::Searchable& config)
             break;
     }
 
+    if (this->binaryLogger) {
+        yInfo() << logPrefix << "Binary logger enabled";
+    }
+
+    if (this->rawCapture) {
+        yInfo() << logPrefix << "Raw capture of the WearableData messages enabled";
+    }
+
     yarp::os::Property prop;
     prop.fromString(config.toString().c_str());
 
@@ -945,6 +1116,168 @@ bool IWearLogger::impl::loadSettingsFromConfig(yarp::os::Searchable& config)
         }
     }
 
+    std::string writerThreads = "writerThreads";
+    if (prop.check(writerThreads.c_str())) {
+        if (!prop.find(writerThreads.c_str()).isInt32()
+            || prop.find(writerThreads.c_str()).asInt32() < 1) {
+            yError() << logPrefix << writerThreads << " must be a positive integer.";
+            return false;
+        }
+        settings.writerThreads = prop.find(writerThreads.c_str()).asInt32();
+    }
+
+    std::string queueSize = "queueSize";
+    if (prop.check(queueSize.c_str())) {
+        if (!prop.find(queueSize.c_str()).isInt32()
+            || prop.find(queueSize.c_str()).asInt32() < 1) {
+            yError() << logPrefix << queueSize << " must be a positive integer.";
+            return false;
+        }
+        settings.queueSize = prop.find(queueSize.c_str()).asInt32();
+    }
+
+    std::string binaryChunkSize = "binaryChunkSize";
+    if (prop.check(binaryChunkSize.c_str())) {
+        if (!prop.find(binaryChunkSize.c_str()).isInt32()
+            || prop.find(binaryChunkSize.c_str()).asInt32() < 1) {
+            yError() << logPrefix << binaryChunkSize << " must be a positive integer.";
+            return false;
+        }
+        settings.binaryChunkSize = prop.find(binaryChunkSize.c_str()).asInt32();
+    }
+
+    // The compression is a bool (xor when true) or the name of the codec
+    std::string binaryCompression = "binaryCompression";
+    if (prop.check(binaryCompression.c_str())) {
+        const yarp::os::Value& value = prop.find(binaryCompression.c_str());
+        const std::string codec = value.isBool() ? (value.asBool() ? "xor" : "none")
+                                                 : value.asString();
+        if (codec == "none") {
+            settings.binaryCompression = wearable::logger::binary::Compression::None;
+        }
+        else if (codec == "xor") {
+            settings.binaryCompression = wearable::logger::binary::Compression::XorRle;
+        }
+        else if (codec == "gorilla") {
+            settings.binaryCompression = wearable::logger::binary::Compression::Gorilla;
+        }
+        else {
+            yError() << logPrefix << binaryCompression
+                     << " must be a bool or one of none, xor and gorilla.";
+            return false;
+        }
+    }
+
+    checkAndLoadBooleanOption(prop, "yarpMultiplexed", settings.yarpMultiplexed);
+
+    if (rawCapture) {
+        std::string rawCaptureDataPorts = "rawCaptureDataPorts";
+        if (!(prop.check(rawCaptureDataPorts.c_str())
+              && prop.find(rawCaptureDataPorts.c_str()).isList())) {
+            yError() << logPrefix << " missing parameter: " << rawCaptureDataPorts;
+            return false;
+        }
+
+        yarp::os::Bottle* portsList = prop.find(rawCaptureDataPorts.c_str()).asList();
+        for (size_t i = 0; i < portsList->size(); ++i) {
+            if (!portsList->get(i).isString()) {
+                yError() << logPrefix << "ith entry of " << rawCaptureDataPorts
+                         << " list is not a string";
+                return false;
+            }
+            settings.rawCaptureDataPorts.push_back(portsList->get(i).asString());
+        }
+
+        std::string rawCapturePortPrefix = "rawCapturePortPrefix";
+        if (prop.check(rawCapturePortPrefix.c_str())
+            && prop.find(rawCapturePortPrefix.c_str()).isString()) {
+            settings.rawCapturePortPrefix = prop.find(rawCapturePortPrefix.c_str()).asString();
+        }
+
+        std::string rawCaptureCarrier = "rawCaptureCarrier";
+        if (prop.check(rawCaptureCarrier.c_str())
+            && prop.find(rawCaptureCarrier.c_str()).isString()) {
+            settings.rawCaptureCarrier = prop.find(rawCaptureCarrier.c_str()).asString();
+        }
+    }
+
+    checkAndLoadBooleanOption(prop, "triggeredCapture", settings.triggeredCapture);
+
+    if (settings.triggeredCapture) {
+        std::string preTriggerTime = "preTriggerTime";
+        if (prop.check(preTriggerTime.c_str())) {
+            if (!prop.find(preTriggerTime.c_str()).isFloat64()
+                || prop.find(preTriggerTime.c_str()).asFloat64() < 0) {
+                yError() << logPrefix << preTriggerTime << " must be a non negative number.";
+                return false;
+            }
+            settings.preTriggerTime = prop.find(preTriggerTime.c_str()).asFloat64();
+        }
+
+        std::string postTriggerTime = "postTriggerTime";
+        if (prop.check(postTriggerTime.c_str())) {
+            if (!prop.find(postTriggerTime.c_str()).isFloat64()
+                || prop.find(postTriggerTime.c_str()).asFloat64() < 0) {
+                yError() << logPrefix << postTriggerTime << " must be a non negative number.";
+                return false;
+            }
+            settings.postTriggerTime = prop.find(postTriggerTime.c_str()).asFloat64();
+        }
+
+        std::string triggerPortPrefix = "triggerPortPrefix";
+        if (prop.check(triggerPortPrefix.c_str())
+            && prop.find(triggerPortPrefix.c_str()).isString()) {
+            settings.triggerPortPrefix = prop.find(triggerPortPrefix.c_str()).asString();
+        }
+
+        // List of (sensorName valueIndex threshold [rising|falling]), rising by default
+        std::string thresholds = "triggerThresholds";
+        if (prop.check(thresholds.c_str())) {
+            yarp::os::Bottle* thresholdsList = prop.find(thresholds.c_str()).asList();
+            if (!thresholdsList) {
+                yError() << logPrefix << thresholds << " option is not a list";
+                return false;
+            }
+
+            for (size_t i = 0; i < thresholdsList->size(); ++i) {
+                yarp::os::Bottle* entry = thresholdsList->get(i).asList();
+                const std::string direction =
+                    entry && entry->size() == 4 ? entry->get(3).asString() : "rising";
+                if (!entry || entry->size() < 3 || entry->size() > 4 || !entry->get(0).isString()
+                    || !entry->get(1).isInt32() || !entry->get(2).isFloat64()
+                    || (direction != "rising" && direction != "falling")) {
+                    yError() << logPrefix << "ith entry of " << thresholds
+                             << " must be (sensorName valueIndex threshold [rising|falling])";
+                    return false;
+                }
+
+                TriggerThreshold threshold;
+                threshold.sensorName = entry->get(0).asString();
+                threshold.valueIndex = entry->get(1).asInt32();
+                threshold.threshold = entry->get(2).asFloat64();
+                threshold.falling = direction == "falling";
+                triggerThresholds.push_back(threshold);
+            }
+        }
+    }
+
+    std::string yarpMultiplexedPortPrefix = "yarpMultiplexedPortPrefix";
+    if (prop.check(yarpMultiplexedPortPrefix.c_str())
+        && prop.find(yarpMultiplexedPortPrefix.c_str()).isString()) {
+        settings.yarpMultiplexedPortPrefix =
+            prop.find(yarpMultiplexedPortPrefix.c_str()).asString();
+    }
+
+    std::string binaryMaxFileSize = "binaryMaxFileSize";
+    if (prop.check(binaryMaxFileSize.c_str())) {
+        if (!prop.find(binaryMaxFileSize.c_str()).isFloat64()
+            || prop.find(binaryMaxFileSize.c_str()).asFloat64() < 0) {
+            yError() << logPrefix << binaryMaxFileSize << " must be a non negative number.";
+            return false;
+        }
+        settings.binaryMaxFileSize = prop.find(binaryMaxFileSize.c_str()).asFloat64();
+    }
+
     std::string auto_save = "auto_save";
     if (prop.check(auto_save.c_str()) && prop.find(auto_save.c_str()).isBool()) {
         bufferConfig.auto_save = prop.find(auto_save.c_str()).asBool();
@@ -971,6 +1304,24 @@ void IWearLogger::impl::checkAndLoadBooleanOption(yarp::os::Property& prop,
 
 bool IWearLogger::close()
 {
+    pImpl->stopWriters();
+    pImpl->closeRawCapture();
+    pImpl->metricsServer.close();
+
+    if (pImpl->triggerRpcPort) {
+        pImpl->triggerRpcPort->close();
+    }
+    if (pImpl->triggerInputPort) {
+        pImpl->triggerInputPort->close();
+    }
+
+    if (pImpl->multiplexedPort) {
+        pImpl->multiplexedPort->close();
+    }
+    if (pImpl->multiplexedLayoutPort) {
+        pImpl->multiplexedLayoutPort->close();
+    }
+
     if (!pImpl->bufferConfig.auto_save) {
         pImpl->bufferManager.saveToFile();
     }
@@ -1006,11 +1357,19 @@ bool IWearLogger::attach(yarp::dev::PolyDriver* poly)
         return false;
     }
 
-    if (!pImpl->configureBufferManager()) {
+    if (!pImpl->configureBufferManager(getPeriod())) {
         yError() << logPrefix << "Failed to configure buffer manager for the logger.";
         return false;
     }
 
+    if (pImpl->settings.triggeredCapture && !pImpl->configureTriggeredCapture()) {
+        yError() << logPrefix << "Failed to configure the triggered capture.";
+        return false;
+    }
+
+    // Start the threads writing the samples to the outputs
+    pImpl->startWriters(getPeriod());
+
     // Start the PeriodicThread loop
     if (!start()) {
         yError() << logPrefix << "Failed to start the loop.";
@@ -1039,6 +1398,11 @@ bool IWearLogger::impl::configureMatlabBufferManager(const std::string& sensorNa
 
 bool IWearLogger::impl::configureYarpBufferManager(const std::string& sensorName)
 {
+    // In multiplexed mode all the sensors are written to a single port
+    if (settings.yarpMultiplexed) {
+        return true;
+    }
+
     auto portName = convertSensorNameToValidYarpPortName(sensorName);
 
     auto port = std::make_unique<YarpBufferedPort>();
@@ -1060,7 +1424,7 @@ bool IWearLogger::impl::configureYarpBufferManager(const std::string& sensorName
     return true;
 }
 
-bool IWearLogger::impl::configureBufferManager()
+bool IWearLogger::impl::configureBufferManager(const double period)
 {
     bool ok{true};
     // Prepare the buffer manager for the logger
@@ -1070,6 +1434,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (4, 1) accelerometer channels for " << sensorName
                     << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 4);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 4);
             }
@@ -1086,6 +1452,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (3, 1) EMG sensor channels value+normalization for "
                     << sensorName << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 3);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 3);
             }
@@ -1102,6 +1470,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (4, 1) 3d force sensor channels for " << sensorName
                     << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 4);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 4);
             }
@@ -1118,6 +1488,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (7, 1) 6D force torque sensor channels for "
                     << sensorName << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 7);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 7);
             }
@@ -1134,6 +1506,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (4, 1) free body acceleration sensor channels for "
                     << sensorName << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 4);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 4);
             }
@@ -1150,6 +1524,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (4, 1) gyroscope channels for " << sensorName
                     << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 4);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 4);
             }
@@ -1166,6 +1542,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (4, 1) magnetometer channels for " << sensorName
                     << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 4);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 4);
             }
@@ -1182,6 +1560,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (5, 1) quaternion wxyz channels for " << sensorName
                     << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 5);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 5);
             }
@@ -1198,6 +1578,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (8, 1) pose sensor (pos+quat) channels for "
                     << sensorName << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 8);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 8);
             }
@@ -1214,6 +1596,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (4, 1) pose sensor channels for " << sensorName
                     << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 4);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 4);
             }
@@ -1230,6 +1614,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (2, 1) temperature sensor channels for " << sensorName
                     << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 2);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 2);
             }
@@ -1246,6 +1632,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (4, 1) 3D torque sensor channels for " << sensorName
                     << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 4);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 4);
             }
@@ -1262,6 +1650,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (20, 1) pos+quat+v+omega+a+alpha channels for "
                     << sensorName << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 20);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 20);
             }
@@ -1278,6 +1668,8 @@ bool IWearLogger::impl::configureBufferManager()
             yInfo() << logPrefix << "Adding (4, 1) virtual joint kinematics channels for "
                     << sensorName << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 4);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 4);
             }
@@ -1295,6 +1687,8 @@ bool IWearLogger::impl::configureBufferManager()
                     << "Adding (10, 1) rpy+vel+acc virtual spherical joint kinematics channels for "
                     << sensorName << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, 10);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, 10);
             }
@@ -1318,6 +1712,8 @@ bool IWearLogger::impl::configureBufferManager()
                     << "Adding ("<< dataSize<<", 1) pressure vector channels for "
                     << sensorName << " prefixed with sensor status.";
 
+            addLoggedSensor(s->getSensorType(), sensorName, dataSize);
+
             if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
                 ok = ok && configureMatlabBufferManager(sensorName, dataSize);
             }
@@ -1333,10 +1729,572 @@ bool IWearLogger::impl::configureBufferManager()
         yDebug() << logPrefix << " buffer manager configured successfully.";
     }
 
-    return ok;
+    if (!ok) {
+        return false;
+    }
+
+    // Resolve the outputs of each logged sensor once, the writer threads only use the layout
+    for (auto& loggedSensor : loggedSensors) {
+        if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
+            loggedSensor.matlabChannelName = wearable2MatlabNameLookup.at(loggedSensor.name);
+        }
+
+        if ((loggerType == LoggerType::YARP || loggerType == LoggerType::MATLAB_YARP)
+            && !settings.yarpMultiplexed) {
+            loggedSensor.yarpPort = wearable2YarpPortLookup.at(loggedSensor.name).get();
+        }
+    }
+
+    if ((loggerType == LoggerType::YARP || loggerType == LoggerType::MATLAB_YARP)
+        && settings.yarpMultiplexed && !openMultiplexedPorts()) {
+        return false;
+    }
+
+    if (binaryLogger && !openBinaryLogFile()) {
+        return false;
+    }
+
+    // When a trigger is received the whole pre-trigger ring is moved to the queue
+    if (settings.triggeredCapture) {
+        const size_t preTriggerSamples =
+            static_cast<size_t>(std::ceil(settings.preTriggerTime / period)) + 1;
+        if (settings.queueSize <= preTriggerSamples) {
+            yWarning() << logPrefix << "queueSize is smaller than the pre-trigger window, using"
+                       << 2 * preTriggerSamples << "samples.";
+            settings.queueSize = 2 * preTriggerSamples;
+        }
+        preTriggerRing = std::make_unique<logger::SampleRing>(
+            preTriggerSamples, nLoggedValues, loggedSensors.size());
+        droppedSample.values.assign(nLoggedValues, 0.0);
+        droppedSample.valid.assign(loggedSensors.size(), 0);
+    }
+
+    sampleQueue = std::make_unique<logger::SampleQueue>(
+        settings.queueSize, nLoggedValues, loggedSensors.size(), settings.writerThreads);
+
+    yInfo() << logPrefix << "Logging" << loggedSensors.size() << "sensors (" << nLoggedValues
+            << "values per sample) using" << settings.writerThreads
+            << "writer threads and a queue of" << settings.queueSize << "samples.";
+
+    return true;
+}
+
+void IWearLogger::impl::addLoggedSensor(const sensor::SensorType type,
+                                        const std::string& sensorName,
+                                        const size_t channelSize)
+{
+    if (loggedSensorsLookup.find(sensorName) != loggedSensorsLookup.end()) {
+        yWarning() << logPrefix << "Sensor" << sensorName
+                   << "has already been added to the logger, ignoring it.";
+        return;
+    }
+
+    LoggedSensor loggedSensor;
+    loggedSensor.name = sensorName;
+    loggedSensor.type = type;
+    loggedSensor.offset = nLoggedValues;
+    loggedSensor.size = channelSize;
+    loggedSensor.writer = loggedSensors.size() % settings.writerThreads;
+
+    loggedSensorsLookup[sensorName] = loggedSensors.size();
+    loggedSensors.push_back(loggedSensor);
+    nLoggedValues += channelSize;
+}
+
+template <typename SensorInterface>
+void IWearLogger::impl::resolveLoggedSensors(
+    const sensor::SensorType type,
+    const wearable::VectorOfSensorPtr<const SensorInterface>& sensors)
+{
+    auto& indices = loggedSensorsIndices[static_cast<size_t>(type)];
+    indices.clear();
+
+    for (const auto& sensor : sensors) {
+        const auto it = loggedSensorsLookup.find(sensor->getSensorName());
+        if (it == loggedSensorsLookup.end()) {
+            // It happens only for sensors that were not available when the logger was attached
+            if (settings.logAllQuantities || isLoggingEnabled(type)) {
+                yWarning() << logPrefix << "Sensor" << sensor->getSensorName()
+                           << "was not available when the logger was configured, it will not be "
+                              "logged.";
+            }
+            indices.push_back(InvalidIndex);
+            continue;
+        }
+        indices.push_back(it->second);
+    }
+}
+
+double* IWearLogger::impl::prepareSensorValues(
+    logger::Sample& sample,
+    const size_t index,
+    const std::shared_ptr<const wearable::sensor::ISensor>& sensor)
+{
+    if (index == InvalidIndex) {
+        return nullptr;
+    }
+
+    // Values are prefixed with the sensor status
+    const LoggedSensor& loggedSensor = loggedSensors[index];
+    sample.values[loggedSensor.offset] = static_cast<double>(sensor->getSensorStatus());
+    sample.valid[index] = 1;
+
+    return &sample.values[loggedSensor.offset + 1];
+}
+
+void IWearLogger::impl::writeSample(const logger::Sample& sample,
+                                    const size_t writer,
+                                    std::vector<double>& saveVar)
+{
+    for (size_t index = 0; index < loggedSensors.size(); ++index) {
+        const LoggedSensor& loggedSensor = loggedSensors[index];
+        if (loggedSensor.writer != writer || !sample.valid[index]) {
+            continue;
+        }
+
+        const double* begin = &sample.values[loggedSensor.offset];
+        const double* end = begin + loggedSensor.size;
+
+        if (loggerType == LoggerType::MATLAB || loggerType == LoggerType::MATLAB_YARP) {
+            saveVar.assign(begin, end);
+            std::lock_guard<std::mutex> guard(bufferManagerMutex);
+            bufferManager.push_back(saveVar, sample.time, loggedSensor.matlabChannelName);
+        }
+
+        if (loggedSensor.yarpPort) {
+            yarp::sig::Vector& data = loggedSensor.yarpPort->prepare();
+            prepareYarpBottle(begin, end, data);
+            loggedSensor.yarpPort->setEnvelope(
+                yarp::os::Stamp(sample.sequenceNumber, sample.time));
+            loggedSensor.yarpPort->write();
+        }
+    }
+
+    // The outputs storing whole samples are handled by the first writer
+    if (writer != 0) {
+        return;
+    }
+
+    if (multiplexedPort) {
+        yarp::sig::Vector& data = multiplexedPort->prepare();
+        prepareYarpBottle(sample.values.data(), sample.values.data() + sample.values.size(), data);
+        // Sensors not read in this tick are marked with the Unknown status
+        for (size_t index = 0; index < loggedSensors.size(); ++index) {
+            if (!sample.valid[index]) {
+                data[loggedSensors[index].offset] =
+                    static_cast<double>(sensor::SensorStatus::Unknown);
+            }
+        }
+        multiplexedPort->setEnvelope(yarp::os::Stamp(sample.sequenceNumber, sample.time));
+        multiplexedPort->write();
+    }
+
+    if (!binaryWriter.isOpen()) {
+        return;
+    }
+
+    if (!binaryWriter.append(sample.time,
+                             static_cast<int32_t>(sample.sequenceNumber),
+                             sample.values.data(),
+                             sample.valid.data())) {
+        yError() << logPrefix << binaryWriter.getLastError() << ", stopping the binary logger.";
+        binaryWriter.close();
+        return;
+    }
+
+    if (settings.binaryMaxFileSize > 0
+        && binaryWriter.getBytesWritten() >= settings.binaryMaxFileSize * 1024 * 1024) {
+        binaryWriter.close();
+        openBinaryLogFile();
+    }
+}
+
+bool IWearLogger::impl::openMultiplexedPorts()
+{
+    // Check yarp network initialization
+    if (!yarp::os::Network::isNetworkInitialized()) {
+        yInfo() << logPrefix << "Initializing yarp network";
+        yarp::os::Network::init();
+    }
+
+    // The layout is fixed once the logger is configured:
+    // ((name type offset size) ...), the values of each sensor are prefixed with its status
+    multiplexedLayoutResponder.layout.clear();
+    for (const auto& loggedSensor : loggedSensors) {
+        yarp::os::Bottle& entry = multiplexedLayoutResponder.layout.addList();
+        entry.addString(loggedSensor.name);
+        entry.addString(sensor::sensorTypeToString(loggedSensor.type));
+        entry.addInt32(static_cast<int>(loggedSensor.offset));
+        entry.addInt32(static_cast<int>(loggedSensor.size));
+    }
+
+    const std::string layoutPortName = settings.yarpMultiplexedPortPrefix + "/layout:rpc";
+    multiplexedLayoutPort = std::make_unique<yarp::os::Port>();
+    multiplexedLayoutPort->setReader(multiplexedLayoutResponder);
+    if (!multiplexedLayoutPort->open(layoutPortName)) {
+        yError() << logPrefix << "Failed to open yarp port " << layoutPortName;
+        return false;
+    }
+
+    const std::string dataPortName = settings.yarpMultiplexedPortPrefix + "/data:o";
+    multiplexedPort = std::make_unique<YarpBufferedPort>();
+    if (!multiplexedPort->open(dataPortName)) {
+        yError() << logPrefix << "Failed to open yarp port " << dataPortName;
+        return false;
+    }
+
+    yInfo() << logPrefix << "Writing" << nLoggedValues << "values of" << loggedSensors.size()
+            << "sensors to" << dataPortName << ", the layout is available on" << layoutPortName;
+    yDebug() << logPrefix << "Multiplexed layout:" << multiplexedLayoutResponder.layout.toString();
+
+    return true;
+}
+
+const std::string& IWearLogger::impl::getLogFileBaseName()
+{
+    if (logFileBaseName.empty()) {
+        char timeString[32];
+        const std::time_t now = std::time(nullptr);
+        std::strftime(timeString, sizeof(timeString), "%Y_%m_%d_%H_%M_%S", std::localtime(&now));
+        logFileBaseName = bufferConfig.path + bufferConfig.filename + "_" + timeString;
+    }
+    return logFileBaseName;
+}
+
+bool IWearLogger::impl::openRawCapture()
+{
+    const std::string fileName = getLogFileBaseName() + ".iwraw";
+    if (!rawCaptureWriter.open(fileName, settings.rawCaptureDataPorts)) {
+        yError() << logPrefix << "Failed to open the raw capture:"
+                 << rawCaptureWriter.getLastError();
+        return false;
+    }
+
+    // Check yarp network initialization
+    if (!yarp::os::Network::isNetworkInitialized()) {
+        yInfo() << logPrefix << "Initializing yarp network";
+        yarp::os::Network::init();
+    }
+
+    for (size_t i = 0; i < settings.rawCaptureDataPorts.size(); ++i) {
+        rawCaptureReceivers.emplace_back(
+            new RawCaptureReceiver(static_cast<uint32_t>(i), rawCaptureWriter));
+        auto& receiver = rawCaptureReceivers.back();
+
+        // The messages are read in the thread of the connection, none is dropped by the port
+        receiver->port.setReader(*receiver);
+
+        const std::string portName = settings.rawCapturePortPrefix + "/" + std::to_string(i) + ":i";
+        if (!receiver->port.open(portName)) {
+            yError() << logPrefix << "Failed to open yarp port " << portName;
+            return false;
+        }
+
+        if (!yarp::os::Network::connect(
+                settings.rawCaptureDataPorts[i], portName, settings.rawCaptureCarrier)) {
+            yError() << logPrefix << "Failed to connect " << settings.rawCaptureDataPorts[i]
+                     << " with " << portName;
+            return false;
+        }
+
+        yInfo() << logPrefix << "Capturing" << settings.rawCaptureDataPorts[i] << "to" << fileName;
+    }
+
+    return true;
+}
+
+void IWearLogger::impl::closeRawCapture()
+{
+    for (auto& receiver : rawCaptureReceivers) {
+        receiver->port.interrupt();
+        receiver->port.close();
+    }
+    rawCaptureReceivers.clear();
+
+    if (rawCaptureWriter.isOpen()) {
+        yInfo() << logPrefix << "Captured" << rawCaptureWriter.getNumberOfRecords()
+                << "raw messages";
+        if (!rawCaptureWriter.close()) {
+            yError() << logPrefix << "Failed to close the raw capture:"
+                     << rawCaptureWriter.getLastError();
+        }
+    }
+}
+
+bool IWearLogger::impl::configureTriggeredCapture()
+{
+    for (auto& threshold : triggerThresholds) {
+        const auto it = loggedSensorsLookup.find(threshold.sensorName);
+        if (it == loggedSensorsLookup.end()) {
+            yError() << logPrefix << "The trigger sensor" << threshold.sensorName
+                     << "is not logged.";
+            return false;
+        }
+
+        if (threshold.valueIndex >= loggedSensors[it->second].size) {
+            yError() << logPrefix << "The trigger value index" << threshold.valueIndex
+                     << "exceeds the" << loggedSensors[it->second].size << "values of"
+                     << threshold.sensorName;
+            return false;
+        }
+        threshold.sensorIndex = it->second;
+
+        yInfo() << logPrefix << "Triggering when value" << threshold.valueIndex << "of"
+                << threshold.sensorName << (threshold.falling ? "drops below" : "rises above")
+                << threshold.threshold;
+    }
+
+    // Check yarp network initialization
+    if (!yarp::os::Network::isNetworkInitialized()) {
+        yInfo() << logPrefix << "Initializing yarp network";
+        yarp::os::Network::init();
+    }
+
+    const std::string rpcPortName = settings.triggerPortPrefix + "/trigger:rpc";
+    triggerRpcPort = std::make_unique<yarp::os::Port>();
+    triggerRpcPort->setReader(triggerReceiver);
+    if (!triggerRpcPort->open(rpcPortName)) {
+        yError() << logPrefix << "Failed to open yarp port " << rpcPortName;
+        return false;
+    }
+
+    const std::string inputPortName = settings.triggerPortPrefix + "/trigger:i";
+    triggerInputPort = std::make_unique<yarp::os::BufferedPort<yarp::os::Bottle>>();
+    triggerInputPort->useCallback(triggerReceiver);
+    if (!triggerInputPort->open(inputPortName)) {
+        yError() << logPrefix << "Failed to open yarp port " << inputPortName;
+        return false;
+    }
+
+    yInfo() << logPrefix << "Triggered capture enabled, keeping the last" << settings.preTriggerTime
+            << "s (" << preTriggerRing->capacity() << "samples ) and writing"
+            << settings.postTriggerTime << "s after each trigger received on" << rpcPortName
+            << "or" << inputPortName;
+
+    return true;
+}
+
+bool IWearLogger::impl::updateTriggeredCapture(const double now)
+{
+    if (triggerRequested.exchange(false)) {
+        statistics.triggers++;
+
+        if (!capturing) {
+            yInfo() << logPrefix << "Trigger received, writing" << preTriggerRing->size()
+                    << "pre-trigger samples.";
+
+            // Move the pre-trigger window to the writers, from the oldest sample
+            for (size_t i = 0; i < preTriggerRing->size(); ++i) {
+                logger::Sample* slot = sampleQueue->tryAcquire();
+                if (!slot) {
+                    statistics.droppedSamples++;
+                    if (metrics) {
+                        metrics->addDrops();
+                    }
+                    continue;
+                }
+                *slot = preTriggerRing->at(i);
+                sampleQueue->publish();
+                statistics.samples++;
+                if (metrics) {
+                    metrics->addFramesIn();
+                }
+            }
+            preTriggerRing->clear();
+            capturing = true;
+        }
+        else {
+            yInfo() << logPrefix << "Trigger received, extending the capture.";
+        }
+
+        captureEndTime = now + settings.postTriggerTime;
+    }
+
+    if (capturing && now > captureEndTime) {
+        yInfo() << logPrefix << "Post-trigger window elapsed, waiting for the next trigger.";
+        capturing = false;
+    }
+
+    return capturing;
 }
 
-void IWearLogger::threadRelease() {}
+bool IWearLogger::impl::checkTriggerThresholds(const logger::Sample& sample)
+{
+    bool triggered = false;
+    for (auto& threshold : triggerThresholds) {
+        if (!sample.valid[threshold.sensorIndex]) {
+            continue;
+        }
+
+        // Trigger only when the value crosses the threshold in the configured direction
+        const size_t offset = loggedSensors[threshold.sensorIndex].offset;
+        const double value = sample.values[offset + threshold.valueIndex];
+        const bool crossed =
+            threshold.falling ? value < threshold.threshold : value > threshold.threshold;
+        triggered = triggered || (crossed && !threshold.crossed);
+        threshold.crossed = crossed;
+    }
+    return triggered;
+}
+
+void IWearLogger::impl::updateTickStatistics(const double tickStartTime)
+{
+    const size_t queueDepth = sampleQueue->size();
+    WEARABLES_TRACE_COUNTER("IWearLogger::queueDepth", queueDepth);
+    if (queueDepth > statistics.maxQueueDepth) {
+        statistics.maxQueueDepth = queueDepth;
+    }
+
+    // The overruns are counted by the jitter statistics of the loop and by the metrics
+    if (metrics) {
+        metrics->addTick(yarp::os::Time::now() - tickStartTime);
+    }
+}
+
+bool IWearLogger::impl::openBinaryLogFile()
+{
+    // When the file rotation is enabled, the following files are suffixed with a counter
+    std::string fileName = getLogFileBaseName();
+    if (binaryFileCounter > 0) {
+        fileName += "_" + std::to_string(binaryFileCounter);
+    }
+    fileName += ".iwlog";
+    binaryFileCounter++;
+
+    std::vector<wearable::logger::binary::Channel> channels;
+    for (const auto& loggedSensor : loggedSensors) {
+        wearable::logger::binary::Channel channel;
+        channel.name = loggedSensor.name;
+        channel.type = sensor::sensorTypeToString(loggedSensor.type);
+        channel.size = static_cast<uint32_t>(loggedSensor.size);
+        channels.push_back(channel);
+    }
+
+    wearable::logger::binary::WriterOptions options;
+    options.chunkSize = settings.binaryChunkSize;
+    options.compression = settings.binaryCompression;
+
+    if (!binaryWriter.open(fileName, channels, options)) {
+        yError() << logPrefix << "Failed to open the binary log:" << binaryWriter.getLastError();
+        return false;
+    }
+
+    yInfo() << logPrefix << "Writing binary log to" << fileName;
+    return true;
+}
+
+void IWearLogger::impl::writerLoop(const size_t writer, const double period)
+{
+    std::vector<double> saveVar;
+    saveVar.reserve(nLoggedValues);
+
+    while (true) {
+        // Read the flag before checking the queue, so that samples published
+        // before stopping are always written
+        const bool running = writersRunning;
+
+        const logger::Sample* sample = sampleQueue->front(writer);
+        if (!sample) {
+            if (!running) {
+                break;
+            }
+            // Woken up by the next sample, or by stopWriters()
+            sampleQueue->wait(writer, period);
+            continue;
+        }
+
+        {
+            WEARABLES_TRACE_SCOPE("IWearLogger::writeSample");
+            writeSample(*sample, writer, saveVar);
+        }
+        sampleQueue->pop(writer);
+
+        // Every writer handles all the samples, the first one accounts for them
+        if (metrics && writer == 0) {
+            metrics->addFramesOut();
+        }
+    }
+}
+
+void IWearLogger::impl::startWriters(const double period)
+{
+    writersRunning = true;
+    sampleQueue->resume();
+    for (size_t writer = 0; writer < settings.writerThreads; ++writer) {
+        writers.emplace_back(&IWearLogger::impl::writerLoop, this, writer, period);
+    }
+}
+
+void IWearLogger::impl::stopWriters()
+{
+    if (writers.empty()) {
+        return;
+    }
+
+    // The writers drain the queue before exiting
+    writersRunning = false;
+    sampleQueue->interrupt();
+    for (auto& writer : writers) {
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+    writers.clear();
+
+    if (binaryWriter.isOpen() && !binaryWriter.close()) {
+        yError() << logPrefix << "Failed to close the binary log:" << binaryWriter.getLastError();
+    }
+
+    yInfo() << logPrefix << "Logged" << statistics.samples << "samples, dropped"
+            << statistics.droppedSamples << "samples, max queue depth"
+            << statistics.maxQueueDepth << "/" << sampleQueue->capacity() << ", triggers"
+            << statistics.triggers;
+}
+
+bool IWearLogger::impl::isLoggingEnabled(const sensor::SensorType type) const
+{
+    switch (type) {
+        case sensor::SensorType::Accelerometer:
+            return settings.logAccelerometers;
+        case sensor::SensorType::EmgSensor:
+            return settings.logEMGSensors;
+        case sensor::SensorType::Force3DSensor:
+            return settings.logForce3DSensors;
+        case sensor::SensorType::ForceTorque6DSensor:
+            return settings.logForceTorque6DSensors;
+        case sensor::SensorType::FreeBodyAccelerationSensor:
+            return settings.logFreeBodyAccelerationSensors;
+        case sensor::SensorType::Gyroscope:
+            return settings.logGyroscopes;
+        case sensor::SensorType::Magnetometer:
+            return settings.logMagnetometers;
+        case sensor::SensorType::OrientationSensor:
+            return settings.logOrientationSensors;
+        case sensor::SensorType::PoseSensor:
+            return settings.logPoseSensors;
+        case sensor::SensorType::PositionSensor:
+            return settings.logPositionSensors;
+        case sensor::SensorType::SkinSensor:
+            return settings.logSkinSensors;
+        case sensor::SensorType::TemperatureSensor:
+            return settings.logTemperatureSensors;
+        case sensor::SensorType::Torque3DSensor:
+            return settings.logTorque3DSensors;
+        case sensor::SensorType::VirtualLinkKinSensor:
+            return settings.logVirtualLinkKinSensors;
+        case sensor::SensorType::VirtualJointKinSensor:
+            return settings.logVirtualJointKinSensors;
+        case sensor::SensorType::VirtualSphericalJointKinSensor:
+            return settings.logVirtualSphericalJointKinSensors;
+        default:
+            return false;
+    }
+}
+
+void IWearLogger::threadRelease()
+{
+    yInfo() << logPrefix << "Loop timing:" << pImpl->jitter.summary();
+}
 
 bool IWearLogger::detach()
 {
@@ -1345,6 +2303,9 @@ bool IWearLogger::detach()
         stop();
     }
 
+    // Write the samples still in the queue before releasing the interfaces
+    pImpl->stopWriters();
+
     pImpl->iWear = nullptr;
     pImpl->iPreciselyTimed = nullptr;
 
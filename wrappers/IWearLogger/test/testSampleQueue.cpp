@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: Fondazione Istituto Italiano di Tecnologia (IIT)
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "SampleQueue.h"
+#include "Wearable/TestUtils/Check.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wearable::wrappers::logger;
+using wearable::test::check;
+
+static void testOrder()
+{
+    SampleQueue queue(4, 3, 1, 2);
+    check(queue.capacity() == 4 && queue.size() == 0, "wrong capacity or size");
+    check(!queue.front(0) && !queue.front(1), "sample read from the empty queue");
+
+    for (int i = 0; i < 4; ++i) {
+        Sample* sample = queue.tryAcquire();
+        check(sample && sample->values.size() == 3 && sample->valid.size() == 1,
+              "slot " + std::to_string(i) + " not preallocated");
+        sample->sequenceNumber = i;
+        queue.publish();
+    }
+    check(!queue.tryAcquire(), "slot acquired from the full queue");
+
+    // A slot is reused only once all the consumers released it
+    for (int i = 0; i < 4; ++i) {
+        const Sample* sample = queue.front(0);
+        check(sample && sample->sequenceNumber == i, "wrong order of the first consumer");
+        queue.pop(0);
+    }
+    check(!queue.tryAcquire() && queue.size() == 4, "slot reused before the second consumer");
+
+    const Sample* sample = queue.front(1);
+    check(sample && sample->sequenceNumber == 0, "wrong order of the second consumer");
+    queue.pop(1);
+    check(queue.tryAcquire() && queue.size() == 3, "released slot not reused");
+}
+
+static void testWait()
+{
+    SampleQueue queue(2, 1, 1);
+
+    // Without samples the wait lasts until the timeout
+    const auto start = std::chrono::steady_clock::now();
+    check(!queue.wait(0, 0.05), "sample returned by the wait of the empty queue");
+    check(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(45),
+          "wait returned before the timeout");
+
+    // A published sample wakes up the consumer
+    std::atomic<bool> received{false};
+    std::thread consumer([&queue, &received] {
+        const Sample* sample = queue.wait(0, 10.0);
+        received = sample && sample->sequenceNumber == 7;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const auto publishTime = std::chrono::steady_clock::now();
+    queue.tryAcquire()->sequenceNumber = 7;
+    queue.publish();
+    consumer.join();
+    check(received && std::chrono::steady_clock::now() - publishTime < std::chrono::seconds(5),
+          "waiting consumer not woken up by the sample");
+    queue.pop(0);
+
+    // An interrupted queue does not wait until resumed
+    std::thread interrupted([&queue] { queue.wait(0, 10.0); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const auto interruptTime = std::chrono::steady_clock::now();
+    queue.interrupt();
+    interrupted.join();
+    check(std::chrono::steady_clock::now() - interruptTime < std::chrono::seconds(5),
+          "waiting consumer not woken up by the interruption");
+    check(!queue.wait(0, 10.0), "interrupted queue waited");
+
+    queue.resume();
+    check(!queue.wait(0, 0.01), "sample returned by the wait of the resumed queue");
+}
+
+// Every consumer receives all the samples of the producer in order, waiting for them
+static void testConcurrency()
+{
+    const int nSamples = 100000;
+    const size_t nConsumers = 3;
+    SampleQueue queue(16, 1, 1, nConsumers);
+
+    std::atomic<bool> running{true};
+    std::vector<int> errors(nConsumers, 0);
+    std::vector<int> received(nConsumers, 0);
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < nConsumers; ++c) {
+        consumers.emplace_back([&, c] {
+            while (true) {
+                const bool producing = running;
+                const Sample* sample = queue.front(c);
+                if (!sample) {
+                    if (!producing) {
+                        break;
+                    }
+                    queue.wait(c, 1.0);
+                    continue;
+                }
+                if (sample->sequenceNumber != received[c]
+                    || sample->values[0] != sample->sequenceNumber) {
+                    errors[c]++;
+                }
+                received[c]++;
+                queue.pop(c);
+            }
+        });
+    }
+
+    for (int i = 0; i < nSamples; ++i) {
+        Sample* sample = queue.tryAcquire();
+        while (!sample) {
+            std::this_thread::yield();
+            sample = queue.tryAcquire();
+        }
+        sample->sequenceNumber = i;
+        sample->values[0] = i;
+        queue.publish();
+    }
+    running = false;
+    queue.interrupt();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    for (size_t c = 0; c < nConsumers; ++c) {
+        check(received[c] == nSamples && errors[c] == 0,
+              "consumer " + std::to_string(c) + " received " + std::to_string(received[c])
+                  + " samples with " + std::to_string(errors[c]) + " errors");
+    }
+}
+
+int main()
+{
+    testOrder();
+    testWait();
+    testConcurrency();
+
+    return wearable::test::exitStatus();
+}